@@ -331,6 +331,26 @@ if (HAVE_LIBDL)
   list(APPEND system_libs ${CMAKE_DL_LIBS})
 endif()
 
+# Packet compression for the gdb-remote protocol and compressed ELF debug
+# info. The HAVE_LIBZ/HAVE_LIBLZ4 definitions are only added by the plugins
+# that use them.
+set(LLDB_HAVE_LIBZ OFF)
+set(LLDB_HAVE_LIBLZ4 OFF)
+if (NOT CMAKE_SYSTEM_NAME MATCHES "Windows")
+  find_package(ZLIB)
+  if (ZLIB_FOUND)
+    set(LLDB_HAVE_LIBZ ON)
+    list(APPEND system_libs ${ZLIB_LIBRARIES})
+  endif()
+
+  find_path(LZ4_INCLUDE_DIR lz4.h)
+  find_library(LZ4_LIBRARY lz4)
+  if (LZ4_INCLUDE_DIR AND LZ4_LIBRARY)
+    set(LLDB_HAVE_LIBLZ4 ON)
+    list(APPEND system_libs ${LZ4_LIBRARY})
+  endif()
+endif()
+
 if(LLDB_REQUIRES_EH)
   set(LLDB_REQUIRES_RTTI ON)
 else()
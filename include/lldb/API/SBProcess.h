@@ -385,6 +385,27 @@ public:
     
     lldb::SBThreadCollection
     GetHistoryThreads (addr_t addr);
+
+    //------------------------------------------------------------------
+    /// Get all the threads of the process with their stack frames
+    /// already computed.
+    ///
+    /// When the "target.process.parallel-thread-unwind" setting is
+    /// enabled and the process plug-in supports it, the threads are
+    /// unwound concurrently, which is much faster than getting the
+    /// frames of one thread after the other for remote processes with
+    /// many threads.
+    ///
+    /// @param[in] num_frames
+    ///   The number of frames to compute for each thread, UINT32_MAX
+    ///   computes all of them.
+    ///
+    /// @return
+    ///   The threads of the process, or an invalid collection if the
+    ///   process isn't stopped.
+    //------------------------------------------------------------------
+    lldb::SBThreadCollection
+    GetThreadsWithStackFrames (uint32_t num_frames);
     
     bool
     IsInstrumentationRuntimePresent(InstrumentationRuntimeType type);
@@ -237,6 +237,29 @@ public:
                      lldb::DynamicValueType use_dynamic,
                      bool can_create_synthetic);
 
+    //------------------------------------------------------------------
+    /// Get a window of consecutive children of a value.
+    ///
+    /// Front ends showing a few children of a huge container at a time
+    /// should use this instead of calling GetChildAtIndex() for each
+    /// child. When the children are next to each other in memory, their
+    /// memory is read in one go instead of one child at a time.
+    ///
+    /// @param[in] start_idx
+    ///     The index of the first child.
+    ///
+    /// @param[in] count
+    ///     The number of children wanted. Fewer are returned when the
+    ///     window goes past the last child.
+    ///
+    /// @return
+    ///     The children in index order. A child that can't be created is
+    ///     an invalid SBValue, so the index of a child in the list is
+    ///     always its index minus start_idx.
+    //------------------------------------------------------------------
+    lldb::SBValueList
+    GetChildrenRange (uint32_t start_idx, uint32_t count);
+
     // Matches children of this object only and will match base classes and
     // member names if this is a clang typed object.
     uint32_t
@@ -793,6 +793,11 @@ private:
     void
     SendBreakpointChangedEvent (BreakpointEventData *data);
 
+    // Tell the process the condition or the ignore count of all the
+    // locations changed.
+    void
+    UpdateBreakpointSiteConditions ();
+
     DISALLOW_COPY_AND_ASSIGN(Breakpoint);
 };
 
@@ -175,7 +175,15 @@ public:
     //------------------------------------------------------------------
     const char *
     GetConditionText(size_t *hash = nullptr) const;
-    
+
+    //------------------------------------------------------------------
+    /// Tell the process the condition or the ignore count of this
+    /// location changed, so the conditions evaluated by the remote stub
+    /// for its breakpoint site can be updated.
+    //------------------------------------------------------------------
+    void
+    UpdateBreakpointSiteConditions ();
+
     bool
     ConditionSaysStop (ExecutionContext &exe_ctx, Error &error);
 
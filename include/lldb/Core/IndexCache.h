@@ -0,0 +1,120 @@
+//===-- IndexCache.h --------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_IndexCache_h_
+#define liblldb_IndexCache_h_
+
+// C Includes
+// C++ Includes
+#include <string>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-types.h"
+#include "lldb/lldb-forward.h"
+#include "lldb/Core/Error.h"
+#include "lldb/Host/FileSpec.h"
+#include "lldb/Host/TimeValue.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class IndexCache IndexCache.h "lldb/Core/IndexCache.h"
+/// @brief An on-disk cache for indexes computed from object files.
+///
+/// Building the name indexes for a large binary is expensive, so the
+/// finalized indexes are stored on disk and reused by later debug
+/// sessions. Each kind of index uses its own file extension and each
+/// cache file is named after the UUID and the file name of the object
+/// file it was computed from. Cache files start with a header holding
+/// the format version and the modification time of the object file, so
+/// a rebuilt binary with an unchanged UUID doesn't pick up stale data:
+///
+///     ${CACHE_ROOT}/${UUID}-${FILENAME}${EXTENSION}
+///
+/// Cache files are written to a temporary file and renamed into place,
+/// so several debug sessions can share a cache directory. All kinds of
+/// index share the directory and its maximum size, when the total size
+/// of the cache files exceeds it the oldest ones are removed. Only files
+/// following the naming scheme above with one of the known index
+/// extensions are counted and removed.
+//----------------------------------------------------------------------
+class IndexCache
+{
+public:
+    //------------------------------------------------------------------
+    /// Construct a cache for one kind of index.
+    ///
+    /// @param[in] cache_dir
+    ///     The directory holding the cache files.
+    ///
+    /// @param[in] max_cache_byte_size
+    ///     The maximum total size of the cache files in \a cache_dir,
+    ///     zero means unlimited.
+    ///
+    /// @param[in] file_extension
+    ///     The file extension, including the leading period, of the
+    ///     cache files for this kind of index.
+    ///
+    /// @param[in] format_version
+    ///     The version of the payload format. Cache files written with
+    ///     an other version are ignored.
+    //------------------------------------------------------------------
+    IndexCache (const FileSpec &cache_dir,
+                uint64_t max_cache_byte_size,
+                const char *file_extension,
+                uint32_t format_version);
+
+    //------------------------------------------------------------------
+    /// Read the cached index for an object file.
+    ///
+    /// @return
+    ///     True if a cache file with a matching version and modification
+    ///     time was found, in which case \a data contains the payload.
+    //------------------------------------------------------------------
+    bool
+    Read (const UUID &uuid,
+          const FileSpec &file_spec,
+          const TimeValue &mod_time,
+          DataExtractor &data) const;
+
+    //------------------------------------------------------------------
+    /// Store the index payload for an object file, replacing any older
+    /// entry and trimming the cache to its maximum size.
+    //------------------------------------------------------------------
+    Error
+    Write (const UUID &uuid,
+           const FileSpec &file_spec,
+           const TimeValue &mod_time,
+           const void *payload,
+           size_t payload_size);
+
+    //------------------------------------------------------------------
+    /// The default cache directory, ~/.lldb/index_cache, or an invalid
+    /// FileSpec when the home directory can't be found.
+    //------------------------------------------------------------------
+    static FileSpec
+    GetDefaultCacheDirectory ();
+
+private:
+    FileSpec
+    GetCacheFileSpec (const UUID &uuid, const FileSpec &file_spec) const;
+
+    void
+    Prune ();
+
+    FileSpec m_cache_dir;
+    uint64_t m_max_byte_size; // Zero means unlimited
+    std::string m_file_extension;
+    uint32_t m_format_version;
+};
+
+} // namespace lldb_private
+
+#endif  // liblldb_IndexCache_h_
@@ -281,6 +281,31 @@ public:
         m_map.reserve (n);
     }
 
+    //------------------------------------------------------------------
+    // Direct access to the entries in this map. This is intended for
+    // clients that fill or sort large maps from multiple threads: call
+    // UniqueCStringMap::Resize() once and have each thread write to a
+    // disjoint range of entries. The returned pointer is invalidated by
+    // any call that changes the size of the map.
+    //------------------------------------------------------------------
+    void
+    Resize (size_t n)
+    {
+        m_map.resize (n);
+    }
+
+    Entry *
+    GetEntries ()
+    {
+        return m_map.data();
+    }
+
+    const Entry *
+    GetEntries () const
+    {
+        return m_map.data();
+    }
+
     //------------------------------------------------------------------
     // Sort the unsorted contents in this map. A typical code flow would
     // be:
@@ -556,6 +556,31 @@ public:
     virtual lldb::ValueObjectSP
     GetChildAtIndex (size_t idx, bool can_create);
 
+    //------------------------------------------------------------------
+    /// Get a window of consecutive children, creating them if needed.
+    ///
+    /// When the children are laid out back to back in memory, like the
+    /// elements of an array or a std::vector, the memory of the whole
+    /// window is read at once so the children find their values in the
+    /// memory cache instead of each reading its own.
+    ///
+    /// @param[in] start_idx
+    ///     The index of the first child.
+    ///
+    /// @param[in] count
+    ///     The number of children wanted, the window stops at the last
+    ///     child.
+    ///
+    /// @param[out] children
+    ///     The children, in index order. Children that can't be created
+    ///     are left empty.
+    ///
+    /// @return
+    ///     The number of children in the window.
+    //------------------------------------------------------------------
+    size_t
+    GetChildrenRange (size_t start_idx, size_t count, std::vector<lldb::ValueObjectSP> &children);
+
     // this will always create the children if necessary
     lldb::ValueObjectSP
     GetChildAtIndexPath(const std::initializer_list<size_t> &idxs,
@@ -12,7 +12,8 @@
 
 // C Includes
 // C++ Includes
-#include <map>
+#include <atomic>
+#include <unordered_map>
 
 // Other libraries and framework includes
 // Project includes
@@ -21,6 +22,21 @@
 #include "lldb/Host/Mutex.h"
 
 namespace lldb_private {
+
+//----------------------------------------------------------------------
+// FormatCache
+//
+// Remembers the formatters found for a type, including that a type has
+// none, so printing many values of the same types doesn't search all the
+// categories for each of them.
+//
+// Entries are keyed by the type name and the dynamic value mode of the
+// lookup, and tagged with the revision of the formatters they were found
+// with. An entry from another revision is a miss, so a lookup that
+// finishes after the formatters changed can't leave a stale result behind.
+// The entries are spread over stripes that each have their own lock,
+// threads looking up different types rarely wait on each other.
+//----------------------------------------------------------------------
 class FormatCache
 {
 private:
@@ -36,13 +52,15 @@ private:
         lldb::TypeSummaryImplSP m_summary_sp;
         lldb::SyntheticChildrenSP m_synthetic_sp;
         lldb::TypeValidatorImplSP m_validator_sp;
+        uint32_t m_revision;
     public:
-        Entry ();
-        Entry (lldb::TypeFormatImplSP);
-        Entry (lldb::TypeSummaryImplSP);
-        Entry (lldb::SyntheticChildrenSP);
-        Entry (lldb::TypeValidatorImplSP);
-        Entry (lldb::TypeFormatImplSP,lldb::TypeSummaryImplSP,lldb::SyntheticChildrenSP,lldb::TypeValidatorImplSP);
+        Entry (uint32_t revision = 0);
+
+        uint32_t
+        GetRevision () const
+        {
+            return m_revision;
+        }
 
         bool
         IsFormatCached ();
@@ -80,42 +98,77 @@ private:
         void
         SetValidator (lldb::TypeValidatorImplSP);
     };
-    typedef std::map<ConstString,Entry> CacheMap;
-    CacheMap m_map;
-    Mutex m_mutex;
-    
-    uint64_t m_cache_hits;
-    uint64_t m_cache_misses;
-    
-    Entry&
-    GetEntry (const ConstString& type);
-    
+
+    struct Key
+    {
+        ConstString m_type;
+        lldb::DynamicValueType m_use_dynamic;
+
+        bool
+        operator == (const Key &rhs) const
+        {
+            return m_type == rhs.m_type && m_use_dynamic == rhs.m_use_dynamic;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t
+        operator () (const Key &key) const;
+    };
+
+    typedef std::unordered_map<Key, Entry, KeyHash> CacheMap;
+
+    struct Stripe
+    {
+        Mutex m_mutex;
+        CacheMap m_map;
+    };
+
+    static const size_t k_num_stripes = 16;
+
+    Stripe m_stripes[k_num_stripes];
+    std::atomic<uint64_t> m_cache_hits;
+    std::atomic<uint64_t> m_cache_negative_hits;
+    std::atomic<uint64_t> m_cache_misses;
+
+    Stripe &
+    GetStripe (const Key &key);
+
+    // Returns the entry of the key for the revision, stale entries are only
+    // replaced when create is true.
+    Entry *
+    GetEntry (Stripe &stripe, const Key &key, uint32_t revision, bool create);
+
+    void
+    RecordLookup (bool found, bool negative);
+
 public:
     FormatCache ();
     
     bool
-    GetFormat (const ConstString& type,lldb::TypeFormatImplSP& format_sp);
+    GetFormat (const ConstString& type, lldb::DynamicValueType use_dynamic, uint32_t revision, lldb::TypeFormatImplSP& format_sp);
     
     bool
-    GetSummary (const ConstString& type,lldb::TypeSummaryImplSP& summary_sp);
+    GetSummary (const ConstString& type, lldb::DynamicValueType use_dynamic, uint32_t revision, lldb::TypeSummaryImplSP& summary_sp);
 
     bool
-    GetSynthetic (const ConstString& type,lldb::SyntheticChildrenSP& synthetic_sp);
+    GetSynthetic (const ConstString& type, lldb::DynamicValueType use_dynamic, uint32_t revision, lldb::SyntheticChildrenSP& synthetic_sp);
     
     bool
-    GetValidator (const ConstString& type,lldb::TypeValidatorImplSP& summary_sp);
+    GetValidator (const ConstString& type, lldb::DynamicValueType use_dynamic, uint32_t revision, lldb::TypeValidatorImplSP& validator_sp);
     
     void
-    SetFormat (const ConstString& type,lldb::TypeFormatImplSP& format_sp);
+    SetFormat (const ConstString& type, lldb::DynamicValueType use_dynamic, uint32_t revision, lldb::TypeFormatImplSP& format_sp);
     
     void
-    SetSummary (const ConstString& type,lldb::TypeSummaryImplSP& summary_sp);
+    SetSummary (const ConstString& type, lldb::DynamicValueType use_dynamic, uint32_t revision, lldb::TypeSummaryImplSP& summary_sp);
     
     void
-    SetSynthetic (const ConstString& type,lldb::SyntheticChildrenSP& synthetic_sp);
+    SetSynthetic (const ConstString& type, lldb::DynamicValueType use_dynamic, uint32_t revision, lldb::SyntheticChildrenSP& synthetic_sp);
     
     void
-    SetValidator (const ConstString& type,lldb::TypeValidatorImplSP& synthetic_sp);
+    SetValidator (const ConstString& type, lldb::DynamicValueType use_dynamic, uint32_t revision, lldb::TypeValidatorImplSP& validator_sp);
     
     void
     Clear ();
@@ -126,6 +179,13 @@ public:
         return m_cache_hits;
     }
     
+    // The hits that found the type has no formatter of the kind looked up.
+    uint64_t
+    GetCacheNegativeHits ()
+    {
+        return m_cache_negative_hits;
+    }
+
     uint64_t
     GetCacheMisses ()
     {
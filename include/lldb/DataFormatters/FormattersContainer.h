@@ -16,6 +16,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 // Other libraries and framework includes
 // Project includes
@@ -24,6 +25,7 @@
 #include "lldb/Core/RegularExpression.h"
 #include "lldb/Core/ValueObject.h"
 #include "lldb/DataFormatters/FormatClasses.h"
+#include "lldb/DataFormatters/RegexPrefixFilter.h"
 #include "lldb/DataFormatters/TypeFormat.h"
 #include "lldb/DataFormatters/TypeSummary.h"
 #include "lldb/DataFormatters/TypeSynthetic.h"
@@ -85,6 +87,7 @@ public:
     FormatMap(IFormatChangeListener* lst) :
     m_map(),
     m_map_mutex(Mutex::eMutexTypeRecursive),
+    m_generation(0),
     listener(lst)
     {
     }
@@ -100,6 +103,7 @@ public:
 
         Mutex::Locker locker(m_map_mutex);
         m_map[name] = entry;
+        m_generation++;
         if (listener)
             listener->Changed();
     }
@@ -112,6 +116,7 @@ public:
         if (iter == m_map.end())
             return false;
         m_map.erase(name);
+        m_generation++;
         if (listener)
             listener->Changed();
         return true;
@@ -122,6 +127,7 @@ public:
     {
         Mutex::Locker locker(m_map_mutex);
         m_map.clear();
+        m_generation++;
         if (listener)
             listener->Changed();
     }
@@ -195,6 +201,7 @@ public:
 protected:
     MapType m_map;    
     Mutex m_map_mutex;
+    uint32_t m_generation; // Bumped on every change of m_map
     IFormatChangeListener* listener;
     
     MapType&
@@ -232,7 +239,10 @@ public:
     FormattersContainer(std::string name,
                     IFormatChangeListener* lst) :
     m_format_map(lst),
-    m_name(name)
+    m_name(name),
+    m_regex_filter(),
+    m_regex_entries(),
+    m_regex_filter_generation(UINT32_MAX)
     {
     }
     
@@ -311,8 +321,30 @@ public:
 protected:
     BackEndType m_format_map;
     std::string m_name;
+    // Only used when the keys are regular expressions, m_regex_entries
+    // holds the map entries in the order m_regex_filter indexes them.
+    RegexPrefixFilter m_regex_filter;
+    std::vector<MapIterator> m_regex_entries;
+    uint32_t m_regex_filter_generation;
     
     DISALLOW_COPY_AND_ASSIGN(FormattersContainer);
+
+    // Must be called with the map mutex held.
+    void
+    UpdateRegexFilter ()
+    {
+        if (m_regex_filter_generation == m_format_map.m_generation)
+            return;
+        m_regex_filter.Clear();
+        m_regex_entries.clear();
+        MapIterator pos, end = m_format_map.map().end();
+        for (pos = m_format_map.map().begin(); pos != end; pos++)
+        {
+            m_regex_entries.push_back(pos);
+            m_regex_filter.Append(pos->first->GetText());
+        }
+        m_regex_filter_generation = m_format_map.m_generation;
+    }
     
     void
     Add_Impl (const MapKeyType &type, const MapValueType& entry, lldb::RegularExpressionSP *dummy)
@@ -343,6 +375,7 @@ protected:
            if ( ::strcmp(type.AsCString(),regex->GetText()) == 0)
            {
                m_format_map.map().erase(pos);
+               m_format_map.m_generation++;
                if (m_format_map.listener)
                    m_format_map.listener->Changed();
                return true;
@@ -392,9 +425,14 @@ protected:
            return false;
        Mutex& x_mutex = m_format_map.mutex();
        lldb_private::Mutex::Locker locker(x_mutex);
-       MapIterator pos, end = m_format_map.map().end();
-       for (pos = m_format_map.map().begin(); pos != end; pos++)
+       // Only execute the regexes whose literal prefix the name starts
+       // with, in the order of the map.
+       UpdateRegexFilter();
+       std::vector<uint32_t> candidates;
+       m_regex_filter.GetCandidates(key_cstr, candidates);
+       for (uint32_t idx : candidates)
        {
+           MapIterator pos = m_regex_entries[idx];
            lldb::RegularExpressionSP regex = pos->first;
            if (regex->Execute(key_cstr))
            {
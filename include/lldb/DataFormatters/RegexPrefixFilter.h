@@ -0,0 +1,84 @@
+//===-- RegexPrefixFilter.h -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef lldb_RegexPrefixFilter_h_
+#define lldb_RegexPrefixFilter_h_
+
+// C Includes
+// C++ Includes
+#include <map>
+#include <string>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-public.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+// RegexPrefixFilter
+//
+// Most regex formatters are anchored patterns like
+// "^std::__1::vector<.+>(( )?&)?$" that can only match type names
+// starting with a literal prefix. The filter keeps the prefixes of a
+// list of patterns in a trie, walking a type name through it once gives
+// the few patterns that can match it, in list order, so only those need
+// to be executed. Patterns without a literal prefix are always returned.
+//----------------------------------------------------------------------
+class RegexPrefixFilter
+{
+public:
+    RegexPrefixFilter ();
+
+    void
+    Clear ();
+
+    //------------------------------------------------------------------
+    // Add the next pattern of the list, its index is the number of
+    // patterns added before it.
+    //------------------------------------------------------------------
+    void
+    Append (const char *regex_text);
+
+    size_t
+    GetSize () const
+    {
+        return m_size;
+    }
+
+    //------------------------------------------------------------------
+    // Fill \a indexes with the increasing indexes of the patterns that
+    // may match \a name.
+    //------------------------------------------------------------------
+    void
+    GetCandidates (const char *name, std::vector<uint32_t> &indexes) const;
+
+    //------------------------------------------------------------------
+    // The literal text every string matched by the extended regular
+    // expression \a regex_text starts with, empty when there is none or
+    // the pattern is too complex to tell.
+    //------------------------------------------------------------------
+    static std::string
+    GetLiteralPrefix (const char *regex_text);
+
+private:
+    struct Node
+    {
+        std::map<char, uint32_t> m_children;
+        std::vector<uint32_t> m_indexes; // Patterns whose prefix ends here
+    };
+
+    std::vector<Node> m_nodes; // m_nodes[0] is the root
+    size_t m_size;
+};
+
+} // namespace lldb_private
+
+#endif // lldb_RegexPrefixFilter_h_
@@ -17,6 +17,7 @@
 
 #include <functional>
 #include <map>
+#include <vector>
 
 namespace lldb_private
 {
@@ -24,6 +25,7 @@ namespace lldb_private
     {
     public:
         typedef std::function<Error (lldb::addr_t addr, size_t size_hint, bool hardware, NativeBreakpointSP &breakpoint_sp)> CreateBreakpointFunc;
+        typedef std::function<void (const std::vector<lldb::addr_t> &addrs, size_t size_hint, bool hardware, std::vector<NativeBreakpointSP> &breakpoints, std::vector<Error> &errors)> CreateBreakpointsFunc;
 
         NativeBreakpointList ();
 
@@ -33,6 +35,15 @@ namespace lldb_private
         Error
         DecRef (lldb::addr_t addr);
 
+        // Like AddRef() and DecRef() for several addresses at once, the
+        // breakpoints that don't exist yet are created with a single call
+        // to create_func. The error of each address is returned in errors.
+        void
+        AddRefs (const std::vector<lldb::addr_t> &addrs, size_t size_hint, bool hardware, CreateBreakpointsFunc create_func, std::vector<Error> &errors);
+
+        void
+        DecRefs (const std::vector<lldb::addr_t> &addrs, std::vector<Error> &errors);
+
         Error
         EnableBreakpoint (lldb::addr_t addr);
 
@@ -97,6 +97,36 @@ namespace lldb_private
         virtual Error
         WriteMemory(lldb::addr_t addr, const void *buf, size_t size, size_t &bytes_written) = 0;
 
+        // A memory range to read with ReadMemoryRanges().
+        struct MemoryRangeRead
+        {
+            lldb::addr_t addr;  // The address to read from
+            void *buf;          // A buffer of at least "size" bytes receiving the memory
+            size_t size;        // The number of bytes to read
+            size_t bytes_read;  // Set to the number of bytes that were read
+        };
+
+        //------------------------------------------------------------------
+        /// Read several ranges of memory at once.
+        ///
+        /// The default implementation reads each range with ReadMemory(),
+        /// processes that can gather several ranges in one operation
+        /// should override it. A range that can't be read doesn't stop the
+        /// others from being read.
+        ///
+        /// @return
+        ///     An error if none of the ranges could be read.
+        //------------------------------------------------------------------
+        virtual Error
+        ReadMemoryRanges(std::vector<MemoryRangeRead> &reads);
+
+        //------------------------------------------------------------------
+        /// Like ReadMemoryRanges() but with the software breakpoint opcodes
+        /// replaced by the original memory contents.
+        //------------------------------------------------------------------
+        Error
+        ReadMemoryRangesWithoutTrap(std::vector<MemoryRangeRead> &reads);
+
         virtual Error
         AllocateMemory(size_t size, uint32_t permissions, lldb::addr_t &addr) = 0;
 
@@ -130,6 +160,22 @@ namespace lldb_private
         virtual Error
         DisableBreakpoint (lldb::addr_t addr);
 
+        //------------------------------------------------------------------
+        /// Set or remove several breakpoints at once.
+        ///
+        /// The default implementations call SetBreakpoint() or
+        /// RemoveBreakpoint() for each address, processes that can set
+        /// their breakpoints in bulk override them.
+        ///
+        /// @param[out] errors
+        ///     The error of each address, in the same order.
+        //------------------------------------------------------------------
+        virtual void
+        SetBreakpoints (const std::vector<lldb::addr_t> &addrs, uint32_t size, bool hardware, std::vector<Error> &errors);
+
+        virtual void
+        RemoveBreakpoints (const std::vector<lldb::addr_t> &addrs, std::vector<Error> &errors);
+
         //----------------------------------------------------------------------
         // Watchpoint functions
         //----------------------------------------------------------------------
@@ -400,6 +446,9 @@ namespace lldb_private
         Error
         SetSoftwareBreakpoint (lldb::addr_t addr, uint32_t size_hint);
 
+        void
+        SetSoftwareBreakpoints (const std::vector<lldb::addr_t> &addrs, uint32_t size_hint, std::vector<Error> &errors);
+
         virtual Error
         GetSoftwareBreakpointTrapOpcode (size_t trap_opcode_size_hint, size_t &actual_opcode_size, const uint8_t *&trap_opcode_bytes) = 0;
 
@@ -10,6 +10,8 @@
 #ifndef liblldb_SoftwareBreakpoint_h_
 #define liblldb_SoftwareBreakpoint_h_
 
+#include <vector>
+
 #include "lldb/lldb-private-forward.h"
 #include "NativeBreakpoint.h"
 
@@ -23,6 +25,34 @@ namespace lldb_private
         static Error
         CreateSoftwareBreakpoint (NativeProcessProtocol &process, lldb::addr_t addr, size_t size_hint, NativeBreakpointSP &breakpoint_spn);
 
+        //------------------------------------------------------------------
+        /// Create the software breakpoints of several addresses at once.
+        ///
+        /// The original opcodes of all the addresses are read, and the
+        /// traps verified, with a single ReadMemoryRanges() call each.
+        ///
+        /// @param[in] addrs
+        ///     The addresses of the breakpoints, all different.
+        ///
+        /// @param[out] breakpoints
+        ///     The breakpoint created for each address, empty for the
+        ///     addresses that failed.
+        ///
+        /// @param[out] errors
+        ///     Why the breakpoint of each address couldn't be created.
+        //------------------------------------------------------------------
+        static void
+        CreateSoftwareBreakpoints (NativeProcessProtocol &process, const std::vector<lldb::addr_t> &addrs, size_t size_hint,
+                                   std::vector<NativeBreakpointSP> &breakpoints, std::vector<Error> &errors);
+
+        //------------------------------------------------------------------
+        /// Restore the original opcodes of several enabled software
+        /// breakpoints at once.
+        //------------------------------------------------------------------
+        static void
+        DisableSoftwareBreakpoints (NativeProcessProtocol &process, const std::vector<SoftwareBreakpoint *> &breakpoints,
+                                    std::vector<Error> &errors);
+
         SoftwareBreakpoint (NativeProcessProtocol &process, lldb::addr_t addr, const uint8_t *saved_opcodes, const uint8_t *trap_opcodes, size_t opcode_size);
 
     protected:
@@ -12,6 +12,9 @@
 
 // C Includes
 // C++ Includes
+#include <list>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 // Other libraries and framework includes
@@ -50,6 +53,43 @@ private:
 class LineTable
 {
 public:
+    //------------------------------------------------------------------
+    /// @class SequenceDecoder LineTable.h "lldb/Symbol/LineTable.h"
+    /// @brief Decodes the sequences of a lazily populated line table.
+    ///
+    /// Symbol files that can decode each sequence of a line table on
+    /// its own only record where the sequences are with
+    /// LineTable::AddLazySequence() and hand a decoder to the line
+    /// table. Address lookups then only decode the sequence that
+    /// contains the address.
+    //------------------------------------------------------------------
+    class SequenceDecoder
+    {
+    public:
+        virtual
+        ~SequenceDecoder() = default;
+
+        //--------------------------------------------------------------
+        /// Decode a sequence.
+        ///
+        /// @param[in] line_table
+        ///     The line table the sequence belongs to.
+        ///
+        /// @param[in] cookie
+        ///     The value given to LineTable::AddLazySequence() for the
+        ///     sequence.
+        ///
+        /// @param[in] sequence
+        ///     The container that gets the entries of the sequence with
+        ///     LineTable::AppendLineEntryToSequence().
+        ///
+        /// @return
+        ///     \b true if the sequence was decoded.
+        //--------------------------------------------------------------
+        virtual bool
+        DecodeSequence (LineTable &line_table, lldb::offset_t cookie, LineSequence *sequence) = 0;
+    };
+
     //------------------------------------------------------------------
     /// Construct with compile unit.
     ///
@@ -111,6 +151,17 @@ public:
     void
     InsertSequence (LineSequence* sequence);
 
+    // Record a sequence covering [low_addr, high_addr) that will be
+    // decoded on demand by the decoder given to SetSequenceDecoder().
+    void
+    AddLazySequence (lldb::addr_t low_addr, lldb::addr_t high_addr, lldb::offset_t cookie);
+
+    // Make this line table decode the sequences added with
+    // AddLazySequence() on demand. Must be called after all of them
+    // were added.
+    void
+    SetSequenceDecoder (std::unique_ptr<SequenceDecoder> &&decoder_ap);
+
     //------------------------------------------------------------------
     /// Dump all line entries in this line table to the stream \a s.
     ///
@@ -230,11 +281,14 @@ public:
     //------------------------------------------------------------------
     /// Gets the size of the line table in number of line table entries.
     ///
+    /// All the sequences of a lazily populated line table are decoded
+    /// to answer this.
+    ///
     /// @return
     ///     The number of line table entries in this line table.
     //------------------------------------------------------------------
     uint32_t
-    GetSize () const;
+    GetSize ();
 
     typedef lldb_private::RangeArray<lldb::addr_t, lldb::addr_t, 32> FileAddressRanges;
     
@@ -393,6 +447,33 @@ protected:
     CompileUnit* m_comp_unit;   ///< The compile unit that this line table belongs to.
     entry_collection m_entries; ///< The collection of line entries in this line table.
 
+    //------------------------------------------------------------------
+    // Lazily populated line tables
+    //------------------------------------------------------------------
+    struct LazySequence
+    {
+        lldb::addr_t low_addr;
+        lldb::addr_t high_addr;
+        lldb::addr_t max_high_addr; ///< The highest high_addr of this and all previous sequences.
+        lldb::offset_t cookie;
+
+        static bool
+        LowAddressLessThan (const LazySequence &lhs, const LazySequence &rhs)
+        {
+            if (lhs.low_addr != rhs.low_addr)
+                return lhs.low_addr < rhs.low_addr;
+            return lhs.high_addr < rhs.high_addr;
+        }
+    };
+
+    typedef std::vector<LazySequence> lazy_sequence_collection;
+    typedef std::list<std::pair<uint32_t, entry_collection>> decoded_sequence_collection;
+
+    std::mutex m_lazy_mutex;                            ///< Protects the lazy state below and the materialization of m_entries.
+    std::unique_ptr<SequenceDecoder> m_decoder_ap;      ///< Set until all the sequences are decoded into m_entries.
+    lazy_sequence_collection m_lazy_sequences;          ///< The sequences to decode, sorted by address once the decoder is set.
+    decoded_sequence_collection m_decoded_sequences;    ///< The most recently used decoded sequences first.
+
     //------------------------------------------------------------------
     // Helper class
     //------------------------------------------------------------------
@@ -412,6 +493,18 @@ protected:
     bool
     ConvertEntryAtIndexToLineEntry (uint32_t idx, LineEntry &line_entry);
 
+    bool
+    ConvertEntryToLineEntry (const Entry &entry, const Entry *next_entry, LineEntry &line_entry);
+
+    static uint32_t
+    FindEntryIndexByFileAddress (const entry_collection &entries, lldb::addr_t file_addr);
+
+    bool
+    FindLazyLineEntryByFileAddress (lldb::addr_t file_addr, LineEntry &line_entry, bool &success);
+
+    void
+    DecodeAllSequences ();
+
 private:
     DISALLOW_COPY_AND_ASSIGN (LineTable);
 };
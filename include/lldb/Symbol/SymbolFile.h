@@ -139,6 +139,17 @@ public:
     virtual CompilerDeclContext GetDeclContextContainingUID (lldb::user_id_t uid) { return CompilerDeclContext(); }
     virtual uint32_t        ResolveSymbolContext (const Address& so_addr, uint32_t resolve_scope, SymbolContext& sc) = 0;
     virtual uint32_t        ResolveSymbolContext (const FileSpec& file_spec, uint32_t line, bool check_inlines, uint32_t resolve_scope, SymbolContextList& sc_list);
+
+    //------------------------------------------------------------------
+    /// Find the indexes of the compile units that can have line entries
+    /// for \a file_spec, either as their own file or as one of their
+    /// support files, without parsing the support files of the others.
+    ///
+    /// @return
+    ///     False if this symbol file can't narrow down the compile units,
+    ///     in which case all of them need to be searched.
+    //------------------------------------------------------------------
+    virtual bool            FindCompileUnitsForFile (const FileSpec &file_spec, std::vector<uint32_t> &cu_indexes) { return false; }
     virtual uint32_t        FindGlobalVariables (const ConstString &name, const CompilerDeclContext *parent_decl_ctx, bool append, uint32_t max_matches, VariableList& variables);
     virtual uint32_t        FindGlobalVariables (const RegularExpression& regex, bool append, uint32_t max_matches, VariableList& variables);
     virtual uint32_t        FindFunctions (const ConstString &name, const CompilerDeclContext *parent_decl_ctx, uint32_t name_type_mask, bool include_inlines, bool append, SymbolContextList& sc_list);
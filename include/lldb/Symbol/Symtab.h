@@ -116,6 +116,8 @@ protected:
     typedef RangeDataVector<lldb::addr_t, lldb::addr_t, uint32_t> FileRangeToIndexMap;
             void        InitNameIndexes ();
             void        InitAddressIndexes ();
+            bool        LoadIndexCache ();
+            void        SaveIndexCache ();
 
     ObjectFile *        m_objfile;
     collection          m_symbols;
@@ -126,8 +128,16 @@ protected:
     UniqueCStringMap<uint32_t> m_selector_to_index;
     mutable Mutex       m_mutex; // Provide thread safety for this symbol table
     bool                m_file_addr_to_index_computed:1,
-                        m_name_indexes_computed:1;
+                        m_name_indexes_computed:1,
+                        m_index_cache_checked:1;
 private:
+    struct NameIndexSlice;
+
+    void
+    IndexSymbolNames (size_t start_idx,
+                      size_t end_idx,
+                      NameIndexSlice &slice,
+                      std::vector<const char *> &symbol_contexts) const;
 
     bool
     CheckSymbolAtIndex (size_t idx, Debug symbol_debug_type, Visibility symbol_visibility) const
@@ -0,0 +1,102 @@
+//===-- FrameUnwindPlanCache.h ----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_FrameUnwindPlanCache_h_
+#define liblldb_FrameUnwindPlanCache_h_
+
+// C Includes
+// C++ Includes
+#include <map>
+#include <tuple>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+#include "lldb/Host/Mutex.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+// The UnwindPlans picked by RegisterContextLLDB for frames above frame
+// zero, keyed by the load address of the frame's pc and its offsets into
+// the function. Picking the plans only depends on the pc for these
+// frames, along with the process' ABI and DynamicLoader, so each process
+// keeps its own cache, shared by all of its threads and kept across
+// stops instead of making the choice again for each frame.
+//
+// The cache must be cleared when a module is unloaded, since the load
+// addresses of its code may be reused, and when the process execs.
+//----------------------------------------------------------------------
+class FrameUnwindPlanCache
+{
+public:
+    FrameUnwindPlanCache ();
+
+    ~FrameUnwindPlanCache ();
+
+    bool
+    GetFastPlan (lldb::addr_t load_addr,
+                 int offset,
+                 int offset_backed_up_one,
+                 lldb::UnwindPlanSP &plan_sp);
+
+    void
+    SetFastPlan (lldb::addr_t load_addr,
+                 int offset,
+                 int offset_backed_up_one,
+                 const lldb::UnwindPlanSP &plan_sp);
+
+    bool
+    GetFullPlan (lldb::addr_t load_addr,
+                 int offset,
+                 int offset_backed_up_one,
+                 lldb::UnwindPlanSP &plan_sp,
+                 lldb::UnwindPlanSP &fallback_plan_sp);
+
+    void
+    SetFullPlan (lldb::addr_t load_addr,
+                 int offset,
+                 int offset_backed_up_one,
+                 const lldb::UnwindPlanSP &plan_sp,
+                 const lldb::UnwindPlanSP &fallback_plan_sp);
+
+    void
+    Clear ();
+
+private:
+    struct FrameUnwindPlans
+    {
+        FrameUnwindPlans () :
+            fast_plan_sp (),
+            full_plan_sp (),
+            fallback_plan_sp (),
+            has_fast_plan (false),
+            has_full_plan (false)
+        {
+        }
+
+        lldb::UnwindPlanSP fast_plan_sp;
+        lldb::UnwindPlanSP full_plan_sp;
+        lldb::UnwindPlanSP fallback_plan_sp;
+        bool has_fast_plan; // fast_plan_sp has been computed, it may still be empty
+        bool has_full_plan; // full_plan_sp and fallback_plan_sp have been computed
+    };
+
+    typedef std::tuple<lldb::addr_t, int, int> FrameKey; // load address, offset, offset backed up one
+    typedef std::map<FrameKey, FrameUnwindPlans> FrameUnwindPlansMap;
+
+    Mutex m_mutex;
+    FrameUnwindPlansMap m_frame_unwind_plans;
+
+    DISALLOW_COPY_AND_ASSIGN (FrameUnwindPlanCache);
+};
+
+} // namespace lldb_private
+
+#endif // liblldb_FrameUnwindPlanCache_h_
@@ -30,6 +30,27 @@ namespace lldb_private {
     class MemoryCache
     {
     public:
+        //------------------------------------------------------------------
+        // Counters describing how effective the cache has been over the
+        // lifetime of the process. They are not reset when the cache is
+        // cleared on each stop.
+        //------------------------------------------------------------------
+        struct Statistics
+        {
+            uint64_t hits;          // Reads satisfied entirely from the cache
+            uint64_t misses;        // Cache line misses, each causing a read from the process
+            uint64_t process_reads; // Number of reads from the process
+            uint64_t bytes_read;    // Number of bytes read from the process
+
+            Statistics () :
+                hits (0),
+                misses (0),
+                process_reads (0),
+                bytes_read (0)
+            {
+            }
+        };
+
         //------------------------------------------------------------------
         // Constructors and Destructors
         //------------------------------------------------------------------
@@ -68,6 +89,14 @@ namespace lldb_private {
         void
         AddL1CacheData(lldb::addr_t addr, const lldb::DataBufferSP &data_buffer_sp);
 
+        // Copy the range from the cache if it is cached in its entirety,
+        // without reading anything from the process.
+        bool
+        ReadFromCache (lldb::addr_t addr, void *dst, size_t dst_len);
+
+        Statistics
+        GetStatistics ();
+
     protected:
         typedef std::map<lldb::addr_t, lldb::DataBufferSP> BlockMap;
         typedef RangeArray<lldb::addr_t, lldb::addr_t, 4> InvalidRanges;
@@ -81,7 +110,13 @@ namespace lldb_private {
         InvalidRanges m_invalid_ranges;
         Process &m_process;
         uint32_t m_L2_cache_line_byte_size;
+        lldb::addr_t m_L2_next_sequential_addr; // The line after the last lines read from the process
+        uint32_t m_L2_prefetch_line_count; // Lines to read on the next sequential miss
+        Statistics m_stats;
     private:
+        size_t
+        ReadL2CacheLines (lldb::addr_t line_addr, uint32_t min_line_count, Error &error);
+
         DISALLOW_COPY_AND_ASSIGN (MemoryCache);
     };
 
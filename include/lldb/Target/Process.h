@@ -41,6 +41,7 @@
 #include "lldb/Host/ProcessRunLock.h"
 #include "lldb/Interpreter/Options.h"
 #include "lldb/Target/ExecutionContextScope.h"
+#include "lldb/Target/FrameUnwindPlanCache.h"
 #include "lldb/Target/Memory.h"
 #include "lldb/Target/ProcessInfo.h"
 #include "lldb/Target/ProcessLaunchInfo.h"
@@ -109,6 +110,9 @@ public:
     bool
     GetWarningsOptimization () const;
 
+    bool
+    GetParallelThreadUnwind () const;
+
 protected:
     static void
     OptionValueChangedCallback (void *baton, OptionValue *option_value);
@@ -2080,6 +2084,20 @@ public:
         return true;
     }
 
+    //------------------------------------------------------------------
+    /// Check if the threads of this process can be unwound concurrently
+    /// when the "parallel-thread-unwind" setting is enabled.
+    ///
+    /// @return
+    ///     \b true if the memory and register reads of this process
+    ///     plug-in are safe to make from several threads at once.
+    //------------------------------------------------------------------
+    virtual bool
+    SupportsParallelThreadUnwind () const
+    {
+        return false;
+    }
+
     //------------------------------------------------------------------
     /// Actually do the reading of memory from a process.
     ///
@@ -2108,6 +2126,34 @@ public:
                   size_t size,
                   Error &error) = 0;
 
+    //------------------------------------------------------------------
+    /// A memory range to read with ReadMemoryRanges().
+    //------------------------------------------------------------------
+    struct MemoryRangeRead
+    {
+        lldb::addr_t addr;  // The address to read from
+        void *buf;          // A buffer of at least "size" bytes receiving the memory
+        size_t size;        // The number of bytes to read
+        size_t bytes_read;  // Set to the number of bytes that were read
+    };
+
+    typedef std::vector<MemoryRangeRead> MemoryRangeReads;
+
+    //------------------------------------------------------------------
+    /// Actually read several ranges of memory from a process at once.
+    ///
+    /// Subclasses that can read multiple ranges with a single request
+    /// to the process should override this and fill in the "buf" and
+    /// "bytes_read" members of each range. Ranges that aren't read
+    /// completely are read again one at a time by ReadMemoryRanges(),
+    /// so subclasses can skip ranges they can't handle. The default
+    /// implementation doesn't read anything.
+    //------------------------------------------------------------------
+    virtual void
+    DoReadMemoryRanges (MemoryRangeReads &reads)
+    {
+    }
+
     //------------------------------------------------------------------
     /// Read of memory from a process.
     ///
@@ -2143,6 +2189,28 @@ public:
                 size_t size,
                 Error &error);
 
+    //------------------------------------------------------------------
+    /// Get memory from a process without copying it.
+    ///
+    /// Processes that already hold the memory of the inferior in a
+    /// buffer, like core files, override this to make \a data
+    /// reference that buffer directly. The byte order and address size
+    /// of \a data are left unchanged. The referenced bytes must not be
+    /// modified.
+    ///
+    /// @return
+    ///     True if all \a size bytes at \a vm_addr are available in a
+    ///     single buffer, false if the memory must be read with
+    ///     ReadMemory().
+    //------------------------------------------------------------------
+    virtual bool
+    GetMemoryData (lldb::addr_t vm_addr,
+                   size_t size,
+                   DataExtractor &data)
+    {
+        return false;
+    }
+
     //------------------------------------------------------------------
     /// Read a NULL terminated string from memory
     ///
@@ -2204,6 +2272,46 @@ public:
                             void *buf, 
                             size_t size,
                             Error &error);
+
+    //------------------------------------------------------------------
+    /// Get the hit, miss and transfer counters of the memory cache
+    /// used by ReadMemory().
+    //------------------------------------------------------------------
+    MemoryCache::Statistics
+    GetMemoryCacheStatistics ()
+    {
+        return m_memory_cache.GetStatistics();
+    }
+
+    //------------------------------------------------------------------
+    /// The UnwindPlans picked for the caller frames of this process'
+    /// threads, see FrameUnwindPlanCache.
+    //------------------------------------------------------------------
+    FrameUnwindPlanCache &
+    GetFrameUnwindPlanCache ()
+    {
+        return m_frame_unwind_plan_cache;
+    }
+
+    //------------------------------------------------------------------
+    /// Read several, possibly scattered, ranges of memory.
+    ///
+    /// Ranges found in the memory cache are copied from it and the
+    /// others are read with as few requests to the process as the
+    /// process plug-in allows, see DoReadMemoryRanges(). This saves a
+    /// round trip per range when debugging a remote process. The data
+    /// read is added to the memory cache so later calls to ReadMemory()
+    /// for the same ranges don't go to the process again.
+    ///
+    /// @param[in,out] reads
+    ///     The ranges to read. The "bytes_read" member of each range is
+    ///     set to the number of bytes read into its buffer.
+    ///
+    /// @return
+    ///     The number of ranges that were read completely.
+    //------------------------------------------------------------------
+    size_t
+    ReadMemoryRanges (MemoryRangeReads &reads);
     
     //------------------------------------------------------------------
     /// Reads an unsigned integer of the specified byte size from 
@@ -2730,6 +2838,14 @@ public:
     virtual Error
     DisableSoftwareBreakpoint (BreakpointSite *bp_site);
 
+    // Called when the conditions of the owners of an enabled breakpoint
+    // site changed. Process plug-ins that have the breakpoint conditions
+    // evaluated by the remote stub send the new conditions here.
+    virtual void
+    UpdateBreakpointSiteConditions (BreakpointSite *bp_site)
+    {
+    }
+
     BreakpointSiteList &
     GetBreakpointSiteList();
 
@@ -2742,6 +2858,8 @@ public:
     Error
     ClearBreakpointSiteByID (lldb::user_id_t break_id);
 
+    // In a breakpoint site batch a new site is only enabled when the batch
+    // is flushed, see BeginBreakpointSiteBatch().
     lldb::break_id_t
     CreateBreakpointSite (const lldb::BreakpointLocationSP &owner,
                           bool use_hardware);
@@ -2759,6 +2877,63 @@ public:
                                    lldb::user_id_t owner_loc_id,
                                    lldb::BreakpointSiteSP &bp_site_sp);
 
+    //------------------------------------------------------------------
+    /// Enable or disable many breakpoint sites at once.
+    ///
+    /// Process plug-ins that can set breakpoints in bulk override these,
+    /// the default implementations enable or disable the sites one at a
+    /// time.
+    ///
+    /// @param[in] bp_sites
+    ///     The breakpoint sites to enable or disable.
+    ///
+    /// @param[out] errors
+    ///     The error for each breakpoint site.
+    //------------------------------------------------------------------
+    virtual void
+    EnableBreakpointSites (const std::vector<BreakpointSite *> &bp_sites, std::vector<Error> &errors);
+
+    virtual void
+    DisableBreakpointSites (const std::vector<BreakpointSite *> &bp_sites, std::vector<Error> &errors);
+
+    //------------------------------------------------------------------
+    /// Defer enabling and disabling breakpoint sites.
+    ///
+    /// Between BeginBreakpointSiteBatch() and the matching
+    /// EndBreakpointSiteBatch() new breakpoint sites are added to the
+    /// breakpoint site list right away but only get enabled, and sites
+    /// without owners only get disabled and removed from the list, when
+    /// the outermost batch of the thread ends or the process resumes.
+    /// They are then handed to EnableBreakpointSites() and
+    /// DisableBreakpointSites() together. Batches are per thread, the
+    /// breakpoint site changes of other threads take effect right away.
+    ///
+    /// A site that fails to enable when the batch is flushed is taken back
+    /// from its owners, which are then unresolved again.
+    //------------------------------------------------------------------
+    void
+    BeginBreakpointSiteBatch ();
+
+    void
+    EndBreakpointSiteBatch ();
+
+    //------------------------------------------------------------------
+    /// @class BreakpointSiteBatch Process.h "lldb/Target/Process.h"
+    /// @brief Batches the breakpoint site changes of a scope.
+    //------------------------------------------------------------------
+    class BreakpointSiteBatch
+    {
+    public:
+        BreakpointSiteBatch (Target &target);
+
+        ~BreakpointSiteBatch ();
+
+    private:
+        lldb::ProcessSP m_process_sp;
+
+        DISALLOW_COPY_AND_ASSIGN (BreakpointSiteBatch);
+    };
+
     //----------------------------------------------------------------------
     // Process Watchpoints (optional)
     //----------------------------------------------------------------------
@@ -3335,6 +3510,21 @@ protected:
         {
         }
     };
+
+    // The breakpoint site changes deferred by the batches of one thread.
+    struct BreakpointSiteBatchState
+    {
+        uint32_t depth; // How many BeginBreakpointSiteBatch() calls of the thread weren't ended yet
+        std::map<lldb::addr_t, lldb::BreakpointSiteSP> enables; // Sites to enable when the batch is flushed
+        std::vector<lldb::BreakpointSiteSP> disables; // Sites without owners to disable and remove when the batch is flushed
+
+        BreakpointSiteBatchState () :
+            depth (0),
+            enables (),
+            disables ()
+        {
+        }
+    };
     
     //------------------------------------------------------------------
     // Member variables
@@ -3366,6 +3556,8 @@ protected:
     std::vector<lldb::addr_t>   m_image_tokens;
     lldb::ListenerSP            m_listener_sp;          ///< Shared pointer to the listener used for public events.  Can not be empty.
     BreakpointSiteList          m_breakpoint_site_list; ///< This is the list of breakpoint locations we intend to insert in the target.
+    Mutex                       m_breakpoint_site_batch_mutex;
+    std::map<lldb::tid_t, BreakpointSiteBatchState> m_breakpoint_site_batches; ///< The open breakpoint site batches by host thread
     lldb::DynamicLoaderUP       m_dyld_ap;
     lldb::JITLoaderListUP       m_jit_loaders_ap;
     lldb::DynamicCheckerFunctionsUP m_dynamic_checkers_ap; ///< The functions used by the expression parser to validate data that expressions use.
@@ -3383,6 +3575,7 @@ protected:
     std::vector<std::string>    m_profile_data;
     Predicate<uint32_t>         m_iohandler_sync;
     MemoryCache                 m_memory_cache;
+    FrameUnwindPlanCache        m_frame_unwind_plan_cache;
     AllocatedMemoryCache        m_allocated_memory_cache;
     bool                        m_should_detach;   /// Should we detach if the process object goes away with an explicit call to Kill or Detach?
     LanguageRuntimeCollection   m_language_runtimes;
@@ -3413,6 +3606,14 @@ protected:
     size_t
     RemoveBreakpointOpcodesFromBuffer (lldb::addr_t addr, size_t size, uint8_t *buf) const;
 
+    bool
+    DeferBreakpointSiteRemoval (const lldb::BreakpointSiteSP &bp_site_sp);
+
+    // Apply the changes deferred by the batches of the current thread, or
+    // of all the threads.
+    void
+    FlushBreakpointSiteBatch (bool all_threads);
+
     void
     SynchronouslyNotifyStateChanged (lldb::StateType state);
 
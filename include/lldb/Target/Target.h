@@ -220,6 +220,15 @@ public:
     void
     SetNonStopModeEnabled (bool b);
 
+    bool
+    GetUseIndexCache () const;
+
+    FileSpec
+    GetIndexCacheDirectory () const;
+
+    uint64_t
+    GetIndexCacheMaxByteSize () const;
+
     bool
     GetDisplayRuntimeSupportValues () const;
     
@@ -246,6 +255,7 @@ private:
     static void DetachOnErrorValueChangedCallback(void *target_property_ptr, OptionValue *);
     static void DisableASLRValueChangedCallback(void *target_property_ptr, OptionValue *);
     static void DisableSTDIOValueChangedCallback(void *target_property_ptr, OptionValue *);
+    static void ParallelThreadsValueChangedCallback(void *target_property_ptr, OptionValue *);
 
     //------------------------------------------------------------------
     // Member variables.
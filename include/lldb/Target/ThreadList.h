@@ -121,6 +121,21 @@ public:
     void
     DiscardThreadPlans();
 
+    //------------------------------------------------------------------
+    /// Compute the stack frames of all the threads ahead of time.
+    ///
+    /// When the "parallel-thread-unwind" process setting is enabled and
+    /// the process plug-in supports it, the threads are unwound
+    /// concurrently. This must not be called with the thread list mutex
+    /// held.
+    ///
+    /// @param[in] num_frames
+    ///     The number of frames to compute for each thread, UINT32_MAX
+    ///     computes all of them.
+    //------------------------------------------------------------------
+    void
+    ComputeStackFrames (uint32_t num_frames);
+
     uint32_t
     GetStopID () const;
 
@@ -26,19 +26,24 @@
 #pragma warning(disable:4062)
 #endif
 
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstdint>
+#include <functional>
 #include <future>
 #include <list>
-#include <queue>
 #include <thread>
 #include <vector>
 
-// Global TaskPool class for running tasks in parallel on a set of worker thread created the first
-// time the task pool is used. The TaskPool provide no gurantee about the order the task will be run
-// and about what tasks will run in parrallel. None of the task added to the task pool should block
-// on something (mutex, future, condition variable) what will be set only by the completion of an
-// other task on the task pool as they may run on the same thread sequentally.
+// Global TaskPool class for running tasks in parallel on a set of persistent worker threads created
+// the first time the task pool is used. Every worker owns a task queue: tasks added from a worker
+// go to the worker's own queue and idle workers steal tasks from the queues of the busy ones, so
+// there is no single lock shared by every producer and consumer. The TaskPool provide no gurantee
+// about the order the task will be run and about what tasks will run in parrallel. A task may wait
+// for tasks it has added itself (using RunTasks, ParallelFor or Wait) because the waiting thread
+// runs pending tasks while it waits, but none of the tasks should block on something (mutex,
+// condition variable) what will be set only by the completion of an other unrelated task.
 class TaskPool
 {
 public:
@@ -51,11 +56,37 @@ public:
     // Run all of the specified tasks on the task pool and wait until all of them are finished
     // before returning. This method is intended to be used for small number tasks where listing
     // them as function arguments is acceptable. For running large number of tasks you should use
-    // AddTask for each task and then call wait() on each returned future.
+    // ParallelFor or AddTask for each task and then call Wait() on each returned future.
     template<typename... T>
     static void
     RunTasks(T&&... tasks);
 
+    // Call fn(idx) for every idx in [begin, end) on the worker threads and on the calling thread and
+    // return when all of them are finished. Indexes are handed out in small chunks on demand so
+    // indexes with very different costs are still balanced between the threads. If cancel is not
+    // nullptr and becomes true then no new chunk is started and false is returned after the
+    // already running calls are finished.
+    static bool
+    ParallelFor(size_t begin,
+                size_t end,
+                const std::function<void(size_t)>& fn,
+                const std::atomic<bool>* cancel = nullptr);
+
+    // Wait for the specified future to become ready. The calling thread runs other pending tasks
+    // while waiting so it is safe to call from inside a task waiting for a nested task.
+    template<typename T>
+    static void
+    Wait(std::future<T>& future);
+
+    // Set the number of worker threads used by the task pool. Zero means one thread for each
+    // hardware thread. Threads are never destroyed, when the count is reduced the extra threads
+    // stop picking up new tasks.
+    static void
+    SetThreadCount(uint32_t thread_count);
+
+    static uint32_t
+    GetThreadCount();
+
 private:
     TaskPool() = delete;
 
@@ -64,6 +95,10 @@ private:
 
     static void
     AddTaskImpl(std::function<void()>&& task_fn);
+
+    // Run one pending task on the calling thread. Returns false if there was no task to run.
+    static bool
+    RunPendingTask();
 };
 
 // Wrapper class around the global TaskPool implementation to make it possible to create a set of
@@ -129,7 +164,7 @@ struct TaskPool::RunTaskImpl<Head, Tail...>
     {
         auto f = AddTask(std::forward<Head>(h));
         RunTaskImpl<Tail...>::Run(std::forward<Tail>(t)...);
-        f.wait();
+        Wait(f);
     }
 };
 
@@ -140,6 +175,22 @@ struct TaskPool::RunTaskImpl<>
     Run() {}
 };
 
+template<typename T>
+void
+TaskPool::Wait(std::future<T>& future)
+{
+    // If there is no pending task left then the task we are waiting for is already running on an
+    // other thread (which will help out in the same way if it waits for something) so we can block.
+    while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        if (!RunPendingTask())
+        {
+            future.wait();
+            break;
+        }
+    }
+}
+
 template <typename T>
 template<typename F, typename... Args>
 void
@@ -105,6 +105,7 @@ class   GoASTContext;
 class   TypeCategoryImpl;
 class   FormatManager;
 class   FormattersMatchCandidate;
+class   FrameUnwindPlanCache;
 class   FuncUnwinders;
 class   Function;
 class   FunctionInfo;
@@ -0,0 +1,73 @@
+"""Benchmark 'thread backtrace all' on a process with many threads."""
+
+from __future__ import print_function
+
+
+
+import os
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbbench import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class TestBacktraceAllBench(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        self.thread_count = 64
+        self.depth = 32
+        self.stop_count = 10
+
+    @benchmarks_test
+    @expectedFailureAll(oslist=["windows"])
+    def test_backtrace_all_bench(self):
+        """Benchmark 'thread backtrace all' over repeated stops of a process with many threads."""
+        self.build()
+        self.addTearDownHook(lambda: self.runCmd("settings clear target.process.parallel-thread-unwind"))
+        # The parallel run reuses the UnwindPlans the serial run cached in the
+        # modules, so its later stops are the ones to compare.
+        for parallel in [False, True]:
+            self.runCmd("settings set target.process.parallel-thread-unwind %s" % ("true" if parallel else "false"))
+            self.run_backtrace_all_bench(parallel)
+
+    def run_backtrace_all_bench(self, parallel):
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateByName("stop_here")
+        self.assertTrue(breakpoint.GetNumLocations() > 0, VALID_BREAKPOINT)
+
+        args = [str(self.thread_count), str(self.depth), str(self.stop_count)]
+        process = target.LaunchSimple(args, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        # The first stop picks the UnwindPlans for every frame, the later ones
+        # can reuse the ones picked before.
+        first_stop = Stopwatch()
+        later_stops = Stopwatch()
+        interp = self.dbg.GetCommandInterpreter()
+        for i in range(self.stop_count):
+            self.assertEqual(process.GetState(), lldb.eStateStopped)
+            self.assertTrue(process.GetNumThreads() > self.thread_count)
+
+            result = lldb.SBCommandReturnObject()
+            with (first_stop if i == 0 else later_stops):
+                interp.HandleCommand("thread backtrace all", result)
+            self.assertTrue(result.Succeeded())
+
+            # Every worker thread must unwind through all of its recursion.
+            for thread in process:
+                frame_names = [frame.GetFunctionName() for frame in thread]
+                if "thread_func(int)" in frame_names:
+                    self.assertTrue(frame_names.count("recurse(int)") > self.depth)
+
+            process.Continue()
+
+        mode = "parallel" if parallel else "serial"
+        print()
+        print("%s thread backtrace all with %d threads, first stop: %s" % (mode, self.thread_count, first_stop))
+        print("%s thread backtrace all with %d threads, later stops: %s" % (mode, self.thread_count, later_stops))
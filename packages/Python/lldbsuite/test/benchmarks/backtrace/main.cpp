@@ -0,0 +1,57 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+std::atomic<int> g_ready(0);
+std::atomic<bool> g_done(false);
+
+// Keep the compiler from turning the recursion into a loop.
+int __attribute__((noinline))
+recurse(int depth)
+{
+    if (depth == 0)
+    {
+        g_ready++;
+        while (!g_done)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        return 0;
+    }
+    return recurse(depth - 1) + 1;
+}
+
+void
+thread_func(int depth)
+{
+    recurse(depth);
+}
+
+void
+stop_here(int iteration)
+{
+    // break here
+}
+
+int
+main(int argc, char const *argv[])
+{
+    int thread_count = argc > 1 ? atoi(argv[1]) : 64;
+    int depth = argc > 2 ? atoi(argv[2]) : 32;
+    int stop_count = argc > 3 ? atoi(argv[3]) : 10;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < thread_count; ++i)
+        threads.push_back(std::thread(thread_func, depth));
+
+    while (g_ready < thread_count)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    for (int i = 0; i < stop_count; ++i)
+        stop_here(i);
+
+    g_done = true;
+    for (std::thread &thread : threads)
+        thread.join();
+    return 0;
+}
@@ -0,0 +1,57 @@
+"""Benchmark a conditional breakpoint hit on every iteration of a loop."""
+
+from __future__ import print_function
+
+
+
+import os
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbbench import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class TestConditionalBreakpointBench(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        self.iteration_count = 2000
+        self.line = line_number('main.cpp', '// Set a breakpoint here.')
+
+    @benchmarks_test
+    @skipUnlessPlatform(["linux"])
+    def test_conditional_breakpoint_bench(self):
+        """Benchmark running to a conditional breakpoint, with the condition evaluated by lldb and by lldb-server."""
+        self.build()
+        self.addTearDownHook(lambda: self.runCmd("settings clear plugin.process.gdb-remote.use-remote-breakpoint-conditions"))
+        for remote in [False, True]:
+            self.runCmd("settings set plugin.process.gdb-remote.use-remote-breakpoint-conditions %s" % ("true" if remote else "false"))
+            self.run_conditional_breakpoint_bench(remote)
+
+    def run_conditional_breakpoint_bench(self, remote):
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        # Only the last iteration satisfies the condition.
+        breakpoint = target.BreakpointCreateByLocation('main.cpp', self.line)
+        self.assertTrue(breakpoint.GetNumLocations() > 0, VALID_BREAKPOINT)
+        breakpoint.SetCondition("value == %d" % (self.iteration_count - 1))
+
+        stopwatch = Stopwatch()
+        with stopwatch:
+            process = target.LaunchSimple([str(self.iteration_count)], None, self.get_process_working_directory())
+            self.assertTrue(process, PROCESS_IS_VALID)
+            self.assertEqual(process.GetState(), lldb.eStateStopped)
+
+        thread = lldbutil.get_stopped_thread(process, lldb.eStopReasonBreakpoint)
+        self.assertIsNotNone(thread)
+        self.assertEqual(thread.GetFrameAtIndex(0).FindVariable("value").GetValueAsSigned(), self.iteration_count - 1)
+        self.assertEqual(breakpoint.GetHitCount(), 1)
+        process.Kill()
+
+        mode = "lldb-server" if remote else "lldb"
+        print()
+        print("conditional breakpoint over %d iterations, condition evaluated by %s: %s" % (self.iteration_count, mode, stopwatch))
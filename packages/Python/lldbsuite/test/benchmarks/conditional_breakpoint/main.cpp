@@ -0,0 +1,18 @@
+#include <cstdlib>
+
+int g_total = 0;
+
+void __attribute__((noinline))
+accumulate(int value)
+{
+    g_total += value; // Set a breakpoint here.
+}
+
+int
+main(int argc, char const *argv[])
+{
+    int count = argc > 1 ? atoi(argv[1]) : 1000;
+    for (int i = 0; i < count; ++i)
+        accumulate(i);
+    return g_total == 0;
+}
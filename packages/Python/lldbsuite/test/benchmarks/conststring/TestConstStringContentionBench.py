@@ -0,0 +1,61 @@
+"""Benchmark indexing many compile units in parallel, which hammers the ConstString pool from every indexing thread."""
+
+from __future__ import print_function
+
+
+
+import os, sys
+import lldb
+from lldbsuite.test.lldbbench import *
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class ConstStringContentionBench(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        self.num_cus = 256
+        self.thread_counts = [1, 2, 4, 0]
+        self.count = 5
+        # Every iteration must index the module again instead of reading
+        # the index an earlier iteration left in the on-disk cache.
+        self.runCmd("settings set target.index-cache false")
+        self.addTearDownHook(lambda: self.runCmd("settings clear target.index-cache"))
+        self.addTearDownHook(lambda: self.runCmd("settings clear target.parallel-threads"))
+
+    @benchmarks_test
+    @skipUnlessPlatform(["linux", "freebsd"])
+    def test_index_contention(self):
+        """Benchmark the DWARF index with a growing number of threads."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        print()
+        for salt, thread_count in enumerate(self.thread_counts):
+            # Each build has names that aren't in the pool yet. The first run
+            # adds them, later runs only look them up, time both.
+            self.build(dictionary={'NUM_CUS': str(self.num_cus), 'CFLAGS_EXTRAS': '-DCU_SALT=%d' % salt})
+            first, again = self.index_bench(exe, thread_count)
+            threads = str(thread_count) if thread_count else "all"
+            print("%d compile units, %s threads, new names: %s" % (self.num_cus, threads, first))
+            print("%d compile units, %s threads, known names: %s" % (self.num_cus, threads, again))
+
+    def index_bench(self, exe, thread_count):
+        self.runCmd("settings set target.parallel-threads %d" % thread_count)
+        first = Stopwatch()
+        again = Stopwatch()
+        for i in range(self.count):
+            stopwatch = first if i == 0 else again
+            with stopwatch:
+                target = self.dbg.CreateTarget(exe)
+                self.assertTrue(target, VALID_TARGET)
+                # Looking up a name that doesn't exist builds the whole index.
+                functions = target.FindFunctions("no_such_function")
+                self.assertEqual(functions.GetSize(), 0)
+
+            self.dbg.DeleteTarget(target)
+            # Drop the module from the shared module list so the next
+            # iteration indexes it again.
+            lldb.SBDebugger.MemoryPressureDetected()
+        return (first, again)
@@ -0,0 +1,30 @@
+// Compiled once per compile unit with a different CU_ID. Every compile unit
+// has its own function and variable names, which are new strings for the
+// ConstString pool, and the same type and member names, which all the
+// indexing threads look up at once. CU_SALT makes all the names of a
+// build new ones.
+
+#ifndef CU_SALT
+#define CU_SALT 0
+#endif
+
+#define CAT2(a, b) a##b
+#define CAT(a, b) CAT2(a, b)
+#define NAME(prefix, n) CAT(CAT(CAT(CAT(CAT(salt, CU_SALT), _cu), CU_ID), prefix), n)
+
+struct shared_type
+{
+    int value;
+    struct shared_type *next;
+};
+
+#define FUNC(n) \
+    int NAME(_global_, n); \
+    int NAME(_function_, n) (struct shared_type *p) { return p->value + NAME(_global_, n) + n; }
+#define FUNC10(n) FUNC(n##0) FUNC(n##1) FUNC(n##2) FUNC(n##3) FUNC(n##4) \
+                  FUNC(n##5) FUNC(n##6) FUNC(n##7) FUNC(n##8) FUNC(n##9)
+#define FUNC100(n) FUNC10(n##0) FUNC10(n##1) FUNC10(n##2) FUNC10(n##3) FUNC10(n##4) \
+                   FUNC10(n##5) FUNC10(n##6) FUNC10(n##7) FUNC10(n##8) FUNC10(n##9)
+
+FUNC100(1)
+FUNC100(2)
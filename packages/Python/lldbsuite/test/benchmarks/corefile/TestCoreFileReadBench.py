@@ -0,0 +1,94 @@
+"""Benchmark reading many small objects from the memory of an ELF core file."""
+
+from __future__ import print_function
+
+
+
+import os, struct, sys
+import lldb
+from lldbsuite.test.lldbbench import *
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class CoreFileReadBench(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    # Where the objects live in the address space of the synthetic core.
+    BASE_ADDRESS = 0x10000000
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        self.num_objects = 1000000
+
+    @benchmarks_test
+    @no_debug_info_test
+    def test_read_small_objects(self):
+        """Benchmark reading a million 8 byte objects from a core file with SBValue and SBProcess.ReadMemory."""
+        core = self.create_synthetic_core(self.num_objects)
+
+        target = self.dbg.CreateTarget("")
+        process = target.LoadCore(core)
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        uint64_type = target.GetBasicType(lldb.eBasicTypeUnsignedLongLong)
+        self.assertTrue(uint64_type.IsValid())
+
+        value_stopwatch = Stopwatch()
+        with value_stopwatch:
+            for i in range(self.num_objects):
+                address = lldb.SBAddress(self.BASE_ADDRESS + i * 8, target)
+                value = target.CreateValueFromAddress("object", address, uint64_type)
+                if value.GetValueAsUnsigned() != i:
+                    self.fail("unexpected value for object %d" % i)
+
+        read_stopwatch = Stopwatch()
+        error = lldb.SBError()
+        with read_stopwatch:
+            for i in range(self.num_objects):
+                process.ReadUnsignedFromMemory(self.BASE_ADDRESS + i * 8, 8, error)
+
+        print()
+        print("%d objects read with SBValue: %s" % (self.num_objects, value_stopwatch))
+        print("%d objects read with SBProcess.ReadUnsignedFromMemory: %s" % (self.num_objects, read_stopwatch))
+
+    def create_synthetic_core(self, num_objects):
+        """Write an x86_64 ELF core file with a single PT_LOAD segment holding num_objects 64 bit integers."""
+        path = os.path.join(os.getcwd(), "synthetic.core")
+        segment_offset = 0x1000
+        segment_size = num_objects * 8
+
+        ELF_HEADER_SIZE = 64
+        PROGRAM_HEADER_SIZE = 56
+        ET_CORE = 4
+        EM_X86_64 = 62
+        PT_LOAD = 1
+        PF_R = 4
+        PF_W = 2
+
+        elf_header = struct.pack("<4sBBBBB7sHHIQQQIHHHHHH",
+                                 b"\x7fELF", 2, 1, 1, 0, 0, b"\0" * 7, # ELFCLASS64, ELFDATA2LSB, EV_CURRENT, ELFOSABI_NONE
+                                 ET_CORE, EM_X86_64, 1,
+                                 0,                      # e_entry
+                                 ELF_HEADER_SIZE,        # e_phoff
+                                 0,                      # e_shoff
+                                 0,                      # e_flags
+                                 ELF_HEADER_SIZE, PROGRAM_HEADER_SIZE, 1,
+                                 0, 0, 0)
+        program_header = struct.pack("<IIQQQQQQ",
+                                     PT_LOAD, PF_R | PF_W,
+                                     segment_offset,
+                                     self.BASE_ADDRESS, 0,
+                                     segment_size, segment_size,
+                                     0x1000)
+
+        with open(path, "wb") as core:
+            core.write(elf_header)
+            core.write(program_header)
+            core.write(b"\0" * (segment_offset - ELF_HEADER_SIZE - PROGRAM_HEADER_SIZE))
+            for i in range(num_objects):
+                core.write(struct.pack("<Q", i))
+
+        self.addTearDownHook(lambda: os.remove(path))
+        return path
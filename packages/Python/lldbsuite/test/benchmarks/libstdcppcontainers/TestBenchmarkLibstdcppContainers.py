@@ -0,0 +1,83 @@
+"""
+Benchmark the native libstdc++ container formatters against the Python ones.
+"""
+
+from __future__ import print_function
+
+
+
+import os, time
+import lldb
+from lldbsuite.test.lldbbench import *
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class TestBenchmarkLibstdcppContainers(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    # The Python providers the native ones replaced.
+    python_providers = [('vector', '^std::vector<.+>(( )?&)?$', 'StdVectorSynthProvider'),
+                        ('list', '^std::(__cxx11::)?list<.+>(( )?&)?$', 'StdListSynthProvider'),
+                        ('map', '^std::map<.+> >(( )?&)?$', 'StdMapSynthProvider')]
+
+    @benchmarks_test
+    @skipIfWindows # libstdcpp not ported to Windows
+    @skipIfDarwin
+    def test_run_command(self):
+        """Benchmark expanding 100000 element libstdc++ containers"""
+        self.build()
+        self.data_formatter_commands()
+
+    def setUp(self):
+        # Call super's setUp().
+        BenchBase.setUp(self)
+
+    def time_expansion(self, name):
+        sw = Stopwatch()
+        sw.start()
+        self.expect('frame variable -A %s' % name, substrs=['size=100000', '[99999] = '])
+        sw.stop()
+        return sw
+
+    def data_formatter_commands(self):
+        """Benchmark expanding 100000 element libstdc++ containers"""
+        self.runCmd("file a.out", CURRENT_EXECUTABLE_SET)
+
+        bkpt = self.target().FindBreakpointByID(lldbutil.run_break_set_by_source_regexp (self, "break here"))
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # The stop reason of the thread should be breakpoint.
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped',
+                       'stop reason = breakpoint'])
+
+        # This is the function to remove the custom formats in order to have a
+        # clean slate for the next test case.
+        def cleanup():
+            self.runCmd('type format clear', check=False)
+            self.runCmd('type summary clear', check=False)
+            self.runCmd('type filter clear', check=False)
+            self.runCmd('type synth clear', check=False)
+            self.runCmd('type category delete gnu-python', check=False)
+            self.runCmd("settings set target.max-children-count 256", check=False)
+
+        # Execute the cleanup function during test case tear down.
+        self.addTearDownHook(cleanup)
+
+        self.runCmd("settings set target.max-children-count 100000")
+
+        native_times = {}
+        for (name, regex, provider) in self.python_providers:
+            native_times[name] = self.time_expansion(name)
+
+        # Put the Python providers in a category in front of the native ones.
+        for (name, regex, provider) in self.python_providers:
+            self.runCmd('type synthetic add -l lldb.formatters.cpp.gnu_libstdcpp.%s -x "%s" -w gnu-python' % (provider, regex))
+        self.runCmd('type category enable gnu-python')
+
+        for (name, regex, provider) in self.python_providers:
+            python_time = self.time_expansion(name)
+            print("std::%s native: %s python: %s" % (name, native_times[name], python_time))
@@ -0,0 +1,19 @@
+#include <list>
+#include <map>
+#include <vector>
+
+int main()
+{
+    std::vector<int> vector;
+    std::list<int> list;
+    std::map<int, int> map;
+    for (int i = 0;
+    i < 100000;
+    i++)
+    {
+        vector.push_back(i);
+        list.push_back(i);
+        map[i] = i;
+    }
+    return vector.size() + list.size() + map.size(); // break here
+}
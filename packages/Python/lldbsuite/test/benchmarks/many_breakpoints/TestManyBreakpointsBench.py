@@ -0,0 +1,50 @@
+"""Benchmark setting and removing a breakpoint with thousands of locations."""
+
+from __future__ import print_function
+
+
+
+import os
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbbench import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class TestManyBreakpointsBench(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        self.function_count = 5000
+        self.line = line_number('main.cpp', '// Set a breakpoint here.')
+
+    @benchmarks_test
+    @skipUnlessPlatform(["linux"])
+    def test_many_breakpoints_bench(self):
+        """Benchmark setting and removing a breakpoint on thousands of functions in a live process."""
+        self.build()
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        main_breakpoint = target.BreakpointCreateByLocation('main.cpp', self.line)
+        self.assertTrue(main_breakpoint.GetNumLocations() > 0, VALID_BREAKPOINT)
+        process = target.LaunchSimple(None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        self.assertEqual(process.GetState(), lldb.eStateStopped)
+
+        set_stopwatch = Stopwatch()
+        with set_stopwatch:
+            breakpoint = target.BreakpointCreateByRegex('^bench_func_')
+        self.assertEqual(breakpoint.GetNumLocations(), self.function_count)
+        self.assertEqual(breakpoint.GetNumResolvedLocations(), self.function_count)
+
+        remove_stopwatch = Stopwatch()
+        with remove_stopwatch:
+            self.assertTrue(target.BreakpointDelete(breakpoint.GetID()))
+        process.Kill()
+
+        print()
+        print("breakpoint on %d functions, set: %s, removed: %s" % (self.function_count, set_stopwatch, remove_stopwatch))
@@ -0,0 +1,17 @@
+// Lots of small functions for a regular expression breakpoint to match.
+#define FUNC(n) void __attribute__((noinline)) bench_func_##n() { asm volatile(""); }
+#define FUNC10(n) FUNC(n##0) FUNC(n##1) FUNC(n##2) FUNC(n##3) FUNC(n##4) FUNC(n##5) FUNC(n##6) FUNC(n##7) FUNC(n##8) FUNC(n##9)
+#define FUNC100(n) FUNC10(n##0) FUNC10(n##1) FUNC10(n##2) FUNC10(n##3) FUNC10(n##4) FUNC10(n##5) FUNC10(n##6) FUNC10(n##7) FUNC10(n##8) FUNC10(n##9)
+#define FUNC1000(n) FUNC100(n##0) FUNC100(n##1) FUNC100(n##2) FUNC100(n##3) FUNC100(n##4) FUNC100(n##5) FUNC100(n##6) FUNC100(n##7) FUNC100(n##8) FUNC100(n##9)
+
+FUNC1000(1)
+FUNC1000(2)
+FUNC1000(3)
+FUNC1000(4)
+FUNC1000(5)
+
+int
+main(int argc, char const *argv[])
+{
+    return 0; // Set a breakpoint here.
+}
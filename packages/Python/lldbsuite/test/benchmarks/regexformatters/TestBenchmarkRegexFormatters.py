@@ -0,0 +1,76 @@
+"""
+Benchmark looking up regex formatters for a realistic mix of type names.
+"""
+
+from __future__ import print_function
+
+
+
+import os, time
+import lldb
+from lldbsuite.test.lldbbench import *
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class TestBenchmarkRegexFormatters(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    # The number of user regex formatters, on top of the built in ones.
+    num_formatters = 500
+
+    @benchmarks_test
+    def test_run_command(self):
+        """Benchmark formatting a frame of many types with many regex formatters"""
+        self.build()
+        self.data_formatter_commands()
+
+    def setUp(self):
+        # Call super's setUp().
+        BenchBase.setUp(self)
+        self.count = 50
+
+    def data_formatter_commands(self):
+        """Benchmark formatting a frame of many types with many regex formatters"""
+        self.runCmd("file a.out", CURRENT_EXECUTABLE_SET)
+
+        bkpt = self.target().FindBreakpointByID(lldbutil.run_break_set_by_source_regexp (self, "break here"))
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # The stop reason of the thread should be breakpoint.
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped',
+                       'stop reason = breakpoint'])
+
+        # This is the function to remove the custom formats in order to have a
+        # clean slate for the next test case.
+        def cleanup():
+            self.runCmd('type summary clear', check=False)
+            self.runCmd('type category delete regex-bench', check=False)
+
+        # Execute the cleanup function during test case tear down.
+        self.addTearDownHook(cleanup)
+
+        # Most of them are anchored on a namespace like the formatters of
+        # libraries, a few aren't anchored at all.
+        for i in range(self.num_formatters):
+            if i % 50 == 0:
+                regex = 'Gadget%d<.+>$' % i
+            else:
+                regex = '^lib%d::Gadget<.+>(( )?&)?$' % i
+            self.runCmd('type summary add -x "%s" -s "gadget" -w regex-bench' % regex)
+        self.runCmd('type summary add -x "^ns::Widget<.+>$" -s "widget" -w regex-bench')
+        self.runCmd('type category enable regex-bench')
+
+        self.expect('frame variable frame', substrs = ['widget0 = widget'])
+
+        sw = Stopwatch()
+        for i in range(self.count):
+            # Adding a formatter empties the format cache, each lap searches
+            # the categories again for every type of the frame.
+            self.runCmd('type summary add -s "lap %d" Unused' % i)
+            with sw:
+                self.runCmd('frame variable frame')
+        print("frame variable with %d regex formatters: %s" % (self.num_formatters, sw))
@@ -0,0 +1,54 @@
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ns
+{
+    template <int N> struct Widget
+    {
+        int value = N;
+    };
+}
+
+// Standard containers, smart pointers and user templates, like the locals
+// of a typical C++ frame.
+struct Frame
+{
+    std::vector<int> vector_int;
+    std::vector<std::string> vector_string;
+    std::vector<bool> vector_bool;
+    std::list<int> list_int;
+    std::map<int, int> map_int;
+    std::map<std::string, std::vector<int> > map_string;
+    std::shared_ptr<int> shared_int;
+    std::unique_ptr<int> unique_int;
+    std::string string;
+    ns::Widget<0> widget0;
+    ns::Widget<1> widget1;
+    ns::Widget<2> widget2;
+    ns::Widget<3> widget3;
+    ns::Widget<4> widget4;
+    ns::Widget<5> widget5;
+    ns::Widget<6> widget6;
+    ns::Widget<7> widget7;
+    int integer = 0;
+    double floating = 0;
+    const char *c_string = "hello";
+};
+
+int main()
+{
+    Frame frame;
+    frame.vector_int.push_back(1);
+    frame.vector_string.push_back("one");
+    frame.vector_bool.push_back(true);
+    frame.list_int.push_back(1);
+    frame.map_int[1] = 1;
+    frame.map_string["one"].push_back(1);
+    frame.shared_int.reset(new int(1));
+    frame.unique_int.reset(new int(1));
+    frame.string = "one";
+    return frame.integer; // break here
+}
@@ -0,0 +1,59 @@
+"""Benchmark the time to launch a process and load its shared libraries with a growing number of them."""
+
+from __future__ import print_function
+
+
+
+import os, sys
+import lldb
+from lldbsuite.test.lldbbench import *
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class SharedLibraryLoadBench(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        self.lib_counts = [16, 64, 256]
+        self.count = 5
+        # Every iteration must index the modules again instead of reading
+        # the indexes an earlier iteration left in the on-disk cache.
+        self.runCmd("settings set target.index-cache false")
+        self.addTearDownHook(lambda: self.runCmd("settings clear target.index-cache"))
+
+    @benchmarks_test
+    @skipUnlessPlatform(["linux", "freebsd"])
+    def test_shared_library_load(self):
+        """Benchmark launching to main with parallel and serial module loading."""
+        print()
+        for num_libs in self.lib_counts:
+            self.build(dictionary={'NUM_LIBS': str(num_libs)})
+            parallel = self.run_to_main_bench(0)
+            serial = self.run_to_main_bench(1)
+            print("%d shared libraries, parallel module loading: %s" % (num_libs, parallel))
+            print("%d shared libraries, serial module loading: %s" % (num_libs, serial))
+
+    def run_to_main_bench(self, parallel_threads):
+        self.runCmd("settings set target.parallel-threads %d" % parallel_threads)
+        self.addTearDownHook(lambda: self.runCmd("settings clear target.parallel-threads"))
+
+        exe = os.path.join(os.getcwd(), "a.out")
+        stopwatch = Stopwatch()
+        for i in range(self.count):
+            with stopwatch:
+                target = self.dbg.CreateTarget(exe)
+                self.assertTrue(target, VALID_TARGET)
+                breakpoint = target.BreakpointCreateBySourceRegex("Set break point at this line.", lldb.SBFileSpec("main.c"))
+                process = target.LaunchSimple(None, None, self.get_process_working_directory())
+                self.assertTrue(process, PROCESS_IS_VALID)
+                self.assertEqual(process.GetState(), lldb.eStateStopped)
+
+            process.Kill()
+            self.dbg.DeleteTarget(target)
+            # Drop the modules from the shared module list so the next
+            # iteration loads them again.
+            lldb.SBDebugger.MemoryPressureDetected()
+        return stopwatch
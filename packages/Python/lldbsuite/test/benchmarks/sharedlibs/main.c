@@ -0,0 +1,5 @@
+int
+main (int argc, char const *argv[])
+{
+    return 0; // Set break point at this line.
+}
@@ -900,6 +900,10 @@ def run_suite():
     # Create a singleton SBDebugger in the lldb namespace.
     lldb.DBG = lldb.SBDebugger.Create()
 
+    # Don't let test runs read or write the on-disk index cache in the home
+    # directory.
+    lldb.DBG.HandleCommand("settings set target.index-cache false")
+
     if configuration.lldb_platform_name:
         print("Setting up remote platform '%s'" % (configuration.lldb_platform_name))
         lldb.remote_platform = lldb.SBPlatform(configuration.lldb_platform_name)
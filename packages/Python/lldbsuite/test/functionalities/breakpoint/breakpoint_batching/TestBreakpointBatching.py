@@ -0,0 +1,114 @@
+"""
+Test that breakpoint sites set and removed in a batch behave like the ones
+set one at a time.
+"""
+
+from __future__ import print_function
+
+
+
+import os
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class BreakpointBatchingTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    NUM_FUNCTIONS = 16
+
+    def launch_to_main(self):
+        self.build()
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateBySourceRegex("Set a breakpoint here", lldb.SBFileSpec("main.c"))
+        self.assertTrue(breakpoint and breakpoint.GetNumLocations() == 1, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        self.assertIsNotNone(lldbutil.get_one_thread_stopped_at_breakpoint(process, breakpoint))
+        target.BreakpointDelete(breakpoint.GetID())
+        return (target, process)
+
+    def read_function_bytes(self, target, process, addresses):
+        result = []
+        for address in addresses:
+            error = lldb.SBError()
+            data = process.ReadMemory(address, 4, error)
+            self.assertTrue(error.Success(), "reading 0x%x failed: %s" % (address, error.GetCString()))
+            result.append(data)
+        return result
+
+    def log_packets(self):
+        self.log_file = os.path.join(os.getcwd(), 'TestBreakpointBatching.log')
+        self.runCmd("log enable -f '%s' gdb-remote packets" % self.log_file)
+        def remove_log(self):
+            self.runCmd("log disable gdb-remote packets")
+            if os.path.exists(self.log_file):
+                os.remove(self.log_file)
+        self.addTearDownHook(remove_log)
+
+    def count_packets(self, prefix):
+        with open(self.log_file, 'r') as f:
+            return len([line for line in f if ("read packet: $" + prefix) in line or ("send packet: $" + prefix) in line])
+
+    @skipUnlessPlatform(['linux'])
+    def test_batched_breakpoint_sites(self):
+        """Test that a breakpoint with many locations is set and removed in one packet each."""
+        (target, process) = self.launch_to_main()
+        self.log_packets()
+
+        addresses = []
+        for i in range(target.GetNumModules()):
+            for symbol in target.GetModuleAtIndex(i).symbols:
+                if symbol.GetName().startswith("batch_func_"):
+                    addresses.append(symbol.GetStartAddress().GetLoadAddress(target))
+        self.assertEqual(len(addresses), self.NUM_FUNCTIONS)
+        original_bytes = self.read_function_bytes(target, process, addresses)
+
+        breakpoint = target.BreakpointCreateByRegex("^batch_func_")
+        self.assertEqual(breakpoint.GetNumLocations(), self.NUM_FUNCTIONS)
+        self.assertEqual(breakpoint.GetNumResolvedLocations(), self.NUM_FUNCTIONS)
+        for location in breakpoint:
+            self.assertTrue(location.IsResolved(), "location %d isn't resolved" % location.GetID())
+
+        # The sites were set together and memory reads don't show them.
+        self.assertEqual(self.count_packets("jMultiBreakpoint:Z0"), 1)
+        self.assertEqual(self.count_packets("Z0,"), 0)
+        self.assertEqual(self.read_function_bytes(target, process, addresses), original_bytes)
+
+        # The first function stops, the others are still to be hit.
+        process.Continue()
+        thread = lldbutil.get_one_thread_stopped_at_breakpoint(process, breakpoint)
+        self.assertIsNotNone(thread)
+        self.assertEqual(thread.GetFrameAtIndex(0).GetFunctionName(), "batch_func_10")
+        self.assertEqual(breakpoint.GetHitCount(), 1)
+
+        # Removing the breakpoint removes its sites together, the program
+        # then runs to the end.
+        self.assertTrue(target.BreakpointDelete(breakpoint.GetID()))
+        self.assertEqual(self.count_packets("jMultiBreakpoint:z0"), 1)
+        self.assertEqual(self.count_packets("z0,"), 0)
+        self.assertEqual(self.read_function_bytes(target, process, addresses), original_bytes)
+
+        process.Continue()
+        self.assertEqual(process.GetState(), lldb.eStateExited)
+        self.assertEqual(process.GetExitStatus(), 6)
+
+    @skipUnlessPlatform(['linux'])
+    def test_batched_breakpoint_site_failure(self):
+        """Test that a site that fails to be set in a batch leaves its location unresolved."""
+        (target, process) = self.launch_to_main()
+
+        breakpoint = target.BreakpointCreateByAddress(0)
+        self.assertEqual(breakpoint.GetNumLocations(), 1)
+        self.assertFalse(breakpoint.GetLocationAtIndex(0).IsResolved())
+        self.assertEqual(breakpoint.GetNumResolvedLocations(), 0)
+
+        process.Continue()
+        self.assertEqual(process.GetState(), lldb.eStateExited)
+        self.assertEqual(process.GetExitStatus(), 6)
@@ -0,0 +1,38 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// Enough functions for a regular expression breakpoint to set its sites in
+// a batch.
+#define FUNC(n) int __attribute__((noinline)) batch_func_##n(int value) { return value + n; }
+#define FUNC8(n) FUNC(n##0) FUNC(n##1) FUNC(n##2) FUNC(n##3) FUNC(n##4) FUNC(n##5) FUNC(n##6) FUNC(n##7)
+FUNC8(1)
+FUNC8(2)
+
+int
+main(int argc, char const *argv[])
+{
+    int value = 0; // Set a breakpoint here.
+    value = batch_func_10(value);
+    value = batch_func_11(value);
+    value = batch_func_12(value);
+    value = batch_func_13(value);
+    value = batch_func_14(value);
+    value = batch_func_15(value);
+    value = batch_func_16(value);
+    value = batch_func_17(value);
+    value = batch_func_20(value);
+    value = batch_func_21(value);
+    value = batch_func_22(value);
+    value = batch_func_23(value);
+    value = batch_func_24(value);
+    value = batch_func_25(value);
+    value = batch_func_26(value);
+    value = batch_func_27(value);
+    return value - 290;
+}
@@ -36,6 +36,20 @@ class BreakpointConditionsTestCase(TestBase):
         self.build()
         self.breakpoint_conditions_python()
 
+    @skipIfWindows # Requires EE to support COFF on Windows (http://llvm.org/pr22232)
+    @add_test_categories(['pyapi'])
+    def test_breakpoint_condition_with_ignore_count(self):
+        """Test that the hits skipped by the ignore count don't depend on the condition."""
+        self.build()
+        self.breakpoint_condition_with_ignore_count(on_location=False)
+
+    @skipIfWindows # Requires EE to support COFF on Windows (http://llvm.org/pr22232)
+    @add_test_categories(['pyapi'])
+    def test_breakpoint_location_condition_with_ignore_count(self):
+        """Test that the hits skipped by the location's ignore count don't depend on the condition."""
+        self.build()
+        self.breakpoint_condition_with_ignore_count(on_location=True)
+
     def setUp(self):
         # Call super's setUp().
         TestBase.setUp(self)
@@ -123,6 +137,49 @@ class BreakpointConditionsTestCase(TestBase):
         self.expect("process status", PROCESS_EXITED,
             patterns = ['Process .* exited'])
 
+    def breakpoint_condition_with_ignore_count(self, on_location):
+        """Use Python APIs to set a breakpoint condition and an ignore count."""
+        exe = os.path.join(os.getcwd(), "a.out")
+
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateByName('c', 'a.out')
+        self.assertTrue(breakpoint and
+                        breakpoint.GetNumLocations() == 1,
+                        VALID_BREAKPOINT)
+
+        # c() is called with 1, 2 and 3. Every hit counts against the ignore
+        # count, including the ones where the condition is false, so the
+        # first stop is at val == 2 and not at val == 3. This holds when the
+        # remote stub evaluates the condition, too.
+        location = breakpoint.GetLocationAtIndex(0)
+        if on_location:
+            location.SetCondition('val >= 2')
+            location.SetIgnoreCount(1)
+        else:
+            breakpoint.SetCondition('val >= 2')
+            breakpoint.SetIgnoreCount(1)
+
+        process = target.LaunchSimple (None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        from lldbsuite.test.lldbutil import get_stopped_thread
+        for expected_val in ['2', '3']:
+            thread = get_stopped_thread(process, lldb.eStopReasonBreakpoint)
+            self.assertTrue(thread.IsValid(), "There should be a thread stopped due to breakpoint condition")
+            frame0 = thread.GetFrameAtIndex(0)
+            var = frame0.FindValue('val', lldb.eValueTypeVariableArgument)
+            self.assertTrue(frame0.GetLineEntry().GetLine() == self.line1 and
+                            var.GetValue() == expected_val,
+                            "stopped with val = %s, expected %s" % (var.GetValue(), expected_val))
+            self.assertEqual(location.GetIgnoreCount(), 0)
+            self.assertEqual(breakpoint.GetIgnoreCount(), 0)
+            process.Continue()
+
+        # The ignore count is used up, so the stop at val == 3 was the last one.
+        self.assertEqual(process.GetState(), lldb.eStateExited, PROCESS_EXITED)
+
     def breakpoint_conditions_python(self):
         """Use Python APIs to set breakpoint conditions."""
         exe = os.path.join(os.getcwd(), "a.out")
@@ -0,0 +1,93 @@
+"""
+Test that file and line breakpoints find the compile units that include the
+file, whether it is their main file or a header with inlined code.
+"""
+
+from __future__ import print_function
+
+
+
+import os
+import lldb
+from lldbsuite.test.lldbtest import *
+import lldbsuite.test.lldbutil as lldbutil
+
+class FileLineBreakpointsTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        self.header_line = line_number('shared.h', '// Set a breakpoint in the header here.')
+        self.main_line = line_number('main.cpp', '// Set a breakpoint in main.cpp here.')
+        self.other_line = line_number('other.cpp', '// Set a breakpoint in other.cpp here.')
+
+    def test_file_line_breakpoints(self):
+        """Test file and line breakpoints in source files and in a header included by several of them."""
+        self.build()
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        # Make sure the breakpoints in headers are looked up in every compile unit.
+        self.runCmd('settings set target.inline-breakpoint-strategy always')
+        self.addTearDownHook(
+            lambda: self.runCmd("settings clear target.inline-breakpoint-strategy"))
+
+        main_breakpoint = target.BreakpointCreateByLocation('main.cpp', self.main_line)
+        self.assertEqual(main_breakpoint.GetNumLocations(), 1, VALID_BREAKPOINT)
+        other_breakpoint = target.BreakpointCreateByLocation('other.cpp', self.other_line)
+        self.assertEqual(other_breakpoint.GetNumLocations(), 1, VALID_BREAKPOINT)
+
+        # The inlined function in the header has a location in both compile units.
+        header_breakpoint = target.BreakpointCreateByLocation('shared.h', self.header_line)
+        self.assertEqual(header_breakpoint.GetNumLocations(), 2, VALID_BREAKPOINT)
+
+        # Files no compile unit includes don't match anything.
+        missing_breakpoint = target.BreakpointCreateByLocation('missing.cpp', self.main_line)
+        self.assertEqual(missing_breakpoint.GetNumLocations(), 0)
+
+        process = target.LaunchSimple(None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        # Run to completion, each location is hit once.
+        while process.GetState() == lldb.eStateStopped:
+            process.Continue()
+        self.assertEqual(process.GetState(), lldb.eStateExited)
+
+        self.assertEqual(main_breakpoint.GetHitCount(), 1)
+        self.assertEqual(other_breakpoint.GetHitCount(), 1)
+        self.assertEqual(header_breakpoint.GetHitCount(), 2)
+
+    def test_file_line_breakpoint_skips_unrelated_compile_units(self):
+        """Test that a file and line breakpoint doesn't parse the support files of compile units without the file."""
+        self.build()
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        # Look for inlined code in every compile unit, so all of them would
+        # be searched without knowing which ones use the file.
+        self.runCmd('settings set target.inline-breakpoint-strategy always')
+        self.addTearDownHook(
+            lambda: self.runCmd("settings clear target.inline-breakpoint-strategy"))
+
+        log_file = os.path.join(os.getcwd(), 'TestFileLineBreakpoints.log')
+        self.runCmd("log enable -f '%s' dwarf line" % log_file)
+        def remove_log(self):
+            self.runCmd("log disable dwarf line")
+            if os.path.exists(log_file):
+                os.remove(log_file)
+        self.addTearDownHook(remove_log)
+
+        other_breakpoint = target.BreakpointCreateByLocation('other.cpp', self.other_line)
+        self.assertEqual(other_breakpoint.GetNumLocations(), 1, VALID_BREAKPOINT)
+        self.runCmd("log disable dwarf line")
+
+        with open(log_file, 'r') as f:
+            parsed = [line for line in f if 'ParseCompileUnitSupportFiles' in line]
+        self.assertTrue(any('other.cpp' in line for line in parsed),
+                        "the support files of other.cpp weren't parsed: %s" % parsed)
+        self.assertFalse(any('main.cpp' in line for line in parsed),
+                         "the support files of main.cpp were parsed: %s" % parsed)
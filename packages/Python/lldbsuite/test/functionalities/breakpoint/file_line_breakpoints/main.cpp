@@ -0,0 +1,8 @@
+#include "shared.h"
+
+int
+main(int argc, char const *argv[])
+{
+    int value = twice(argc); // Set a breakpoint in main.cpp here.
+    return other(value) == 5 ? 0 : 1;
+}
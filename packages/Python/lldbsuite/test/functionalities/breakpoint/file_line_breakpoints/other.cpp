@@ -0,0 +1,7 @@
+#include "shared.h"
+
+int
+other(int value)
+{
+    return twice(value) + 1; // Set a breakpoint in other.cpp here.
+}
@@ -0,0 +1,7 @@
+inline int __attribute__((always_inline))
+twice(int value)
+{
+    return value * 2; // Set a breakpoint in the header here.
+}
+
+int other(int value);
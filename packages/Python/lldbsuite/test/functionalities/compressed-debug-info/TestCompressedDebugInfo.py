@@ -0,0 +1,76 @@
+"""
+Test that lldb reads the DWARF from compressed ELF debug sections.
+"""
+
+from __future__ import print_function
+
+
+
+import os
+import subprocess
+import tempfile
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class CompressedDebugInfoTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break inside main().
+        self.line = line_number('main.c', '// Set break point at this line.')
+
+    @skipUnlessPlatform(["linux", "freebsd"])
+    @skipIf(debug_info=no_match(["dwarf"]))
+    def test_SHF_COMPRESSED(self):
+        """Test reading debug info from SHF_COMPRESSED sections."""
+        self.skip_unless_gz_supported('-gz=zlib')
+        self.build(dictionary={'CFLAGS_EXTRAS': '-gz=zlib'})
+        self.check_debug_info()
+
+    @skipUnlessPlatform(["linux", "freebsd"])
+    @skipIf(debug_info=no_match(["dwarf"]))
+    def test_zdebug(self):
+        """Test reading debug info from legacy .zdebug_* sections."""
+        self.skip_unless_gz_supported('-gz=zlib-gnu')
+        self.build(dictionary={'CFLAGS_EXTRAS': '-gz=zlib-gnu'})
+        self.check_debug_info()
+
+    def skip_unless_gz_supported(self, gz_option):
+        # lldb can only decompress the sections when it was linked with zlib.
+        lldb_lib = os.path.join(os.path.dirname(lldb.__file__), "_lldb.so")
+        try:
+            linked_libs = subprocess.check_output(["ldd", lldb_lib])
+        except (OSError, subprocess.CalledProcessError):
+            self.skipTest("unable to tell whether lldb was built with zlib")
+        if b"libz.so" not in linked_libs:
+            self.skipTest("lldb was built without zlib")
+
+        # The compiler, assembler and linker all need to handle the option.
+        with tempfile.NamedTemporaryFile(suffix=".out") as exe:
+            compiler = subprocess.Popen([self.getCompiler(), gz_option, "-g", "-x", "c", "-", "-o", exe.name],
+                                        stdin=subprocess.PIPE, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+            compiler.communicate(b"int main(void) { return 0; }\n")
+            if compiler.returncode != 0:
+                self.skipTest("the compiler doesn't support %s" % gz_option)
+
+    def check_debug_info(self):
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.c", self.line, num_expected_locations=1, loc_exact=True)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped',
+                       'stop reason = breakpoint'])
+
+        self.expect("frame variable pt", VARIABLES_DISPLAYED_CORRECTLY,
+            substrs = ['(point) pt = ',
+                       'x = 1',
+                       'y = 2'])
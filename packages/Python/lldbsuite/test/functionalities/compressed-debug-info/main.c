@@ -0,0 +1,15 @@
+#include <stdio.h>
+
+struct point
+{
+    int x;
+    int y;
+};
+
+int
+main (int argc, char const *argv[])
+{
+    struct point pt = { 1, 2 };
+    printf ("%d %d\n", pt.x, pt.y); // Set break point at this line.
+    return 0;
+}
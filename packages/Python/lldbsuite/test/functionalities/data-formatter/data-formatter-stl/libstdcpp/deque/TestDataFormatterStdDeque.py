@@ -0,0 +1,74 @@
+"""
+Test lldb data formatter subsystem.
+"""
+
+from __future__ import print_function
+
+
+
+import os, time
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class StdDequeDataFormatterTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @skipIfWindows # libstdcpp not ported to Windows
+    @skipIfDarwin
+    def test_with_run_command(self):
+        """Test the libstdc++ std::deque synthetic children."""
+        self.build()
+        self.runCmd("file a.out", CURRENT_EXECUTABLE_SET)
+
+        lldbutil.run_break_set_by_source_regexp (self, "Set break point at this line.")
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # The stop reason of the thread should be breakpoint.
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped',
+                       'stop reason = breakpoint'])
+
+        # This is the function to remove the custom formats in order to have a
+        # clean slate for the next test case.
+        def cleanup():
+            self.runCmd('type format clear', check=False)
+            self.runCmd('type summary clear', check=False)
+            self.runCmd('type filter clear', check=False)
+            self.runCmd('type synth clear', check=False)
+            self.runCmd("settings set target.max-children-count 256", check=False)
+
+        # Execute the cleanup function during test case tear down.
+        self.addTearDownHook(cleanup)
+
+        self.expect("frame variable empty",
+            substrs = ['size=0'])
+
+        self.expect("frame variable small",
+            substrs = ['size=3',
+                       '[0] = 0',
+                       '[1] = 1',
+                       '[2] = 2'])
+
+        # The elements span several buffers and the first one starts in the
+        # middle of its buffer.
+        self.expect("frame variable large",
+            substrs = ['size=991',
+                       '[0] = -1',
+                       '[1] = 10',
+                       '[255] = 264',
+                       '...'])
+
+        self.runCmd("settings set target.max-children-count 1000")
+        self.expect("frame variable large",
+            substrs = ['[500] = 509',
+                       '[990] = 999'])
+        self.expect("frame variable large[127]",
+            substrs = ['= 136'])
+
+        # A deque whose map and iterators don't agree has no children.
+        self.expect("frame variable garbage",
+            substrs = ['size=0'])
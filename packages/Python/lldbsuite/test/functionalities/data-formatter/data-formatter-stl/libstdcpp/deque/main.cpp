@@ -0,0 +1,30 @@
+#include <string.h>
+#include <deque>
+
+typedef std::deque<int> intdeque;
+
+int main()
+{
+    // Storage that looks like a deque whose map and iterators are garbage.
+    alignas(intdeque) unsigned char storage[sizeof(intdeque)];
+    memset(storage, 0xff, sizeof(storage));
+    intdeque &garbage = *reinterpret_cast<intdeque *>(storage);
+
+    intdeque empty;
+
+    intdeque small;
+    small.push_back(1);
+    small.push_back(2);
+    small.push_front(0);
+
+    // Large enough to span several buffers, with elements removed from the
+    // front so the first buffer starts in the middle.
+    intdeque large;
+    for (int i = 0; i < 1000; ++i)
+        large.push_back(i);
+    for (int i = 0; i < 10; ++i)
+        large.pop_front();
+    large.push_front(-1);
+
+    return garbage.empty(); // Set break point at this line.
+}
@@ -0,0 +1,82 @@
+"""
+Test lldb data formatter subsystem.
+"""
+
+from __future__ import print_function
+
+
+
+import os, time
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class StdSetDataFormatterTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @skipIfWindows # libstdcpp not ported to Windows
+    @skipIfDarwin
+    def test_with_run_command(self):
+        """Test the libstdc++ std::set and std::multiset synthetic children."""
+        self.build()
+        self.runCmd("file a.out", CURRENT_EXECUTABLE_SET)
+
+        lldbutil.run_break_set_by_source_regexp (self, "Set break point at this line.")
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # The stop reason of the thread should be breakpoint.
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped',
+                       'stop reason = breakpoint'])
+
+        # This is the function to remove the custom formats in order to have a
+        # clean slate for the next test case.
+        def cleanup():
+            self.runCmd('type format clear', check=False)
+            self.runCmd('type summary clear', check=False)
+            self.runCmd('type filter clear', check=False)
+            self.runCmd('type synth clear', check=False)
+            self.runCmd("settings set target.max-children-count 256", check=False)
+
+        # Execute the cleanup function during test case tear down.
+        self.addTearDownHook(cleanup)
+
+        self.expect("frame variable iset",
+            substrs = ['size=3 {',
+                       '[0] = 1',
+                       '[1] = 2',
+                       '[2] = 3'])
+
+        self.expect("frame variable imset",
+            substrs = ['size=4 {',
+                       '[0] = 1',
+                       '[1] = 1',
+                       '[2] = 2',
+                       '[3] = 3'])
+
+        self.expect("frame variable sset",
+            substrs = ['size=3 {',
+                       '[0] = "hello"',
+                       '[1] = "this"',
+                       '[2] = "world"'])
+
+        self.expect("frame variable imset[3]",
+            substrs = ['(int) imset[3] = 3'])
+
+        # A node count past the capping size is only believed when the tree
+        # has that many nodes.
+        frame = self.dbg.GetSelectedTarget().GetProcess().GetSelectedThread().GetSelectedFrame()
+        corrupt = frame.FindVariable('corrupt').GetNonSyntheticValue()
+        node_count = corrupt.GetChildMemberWithName('_M_t').GetChildMemberWithName('_M_impl').GetChildMemberWithName('_M_node_count')
+        self.assertTrue(node_count.IsValid(), "_M_node_count not found")
+        error = lldb.SBError()
+        self.assertTrue(node_count.SetValueFromCString('1000000', error), error.GetCString())
+
+        self.expect("frame variable corrupt",
+            substrs = ['size=3 {',
+                       '[0] = 1',
+                       '[1] = 2',
+                       '[2] = 3'])
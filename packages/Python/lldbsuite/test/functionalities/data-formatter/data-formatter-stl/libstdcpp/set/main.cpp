@@ -0,0 +1,34 @@
+#include <set>
+#include <string>
+
+typedef std::set<int> intset;
+typedef std::multiset<int> intmset;
+typedef std::set<std::string> stringset;
+
+int main()
+{
+    intset iset;
+    intmset imset;
+    stringset sset;
+    intset corrupt; // Its node count is overwritten by the test.
+
+    iset.insert(3);
+    iset.insert(1);
+    iset.insert(2);
+    iset.insert(1);
+
+    imset.insert(3);
+    imset.insert(1);
+    imset.insert(1);
+    imset.insert(2);
+
+    sset.insert("hello");
+    sset.insert("world");
+    sset.insert("this");
+
+    corrupt.insert(1);
+    corrupt.insert(2);
+    corrupt.insert(3);
+
+    return 0; // Set break point at this line.
+}
@@ -0,0 +1,62 @@
+"""
+Test lldb data formatter subsystem.
+"""
+
+from __future__ import print_function
+
+
+
+import os, time
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class StdSmartPtrDataFormatterTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @skipIfWindows # libstdcpp not ported to Windows
+    @skipIfDarwin
+    def test_with_run_command(self):
+        """Test the libstdc++ std::shared_ptr and std::weak_ptr formatters."""
+        self.build()
+        self.runCmd("file a.out", CURRENT_EXECUTABLE_SET)
+
+        lldbutil.run_break_set_by_source_regexp (self, "Set break point at this line.")
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # The stop reason of the thread should be breakpoint.
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped',
+                       'stop reason = breakpoint'])
+
+        # This is the function to remove the custom formats in order to have a
+        # clean slate for the next test case.
+        def cleanup():
+            self.runCmd('type format clear', check=False)
+            self.runCmd('type summary clear', check=False)
+            self.runCmd('type filter clear', check=False)
+            self.runCmd('type synth clear', check=False)
+            self.runCmd("settings set target.max-children-count 256", check=False)
+
+        # Execute the cleanup function during test case tear down.
+        self.addTearDownHook(cleanup)
+
+        self.expect("frame variable nsp", substrs = ['nsp = nullptr'])
+        self.expect("frame variable isp", substrs = ['isp = 123 strong=2 weak=2'])
+        self.expect("frame variable ssp", substrs = ['ssp = "foobar" strong=1 weak=2'])
+        self.expect("frame variable nwp", substrs = ['nwp = nullptr'])
+        self.expect("frame variable iwp", substrs = ['iwp = 123 strong=2 weak=2'])
+        self.expect("frame variable swp", substrs = ['swp = "foobar" strong=1 weak=2'])
+
+        self.expect("frame variable *isp", substrs = ['(int) *isp = 123'])
+        self.expect("frame variable isp._M_ptr", substrs = ['_M_ptr = 0x'])
+
+        self.runCmd("continue")
+
+        self.expect("frame variable isp", substrs = ['isp = 123 strong=1 weak=2'])
+        self.expect("frame variable iwp", substrs = ['iwp = 123 strong=1 weak=2'])
+        self.expect("frame variable ssp", substrs = ['ssp = nullptr'])
+        self.expect("frame variable swp", substrs = ['strong=0 weak=1'])
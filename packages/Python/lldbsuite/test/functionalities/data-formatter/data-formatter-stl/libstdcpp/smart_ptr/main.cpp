@@ -0,0 +1,19 @@
+#include <memory>
+#include <string>
+
+int main()
+{
+    std::shared_ptr<int> nsp;
+    std::shared_ptr<int> isp(new int(123));
+    std::shared_ptr<int> isp2 = isp;
+    std::shared_ptr<std::string> ssp = std::make_shared<std::string>("foobar");
+
+    std::weak_ptr<int> nwp;
+    std::weak_ptr<int> iwp = isp;
+    std::weak_ptr<std::string> swp = ssp;
+
+    isp2.reset(); // Set break point at this line.
+    ssp.reset();
+
+    return 0; // Set break point at this line.
+}
@@ -0,0 +1,65 @@
+"""
+Test lldb data formatter subsystem.
+"""
+
+from __future__ import print_function
+
+
+
+import os, time
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class StdUnorderedDataFormatterTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @skipIfWindows # libstdcpp not ported to Windows
+    @skipIfDarwin
+    def test_with_run_command(self):
+        """Test the libstdc++ unordered containers synthetic children."""
+        self.build()
+        self.runCmd("file a.out", CURRENT_EXECUTABLE_SET)
+
+        lldbutil.run_break_set_by_source_regexp (self, "Set break point at this line.")
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # The stop reason of the thread should be breakpoint.
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped',
+                       'stop reason = breakpoint'])
+
+        # This is the function to remove the custom formats in order to have a
+        # clean slate for the next test case.
+        def cleanup():
+            self.runCmd('type format clear', check=False)
+            self.runCmd('type summary clear', check=False)
+            self.runCmd('type filter clear', check=False)
+            self.runCmd('type synth clear', check=False)
+            self.runCmd("settings set target.max-children-count 256", check=False)
+
+        # Execute the cleanup function during test case tear down.
+        self.addTearDownHook(cleanup)
+
+        self.expect("frame variable map",
+            substrs = ['size=3 {', 'first = 1', 'second = "hello"',
+                       'first = 2', 'second = "world"', 'first = 3', 'second = "this"'])
+
+        self.expect("frame variable mmap",
+            patterns = ['size=3 {', '(second = "hello"(\\n|.)+){2}', 'second = "world"'])
+
+        self.expect("frame variable iset",
+            patterns = ['size=4 {', '\[\d\] = 1', '\[\d\] = 2', '\[\d\] = 3', '\[\d\] = 4'])
+
+        self.expect("frame variable smset",
+            patterns = ['size=3 {', '\[\d\] = "hello"', '(\[\d\] = "world"(\\n|.)+){2}'])
+
+        self.expect("frame variable iset[3]",
+            patterns = ['\(int\) iset\[3\] = \d'])
+
+        # An element count that the chain doesn't back up isn't trusted.
+        self.expect("frame variable garbage",
+            substrs = ['size=0'])
@@ -0,0 +1,40 @@
+#include <string.h>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+typedef std::unordered_map<int, std::string> intstrmap;
+typedef std::unordered_multimap<int, std::string> intstrmmap;
+typedef std::unordered_set<int> intset;
+typedef std::unordered_multiset<std::string> strmset;
+
+int main()
+{
+    // Storage that looks like a table whose element count is garbage.
+    alignas(intset) unsigned char storage[sizeof(intset)];
+    memset(storage, 0xff, sizeof(storage));
+    intset &garbage = *reinterpret_cast<intset *>(storage);
+
+    intstrmap map;
+    map.emplace(1, "hello");
+    map.emplace(2, "world");
+    map.emplace(3, "this");
+
+    intstrmmap mmap;
+    mmap.emplace(1, "hello");
+    mmap.emplace(2, "hello");
+    mmap.emplace(2, "world");
+
+    intset iset;
+    iset.emplace(1);
+    iset.emplace(2);
+    iset.emplace(3);
+    iset.emplace(4);
+
+    strmset smset;
+    smset.emplace("hello");
+    smset.emplace("world");
+    smset.emplace("world");
+
+    return garbage.bucket_count() == 0; // Set break point at this line.
+}
@@ -0,0 +1,68 @@
+"""
+Test that looking up addresses in a lazily decoded line table finds the same
+line entries as the fully decoded line table.
+"""
+
+from __future__ import print_function
+
+
+
+import os
+import lldb
+from lldbsuite.test.lldbtest import *
+import lldbsuite.test.lldbutil as lldbutil
+
+class LazyLineTablesTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def test_lazy_line_tables(self):
+        """Test address lookups in lazily decoded line tables against the fully decoded line tables."""
+        self.build()
+        exe = os.path.join(os.getcwd(), "a.out")
+
+        self.runCmd('settings set plugin.symbol-file.dwarf.lazy-line-tables true')
+        self.addTearDownHook(
+            lambda: self.runCmd("settings clear plugin.symbol-file.dwarf.lazy-line-tables"))
+
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+        module = target.GetModuleAtIndex(0)
+        self.assertTrue(module.IsValid())
+
+        # Look up every address of the functions before anything needs the
+        # whole line table.
+        lookups = {}
+        compile_unit = None
+        for name in ['main', 'sum_of_squares', 'square']:
+            symbol_contexts = module.FindFunctions(name, lldb.eFunctionNameTypeFull)
+            self.assertEqual(symbol_contexts.GetSize(), 1)
+            compile_unit = symbol_contexts.GetContextAtIndex(0).GetCompileUnit()
+            function = symbol_contexts.GetContextAtIndex(0).GetFunction()
+            start = function.GetStartAddress().GetFileAddress()
+            end = function.GetEndAddress().GetFileAddress()
+            self.assertTrue(start < end)
+            for file_addr in range(start, end):
+                address = module.ResolveFileAddress(file_addr)
+                line_entry = module.ResolveSymbolContextForAddress(address, lldb.eSymbolContextLineEntry).GetLineEntry()
+                self.assertTrue(line_entry.IsValid(), "no line entry for 0x%x" % file_addr)
+                lookups[file_addr] = line_entry
+
+        # Now decode the whole line table and compare.
+        self.assertTrue(compile_unit.IsValid())
+        num_checked = 0
+        for idx in range(compile_unit.GetNumLineEntries()):
+            expected = compile_unit.GetLineEntryAtIndex(idx)
+            start = expected.GetStartAddress().GetFileAddress()
+            end = expected.GetEndAddress().GetFileAddress()
+            for file_addr in range(start, end):
+                if file_addr not in lookups:
+                    continue
+                line_entry = lookups[file_addr]
+                self.assertEqual(line_entry.GetLine(), expected.GetLine())
+                self.assertEqual(line_entry.GetColumn(), expected.GetColumn())
+                self.assertEqual(line_entry.GetFileSpec().GetFilename(), expected.GetFileSpec().GetFilename())
+                self.assertEqual(line_entry.GetStartAddress().GetFileAddress(), start)
+                self.assertEqual(line_entry.GetEndAddress().GetFileAddress(), end)
+                num_checked += 1
+        self.assertEqual(num_checked, len(lookups))
@@ -0,0 +1,31 @@
+#include <stdio.h>
+
+int
+unused_function (int value)
+{
+    return value * 3;
+}
+
+int
+square (int value)
+{
+    int result = value * value;
+    return result;
+}
+
+int
+sum_of_squares (int count)
+{
+    int sum = 0;
+    for (int i = 0; i < count; ++i)
+        sum += square (i);
+    return sum;
+}
+
+int
+main (int argc, char const *argv[])
+{
+    int sum = sum_of_squares (argc + 4);
+    printf ("sum = %d\n", sum);
+    return 0;
+}
@@ -0,0 +1,119 @@
+"""
+Test reading values from the memory of an ELF core file, which lldb
+references without copying it.
+"""
+
+from __future__ import print_function
+
+
+
+import os, struct
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class ElfCoreValuesTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    # Where the segment lives in the address space of the synthetic core.
+    BASE_ADDRESS = 0x10000000
+    NUM_OBJECTS = 64
+
+    @no_debug_info_test
+    def test_values_at_offsets(self):
+        """Test reading values at nonzero offsets into a core file segment leaves the core file intact."""
+        core = self.create_synthetic_core()
+        with open(core, "rb") as f:
+            core_contents = f.read()
+
+        target = self.dbg.CreateTarget("")
+        process = target.LoadCore(core)
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        uint32_type = target.GetBasicType(lldb.eBasicTypeUnsignedInt)
+        uint64_type = target.GetBasicType(lldb.eBasicTypeUnsignedLongLong)
+        self.assertTrue(uint32_type.IsValid())
+        self.assertTrue(uint64_type.IsValid())
+
+        # Read each object twice, the second read updates values that may
+        # reference the core file memory.
+        for i in range(2):
+            for index in [1, 5, 33, self.NUM_OBJECTS - 1]:
+                value = self.value_at(target, "object", self.address_of(index), uint64_type)
+                self.assertEqual(value.GetValueAsUnsigned(), index)
+
+                # The upper half of each object is zero.
+                value = self.value_at(target, "upper", self.address_of(index) + 4, uint32_type)
+                self.assertEqual(value.GetValueAsUnsigned(), 0)
+
+                # Casting the value reads it again into a value of its own.
+                value = self.value_at(target, "object", self.address_of(index), uint64_type)
+                self.assertEqual(value.Cast(uint32_type).GetValueAsUnsigned(), index)
+
+        # Children of an array are read at nonzero offsets of its data.
+        array = self.value_at(target, "array", self.address_of(16), uint64_type.GetArrayType(8))
+        self.assertTrue(array.IsValid())
+        self.assertEqual(array.GetNumChildren(), 8)
+        for i in range(8):
+            self.assertEqual(array.GetChildAtIndex(i).GetValueAsUnsigned(), 16 + i)
+        data = array.GetData()
+        error = lldb.SBError()
+        self.assertEqual(data.GetUnsignedInt64(error, 8 * 3), 19)
+        self.assertTrue(error.Success())
+
+        # The process memory and the file on disk are unchanged.
+        memory = process.ReadMemory(self.BASE_ADDRESS, self.NUM_OBJECTS * 8, error)
+        self.assertTrue(error.Success())
+        self.assertEqual(memory, b"".join(struct.pack("<Q", i) for i in range(self.NUM_OBJECTS)))
+        with open(core, "rb") as f:
+            self.assertEqual(f.read(), core_contents)
+
+    def address_of(self, index):
+        return self.BASE_ADDRESS + index * 8
+
+    def value_at(self, target, name, address, type):
+        value = target.CreateValueFromAddress(name, lldb.SBAddress(address, target), type)
+        self.assertTrue(value.IsValid())
+        return value
+
+    def create_synthetic_core(self):
+        """Write an x86_64 ELF core file with one PT_LOAD segment holding NUM_OBJECTS 64 bit integers."""
+        path = os.path.join(os.getcwd(), "values.core")
+        segment_offset = 0x1000
+        segment_size = self.NUM_OBJECTS * 8
+
+        ELF_HEADER_SIZE = 64
+        PROGRAM_HEADER_SIZE = 56
+        ET_CORE = 4
+        EM_X86_64 = 62
+        PT_LOAD = 1
+        PF_R = 4
+        PF_W = 2
+
+        elf_header = struct.pack("<4sBBBBB7sHHIQQQIHHHHHH",
+                                 b"\x7fELF", 2, 1, 1, 0, 0, b"\0" * 7, # ELFCLASS64, ELFDATA2LSB, EV_CURRENT, ELFOSABI_NONE
+                                 ET_CORE, EM_X86_64, 1,
+                                 0,                      # e_entry
+                                 ELF_HEADER_SIZE,        # e_phoff
+                                 0,                      # e_shoff
+                                 0,                      # e_flags
+                                 ELF_HEADER_SIZE, PROGRAM_HEADER_SIZE, 1,
+                                 0, 0, 0)
+        program_header = struct.pack("<IIQQQQQQ",
+                                     PT_LOAD, PF_R | PF_W,
+                                     segment_offset,
+                                     self.BASE_ADDRESS, 0,
+                                     segment_size, segment_size,
+                                     0x1000)
+
+        with open(path, "wb") as core:
+            core.write(elf_header)
+            core.write(program_header)
+            core.write(b"\0" * (segment_offset - ELF_HEADER_SIZE - PROGRAM_HEADER_SIZE))
+            for i in range(self.NUM_OBJECTS):
+                core.write(struct.pack("<Q", i))
+
+        self.addTearDownHook(lambda: os.remove(path))
+        return path
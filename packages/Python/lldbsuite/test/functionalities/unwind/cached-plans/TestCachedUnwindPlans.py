@@ -0,0 +1,64 @@
+"""
+Test that backtraces stay correct when the unwind plans picked for caller
+frames are reused across threads, stops and processes.
+"""
+
+from __future__ import print_function
+
+
+
+import os
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class CachedUnwindPlansTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    NUM_THREADS = 8
+    NUM_STOPS = 3
+
+    @skipIfWindows # clang-cl does not support gcc style attributes.
+    def test(self):
+        """Test backtraces of many threads sharing call sites across stops and a relaunch."""
+        self.build()
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateBySourceRegex("Set break point at this line.", lldb.SBFileSpec("main.c"))
+        self.assertTrue(breakpoint.GetNumLocations() > 0, VALID_BREAKPOINT)
+
+        # The second process uses the same modules but must not depend on
+        # what was cached for the first one.
+        for run in range(2):
+            process = target.LaunchSimple(None, None, self.get_process_working_directory())
+            self.assertTrue(process, PROCESS_IS_VALID)
+
+            for stop in range(self.NUM_STOPS):
+                self.assertEqual(process.GetState(), lldb.eStateStopped)
+                self.check_worker_backtraces(process)
+                if stop + 1 < self.NUM_STOPS:
+                    process.Continue()
+
+            process.Kill()
+
+    def check_worker_backtraces(self, process):
+        num_workers = 0
+        for thread in process:
+            names = [frame.GetFunctionName() for frame in thread]
+            if "wait_here" not in names:
+                continue
+            num_workers += 1
+
+            # Skip the frames of the C library sleeping.
+            names = names[names.index("wait_here"):]
+            if "chain_one" in names:
+                expected = ["wait_here"] + ["common"] * 3 + ["chain_one", "thread_func"]
+            else:
+                expected = ["wait_here"] + ["common"] * 5 + ["chain_two", "thread_func"]
+            self.assertEqual(names[:len(expected)], expected,
+                             "unexpected backtrace for thread %d: %s" % (thread.GetIndexID(), names))
+        self.assertEqual(num_workers, self.NUM_THREADS)
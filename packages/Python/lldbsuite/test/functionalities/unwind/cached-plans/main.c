@@ -0,0 +1,76 @@
+#include <pthread.h>
+#include <unistd.h>
+
+#define NUM_THREADS 8
+
+volatile int g_ready = 0;
+volatile int g_done = 0;
+volatile int g_iteration = 0;
+pthread_mutex_t g_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+void __attribute__((noinline))
+wait_here (void)
+{
+    pthread_mutex_lock (&g_mutex);
+    g_ready++;
+    pthread_mutex_unlock (&g_mutex);
+    while (!g_done)
+        usleep (10000);
+}
+
+int __attribute__((noinline))
+common (int depth)
+{
+    if (depth > 0)
+        return common (depth - 1) + 1;
+    wait_here ();
+    return 0;
+}
+
+int __attribute__((noinline))
+chain_one (void)
+{
+    return common (2) + 1;
+}
+
+int __attribute__((noinline))
+chain_two (void)
+{
+    return common (4) + 2;
+}
+
+void *
+thread_func (void *arg)
+{
+    if ((long)arg % 2)
+        chain_two ();
+    else
+        chain_one ();
+    return NULL;
+}
+
+void __attribute__((noinline))
+stop_here (int iteration)
+{
+    g_iteration = iteration; // Set break point at this line.
+}
+
+int
+main (int argc, char const *argv[])
+{
+    pthread_t threads[NUM_THREADS];
+    long i;
+    for (i = 0; i < NUM_THREADS; ++i)
+        pthread_create (&threads[i], NULL, thread_func, (void *)i);
+
+    while (g_ready < NUM_THREADS)
+        usleep (10000);
+
+    for (i = 0; i < 3; ++i)
+        stop_here (i);
+
+    g_done = 1;
+    for (i = 0; i < NUM_THREADS; ++i)
+        pthread_join (threads[i], NULL);
+    return 0;
+}
@@ -0,0 +1,94 @@
+"""
+Test watching more variables than there are hardware debug registers.
+"""
+
+from __future__ import print_function
+
+
+
+import os
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class SoftwareWatchpointsTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    NUM_VALUES = 8
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Our simple source filename.
+        self.source = 'main.c'
+        # Find the line number to break inside main().
+        self.line = line_number(self.source, '// Set break point at this line.')
+
+    def launch_and_watch_values(self):
+        """Stop in main and watch every element of g_values for writes."""
+        self.build()
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateByLocation(self.source, self.line)
+        self.assertTrue(breakpoint and breakpoint.GetNumLocations() == 1, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        thread = lldbutil.get_stopped_thread(process, lldb.eStopReasonBreakpoint)
+        self.assertIsNotNone(thread)
+
+        values = target.FindFirstGlobalVariable("g_values")
+        self.assertTrue(values.IsValid())
+        watchpoints = []
+        for i in range(self.NUM_VALUES):
+            error = lldb.SBError()
+            watchpoint = values.GetChildAtIndex(i).Watch(True, False, True, error)
+            self.assertTrue(error.Success() and watchpoint.IsValid(),
+                            "watchpoint %d failed: %s" % (i, error.GetCString()))
+            watchpoints.append(watchpoint)
+        return (process, values, watchpoints)
+
+    @skipUnlessPlatform(['linux'])
+    @skipIf(archs=no_match(['x86_64', 'i386']))
+    def test_more_watchpoints_than_debug_registers(self):
+        """Test that the watchpoints beyond the debug registers fall back to software ones."""
+        (process, values, watchpoints) = self.launch_and_watch_values()
+
+        # Each write stops exactly once, whichever mechanism watches the
+        # element, and writes to g_unwatched don't stop at all.
+        for i in range(self.NUM_VALUES):
+            process.Continue()
+            thread = lldbutil.get_stopped_thread(process, lldb.eStopReasonWatchpoint)
+            self.assertIsNotNone(thread, "write %d didn't stop" % i)
+            self.assertEqual(values.GetChildAtIndex(i).GetValueAsSigned(), i + 1)
+            self.assertEqual(watchpoints[i].GetHitCount(), 1)
+
+        process.Continue()
+        self.assertEqual(process.GetState(), lldb.eStateExited)
+        for watchpoint in watchpoints:
+            self.assertEqual(watchpoint.GetHitCount(), 1)
+
+    @skipUnlessPlatform(['linux'])
+    @skipIf(archs=no_match(['x86_64', 'i386']))
+    def test_debugger_writes_dont_hit_watchpoints(self):
+        """Test that writing watched memory from the debugger isn't reported as a hit."""
+        (process, values, watchpoints) = self.launch_and_watch_values()
+
+        # The last elements don't fit in the debug registers.
+        for i in range(self.NUM_VALUES):
+            error = lldb.SBError()
+            self.assertTrue(values.GetChildAtIndex(i).SetValueFromCString(str(100 + i), error),
+                            "writing element %d failed: %s" % (i, error.GetCString()))
+
+        # The first stop is still the program's first write.
+        process.Continue()
+        thread = lldbutil.get_stopped_thread(process, lldb.eStopReasonWatchpoint)
+        self.assertIsNotNone(thread)
+        self.assertEqual(values.GetChildAtIndex(0).GetValueAsSigned(), 1)
+        self.assertEqual(watchpoints[0].GetHitCount(), 1)
+        for i in range(1, self.NUM_VALUES):
+            self.assertEqual(watchpoints[i].GetHitCount(), 0)
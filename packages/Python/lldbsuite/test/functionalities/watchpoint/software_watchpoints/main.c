@@ -0,0 +1,27 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdio.h>
+#include <stdint.h>
+
+// More variables than there are debug registers.
+#define NUM_VALUES 8
+
+int64_t g_values[NUM_VALUES]; // Watchpoint variable declaration.
+int64_t g_unwatched;
+
+int main(int argc, char** argv) {
+    int i;
+    printf("&g_values=%p\n", g_values); // Set break point at this line.
+    for (i = 0; i < NUM_VALUES; ++i) {
+        g_unwatched += i;
+        g_values[i] = i + 1;
+    }
+    printf("g_unwatched=%lld\n", (long long)g_unwatched);
+    return 0;
+}
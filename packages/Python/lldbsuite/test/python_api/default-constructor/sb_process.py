@@ -45,5 +45,6 @@ def fuzz_obj(obj):
     obj.UnloadImage(0)
     obj.Clear()
     obj.GetNumSupportedHardwareWatchpoints(error)
+    obj.GetThreadsWithStackFrames(10)
     for thread in obj:
         s = str(thread)
@@ -23,6 +23,7 @@ def fuzz_obj(obj):
     obj.SetValueFromCString("my_new_value")
     obj.GetChildAtIndex(1)
     obj.GetChildAtIndex(2, lldb.eNoDynamicValues, False)
+    obj.GetChildrenRange(0, 2)
     obj.GetIndexOfChildWithName("my_first_child")
     obj.GetChildMemberWithName("my_first_child")
     obj.GetChildMemberWithName("my_first_child", lldb.eNoDynamicValues)
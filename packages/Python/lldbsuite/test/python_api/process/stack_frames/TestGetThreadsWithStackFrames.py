@@ -0,0 +1,72 @@
+"""Test SBProcess.GetThreadsWithStackFrames()."""
+
+from __future__ import print_function
+
+
+
+import os
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class GetThreadsWithStackFramesTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    thread_count = 8
+    depth = 10
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        self.line = line_number('main.cpp', '// Set break point at this line.')
+
+    @expectedFailureAll(oslist=["windows"])
+    def test_parallel_unwind(self):
+        """Test getting the frames of all the threads concurrently."""
+        self.build()
+        self.check_threads_with_stack_frames(True)
+
+    @expectedFailureAll(oslist=["windows"])
+    def test_serial_unwind(self):
+        """Test getting the frames of all the threads one after the other."""
+        self.build()
+        self.check_threads_with_stack_frames(False)
+
+    def check_threads_with_stack_frames(self, parallel):
+        self.runCmd("settings set target.process.parallel-thread-unwind %s" % ("true" if parallel else "false"))
+        self.addTearDownHook(lambda: self.runCmd("settings clear target.process.parallel-thread-unwind"))
+
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateByLocation("main.cpp", self.line)
+        self.assertTrue(breakpoint.GetNumLocations() > 0, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        self.assertEqual(process.GetState(), lldb.eStateStopped)
+
+        threads = process.GetThreadsWithStackFrames(lldb.UINT32_MAX)
+        self.assertTrue(threads.IsValid())
+        self.assertEqual(threads.GetSize(), process.GetNumThreads())
+
+        # Every worker thread unwinds through all of its recursion.
+        num_workers = 0
+        for i in range(threads.GetSize()):
+            thread = threads.GetThreadAtIndex(i)
+            self.assertTrue(thread.IsValid())
+            frame_names = [frame.GetFunctionName() for frame in thread]
+            if "thread_func()" in frame_names:
+                num_workers += 1
+                self.assertEqual(frame_names.count("recurse(int)"), self.depth + 1)
+        self.assertEqual(num_workers, self.thread_count)
+
+        # Computing only a few frames gives the same threads.
+        threads = process.GetThreadsWithStackFrames(2)
+        self.assertEqual(threads.GetSize(), process.GetNumThreads())
+
+        # The command unwinds the threads the same way.
+        self.expect("thread backtrace all", substrs = ["thread_func"])
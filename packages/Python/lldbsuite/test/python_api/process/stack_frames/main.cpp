@@ -0,0 +1,46 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+static const int g_thread_count = 8;
+static const int g_depth = 10;
+
+std::atomic<int> g_ready(0);
+std::atomic<bool> g_done(false);
+
+int __attribute__((noinline))
+recurse(int depth)
+{
+    if (depth == 0)
+    {
+        g_ready++;
+        while (!g_done)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        return 0;
+    }
+    return recurse(depth - 1) + 1;
+}
+
+void
+thread_func()
+{
+    recurse(g_depth);
+}
+
+int
+main(int argc, char const *argv[])
+{
+    std::vector<std::thread> threads;
+    for (int i = 0; i < g_thread_count; ++i)
+        threads.push_back(std::thread(thread_func));
+
+    while (g_ready < g_thread_count)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    g_done = true; // Set break point at this line.
+
+    for (std::thread &thread : threads)
+        thread.join();
+    return 0;
+}
@@ -0,0 +1,73 @@
+"""
+Test SBValue::GetChildrenRange().
+"""
+
+from __future__ import print_function
+
+import os
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class ValueAPIChildrenRangeTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        self.line = line_number('main.c', '// Break at this line')
+
+    @add_test_categories(['pyapi'])
+    def test_children_range(self):
+        """Get windows of the children of arrays with SBValue.GetChildrenRange()."""
+        self.build()
+        exe = os.path.join(os.getcwd(), "a.out")
+
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateByLocation('main.c', self.line)
+        self.assertTrue(breakpoint, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple (None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        thread = lldbutil.get_stopped_thread(process, lldb.eStopReasonBreakpoint)
+        self.assertTrue(thread.IsValid(), "There should be a thread stopped due to breakpoint")
+        frame = thread.GetFrameAtIndex(0)
+
+        numbers = frame.FindVariable('g_numbers')
+        self.assertTrue(numbers, VALID_VARIABLE)
+        self.assertEqual(numbers.GetNumChildren(), 1000)
+
+        # A window in the middle matches the children by index.
+        children = numbers.GetChildrenRange(500, 100)
+        self.assertEqual(children.GetSize(), 100)
+        for i in range(children.GetSize()):
+            child = children.GetValueAtIndex(i)
+            self.assertTrue(child.IsValid())
+            self.assertEqual(child.GetName(), "[%d]" % (500 + i))
+            self.assertEqual(child.GetValueAsSigned(), (500 + i) * 2)
+            self.assertEqual(child.GetLoadAddress(), numbers.GetChildAtIndex(500 + i).GetLoadAddress())
+
+        # The window stops at the last child.
+        children = numbers.GetChildrenRange(990, 100)
+        self.assertEqual(children.GetSize(), 10)
+        self.assertEqual(children.GetValueAtIndex(9).GetValueAsSigned(), 999 * 2)
+        self.assertEqual(numbers.GetChildrenRange(1000, 10).GetSize(), 0)
+        self.assertEqual(numbers.GetChildrenRange(0, 0).GetSize(), 0)
+
+        # Aggregate children work the same way.
+        points = frame.FindVariable('g_points')
+        self.assertTrue(points, VALID_VARIABLE)
+        children = points.GetChildrenRange(40, 20)
+        self.assertEqual(children.GetSize(), 20)
+        for i in range(children.GetSize()):
+            point = children.GetValueAtIndex(i)
+            self.assertEqual(point.GetChildMemberWithName('x').GetValueAsSigned(), 40 + i)
+            self.assertEqual(point.GetChildMemberWithName('y').GetValueAsSigned(), -(40 + i))
+
+        # Values without children give empty windows.
+        self.assertEqual(numbers.GetChildAtIndex(0).GetChildrenRange(0, 10).GetSize(), 0)
@@ -0,0 +1,25 @@
+#include <stdio.h>
+
+struct point
+{
+    int x;
+    int y;
+};
+
+int g_numbers[1000];
+struct point g_points[100];
+
+int
+main (int argc, char const *argv[])
+{
+    int i;
+    for (i = 0; i < 1000; ++i)
+        g_numbers[i] = i * 2;
+    for (i = 0; i < 100; ++i)
+    {
+        g_points[i].x = i;
+        g_points[i].y = -i;
+    }
+    printf ("%d %d\n", g_numbers[999], g_points[99].y); // Break at this line
+    return 0;
+}
@@ -0,0 +1,196 @@
+from __future__ import print_function
+
+import json
+import zlib
+
+import gdbremote_testcase
+from lldbsuite.test.lldbbench import Stopwatch
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class TestGdbRemoteCompression(gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def stop_with_threads(self, thread_count):
+        # Start the inferior with the requested number of threads.
+        inferior_args = []
+        for i in range(thread_count - 1):
+            inferior_args.append("thread:new")
+        inferior_args.append("sleep:30")
+        procs = self.prep_debug_monitor_and_inferior(inferior_args=inferior_args)
+
+        # Let the threads start, then stop the inferior.
+        self.run_process_then_stop(run_seconds=1)
+        threads = self.wait_for_thread_count(thread_count, timeout_seconds=5)
+        self.assertEqual(len(threads), thread_count)
+
+    def get_supported_compressions(self):
+        self.reset_test_sequence()
+        self.add_qSupported_packets()
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        supported_dict = self.parse_qSupported_response(context)
+        compressions = supported_dict.get("SupportedCompressions")
+        if not compressions:
+            return []
+        return compressions.split(",")
+
+    def enable_compression(self, compression):
+        # The reply to QEnableCompression is never compressed.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $QEnableCompression:type:{};#00".format(compression),
+             "send packet: $OK#00"],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+    def read_jThreadsInfo_payload(self):
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $jThreadsInfo#c1",
+             {"direction":"send", "regex":r"^\$([^#]*)#[0-9a-fA-F]{2}$", "capture":{1:"payload"} }],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertIsNotNone(context.get("payload"))
+        return context.get("payload")
+
+    def decode_payload(self, payload, compression):
+        # Uncompressed payloads use an 'N' prefix.
+        if payload.startswith("N"):
+            return payload[1:]
+
+        self.assertTrue(payload.startswith("C"))
+        size_text, encoded = payload[1:].split(":", 1)
+
+        # Undo the gdb-remote binary escaping.
+        data = bytearray()
+        escaped = False
+        for c in encoded:
+            byte = ord(c)
+            if escaped:
+                data.append(byte ^ 0x20)
+                escaped = False
+            elif byte == 0x7d:
+                escaped = True
+            else:
+                data.append(byte)
+
+        if compression == "zlib-deflate":
+            decoded = zlib.decompress(bytes(data), -15)
+        elif compression == "lz4":
+            try:
+                import lz4.block
+            except ImportError:
+                self.skipTest("the lz4 python module is not available")
+            decoded = lz4.block.decompress(bytes(data), uncompressed_size=int(size_text))
+        else:
+            self.fail("unexpected compression type %s" % compression)
+
+        self.assertEqual(len(decoded), int(size_text))
+        return decoded.decode("utf-8")
+
+    def QEnableCompression_compresses_jThreadsInfo(self):
+        thread_count = 8
+        self.stop_with_threads(thread_count)
+
+        compressions = self.get_supported_compressions()
+        if not compressions:
+            self.skipTest("lldb-server was built without compression support")
+        compression = compressions[0]
+
+        self.enable_compression(compression)
+
+        # The jThreadsInfo reply is large enough to be compressed and must decode
+        # to the same threads as before.
+        payload = self.read_jThreadsInfo_payload()
+        self.assertTrue(payload.startswith("C"))
+        threads_info = json.loads(self.decode_payload(payload, compression))
+        self.assertEqual(len(threads_info), thread_count)
+
+        # Small replies are sent as is with an 'N' prefix.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $qC#b4",
+             {"direction":"send", "regex":r"^\$NQC[0-9a-fA-F]+#[0-9a-fA-F]{2}$" }],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+    @llgs_test
+    def test_QEnableCompression_compresses_jThreadsInfo_llgs(self):
+        self.init_llgs_test()
+        self.debug_monitor_extra_args.append("--enable-compression")
+        self.build()
+        self.set_inferior_startup_launch()
+        self.QEnableCompression_compresses_jThreadsInfo()
+
+    def QEnableCompression_rejects_unknown_type(self):
+        procs = self.prep_debug_monitor_and_inferior()
+        self.test_sequence.add_log_lines(
+            ["read packet: $QEnableCompression:type:unknown;#00",
+             "send packet: $E88#00"],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+    @llgs_test
+    def test_QEnableCompression_rejects_unknown_type_llgs(self):
+        self.init_llgs_test()
+        self.debug_monitor_extra_args.append("--enable-compression")
+        self.build()
+        self.set_inferior_startup_launch()
+        self.QEnableCompression_rejects_unknown_type()
+
+    def compression_is_disabled_by_default(self):
+        procs = self.prep_debug_monitor_and_inferior()
+        self.assertEqual(self.get_supported_compressions(), [])
+
+        # The server answers like one that doesn't know the packet.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $QEnableCompression:type:zlib-deflate;#00",
+             "send packet: $#00"],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+    @llgs_test
+    def test_compression_is_disabled_by_default_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.compression_is_disabled_by_default()
+
+    def jThreadsInfo_compression_bench(self, thread_count, count):
+        self.stop_with_threads(thread_count)
+        compressions = self.get_supported_compressions()
+
+        # Measure the bytes on the wire and the round trip time of jThreadsInfo
+        # without compression, then with each compression the server supports.
+        results = []
+        for compression in [None] + compressions:
+            if compression:
+                self.enable_compression(compression)
+            stopwatch = Stopwatch()
+            for i in range(count):
+                with stopwatch:
+                    payload = self.read_jThreadsInfo_payload()
+            results.append((compression or "none", len(payload), stopwatch))
+
+        print()
+        for compression, size, stopwatch in results:
+            print("jThreadsInfo with %d threads, compression %s: %d bytes, %s" % (thread_count, compression, size, stopwatch))
+
+    @benchmarks_test
+    @llgs_test
+    def test_jThreadsInfo_compression_bench_llgs(self):
+        self.init_llgs_test()
+        self.debug_monitor_extra_args.append("--enable-compression")
+        self.build()
+        self.set_inferior_startup_launch()
+        self.jThreadsInfo_compression_bench(64, 20)
@@ -0,0 +1,142 @@
+from __future__ import print_function
+
+import gdbremote_testcase
+import lldbgdbserverutils
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class TestGdbRemoteConditionalBreakpoints(gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    # Agent expression opcodes.
+    OP_EQUAL = 0x13
+    OP_CONST8 = 0x22
+    OP_CONST64 = 0x25
+    OP_REG = 0x26
+    OP_END = 0x27
+
+    HELLO_CALL_COUNT = 3
+
+    def breakpoint_kind(self):
+        if self.getArchitecture() == "arm":
+            # TODO: Handle case when setting breakpoint in thumb code
+            return 4
+        return 1
+
+    def stop_before_hello_calls(self):
+        inferior_args = ["get-code-address-hex:hello", "sleep:1"]
+        inferior_args += ["call-function:hello"] * self.HELLO_CALL_COUNT
+        procs = self.prep_debug_monitor_and_inferior(inferior_args=inferior_args)
+
+        self.add_register_info_collection_packets()
+        self.add_process_info_collection_packets()
+        self.add_qSupported_packets()
+        self.test_sequence.add_log_lines(
+            [# Start running after initial stop.
+             "read packet: $c#63",
+             # Match output line that prints the memory address of the function call entry point.
+             { "type":"output_match", "regex":r"^code address: 0x([0-9a-fA-F]+)\r\n$", "capture":{ 1:"function_address"} },
+             # Now stop the inferior.
+             "read packet: {}".format(chr(3)),
+             # And wait for the stop notification.
+             {"direction":"send", "regex":r"^\$T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);", "capture":{1:"stop_signo", 2:"stop_thread_id"} }],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        supported_dict = self.parse_qSupported_response(context)
+        self.assertEqual(supported_dict.get("ConditionalBreakpoints"), "+")
+
+        reg_infos = self.parse_register_info_packets(context)
+        (pc_lldb_reg_index, pc_reg_info) = self.find_pc_reg_info(reg_infos)
+        self.assertIsNotNone(pc_lldb_reg_index)
+
+        self.assertIsNotNone(context.get("function_address"))
+        return (int(context.get("function_address"), 16), pc_lldb_reg_index)
+
+    def set_conditional_breakpoint(self, address, conditions):
+        packet = "Z0,{0:x},{1}".format(address, self.breakpoint_kind())
+        for condition in conditions:
+            packet += ";X{0:x},{1}".format(len(condition), "".join("{0:02x}".format(b) for b in condition))
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: ${}#00".format(packet),
+             "send packet: $OK#00"],
+            True)
+
+    def false_condition_does_not_stop(self):
+        (function_address, pc_reg_index) = self.stop_before_hello_calls()
+
+        # A breakpoint whose condition is false lets every call through.
+        self.set_conditional_breakpoint(function_address, [[self.OP_CONST8, 0, self.OP_END]])
+        self.test_sequence.add_log_lines(
+            ["read packet: $c#63",
+             {"direction":"send", "regex":r"^\$W00(.*)#[0-9a-fA-F]{2}$" }],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertEqual(context["O_content"].count("hello, world"), self.HELLO_CALL_COUNT)
+
+    @llgs_test
+    def test_false_condition_does_not_stop_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.false_condition_does_not_stop()
+
+    def true_condition_stops(self):
+        (function_address, pc_reg_index) = self.stop_before_hello_calls()
+
+        # The first condition is false and the second one compares the pc
+        # to the breakpoint address, any true condition stops.
+        pc_condition = [self.OP_REG, (pc_reg_index >> 8) & 0xff, pc_reg_index & 0xff, self.OP_CONST64]
+        pc_condition += [(function_address >> shift) & 0xff for shift in range(56, -8, -8)]
+        pc_condition += [self.OP_EQUAL, self.OP_END]
+        self.set_conditional_breakpoint(function_address, [[self.OP_CONST8, 0, self.OP_END], pc_condition])
+        self.test_sequence.add_log_lines(
+            ["read packet: $c#63",
+             {"direction":"send", "regex":r"^\$T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);", "capture":{1:"stop_signo", 2:"stop_thread_id"} }],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertEqual(int(context.get("stop_signo"), 16), lldbutil.get_signal_number('SIGTRAP'))
+        self.assertEqual(context["O_content"].count("hello, world"), 0)
+
+        # Setting the breakpoint again without conditions replaces them, then
+        # removing it lets the remaining calls run.
+        self.set_conditional_breakpoint(function_address, [])
+        self.test_sequence.add_log_lines(
+            ["read packet: $z0,{0:x},{1}#00".format(function_address, self.breakpoint_kind()),
+             "send packet: $OK#00",
+             "read packet: $c#63",
+             {"direction":"send", "regex":r"^\$W00(.*)#[0-9a-fA-F]{2}$" }],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertEqual(context["O_content"].count("hello, world"), self.HELLO_CALL_COUNT)
+
+    @llgs_test
+    def test_true_condition_stops_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.true_condition_stops()
+
+    def malformed_condition_is_rejected(self):
+        (function_address, pc_reg_index) = self.stop_before_hello_calls()
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $Z0,{0:x},{1};X3,22#00".format(function_address, self.breakpoint_kind()),
+             {"direction":"send", "regex":r"^\$E[0-9a-fA-F]{2}#[0-9a-fA-F]{2}$" }],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+    @llgs_test
+    def test_malformed_condition_is_rejected_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.malformed_condition_is_rejected()
@@ -912,6 +912,139 @@ class LldbGdbServerTestCase(gdbremote_testcase.GdbRemoteTestCaseBase):
         self.set_inferior_startup_launch()
         self.m_packet_reads_memory()
 
+    def jMultiMemRead_reads_memory(self):
+        MEMORY_CONTENTS = "Test contents 0123456789 ABCDEFGHIJKLMNOPQRSTUVWXYZ abcdefghijklmnopqrstuvwxyz"
+
+        # Start up the inferior.
+        procs = self.prep_debug_monitor_and_inferior(
+            inferior_args=["set-message:%s" % MEMORY_CONTENTS, "get-data-address-hex:g_message", "sleep:5"])
+
+        # Run the process
+        self.test_sequence.add_log_lines(
+            [
+             # Start running after initial stop.
+             "read packet: $c#63",
+             # Match output line that prints the memory address of the message buffer within the inferior. 
+             # Note we require launch-only testing so we can get inferior otuput.
+             { "type":"output_match", "regex":r"^data address: 0x([0-9a-fA-F]+)\r\n$", "capture":{ 1:"message_address"} },
+             # Now stop the inferior.
+             "read packet: {}".format(chr(3)),
+             # And wait for the stop notification.
+             {"direction":"send", "regex":r"^\$T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);", "capture":{1:"stop_signo", 2:"stop_thread_id"} }],
+            True)
+
+        # Run the packet stream.
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        # Grab the message address.
+        self.assertIsNotNone(context.get("message_address"))
+        message_address = int(context.get("message_address"), 16)
+
+        # Read two pieces of the message and the unmapped address 0, which reads nothing.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $jMultiMemRead:{0:x},4;{1:x},a;0,8#00".format(message_address, message_address + 14),
+             {"direction":"send", "regex":r"^\$([^;]+);(.*)#[0-9a-fA-F]{2}$", "capture":{1:"counts", 2:"read_contents"} }],
+            True)
+
+        # Run the packet stream.
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        self.assertEqual(context.get("counts"), "4,a,0")
+        self.assertEqual(context.get("read_contents"), "Test0123456789")
+
+    @llgs_test
+    def test_jMultiMemRead_reads_memory_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.jMultiMemRead_reads_memory()
+
+    def M_packet_writes_memory(self):
+        MEMORY_CONTENTS = "Test contents 0123456789 ABCDEFGHIJKLMNOPQRSTUVWXYZ abcdefghijklmnopqrstuvwxyz"
+        NEW_CONTENTS = "Written by M"
+
+        # Start up the inferior.
+        procs = self.prep_debug_monitor_and_inferior(
+            inferior_args=["set-message:%s" % MEMORY_CONTENTS, "get-data-address-hex:g_message", "get-code-address-hex:hello", "sleep:5"])
+
+        # Run the process
+        self.test_sequence.add_log_lines(
+            [
+             # Start running after initial stop.
+             "read packet: $c#63",
+             # Match the output lines that print the message buffer and code addresses.
+             { "type":"output_match", "regex":r"^data address: 0x([0-9a-fA-F]+)\r\n$", "capture":{ 1:"message_address"} },
+             { "type":"output_match", "regex":r"^code address: 0x([0-9a-fA-F]+)\r\n$", "capture":{ 1:"code_address"} },
+             # Now stop the inferior.
+             "read packet: {}".format(chr(3)),
+             # And wait for the stop notification.
+             {"direction":"send", "regex":r"^\$T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);", "capture":{1:"stop_signo", 2:"stop_thread_id"} }],
+            True)
+
+        # Run the packet stream.
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        self.assertIsNotNone(context.get("message_address"))
+        message_address = int(context.get("message_address"), 16)
+        self.assertIsNotNone(context.get("code_address"))
+        code_address = int(context.get("code_address"), 16)
+
+        # Write over the start of the writable message buffer and read it back.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $M{0:x},{1:x}:{2}#00".format(message_address, len(NEW_CONTENTS), NEW_CONTENTS.encode("hex")),
+             "send packet: $OK#00",
+             "read packet: $m{0:x},{1:x}#00".format(message_address, len(MEMORY_CONTENTS)),
+             {"direction":"send", "regex":r"^\$(.+)#[0-9a-fA-F]{2}$", "capture":{1:"read_contents"} }],
+            True)
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertIsNotNone(context.get("read_contents"))
+        read_contents = context.get("read_contents").decode("hex")
+        self.assertEqual(read_contents, NEW_CONTENTS + MEMORY_CONTENTS[len(NEW_CONTENTS):])
+
+        # Code is mapped read-only, writing it must still work the way
+        # setting a software breakpoint does. Flip the bits of the first
+        # bytes, read them back and restore them.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $m{0:x},4#00".format(code_address),
+             {"direction":"send", "regex":r"^\$([0-9a-fA-F]{8})#[0-9a-fA-F]{2}$", "capture":{1:"code_contents"} }],
+            True)
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertIsNotNone(context.get("code_contents"))
+        code_contents = context.get("code_contents")
+        flipped_contents = "{0:08x}".format(int(code_contents, 16) ^ 0xffffffff)
+
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $M{0:x},4:{1}#00".format(code_address, flipped_contents),
+             "send packet: $OK#00",
+             "read packet: $m{0:x},4#00".format(code_address),
+             "send packet: ${0}#00".format(flipped_contents),
+             "read packet: $M{0:x},4:{1}#00".format(code_address, code_contents),
+             "send packet: $OK#00",
+             "read packet: $m{0:x},4#00".format(code_address),
+             "send packet: ${0}#00".format(code_contents)],
+            True)
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+    @llgs_test
+    def test_M_packet_writes_memory_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.M_packet_writes_memory()
+
     def qMemoryRegionInfo_is_supported(self):
         # Start up the inferior.
         procs = self.prep_debug_monitor_and_inferior()
@@ -1239,6 +1372,77 @@ class LldbGdbServerTestCase(gdbremote_testcase.GdbRemoteTestCaseBase):
         self.set_inferior_startup_launch()
         self.software_breakpoint_set_and_remove_work()
 
+    def jMultiBreakpoint_sets_and_removes_breakpoints(self):
+        # Start up the inferior.
+        procs = self.prep_debug_monitor_and_inferior(
+            inferior_args=["get-code-address-hex:hello", "sleep:1", "call-function:hello"])
+
+        # Run the process
+        self.add_qSupported_packets()
+        self.test_sequence.add_log_lines(
+            [# Start running after initial stop.
+             "read packet: $c#63",
+             # Match output line that prints the memory address of the function call entry point.
+             { "type":"output_match", "regex":r"^code address: 0x([0-9a-fA-F]+)\r\n$", "capture":{ 1:"function_address"} },
+             # Now stop the inferior.
+             "read packet: {}".format(chr(3)),
+             # And wait for the stop notification.
+             {"direction":"send", "regex":r"^\$T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);", "capture":{1:"stop_signo", 2:"stop_thread_id"} }],
+            True)
+
+        # Run the packet stream.
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        supported_dict = self.parse_qSupported_response(context)
+        self.assertEqual(supported_dict.get("jMultiBreakpoint"), "+")
+
+        # Grab the function address.
+        self.assertIsNotNone(context.get("function_address"))
+        function_address = int(context.get("function_address"), 16)
+
+        if self.getArchitecture() == "arm":
+            # TODO: Handle case when setting breakpoint in thumb code
+            BREAKPOINT_KIND = 4
+        else:
+            BREAKPOINT_KIND = 1
+
+        # Set a breakpoint on the function and one at the unmapped address 0 in
+        # one packet, each request gets its own reply and the failure doesn't
+        # affect the other one.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $jMultiBreakpoint:Z0,{0:x},{1};Z0,0,{1}#00".format(function_address, BREAKPOINT_KIND),
+             "send packet: $OK,E09#00",
+             "read packet: $c#63",
+             {"direction":"send", "regex":r"^\$T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);", "capture":{1:"stop_signo", 2:"stop_thread_id"} }],
+            True)
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertEqual(int(context.get("stop_signo"), 16), lldbutil.get_signal_number('SIGTRAP'))
+        self.assertEqual(len(context["O_content"]), 0)
+
+        # Removing the breakpoint lets the call run.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $jMultiBreakpoint:z0,{0:x},{1}#00".format(function_address, BREAKPOINT_KIND),
+             "send packet: $OK#00",
+             "read packet: $c#63",
+             { "type":"output_match", "regex":r"^hello, world\r\n$" },
+             {"direction":"send", "regex":r"^\$W00(.*)#[0-9a-fA-F]{2}$" }],
+            True)
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+    @llgs_test
+    def test_jMultiBreakpoint_sets_and_removes_breakpoints_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.jMultiBreakpoint_sets_and_removes_breakpoints()
+
     def qSupported_returns_known_stub_features(self):
         # Start up the stub and start/prep the inferior.
         procs = self.prep_debug_monitor_and_inferior()
@@ -790,7 +790,11 @@ class GdbRemoteTestCaseBase(TestBase):
         "qXfer:libraries:read",
         "qXfer:libraries-svr4:read",
         "qXfer:features:read",
-        "qEcho"
+        "qEcho",
+        "SupportedCompressions",
+        "DefaultCompressionMinSize",
+        "ConditionalBreakpoints",
+        "jMultiBreakpoint"
     ]
 
     def parse_qSupported_response(self, context):
@@ -394,6 +394,16 @@ public:
 
     lldb::SBThreadCollection
     GetHistoryThreads (addr_t addr);
+
+    %feature("autodoc", "
+    Returns all the threads of the process with their first num_frames stack
+    frames computed, UINT32_MAX computes all of them. The threads are unwound
+    concurrently when target.process.parallel-thread-unwind is enabled and the
+    process plug-in supports it.
+    ") GetThreadsWithStackFrames;
+
+    lldb::SBThreadCollection
+    GetThreadsWithStackFrames (uint32_t num_frames);
              
     bool
     IsInstrumentationRuntimePresent(lldb::InstrumentationRuntimeType type);
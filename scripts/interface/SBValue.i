@@ -244,6 +244,23 @@ public:
                      lldb::DynamicValueType use_dynamic,
                      bool can_create_synthetic);
 
+    %feature("docstring", "
+    //------------------------------------------------------------------
+    /// Get a window of consecutive children of a value.
+    ///
+    /// Front ends showing a few children of a huge container at a time
+    /// should use this instead of calling GetChildAtIndex() for each
+    /// child. When the children are next to each other in memory, their
+    /// memory is read in one go instead of one child at a time.
+    ///
+    /// Returns the children in index order, fewer than count when the
+    /// window goes past the last child. A child that can't be created is
+    /// an invalid SBValue.
+    //------------------------------------------------------------------
+    ") GetChildrenRange;
+    lldb::SBValueList
+    GetChildrenRange (uint32_t start_idx, uint32_t count);
+
     lldb::SBValue
     CreateChildAtOffset (const char *name, uint32_t offset, lldb::SBType type);
     
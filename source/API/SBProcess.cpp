@@ -1433,6 +1433,42 @@ SBProcess::GetHistoryThreads (addr_t addr)
     return threads;
 }
 
+SBThreadCollection
+SBProcess::GetThreadsWithStackFrames (uint32_t num_frames)
+{
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+
+    SBThreadCollection threads;
+    ProcessSP process_sp(GetSP());
+    if (process_sp)
+    {
+        Process::StopLocker stop_locker;
+        if (stop_locker.TryLock(&process_sp->GetRunLock()))
+        {
+            Mutex::Locker api_locker (process_sp->GetTarget().GetAPIMutex());
+            ThreadList &thread_list = process_sp->GetThreadList();
+            thread_list.ComputeStackFrames (num_frames);
+
+            ThreadCollectionSP thread_collection_sp (new ThreadCollection());
+            for (ThreadSP thread_sp : thread_list.Threads())
+                thread_collection_sp->AddThread (thread_sp);
+            threads = SBThreadCollection (thread_collection_sp);
+        }
+        else
+        {
+            if (log)
+                log->Printf ("SBProcess(%p)::GetThreadsWithStackFrames() => error: process is running",
+                             static_cast<void*>(process_sp.get()));
+        }
+    }
+
+    if (log)
+        log->Printf ("SBProcess(%p)::GetThreadsWithStackFrames (num_frames=%u) => %" PRIu64 " threads",
+                     static_cast<void*>(process_sp.get()), num_frames, static_cast<uint64_t>(threads.GetSize()));
+
+    return threads;
+}
+
 bool
 SBProcess::IsInstrumentationRuntimePresent(InstrumentationRuntimeType type)
 {
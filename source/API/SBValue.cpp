@@ -46,6 +46,7 @@
 #include "lldb/API/SBProcess.h"
 #include "lldb/API/SBTarget.h"
 #include "lldb/API/SBThread.h"
+#include "lldb/API/SBValueList.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -993,6 +994,39 @@ SBValue::GetChildAtIndex (uint32_t idx, lldb::DynamicValueType use_dynamic, bool
     return sb_value;
 }
 
+SBValueList
+SBValue::GetChildrenRange (uint32_t start_idx, uint32_t count)
+{
+    SBValueList sb_children;
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+
+    ValueLocker locker;
+    lldb::ValueObjectSP value_sp(GetSP(locker));
+    if (value_sp)
+    {
+        lldb::DynamicValueType use_dynamic = eNoDynamicValues;
+        TargetSP target_sp(value_sp->GetTargetSP());
+        if (target_sp)
+            use_dynamic = target_sp->GetPreferDynamicValue();
+
+        std::vector<lldb::ValueObjectSP> children;
+        value_sp->GetChildrenRange (start_idx, count, children);
+        for (const lldb::ValueObjectSP &child_sp : children)
+        {
+            SBValue sb_child;
+            sb_child.SetSP (child_sp, use_dynamic, GetPreferSyntheticValue());
+            sb_children.Append (sb_child);
+        }
+    }
+
+    if (log)
+        log->Printf ("SBValue(%p)::GetChildrenRange (%u, %u) => %u children",
+                     static_cast<void*>(value_sp.get()), start_idx, count,
+                     sb_children.GetSize());
+
+    return sb_children;
+}
+
 uint32_t
 SBValue::GetIndexOfChildWithName (const char *name)
 {
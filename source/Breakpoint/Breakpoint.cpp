@@ -29,6 +29,7 @@
 #include "lldb/Symbol/CompileUnit.h"
 #include "lldb/Symbol/Function.h"
 #include "lldb/Symbol/SymbolContext.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/ThreadSpec.h"
 
@@ -147,10 +148,13 @@ Breakpoint::SetEnabled (bool enable)
         return;
 
     m_options.SetEnabled(enable);
-    if (enable)
-        m_locations.ResolveAllBreakpointSites();
-    else
-        m_locations.ClearAllBreakpointSites();
+    {
+        Process::BreakpointSiteBatch batch (m_target);
+        if (enable)
+            m_locations.ResolveAllBreakpointSites();
+        else
+            m_locations.ClearAllBreakpointSites();
+    }
         
     SendBreakpointChangedEvent (enable ? eBreakpointEventTypeEnabled : eBreakpointEventTypeDisabled);
 
@@ -170,6 +174,7 @@ Breakpoint::SetIgnoreCount (uint32_t n)
         
     m_options.SetIgnoreCount(n);
     SendBreakpointChangedEvent (eBreakpointEventTypeIgnoreChanged);
+    UpdateBreakpointSiteConditions ();
 }
 
 void
@@ -177,7 +182,13 @@ Breakpoint::DecrementIgnoreCount ()
 {
     uint32_t ignore = m_options.GetIgnoreCount();
     if (ignore != 0)
+    {
         m_options.SetIgnoreCount(ignore - 1);
+        // The remote stub can evaluate the conditions again once every
+        // hit to ignore has been seen.
+        if (ignore == 1)
+            UpdateBreakpointSiteConditions ();
+    }
 }
 
 uint32_t
@@ -303,6 +314,17 @@ Breakpoint::SetCondition (const char *condition)
 {
     m_options.SetCondition (condition);
     SendBreakpointChangedEvent (eBreakpointEventTypeConditionChanged);
+
+    // The locations without their own condition use this one.
+    UpdateBreakpointSiteConditions ();
+}
+
+void
+Breakpoint::UpdateBreakpointSiteConditions ()
+{
+    const size_t num_locations = m_locations.GetSize();
+    for (size_t i = 0; i < num_locations; ++i)
+        m_locations.GetByIndex(i)->UpdateBreakpointSiteConditions();
 }
 
 const char *
@@ -352,7 +374,10 @@ void
 Breakpoint::ResolveBreakpoint ()
 {
     if (m_resolver_sp)
+    {
+        Process::BreakpointSiteBatch batch (m_target);
         m_resolver_sp->ResolveBreakpoint(*m_filter_sp);
+    }
 }
 
 void
@@ -360,7 +385,10 @@ Breakpoint::ResolveBreakpointInModules (ModuleList &module_list, BreakpointLocat
 {
     m_locations.StartRecordingNewLocations(new_locations);
     
-    m_resolver_sp->ResolveBreakpointInModules(*m_filter_sp, module_list);
+    {
+        Process::BreakpointSiteBatch batch (m_target);
+        m_resolver_sp->ResolveBreakpointInModules(*m_filter_sp, module_list);
+    }
 
     m_locations.StopRecordingNewLocations();
 }
@@ -388,6 +416,7 @@ Breakpoint::ResolveBreakpointInModules (ModuleList &module_list, bool send_event
         }
         else
         {
+            Process::BreakpointSiteBatch batch (m_target);
             m_resolver_sp->ResolveBreakpointInModules(*m_filter_sp, module_list);
         }
     }
@@ -396,6 +425,7 @@ Breakpoint::ResolveBreakpointInModules (ModuleList &module_list, bool send_event
 void
 Breakpoint::ClearAllBreakpointSites ()
 {
+    Process::BreakpointSiteBatch batch (m_target);
     m_locations.ClearAllBreakpointSites();
 }
 
@@ -412,6 +442,7 @@ Breakpoint::ModulesChanged (ModuleList &module_list, bool load, bool delete_loca
                      module_list.GetSize(), load, delete_locations);
     
     Mutex::Locker modules_mutex(module_list.GetMutex());
+    Process::BreakpointSiteBatch batch (m_target);
     if (load)
     {
         // The logic for handling new modules is:
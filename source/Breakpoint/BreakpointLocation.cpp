@@ -254,6 +254,17 @@ BreakpointLocation::SetCondition (const char *condition)
 {
     GetLocationOptions()->SetCondition (condition);
     SendBreakpointLocationChangedEvent (eBreakpointEventTypeConditionChanged);
+    UpdateBreakpointSiteConditions ();
+}
+
+void
+BreakpointLocation::UpdateBreakpointSiteConditions ()
+{
+    if (!m_bp_site_sp)
+        return;
+    ProcessSP process_sp (m_owner.GetTarget().GetProcessSP());
+    if (process_sp && process_sp->IsAlive())
+        process_sp->UpdateBreakpointSiteConditions (m_bp_site_sp.get());
 }
 
 const char *
@@ -399,6 +410,7 @@ BreakpointLocation::SetIgnoreCount (uint32_t n)
 {
     GetLocationOptions()->SetIgnoreCount(n);
     SendBreakpointLocationChangedEvent (eBreakpointEventTypeIgnoreChanged);
+    UpdateBreakpointSiteConditions ();
 }
 
 void
@@ -408,7 +420,11 @@ BreakpointLocation::DecrementIgnoreCount()
     {
         uint32_t loc_ignore = m_options_ap->GetIgnoreCount();
         if (loc_ignore != 0)
+        {
             m_options_ap->SetIgnoreCount(loc_ignore - 1);
+            if (loc_ignore == 1)
+                UpdateBreakpointSiteConditions ();
+        }
     }
 }
 
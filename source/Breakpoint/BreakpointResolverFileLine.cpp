@@ -11,6 +11,8 @@
 
 // C Includes
 // C++ Includes
+#include <vector>
+
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Breakpoint/BreakpointLocation.h"
@@ -19,6 +21,7 @@
 #include "lldb/Core/StreamString.h"
 #include "lldb/Symbol/CompileUnit.h"
 #include "lldb/Symbol/Function.h"
+#include "lldb/Symbol/SymbolVendor.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -73,10 +76,20 @@ BreakpointResolverFileLine::SearchCallback
     // So we go through the match list and pull out the sets that have the same file spec in their line_entry
     // and treat each set separately.
     
-    const size_t num_comp_units = context.module_sp->GetNumCompileUnits();
-    for (size_t i = 0; i < num_comp_units; i++)
+    // Ask the symbol file which compile units use a file with this name, so
+    // the support files of all the others don't need to be parsed.
+    std::vector<uint32_t> cu_indexes;
+    SymbolVendor *sym_vendor = context.module_sp->GetSymbolVendor();
+    if (sym_vendor == nullptr || !sym_vendor->FindCompileUnitsForFile (m_file_spec, cu_indexes))
+    {
+        const size_t num_comp_units = context.module_sp->GetNumCompileUnits();
+        for (size_t i = 0; i < num_comp_units; i++)
+            cu_indexes.push_back (i);
+    }
+
+    for (uint32_t cu_idx : cu_indexes)
     {
-        CompUnitSP cu_sp (context.module_sp->GetCompileUnitAtIndex (i));
+        CompUnitSP cu_sp (context.module_sp->GetCompileUnitAtIndex (cu_idx));
         if (cu_sp)
         {
             if (filter.CompUnitPasses(*cu_sp))
@@ -1555,17 +1555,73 @@ protected:
 class CommandObjectProcessStatus : public CommandObjectParsed
 {
 public:
+    class CommandOptions : public Options
+    {
+    public:
+        CommandOptions (CommandInterpreter &interpreter) :
+            Options (interpreter)
+        {
+            OptionParsingStarting ();
+        }
+
+        ~CommandOptions() override = default;
+
+        Error
+        SetOptionValue (uint32_t option_idx, const char *option_arg) override
+        {
+            Error error;
+            const int short_option = m_getopt_table[option_idx].val;
+
+            switch (short_option)
+            {
+                case 'v':
+                    m_verbose = true;
+                    break;
+                default:
+                    error.SetErrorStringWithFormat("invalid short option character '%c'", short_option);
+                    break;
+            }
+            return error;
+        }
+
+        void
+        OptionParsingStarting () override
+        {
+            m_verbose = false;
+        }
+
+        const OptionDefinition*
+        GetDefinitions () override
+        {
+            return g_option_table;
+        }
+
+        // Options table: Required for subclasses of Options.
+
+        static OptionDefinition g_option_table[];
+
+        // Instance variables to hold the values for command options.
+        bool m_verbose;
+    };
+
     CommandObjectProcessStatus (CommandInterpreter &interpreter) :
         CommandObjectParsed (interpreter, 
                              "process status",
                              "Show the current status and location of executing process.",
                              "process status",
-                             eCommandRequiresProcess | eCommandTryTargetAPILock)
+                             eCommandRequiresProcess | eCommandTryTargetAPILock),
+        m_options(interpreter)
     {
     }
 
     ~CommandObjectProcessStatus() override = default;
 
+    Options *
+    GetOptions () override
+    {
+        return &m_options;
+    }
+
     bool
     DoExecute (Args& command, CommandReturnObject &result) override
     {
@@ -1583,8 +1639,27 @@ public:
                                   start_frame,
                                   num_frames,
                                   num_frames_with_source);
+
+        if (m_options.m_verbose)
+        {
+            const MemoryCache::Statistics stats = process->GetMemoryCacheStatistics();
+            strm.Printf ("Memory cache: %" PRIu64 " hits, %" PRIu64 " misses, %" PRIu64 " reads from the process (%" PRIu64 " bytes)\n",
+                         stats.hits,
+                         stats.misses,
+                         stats.process_reads,
+                         stats.bytes_read);
+        }
         return result.Succeeded();
     }
+
+    CommandOptions m_options;
+};
+
+OptionDefinition
+CommandObjectProcessStatus::CommandOptions::g_option_table[] =
+{
+{ LLDB_OPT_SET_1, false, "verbose", 'v', OptionParser::eNoArgument, nullptr, nullptr, 0, eArgTypeNone, "Show additional statistics such as the memory cache hit rate." },
+{ 0, false, nullptr, 0, 0, nullptr, nullptr, 0, eArgTypeNone, nullptr }
 };
 
 //-------------------------------------------------------------------------
@@ -72,6 +72,8 @@ public:
         else if (command.GetArgumentCount() == 1 && ::strcmp (command.GetArgumentAtIndex(0), "all") == 0)
         {
             Process *process = m_exe_ctx.GetProcessPtr();
+            WillHandleAllThreads (*process);
+
             uint32_t idx = 0;
             for (ThreadSP thread_sp : process->Threads())
             {
@@ -135,6 +137,14 @@ protected:
     virtual bool
     HandleOneThread (Thread &thread, CommandReturnObject &result) = 0;
 
+    // Override this to prepare all the threads of the process at once when iterating over "all" of them,
+    // before HandleOneThread is called for each one.  It is called without the thread list mutex held.
+
+    virtual void
+    WillHandleAllThreads (Process &process)
+    {
+    }
+
     ReturnStatus m_success_return = eReturnStatusSuccessFinishResult;
     bool m_add_return = true;
 };
@@ -274,6 +284,17 @@ protected:
         }
     }
 
+    void
+    WillHandleAllThreads (Process &process) override
+    {
+        // Compute the frames that will be displayed for all the threads up front, so they can be
+        // unwound concurrently.
+        uint32_t num_frames = UINT32_MAX;
+        if (m_options.m_count != UINT32_MAX && m_options.m_start < UINT32_MAX - m_options.m_count)
+            num_frames = m_options.m_start + m_options.m_count;
+        process.GetThreadList().ComputeStackFrames (num_frames);
+    }
+
     bool
     HandleOneThread (Thread &thread, CommandReturnObject &result) override
     {
@@ -8,21 +8,48 @@
 //===----------------------------------------------------------------------===//
 #include "lldb/Core/ConstString.h"
 #include "lldb/Core/Stream.h"
-#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringExtras.h"
-#include "llvm/Support/RWMutex.h"
+#include "llvm/Support/Allocator.h"
 
 #include <array>
+#include <atomic>
+#include <cstring>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 using namespace lldb_private;
 
+//----------------------------------------------------------------------
+// The pool is split into 256 shards, each of them being an open
+// addressing hash table of pointers to the entries. Entries are never
+// moved or freed, and the length and mangled counterpart of a string
+// are stored inline right before its characters, so they can be read
+// from a const C string without any locking.
+//
+// Lookups don't take any lock either: buckets are only ever filled in
+// with a release store, and a shard growing publishes a new table while
+// keeping the old one around for readers still probing it. A reader
+// that misses a string inserted concurrently falls back to the insertion
+// path, which looks the string up again while holding the shard mutex.
+//----------------------------------------------------------------------
 class Pool
 {
 public:
     typedef const char * StringPoolValueType;
-    typedef llvm::StringMap<StringPoolValueType, llvm::BumpPtrAllocator> StringPool;
-    typedef llvm::StringMapEntry<StringPoolValueType> StringPoolEntryType;
+
+    struct StringPoolEntryType
+    {
+        std::atomic<StringPoolValueType> m_mangled_counterpart;
+        uint32_t m_hash;
+        uint32_t m_length;
+
+        const char *
+        GetKeyData () const
+        {
+            return reinterpret_cast<const char *>(this + 1);
+        }
+    };
 
     static StringPoolEntryType &
     GetStringMapEntryFromKeyData (const char *keyData)
@@ -35,12 +62,7 @@ public:
     GetConstCStringLength (const char *ccstr) const
     {
         if (ccstr)
-        {
-            const uint8_t h = hash (llvm::StringRef(ccstr));
-            llvm::sys::SmartScopedReader<false> rlock(m_string_pools[h].m_mutex);
-            const StringPoolEntryType& entry = GetStringMapEntryFromKeyData (ccstr);
-            return entry.getKey().size();
-        }
+            return GetStringMapEntryFromKeyData (ccstr).m_length;
         return 0;
     }
 
@@ -48,11 +70,7 @@ public:
     GetMangledCounterpart (const char *ccstr) const
     {
         if (ccstr)
-        {
-            const uint8_t h = hash (llvm::StringRef(ccstr));
-            llvm::sys::SmartScopedReader<false> rlock(m_string_pools[h].m_mutex);
-            return GetStringMapEntryFromKeyData (ccstr).getValue();
-        }
+            return GetStringMapEntryFromKeyData (ccstr).m_mangled_counterpart.load (std::memory_order_acquire);
         return 0;
     }
 
@@ -61,16 +79,8 @@ public:
     {
         if (key_ccstr && value_ccstr)
         {
-            {
-                const uint8_t h = hash (llvm::StringRef(key_ccstr));
-                llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
-                GetStringMapEntryFromKeyData (key_ccstr).setValue(value_ccstr);
-            }
-            {
-                const uint8_t h = hash (llvm::StringRef(value_ccstr));
-                llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
-                GetStringMapEntryFromKeyData (value_ccstr).setValue(key_ccstr);
-            }
+            GetStringMapEntryFromKeyData (key_ccstr).m_mangled_counterpart.store (value_ccstr, std::memory_order_release);
+            GetStringMapEntryFromKeyData (value_ccstr).m_mangled_counterpart.store (key_ccstr, std::memory_order_release);
             return true;
         }
         return false;
@@ -97,18 +107,14 @@ public:
     {
         if (string_ref.data())
         {
-            const uint8_t h = hash (string_ref);
+            const uint32_t h = llvm::HashString (string_ref);
+            PoolShard &shard = m_string_pools[ShardIndex (h)];
 
-            {
-                llvm::sys::SmartScopedReader<false> rlock(m_string_pools[h].m_mutex);
-                auto it = m_string_pools[h].m_string_map.find (string_ref);
-                if (it != m_string_pools[h].m_string_map.end())
-                    return it->getKeyData();
-            }
+            const StringPoolEntryType *entry = shard.Find (string_ref, h);
+            if (entry)
+                return entry->GetKeyData();
 
-            llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
-            StringPoolEntryType& entry = *m_string_pools[h].m_string_map.insert (std::make_pair (string_ref, nullptr)).first;
-            return entry.getKeyData();
+            return shard.Insert (string_ref, h, nullptr).GetKeyData();
         }
         return nullptr;
     }
@@ -118,28 +124,18 @@ public:
     {
         if (demangled_cstr)
         {
-            const char *demangled_ccstr = nullptr;
-
-            {
-                llvm::StringRef string_ref (demangled_cstr);
-                const uint8_t h = hash (string_ref);
-                llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
-
-                // Make string pool entry with the mangled counterpart already set
-                StringPoolEntryType& entry = *m_string_pools[h].m_string_map.insert (
-                    std::make_pair (string_ref, mangled_ccstr)).first;
+            // Make string pool entry with the mangled counterpart already set
+            llvm::StringRef string_ref (demangled_cstr);
+            const uint32_t h = llvm::HashString (string_ref);
+            StringPoolEntryType &entry = m_string_pools[ShardIndex (h)].Insert (string_ref, h, mangled_ccstr);
 
-                // Extract the const version of the demangled_cstr
-                demangled_ccstr = entry.getKeyData();
-            }
+            // Extract the const version of the demangled_cstr
+            const char *demangled_ccstr = entry.GetKeyData();
 
-            {
-                // Now assign the demangled const string as the counterpart of the
-                // mangled const string...
-                const uint8_t h = hash (llvm::StringRef(mangled_ccstr));
-                llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
-                GetStringMapEntryFromKeyData (mangled_ccstr).setValue(demangled_ccstr);
-            }
+            // Now assign the demangled const string as the counterpart of the
+            // mangled const string...
+            GetStringMapEntryFromKeyData (mangled_ccstr).m_mangled_counterpart.store (demangled_ccstr,
+                                                                                     std::memory_order_release);
 
             // Return the constant demangled C string
             return demangled_ccstr;
@@ -168,29 +164,144 @@ public:
     {
         size_t mem_size = sizeof(Pool);
         for (const auto& pool : m_string_pools)
-        {
-            llvm::sys::SmartScopedReader<false> rlock(pool.m_mutex);
-            for (const auto& entry : pool.m_string_map)
-                mem_size += sizeof(StringPoolEntryType) + entry.getKey().size();
-        }
+            mem_size += pool.MemorySize();
         return mem_size;
     }
 
 protected:
-    uint8_t
-    hash(const llvm::StringRef &s) const
+    static uint8_t
+    ShardIndex (uint32_t h)
     {
-        uint32_t h = llvm::HashString(s);
         return ((h >> 24) ^ (h >> 16) ^ (h >> 8) ^ h) & 0xff;
     }
 
-    struct PoolEntry
+    struct BucketTable
     {
-        mutable llvm::sys::SmartRWMutex<false> m_mutex;
-        StringPool m_string_map;
+        explicit BucketTable (uint32_t size) :
+            m_mask (size - 1),
+            m_buckets (new std::atomic<StringPoolEntryType*>[size])
+        {
+            for (uint32_t i = 0; i < size; ++i)
+                m_buckets[i].store (nullptr, std::memory_order_relaxed);
+        }
+
+        const uint32_t m_mask; // The table size is a power of two
+        std::unique_ptr<std::atomic<StringPoolEntryType*>[]> m_buckets;
+    };
+
+    class PoolShard
+    {
+    public:
+        PoolShard () :
+            m_table (nullptr),
+            m_num_entries (0)
+        {
+        }
+
+        const StringPoolEntryType *
+        Find (const llvm::StringRef &string_ref, uint32_t h) const
+        {
+            const BucketTable *table = m_table.load (std::memory_order_acquire);
+            if (table == nullptr)
+                return nullptr;
+
+            for (uint32_t idx = h & table->m_mask;; idx = (idx + 1) & table->m_mask)
+            {
+                const StringPoolEntryType *entry = table->m_buckets[idx].load (std::memory_order_acquire);
+                if (entry == nullptr)
+                    return nullptr;
+                if (entry->m_hash == h && entry->m_length == string_ref.size() &&
+                    ::memcmp (entry->GetKeyData(), string_ref.data(), string_ref.size()) == 0)
+                    return entry;
+            }
+        }
+
+        // Returns the existing entry for the string if there is one, otherwise
+        // a new entry with its mangled counterpart set to "mangled".
+        StringPoolEntryType &
+        Insert (const llvm::StringRef &string_ref, uint32_t h, StringPoolValueType mangled)
+        {
+            std::lock_guard<std::mutex> guard (m_mutex);
+
+            // Another thread might have added the string since we last looked.
+            const StringPoolEntryType *existing_entry = Find (string_ref, h);
+            if (existing_entry)
+                return *const_cast<StringPoolEntryType*>(existing_entry);
+
+            // Keep the load factor under 3/4 so probe sequences stay short.
+            const BucketTable *table = m_table.load (std::memory_order_relaxed);
+            if (table == nullptr || (m_num_entries + 1) * 4 > (table->m_mask + 1) * 3)
+                table = Grow ();
+
+            void *mem = m_allocator.Allocate (sizeof (StringPoolEntryType) + string_ref.size() + 1,
+                                              alignof (StringPoolEntryType));
+            StringPoolEntryType *entry = new (mem) StringPoolEntryType();
+            entry->m_mangled_counterpart.store (mangled, std::memory_order_relaxed);
+            entry->m_hash = h;
+            entry->m_length = string_ref.size();
+            char *key_data = const_cast<char*>(entry->GetKeyData());
+            ::memcpy (key_data, string_ref.data(), string_ref.size());
+            key_data[string_ref.size()] = '\0';
+
+            AddToTable (*table, entry);
+            ++m_num_entries;
+            return *entry;
+        }
+
+        size_t
+        MemorySize () const
+        {
+            std::lock_guard<std::mutex> guard (m_mutex);
+            size_t mem_size = m_allocator.getTotalMemory();
+            for (const auto &table : m_tables)
+                mem_size += sizeof (BucketTable) + (table->m_mask + 1) * sizeof (std::atomic<StringPoolEntryType*>);
+            return mem_size;
+        }
+
+    private:
+        static void
+        AddToTable (const BucketTable &table, StringPoolEntryType *entry)
+        {
+            uint32_t idx = entry->m_hash & table.m_mask;
+            while (table.m_buckets[idx].load (std::memory_order_relaxed) != nullptr)
+                idx = (idx + 1) & table.m_mask;
+            table.m_buckets[idx].store (entry, std::memory_order_release);
+        }
+
+        // Must be called with m_mutex held
+        const BucketTable *
+        Grow ()
+        {
+            const BucketTable *old_table = m_table.load (std::memory_order_relaxed);
+            const uint32_t new_size = old_table ? (old_table->m_mask + 1) * 2 : 64;
+            std::unique_ptr<BucketTable> new_table (new BucketTable (new_size));
+            if (old_table)
+            {
+                for (uint32_t i = 0; i <= old_table->m_mask; ++i)
+                {
+                    StringPoolEntryType *entry = old_table->m_buckets[i].load (std::memory_order_relaxed);
+                    if (entry)
+                        AddToTable (*new_table, entry);
+                }
+            }
+
+            // Readers can still be probing the old tables so they are kept
+            // alive. As the tables double in size, this at most doubles the
+            // memory used by the buckets.
+            const BucketTable *result = new_table.get();
+            m_tables.push_back (std::move (new_table));
+            m_table.store (result, std::memory_order_release);
+            return result;
+        }
+
+        mutable std::mutex m_mutex;
+        std::atomic<const BucketTable*> m_table;
+        uint32_t m_num_entries;
+        std::vector<std::unique_ptr<BucketTable>> m_tables;
+        llvm::BumpPtrAllocator m_allocator;
     };
 
-    std::array<PoolEntry, 256> m_string_pools;
+    std::array<PoolShard, 256> m_string_pools;
 };
 
 //----------------------------------------------------------------------
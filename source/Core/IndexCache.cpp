@@ -0,0 +1,277 @@
+//===-- IndexCache.cpp ------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Core/IndexCache.h"
+
+// C Includes
+#include <ctype.h>
+#include <string.h>
+
+// C++ Includes
+#include <algorithm>
+#include <vector>
+
+// Other libraries and framework includes
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+
+// Project includes
+#include "lldb/Core/DataBuffer.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/Log.h"
+#include "lldb/Core/StreamString.h"
+#include "lldb/Core/UUID.h"
+#include "lldb/Host/File.h"
+#include "lldb/Host/FileSystem.h"
+#include "lldb/Host/Host.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace {
+
+const uint32_t kCacheMagic = 0x58444957; // 'WIDX'
+const lldb::offset_t kCacheHeaderSize = 16;
+const char *kCacheTempExtension = "tmp";
+
+// The extensions of all the kinds of index sharing the cache directory,
+// see Symtab::SaveIndexCache () and SymbolFileDWARF::SaveIndexCache ().
+const char *kCacheFileExtensions[] = { ".dwarf-index", ".symtab-index" };
+
+// UUID::GetAsString () formats 16 byte UUIDs like this. 20 byte ones have
+// an extra "-XXXXXXXX" group, which is simply matched as part of the file
+// name that follows.
+const char *kCacheUUIDPattern = "XXXXXXXX-XXXX-XXXX-XXXX-XXXXXXXXXXXX";
+
+struct CacheFileInfo
+{
+    FileSpec file_spec;
+    uint64_t mod_time;
+    uint64_t byte_size;
+};
+
+//----------------------------------------------------------------------
+// Returns true if \a filename is named ${UUID}-${FILENAME}${EXTENSION}
+// with one of the known index extensions, so that pruning never touches
+// files some other tool put into the cache directory.
+//----------------------------------------------------------------------
+bool
+IsCacheFileName (const char *filename)
+{
+    if (filename == nullptr)
+        return false;
+
+    const char *p = filename;
+    for (const char *pattern = kCacheUUIDPattern; *pattern; ++pattern, ++p)
+    {
+        if (*pattern == 'X' ? !isxdigit (*p) || islower (*p) : *p != *pattern)
+            return false;
+    }
+    if (*p++ != '-')
+        return false;
+
+    const size_t name_len = strlen (p);
+    for (const char *extension : kCacheFileExtensions)
+    {
+        const size_t extension_len = strlen (extension);
+        // The object file name in between can't be empty.
+        if (name_len > extension_len && strcmp (p + name_len - extension_len, extension) == 0)
+            return true;
+    }
+    return false;
+}
+
+} // anonymous namespace
+
+IndexCache::IndexCache (const FileSpec &cache_dir,
+                        uint64_t max_cache_byte_size,
+                        const char *file_extension,
+                        uint32_t format_version) :
+    m_cache_dir (cache_dir),
+    m_max_byte_size (max_cache_byte_size),
+    m_file_extension (file_extension),
+    m_format_version (format_version)
+{
+}
+
+FileSpec
+IndexCache::GetCacheFileSpec (const UUID &uuid, const FileSpec &file_spec) const
+{
+    std::string filename (uuid.GetAsString ());
+    filename += '-';
+    filename += file_spec.GetFilename ().AsCString ("<unknown>");
+    filename += m_file_extension;
+
+    FileSpec cache_file_spec (m_cache_dir);
+    cache_file_spec.AppendPathComponent (filename.c_str ());
+    return cache_file_spec;
+}
+
+bool
+IndexCache::Read (const UUID &uuid,
+                  const FileSpec &file_spec,
+                  const TimeValue &mod_time,
+                  DataExtractor &data) const
+{
+    if (!m_cache_dir || !uuid.IsValid ())
+        return false;
+
+    const FileSpec cache_file_spec (GetCacheFileSpec (uuid, file_spec));
+    if (!cache_file_spec.Exists ())
+        return false;
+
+    DataBufferSP data_sp (cache_file_spec.ReadFileContents ());
+    if (!data_sp || data_sp->GetByteSize () < kCacheHeaderSize)
+        return false;
+
+    DataExtractor cache_data (data_sp, eByteOrderLittle, 4);
+    lldb::offset_t offset = 0;
+    const uint32_t magic = cache_data.GetU32 (&offset);
+    const uint32_t version = cache_data.GetU32 (&offset);
+    const uint64_t cached_mod_time = cache_data.GetU64 (&offset);
+    if (magic != kCacheMagic || version != m_format_version ||
+        cached_mod_time != mod_time.GetAsMicroSecondsSinceJan1_1970 ())
+    {
+        Log *log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_SYMBOLS));
+        if (log)
+            log->Printf ("IndexCache::Read ignoring stale index cache %s",
+                         cache_file_spec.GetPath ().c_str ());
+        return false;
+    }
+
+    data.SetData (cache_data, offset, cache_data.GetByteSize () - offset);
+    return true;
+}
+
+Error
+IndexCache::Write (const UUID &uuid,
+                   const FileSpec &file_spec,
+                   const TimeValue &mod_time,
+                   const void *payload,
+                   size_t payload_size)
+{
+    if (!m_cache_dir || !uuid.IsValid ())
+        return Error ("invalid index cache key");
+
+    if (m_max_byte_size && payload_size + kCacheHeaderSize > m_max_byte_size)
+        return Error ("index is larger than the index cache");
+
+    Error error;
+    if (!m_cache_dir.Exists ())
+    {
+        error = FileSystem::MakeDirectory (m_cache_dir, eFilePermissionsDirectoryDefault);
+        if (error.Fail ())
+            return error;
+    }
+
+    StreamString header (Stream::eBinary, 4, eByteOrderLittle);
+    header.PutHex32 (kCacheMagic);
+    header.PutHex32 (m_format_version);
+    header.PutHex64 (mod_time.GetAsMicroSecondsSinceJan1_1970 ());
+
+    // Write to a per-process temporary file and rename it into place so
+    // that concurrent debug sessions never see a partially written index.
+    const FileSpec cache_file_spec (GetCacheFileSpec (uuid, file_spec));
+    StreamString tmp_path;
+    tmp_path.Printf ("%s.%" PRIu64 ".%s", cache_file_spec.GetPath ().c_str (), (uint64_t)Host::GetCurrentProcessID (), kCacheTempExtension);
+    {
+        File file (tmp_path.GetData (),
+                   File::eOpenOptionWrite | File::eOpenOptionCanCreate | File::eOpenOptionTruncate | File::eOpenOptionCloseOnExec);
+        if (!file.IsValid ())
+            return Error ("unable to create index cache file %s", tmp_path.GetData ());
+
+        size_t num_bytes = header.GetSize ();
+        error = file.Write (header.GetData (), num_bytes);
+        if (error.Success ())
+        {
+            num_bytes = payload_size;
+            error = file.Write (payload, num_bytes);
+        }
+    }
+
+    if (error.Success ())
+    {
+        const auto err_code = llvm::sys::fs::rename (tmp_path.GetData (), cache_file_spec.GetPath ().c_str ());
+        if (err_code)
+            error.SetErrorStringWithFormat ("failed to rename %s to %s: %s",
+                                            tmp_path.GetData (),
+                                            cache_file_spec.GetPath ().c_str (),
+                                            err_code.message ().c_str ());
+    }
+
+    if (error.Fail ())
+    {
+        FileSystem::Unlink (FileSpec (tmp_path.GetData (), false));
+        return error;
+    }
+
+    Prune ();
+    return error;
+}
+
+FileSpec
+IndexCache::GetDefaultCacheDirectory ()
+{
+    llvm::SmallString<64> user_home_dir;
+    if (!llvm::sys::path::home_directory (user_home_dir))
+        return FileSpec ();
+
+    FileSpec cache_dir (user_home_dir.c_str (), false);
+    cache_dir.AppendPathComponent (".lldb");
+    cache_dir.AppendPathComponent ("index_cache");
+    return cache_dir;
+}
+
+void
+IndexCache::Prune ()
+{
+    if (m_max_byte_size == 0)
+        return;
+
+    std::vector<CacheFileInfo> cache_files;
+    uint64_t total_byte_size = 0;
+    const std::string cache_dir_path (m_cache_dir.GetPath ());
+    // Every kind of index counts towards the maximum size. Files other
+    // sessions are still writing end in kCacheTempExtension and don't
+    // match, neither does anything else that was put into the directory.
+    FileSpec::ForEachItemInDirectory (cache_dir_path.c_str (),
+                                      [&cache_files, &total_byte_size] (FileSpec::FileType file_type, const FileSpec &spec)
+                                      {
+                                          if (file_type == FileSpec::eFileTypeRegular &&
+                                              IsCacheFileName (spec.GetFilename ().GetCString ()))
+                                          {
+                                              CacheFileInfo info = { spec,
+                                                                     spec.GetModificationTime ().GetAsMicroSecondsSinceJan1_1970 (),
+                                                                     spec.GetByteSize () };
+                                              total_byte_size += info.byte_size;
+                                              cache_files.push_back (info);
+                                          }
+                                          return FileSpec::eEnumerateDirectoryResultNext;
+                                      });
+
+    if (total_byte_size <= m_max_byte_size)
+        return;
+
+    std::sort (cache_files.begin (), cache_files.end (),
+               [] (const CacheFileInfo &lhs, const CacheFileInfo &rhs) { return lhs.mod_time < rhs.mod_time; });
+
+    Log *log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_SYMBOLS));
+    for (const CacheFileInfo &info : cache_files)
+    {
+        if (total_byte_size <= m_max_byte_size)
+            break;
+        if (FileSystem::Unlink (info.file_spec).Success ())
+        {
+            total_byte_size -= info.byte_size;
+            if (log)
+                log->Printf ("IndexCache::Prune removed %s", info.file_spec.GetPath ().c_str ());
+        }
+    }
+}
@@ -645,14 +645,27 @@ Value::GetValueAsData (ExecutionContext *exe_ctx,
     if (error.Fail())
         return error;
 
-    // Make sure we have enough room within "data", and if we don't make
-    // something large enough that does
-    if (!data.ValidOffsetForDataOfSize (data_offset, byte_size))
+    // Reference the memory directly when the process already holds it in a
+    // buffer, like the memory of a core file.
+    if (address_type == eAddressTypeLoad && data_offset == 0 && byte_size > 0 && !file_so_addr.IsValid())
     {
-        DataBufferSP data_sp(new DataBufferHeap (data_offset + byte_size, '\0'));
-        data.SetData(data_sp);
+        Process *process = exe_ctx ? exe_ctx->GetProcessPtr() : nullptr;
+        if (process)
+        {
+            if (process->GetMemoryData(address, byte_size, data))
+                return error;
+        }
     }
 
+    // Always read into a buffer of our own, "data" may reference memory
+    // that isn't ours to write to, like the memory mapped core file a
+    // process handed out with GetMemoryData or a buffer shared with other
+    // values. Keep the bytes before data_offset.
+    DataBufferSP data_sp(new DataBufferHeap (data_offset + byte_size, '\0'));
+    if (data_offset > 0)
+        data.CopyData (0, data_offset, data_sp->GetBytes());
+    data.SetData(data_sp);
+
     uint8_t* dst = const_cast<uint8_t*>(data.PeekData (data_offset, byte_size));
     if (dst != NULL)
     {
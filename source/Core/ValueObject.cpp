@@ -597,6 +597,51 @@ ValueObject::GetChildAtIndex (size_t idx, bool can_create)
     return child_sp;
 }
 
+size_t
+ValueObject::GetChildrenRange (size_t start_idx, size_t count, std::vector<ValueObjectSP> &children)
+{
+    // The most memory read ahead for a window of children.
+    static const uint64_t k_max_prefetch_size = 1024 * 1024;
+
+    children.clear();
+    // We may need to update our value if we are dynamic
+    if (IsPossibleDynamicType ())
+        UpdateValueIfNeeded(false);
+    const size_t num_children = GetNumChildren();
+    if (start_idx >= num_children || count == 0)
+        return 0;
+    count = std::min (count, num_children - start_idx);
+    children.reserve(count);
+
+    for (size_t idx = start_idx; idx < start_idx + count; ++idx)
+    {
+        children.push_back(GetChildAtIndex(idx, true));
+        if (children.size() != 2 || count <= 2 || !children[0] || !children[1])
+            continue;
+
+        // If the first two children are next to each other in memory, expect
+        // the others to follow them and read their memory in one go. That
+        // fills the memory cache the remaining children read from.
+        AddressType first_address_type = eAddressTypeInvalid;
+        AddressType second_address_type = eAddressTypeInvalid;
+        const addr_t first_addr = children[0]->GetAddressOf(true, &first_address_type);
+        const addr_t second_addr = children[1]->GetAddressOf(true, &second_address_type);
+        const uint64_t byte_size = children[0]->GetByteSize();
+        if (first_address_type != eAddressTypeLoad || second_address_type != eAddressTypeLoad ||
+            first_addr == LLDB_INVALID_ADDRESS || byte_size == 0 || second_addr != first_addr + byte_size)
+            continue;
+
+        ProcessSP process_sp(GetProcessSP());
+        if (!process_sp)
+            continue;
+        const uint64_t prefetch_size = std::min<uint64_t> ((count - 2) * byte_size, k_max_prefetch_size);
+        DataBufferHeap buffer(prefetch_size, 0);
+        Error error;
+        process_sp->ReadMemory (second_addr + byte_size, buffer.GetBytes(), buffer.GetByteSize(), error);
+    }
+    return children.size();
+}
+
 ValueObjectSP
 ValueObject::GetChildAtIndexPath (const std::initializer_list<size_t>& idxs,
                                   size_t* index_of_error)
@@ -1044,6 +1089,9 @@ ValueObject::GetPointeeData (DataExtractor& data,
                     Process *process = exe_ctx.GetProcessPtr();
                     if (process)
                     {
+                        if (process->GetMemoryData(addr + offset, bytes, data))
+                            return bytes;
+
                         heap_buf_ptr->SetByteSize(bytes);
                         size_t bytes_read = process->ReadMemory(addr + offset, heap_buf_ptr->GetBytes(), bytes, error);
                         if (error.Success() || bytes_read > 0)
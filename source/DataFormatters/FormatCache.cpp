@@ -10,6 +10,7 @@
 // C Includes
 
 // C++ Includes
+#include <functional>
 
 // Other libraries and framework includes
 
@@ -19,7 +20,7 @@
 using namespace lldb;
 using namespace lldb_private;
 
-FormatCache::Entry::Entry () :
+FormatCache::Entry::Entry (uint32_t revision) :
 m_format_cached(false),
 m_summary_cached(false),
 m_synthetic_cached(false),
@@ -27,61 +28,10 @@ m_validator_cached(false),
 m_format_sp(),
 m_summary_sp(),
 m_synthetic_sp(),
-m_validator_sp()
+m_validator_sp(),
+m_revision(revision)
 {}
 
-FormatCache::Entry::Entry (lldb::TypeFormatImplSP format_sp) :
-m_summary_cached(false),
-m_synthetic_cached(false),
-m_validator_cached(false),
-m_summary_sp(),
-m_synthetic_sp(),
-m_validator_sp()
-{
-    SetFormat (format_sp);
-}
-
-FormatCache::Entry::Entry (lldb::TypeSummaryImplSP summary_sp) :
-m_format_cached(false),
-m_synthetic_cached(false),
-m_validator_cached(false),
-m_format_sp(),
-m_synthetic_sp(),
-m_validator_sp()
-{
-    SetSummary (summary_sp);
-}
-
-FormatCache::Entry::Entry (lldb::SyntheticChildrenSP synthetic_sp) :
-m_format_cached(false),
-m_summary_cached(false),
-m_validator_cached(false),
-m_format_sp(),
-m_summary_sp(),
-m_validator_sp()
-{
-    SetSynthetic (synthetic_sp);
-}
-
-FormatCache::Entry::Entry (lldb::TypeValidatorImplSP validator_sp) :
-m_format_cached(false),
-m_summary_cached(false),
-m_synthetic_cached(false),
-m_format_sp(),
-m_summary_sp(),
-m_synthetic_sp()
-{
-    SetValidator (validator_sp);
-}
-
-FormatCache::Entry::Entry (lldb::TypeFormatImplSP format_sp, lldb::TypeSummaryImplSP summary_sp, lldb::SyntheticChildrenSP synthetic_sp, lldb::TypeValidatorImplSP validator_sp)
-{
-    SetFormat (format_sp);
-    SetSummary (summary_sp);
-    SetSynthetic (synthetic_sp);
-    SetValidator (validator_sp);
-}
-
 bool
 FormatCache::Entry::IsFormatCached ()
 {
@@ -158,138 +108,182 @@ FormatCache::Entry::SetValidator (lldb::TypeValidatorImplSP validator_sp)
     m_validator_sp = validator_sp;
 }
 
+size_t
+FormatCache::KeyHash::operator () (const Key &key) const
+{
+    // ConstStrings are unique, hashing the pointer is enough.
+    return std::hash<const char *>()(key.m_type.GetCString()) ^ ((size_t)key.m_use_dynamic * 0x9e3779b9);
+}
+
 FormatCache::FormatCache () :
-m_map(),
-m_mutex (Mutex::eMutexTypeRecursive)
-#ifdef LLDB_CONFIGURATION_DEBUG
-,m_cache_hits(0),m_cache_misses(0)
-#endif
+m_stripes(),
+m_cache_hits(0),
+m_cache_negative_hits(0),
+m_cache_misses(0)
 {
 }
 
-FormatCache::Entry&
-FormatCache::GetEntry (const ConstString& type)
+FormatCache::Stripe &
+FormatCache::GetStripe (const Key &key)
 {
-    auto i = m_map.find(type),
-    e = m_map.end();
-    if (i != e)
-        return i->second;
-    m_map[type] = FormatCache::Entry();
-    return m_map[type];
+    // The low bits of the string pointers are mostly the same, use the
+    // ones above them.
+    return m_stripes[(KeyHash()(key) >> 4) % k_num_stripes];
 }
 
-bool
-FormatCache::GetFormat (const ConstString& type,lldb::TypeFormatImplSP& format_sp)
+FormatCache::Entry *
+FormatCache::GetEntry (Stripe &stripe, const Key &key, uint32_t revision, bool create)
 {
-    Mutex::Locker lock(m_mutex);
-    auto entry = GetEntry(type);
-    if (entry.IsFormatCached())
+    auto pos = stripe.m_map.find(key);
+    if (pos != stripe.m_map.end())
     {
-#ifdef LLDB_CONFIGURATION_DEBUG
-        m_cache_hits++;
-#endif
-        format_sp = entry.GetFormat();
-        return true;
+        if (pos->second.GetRevision() == revision)
+            return &pos->second;
+        if (!create)
+            return nullptr;
+        pos->second = Entry(revision);
+        return &pos->second;
+    }
+    if (!create)
+        return nullptr;
+    return &stripe.m_map.insert(std::make_pair(key, Entry(revision))).first->second;
+}
+
+void
+FormatCache::RecordLookup (bool found, bool negative)
+{
+    if (!found)
+        ++m_cache_misses;
+    else
+    {
+        ++m_cache_hits;
+        if (negative)
+            ++m_cache_negative_hits;
     }
-#ifdef LLDB_CONFIGURATION_DEBUG
-    m_cache_misses++;
-#endif
-    format_sp.reset();
-    return false;
 }
 
 bool
-FormatCache::GetSummary (const ConstString& type,lldb::TypeSummaryImplSP& summary_sp)
+FormatCache::GetFormat (const ConstString& type, lldb::DynamicValueType use_dynamic, uint32_t revision, lldb::TypeFormatImplSP& format_sp)
 {
-    Mutex::Locker lock(m_mutex);
-    auto entry = GetEntry(type);
-    if (entry.IsSummaryCached())
+    const Key key = { type, use_dynamic };
+    Stripe &stripe = GetStripe(key);
+    format_sp.reset();
+    bool found = false;
     {
-#ifdef LLDB_CONFIGURATION_DEBUG
-        m_cache_hits++;
-#endif
-        summary_sp = entry.GetSummary();
-        return true;
+        Mutex::Locker lock(stripe.m_mutex);
+        Entry *entry = GetEntry(stripe, key, revision, false);
+        if (entry && entry->IsFormatCached())
+        {
+            format_sp = entry->GetFormat();
+            found = true;
+        }
     }
-#ifdef LLDB_CONFIGURATION_DEBUG
-    m_cache_misses++;
-#endif
-    summary_sp.reset();
-    return false;
+    RecordLookup(found, !format_sp);
+    return found;
 }
 
 bool
-FormatCache::GetSynthetic (const ConstString& type,lldb::SyntheticChildrenSP& synthetic_sp)
+FormatCache::GetSummary (const ConstString& type, lldb::DynamicValueType use_dynamic, uint32_t revision, lldb::TypeSummaryImplSP& summary_sp)
 {
-    Mutex::Locker lock(m_mutex);
-    auto entry = GetEntry(type);
-    if (entry.IsSyntheticCached())
+    const Key key = { type, use_dynamic };
+    Stripe &stripe = GetStripe(key);
+    summary_sp.reset();
+    bool found = false;
     {
-#ifdef LLDB_CONFIGURATION_DEBUG
-        m_cache_hits++;
-#endif
-        synthetic_sp = entry.GetSynthetic();
-        return true;
+        Mutex::Locker lock(stripe.m_mutex);
+        Entry *entry = GetEntry(stripe, key, revision, false);
+        if (entry && entry->IsSummaryCached())
+        {
+            summary_sp = entry->GetSummary();
+            found = true;
+        }
     }
-#ifdef LLDB_CONFIGURATION_DEBUG
-    m_cache_misses++;
-#endif
-    synthetic_sp.reset();
-    return false;
+    RecordLookup(found, !summary_sp);
+    return found;
 }
 
 bool
-FormatCache::GetValidator (const ConstString& type,lldb::TypeValidatorImplSP& validator_sp)
+FormatCache::GetSynthetic (const ConstString& type, lldb::DynamicValueType use_dynamic, uint32_t revision, lldb::SyntheticChildrenSP& synthetic_sp)
 {
-    Mutex::Locker lock(m_mutex);
-    auto entry = GetEntry(type);
-    if (entry.IsValidatorCached())
+    const Key key = { type, use_dynamic };
+    Stripe &stripe = GetStripe(key);
+    synthetic_sp.reset();
+    bool found = false;
     {
-#ifdef LLDB_CONFIGURATION_DEBUG
-        m_cache_hits++;
-#endif
-        validator_sp = entry.GetValidator();
-        return true;
+        Mutex::Locker lock(stripe.m_mutex);
+        Entry *entry = GetEntry(stripe, key, revision, false);
+        if (entry && entry->IsSyntheticCached())
+        {
+            synthetic_sp = entry->GetSynthetic();
+            found = true;
+        }
     }
-#ifdef LLDB_CONFIGURATION_DEBUG
-    m_cache_misses++;
-#endif
+    RecordLookup(found, !synthetic_sp);
+    return found;
+}
+
+bool
+FormatCache::GetValidator (const ConstString& type, lldb::DynamicValueType use_dynamic, uint32_t revision, lldb::TypeValidatorImplSP& validator_sp)
+{
+    const Key key = { type, use_dynamic };
+    Stripe &stripe = GetStripe(key);
     validator_sp.reset();
-    return false;
+    bool found = false;
+    {
+        Mutex::Locker lock(stripe.m_mutex);
+        Entry *entry = GetEntry(stripe, key, revision, false);
+        if (entry && entry->IsValidatorCached())
+        {
+            validator_sp = entry->GetValidator();
+            found = true;
+        }
+    }
+    RecordLookup(found, !validator_sp);
+    return found;
 }
 
 void
-FormatCache::SetFormat (const ConstString& type,lldb::TypeFormatImplSP& format_sp)
+FormatCache::SetFormat (const ConstString& type, lldb::DynamicValueType use_dynamic, uint32_t revision, lldb::TypeFormatImplSP& format_sp)
 {
-    Mutex::Locker lock(m_mutex);
-    GetEntry(type).SetFormat(format_sp);
+    const Key key = { type, use_dynamic };
+    Stripe &stripe = GetStripe(key);
+    Mutex::Locker lock(stripe.m_mutex);
+    GetEntry(stripe, key, revision, true)->SetFormat(format_sp);
 }
 
 void
-FormatCache::SetSummary (const ConstString& type,lldb::TypeSummaryImplSP& summary_sp)
+FormatCache::SetSummary (const ConstString& type, lldb::DynamicValueType use_dynamic, uint32_t revision, lldb::TypeSummaryImplSP& summary_sp)
 {
-    Mutex::Locker lock(m_mutex);
-    GetEntry(type).SetSummary(summary_sp);
+    const Key key = { type, use_dynamic };
+    Stripe &stripe = GetStripe(key);
+    Mutex::Locker lock(stripe.m_mutex);
+    GetEntry(stripe, key, revision, true)->SetSummary(summary_sp);
 }
 
 void
-FormatCache::SetSynthetic (const ConstString& type,lldb::SyntheticChildrenSP& synthetic_sp)
+FormatCache::SetSynthetic (const ConstString& type, lldb::DynamicValueType use_dynamic, uint32_t revision, lldb::SyntheticChildrenSP& synthetic_sp)
 {
-    Mutex::Locker lock(m_mutex);
-    GetEntry(type).SetSynthetic(synthetic_sp);
+    const Key key = { type, use_dynamic };
+    Stripe &stripe = GetStripe(key);
+    Mutex::Locker lock(stripe.m_mutex);
+    GetEntry(stripe, key, revision, true)->SetSynthetic(synthetic_sp);
 }
 
 void
-FormatCache::SetValidator (const ConstString& type,lldb::TypeValidatorImplSP& validator_sp)
+FormatCache::SetValidator (const ConstString& type, lldb::DynamicValueType use_dynamic, uint32_t revision, lldb::TypeValidatorImplSP& validator_sp)
 {
-    Mutex::Locker lock(m_mutex);
-    GetEntry(type).SetValidator(validator_sp);
+    const Key key = { type, use_dynamic };
+    Stripe &stripe = GetStripe(key);
+    Mutex::Locker lock(stripe.m_mutex);
+    GetEntry(stripe, key, revision, true)->SetValidator(validator_sp);
 }
 
 void
 FormatCache::Clear ()
 {
-    Mutex::Locker lock(m_mutex);
-    m_map.clear();
+    for (Stripe &stripe : m_stripes)
+    {
+        Mutex::Locker lock(stripe.m_mutex);
+        stripe.m_map.clear();
+    }
 }
-
@@ -743,6 +743,9 @@ FormatManager::GetFormat (ValueObject& valobj,
                           lldb::DynamicValueType use_dynamic)
 {
     FormattersMatchData match_data(valobj, use_dynamic);
+    // Tag what is cached with the revision the search starts with, a search
+    // racing with a change of the formatters doesn't cache a stale result.
+    const uint32_t revision = GetCurrentRevision();
     
     TypeFormatImplSP retval;
     Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_DATAFORMATTERS));
@@ -750,13 +753,13 @@ FormatManager::GetFormat (ValueObject& valobj,
     {
         if (log)
             log->Printf("\n\n[FormatManager::GetFormat] Looking into cache for type %s", match_data.GetTypeForCache().AsCString("<invalid>"));
-        if (m_format_cache.GetFormat(match_data.GetTypeForCache(),retval))
+        if (m_format_cache.GetFormat(match_data.GetTypeForCache(),match_data.GetDynamicValueType(),revision,retval))
         {
             if (log)
             {
                 log->Printf("[FormatManager::GetFormat] Cache search success. Returning.");
                 if (log->GetDebug())
-                    log->Printf("[FormatManager::GetFormat] Cache hits: %" PRIu64 " - Cache Misses: %" PRIu64, m_format_cache.GetCacheHits(), m_format_cache.GetCacheMisses());
+                    log->Printf("[FormatManager::GetFormat] Cache hits: %" PRIu64 " (%" PRIu64 " negative) - Cache Misses: %" PRIu64, m_format_cache.GetCacheHits(), m_format_cache.GetCacheNegativeHits(), m_format_cache.GetCacheMisses());
             }
             return retval;
         }
@@ -777,12 +780,6 @@ FormatManager::GetFormat (ValueObject& valobj,
                     break;
             }
         }
-        if (retval)
-        {
-            if (log)
-                log->Printf("[FormatManager::GetFormat] Language search success. Returning.");
-            return retval;
-        }
     }
     if (!retval)
     {
@@ -797,10 +794,10 @@ FormatManager::GetFormat (ValueObject& valobj,
             log->Printf("[FormatManager::GetFormat] Caching %p for type %s",
                         static_cast<void*>(retval.get()),
                         match_data.GetTypeForCache().AsCString("<invalid>"));
-        m_format_cache.SetFormat(match_data.GetTypeForCache(),retval);
+        m_format_cache.SetFormat(match_data.GetTypeForCache(),match_data.GetDynamicValueType(),revision,retval);
     }
     if (log && log->GetDebug())
-        log->Printf("[FormatManager::GetFormat] Cache hits: %" PRIu64 " - Cache Misses: %" PRIu64, m_format_cache.GetCacheHits(), m_format_cache.GetCacheMisses());
+        log->Printf("[FormatManager::GetFormat] Cache hits: %" PRIu64 " (%" PRIu64 " negative) - Cache Misses: %" PRIu64, m_format_cache.GetCacheHits(), m_format_cache.GetCacheNegativeHits(), m_format_cache.GetCacheMisses());
     return retval;
 }
 
@@ -826,6 +823,9 @@ FormatManager::GetSummaryFormat (ValueObject& valobj,
                                  lldb::DynamicValueType use_dynamic)
 {
     FormattersMatchData match_data(valobj, use_dynamic);
+    // Tag what is cached with the revision the search starts with, a search
+    // racing with a change of the formatters doesn't cache a stale result.
+    const uint32_t revision = GetCurrentRevision();
     
     TypeSummaryImplSP retval;
     Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_DATAFORMATTERS));
@@ -833,13 +833,13 @@ FormatManager::GetSummaryFormat (ValueObject& valobj,
     {
         if (log)
             log->Printf("\n\n[FormatManager::GetSummaryFormat] Looking into cache for type %s", match_data.GetTypeForCache().AsCString("<invalid>"));
-        if (m_format_cache.GetSummary(match_data.GetTypeForCache(),retval))
+        if (m_format_cache.GetSummary(match_data.GetTypeForCache(),match_data.GetDynamicValueType(),revision,retval))
         {
             if (log)
             {
                 log->Printf("[FormatManager::GetSummaryFormat] Cache search success. Returning.");
                 if (log->GetDebug())
-                    log->Printf("[FormatManager::GetSummaryFormat] Cache hits: %" PRIu64 " - Cache Misses: %" PRIu64, m_format_cache.GetCacheHits(), m_format_cache.GetCacheMisses());
+                    log->Printf("[FormatManager::GetSummaryFormat] Cache hits: %" PRIu64 " (%" PRIu64 " negative) - Cache Misses: %" PRIu64, m_format_cache.GetCacheHits(), m_format_cache.GetCacheNegativeHits(), m_format_cache.GetCacheMisses());
             }
             return retval;
         }
@@ -860,12 +860,6 @@ FormatManager::GetSummaryFormat (ValueObject& valobj,
                     break;
             }
         }
-        if (retval)
-        {
-            if (log)
-                log->Printf("[FormatManager::GetSummaryFormat] Language search success. Returning.");
-            return retval;
-        }
     }
     if (!retval)
     {
@@ -880,10 +874,10 @@ FormatManager::GetSummaryFormat (ValueObject& valobj,
             log->Printf("[FormatManager::GetSummaryFormat] Caching %p for type %s",
                         static_cast<void*>(retval.get()),
                         match_data.GetTypeForCache().AsCString("<invalid>"));
-        m_format_cache.SetSummary(match_data.GetTypeForCache(),retval);
+        m_format_cache.SetSummary(match_data.GetTypeForCache(),match_data.GetDynamicValueType(),revision,retval);
     }
     if (log && log->GetDebug())
-        log->Printf("[FormatManager::GetSummaryFormat] Cache hits: %" PRIu64 " - Cache Misses: %" PRIu64, m_format_cache.GetCacheHits(), m_format_cache.GetCacheMisses());
+        log->Printf("[FormatManager::GetSummaryFormat] Cache hits: %" PRIu64 " (%" PRIu64 " negative) - Cache Misses: %" PRIu64, m_format_cache.GetCacheHits(), m_format_cache.GetCacheNegativeHits(), m_format_cache.GetCacheMisses());
     return retval;
 }
 
@@ -910,6 +904,9 @@ FormatManager::GetSyntheticChildren (ValueObject& valobj,
                                      lldb::DynamicValueType use_dynamic)
 {
     FormattersMatchData match_data(valobj, use_dynamic);
+    // Tag what is cached with the revision the search starts with, a search
+    // racing with a change of the formatters doesn't cache a stale result.
+    const uint32_t revision = GetCurrentRevision();
     
     SyntheticChildrenSP retval;
     Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_DATAFORMATTERS));
@@ -917,13 +914,13 @@ FormatManager::GetSyntheticChildren (ValueObject& valobj,
     {
         if (log)
             log->Printf("\n\n[FormatManager::GetSyntheticChildren] Looking into cache for type %s", match_data.GetTypeForCache().AsCString("<invalid>"));
-        if (m_format_cache.GetSynthetic(match_data.GetTypeForCache(),retval))
+        if (m_format_cache.GetSynthetic(match_data.GetTypeForCache(),match_data.GetDynamicValueType(),revision,retval))
         {
             if (log)
             {
                 log->Printf("[FormatManager::GetSyntheticChildren] Cache search success. Returning.");
                 if (log->GetDebug())
-                    log->Printf("[FormatManager::GetSyntheticChildren] Cache hits: %" PRIu64 " - Cache Misses: %" PRIu64, m_format_cache.GetCacheHits(), m_format_cache.GetCacheMisses());
+                    log->Printf("[FormatManager::GetSyntheticChildren] Cache hits: %" PRIu64 " (%" PRIu64 " negative) - Cache Misses: %" PRIu64, m_format_cache.GetCacheHits(), m_format_cache.GetCacheNegativeHits(), m_format_cache.GetCacheMisses());
             }
             return retval;
         }
@@ -944,12 +941,6 @@ FormatManager::GetSyntheticChildren (ValueObject& valobj,
                     break;
             }
         }
-        if (retval)
-        {
-            if (log)
-                log->Printf("[FormatManager::GetSyntheticChildren] Language search success. Returning.");
-            return retval;
-        }
     }
     if (!retval)
     {
@@ -964,10 +955,10 @@ FormatManager::GetSyntheticChildren (ValueObject& valobj,
             log->Printf("[FormatManager::GetSyntheticChildren] Caching %p for type %s",
                         static_cast<void*>(retval.get()),
                         match_data.GetTypeForCache().AsCString("<invalid>"));
-        m_format_cache.SetSynthetic(match_data.GetTypeForCache(),retval);
+        m_format_cache.SetSynthetic(match_data.GetTypeForCache(),match_data.GetDynamicValueType(),revision,retval);
     }
     if (log && log->GetDebug())
-        log->Printf("[FormatManager::GetSyntheticChildren] Cache hits: %" PRIu64 " - Cache Misses: %" PRIu64, m_format_cache.GetCacheHits(), m_format_cache.GetCacheMisses());
+        log->Printf("[FormatManager::GetSyntheticChildren] Cache hits: %" PRIu64 " (%" PRIu64 " negative) - Cache Misses: %" PRIu64, m_format_cache.GetCacheHits(), m_format_cache.GetCacheNegativeHits(), m_format_cache.GetCacheMisses());
     return retval;
 }
 #endif
@@ -977,6 +968,9 @@ FormatManager::GetValidator (ValueObject& valobj,
                              lldb::DynamicValueType use_dynamic)
 {
     FormattersMatchData match_data(valobj, use_dynamic);
+    // Tag what is cached with the revision the search starts with, a search
+    // racing with a change of the formatters doesn't cache a stale result.
+    const uint32_t revision = GetCurrentRevision();
     
     TypeValidatorImplSP retval;
     Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_DATAFORMATTERS));
@@ -984,13 +978,13 @@ FormatManager::GetValidator (ValueObject& valobj,
     {
         if (log)
             log->Printf("\n\n[FormatManager::GetValidator] Looking into cache for type %s", match_data.GetTypeForCache().AsCString("<invalid>"));
-        if (m_format_cache.GetValidator(match_data.GetTypeForCache(),retval))
+        if (m_format_cache.GetValidator(match_data.GetTypeForCache(),match_data.GetDynamicValueType(),revision,retval))
         {
             if (log)
             {
                 log->Printf("[FormatManager::GetValidator] Cache search success. Returning.");
                 if (log->GetDebug())
-                    log->Printf("[FormatManager::GetValidator] Cache hits: %" PRIu64 " - Cache Misses: %" PRIu64, m_format_cache.GetCacheHits(), m_format_cache.GetCacheMisses());
+                    log->Printf("[FormatManager::GetValidator] Cache hits: %" PRIu64 " (%" PRIu64 " negative) - Cache Misses: %" PRIu64, m_format_cache.GetCacheHits(), m_format_cache.GetCacheNegativeHits(), m_format_cache.GetCacheMisses());
             }
             return retval;
         }
@@ -1011,12 +1005,6 @@ FormatManager::GetValidator (ValueObject& valobj,
                     break;
             }
         }
-        if (retval)
-        {
-            if (log)
-                log->Printf("[FormatManager::GetValidator] Language search success. Returning.");
-            return retval;
-        }
     }
     if (!retval)
     {
@@ -1031,10 +1019,10 @@ FormatManager::GetValidator (ValueObject& valobj,
             log->Printf("[FormatManager::GetValidator] Caching %p for type %s",
                         static_cast<void*>(retval.get()),
                         match_data.GetTypeForCache().AsCString("<invalid>"));
-        m_format_cache.SetValidator(match_data.GetTypeForCache(),retval);
+        m_format_cache.SetValidator(match_data.GetTypeForCache(),match_data.GetDynamicValueType(),revision,retval);
     }
     if (log && log->GetDebug())
-        log->Printf("[FormatManager::GetValidator] Cache hits: %" PRIu64 " - Cache Misses: %" PRIu64, m_format_cache.GetCacheHits(), m_format_cache.GetCacheMisses());
+        log->Printf("[FormatManager::GetValidator] Cache hits: %" PRIu64 " (%" PRIu64 " negative) - Cache Misses: %" PRIu64, m_format_cache.GetCacheHits(), m_format_cache.GetCacheNegativeHits(), m_format_cache.GetCacheMisses());
     return retval;
 }
 
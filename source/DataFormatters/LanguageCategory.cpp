@@ -13,6 +13,7 @@
 // C++ Includes
 // Other libraries and framework includes
 // Project includes
+#include "lldb/DataFormatters/DataVisualization.h"
 #include "lldb/DataFormatters/FormatManager.h"
 #include "lldb/DataFormatters/TypeCategory.h"
 #include "lldb/DataFormatters/TypeFormat.h"
@@ -54,9 +55,11 @@ LanguageCategory::Get (FormattersMatchData& match_data,
     if (!IsEnabled())
         return false;
 
+    const uint32_t revision = DataVisualization::GetCurrentRevision();
+
     if (match_data.GetTypeForCache())
     {
-        if (m_format_cache.GetFormat(match_data.GetTypeForCache(), format_sp))
+        if (m_format_cache.GetFormat(match_data.GetTypeForCache(), match_data.GetDynamicValueType(), revision, format_sp))
             return format_sp.get() != nullptr;
     }
 
@@ -64,7 +67,7 @@ LanguageCategory::Get (FormattersMatchData& match_data,
     bool result = m_category_sp->Get(valobj, match_data.GetMatchesVector(), format_sp);
     if (match_data.GetTypeForCache() && (!format_sp || !format_sp->NonCacheable()))
     {
-        m_format_cache.SetFormat(match_data.GetTypeForCache(), format_sp);
+        m_format_cache.SetFormat(match_data.GetTypeForCache(), match_data.GetDynamicValueType(), revision, format_sp);
     }
     return result;
 }
@@ -79,9 +82,11 @@ LanguageCategory::Get (FormattersMatchData& match_data,
     if (!IsEnabled())
         return false;
 
+    const uint32_t revision = DataVisualization::GetCurrentRevision();
+
     if (match_data.GetTypeForCache())
     {
-        if (m_format_cache.GetSummary(match_data.GetTypeForCache(), format_sp))
+        if (m_format_cache.GetSummary(match_data.GetTypeForCache(), match_data.GetDynamicValueType(), revision, format_sp))
             return format_sp.get() != nullptr;
     }
     
@@ -89,7 +94,7 @@ LanguageCategory::Get (FormattersMatchData& match_data,
     bool result = m_category_sp->Get(valobj, match_data.GetMatchesVector(), format_sp);
     if (match_data.GetTypeForCache() && (!format_sp || !format_sp->NonCacheable()))
     {
-        m_format_cache.SetSummary(match_data.GetTypeForCache(), format_sp);
+        m_format_cache.SetSummary(match_data.GetTypeForCache(), match_data.GetDynamicValueType(), revision, format_sp);
     }
     return result;
 }
@@ -104,9 +109,11 @@ LanguageCategory::Get (FormattersMatchData& match_data,
     if (!IsEnabled())
         return false;
 
+    const uint32_t revision = DataVisualization::GetCurrentRevision();
+
     if (match_data.GetTypeForCache())
     {
-        if (m_format_cache.GetSynthetic(match_data.GetTypeForCache(), format_sp))
+        if (m_format_cache.GetSynthetic(match_data.GetTypeForCache(), match_data.GetDynamicValueType(), revision, format_sp))
             return format_sp.get() != nullptr;
     }
     
@@ -114,7 +121,7 @@ LanguageCategory::Get (FormattersMatchData& match_data,
     bool result = m_category_sp->Get(valobj, match_data.GetMatchesVector(), format_sp);
     if (match_data.GetTypeForCache() && (!format_sp || !format_sp->NonCacheable()))
     {
-        m_format_cache.SetSynthetic(match_data.GetTypeForCache(), format_sp);
+        m_format_cache.SetSynthetic(match_data.GetTypeForCache(), match_data.GetDynamicValueType(), revision, format_sp);
     }
     return result;
 }
@@ -129,9 +136,11 @@ LanguageCategory::Get (FormattersMatchData& match_data,
     if (!IsEnabled())
         return false;
 
+    const uint32_t revision = DataVisualization::GetCurrentRevision();
+
     if (match_data.GetTypeForCache())
     {
-        if (m_format_cache.GetValidator(match_data.GetTypeForCache(), format_sp))
+        if (m_format_cache.GetValidator(match_data.GetTypeForCache(), match_data.GetDynamicValueType(), revision, format_sp))
             return format_sp.get() != nullptr;
     }
     
@@ -139,7 +148,7 @@ LanguageCategory::Get (FormattersMatchData& match_data,
     bool result = m_category_sp->Get(valobj, match_data.GetMatchesVector(), format_sp);
     if (match_data.GetTypeForCache() && (!format_sp || !format_sp->NonCacheable()))
     {
-        m_format_cache.SetValidator(match_data.GetTypeForCache(), format_sp);
+        m_format_cache.SetValidator(match_data.GetTypeForCache(), match_data.GetDynamicValueType(), revision, format_sp);
     }
     return result;
 }
@@ -162,7 +171,7 @@ LanguageCategory::GetHardcoded (FormatManager& fmt_mgr,
     }
     if (match_data.GetTypeForCache() && (!format_sp || !format_sp->NonCacheable()))
     {
-        m_format_cache.SetFormat(match_data.GetTypeForCache(), format_sp);
+        m_format_cache.SetFormat(match_data.GetTypeForCache(), match_data.GetDynamicValueType(), fmt_mgr.GetCurrentRevision(), format_sp);
     }
     return format_sp.get() != nullptr;
 }
@@ -185,7 +194,7 @@ LanguageCategory::GetHardcoded (FormatManager& fmt_mgr,
     }
     if (match_data.GetTypeForCache() && (!format_sp || !format_sp->NonCacheable()))
     {
-        m_format_cache.SetSummary(match_data.GetTypeForCache(), format_sp);
+        m_format_cache.SetSummary(match_data.GetTypeForCache(), match_data.GetDynamicValueType(), fmt_mgr.GetCurrentRevision(), format_sp);
     }
     return format_sp.get() != nullptr;
 }
@@ -208,7 +217,7 @@ LanguageCategory::GetHardcoded (FormatManager& fmt_mgr,
     }
     if (match_data.GetTypeForCache() && (!format_sp || !format_sp->NonCacheable()))
     {
-        m_format_cache.SetSynthetic(match_data.GetTypeForCache(), format_sp);
+        m_format_cache.SetSynthetic(match_data.GetTypeForCache(), match_data.GetDynamicValueType(), fmt_mgr.GetCurrentRevision(), format_sp);
     }
     return format_sp.get() != nullptr;
 }
@@ -231,7 +240,7 @@ LanguageCategory::GetHardcoded (FormatManager& fmt_mgr,
     }
     if (match_data.GetTypeForCache() && (!format_sp || !format_sp->NonCacheable()))
     {
-        m_format_cache.SetValidator(match_data.GetTypeForCache(), format_sp);
+        m_format_cache.SetValidator(match_data.GetTypeForCache(), match_data.GetDynamicValueType(), fmt_mgr.GetCurrentRevision(), format_sp);
     }
     return format_sp.get() != nullptr;
 }
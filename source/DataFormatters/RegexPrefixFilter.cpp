@@ -0,0 +1,201 @@
+//===-- RegexPrefixFilter.cpp -----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C Includes
+#include <string.h>
+
+// C++ Includes
+#include <algorithm>
+
+// Other libraries and framework includes
+
+// Project includes
+#include "lldb/DataFormatters/RegexPrefixFilter.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    // The characters that are special outside of bracket expressions.
+    const char *k_metachars = ".[]()*+?{}|^$\\";
+
+    // Skip the bracket expression starting at \a p, returns nullptr if it
+    // isn't terminated.
+    const char *
+    SkipBracketExpression (const char *p)
+    {
+        ++p; // '['
+        if (*p == '^')
+            ++p;
+        if (*p == ']')
+            ++p;
+        while (*p && *p != ']')
+        {
+            // Character classes, collating symbols and equivalence classes
+            // like [:alpha:] can contain a ']'.
+            if (p[0] == '[' && (p[1] == ':' || p[1] == '.' || p[1] == '='))
+            {
+                const char terminator[3] = { p[1], ']', '\0' };
+                const char *end = ::strstr (p + 2, terminator);
+                if (end == nullptr)
+                    return nullptr;
+                p = end + 2;
+            }
+            else
+                ++p;
+        }
+        return *p ? p + 1 : nullptr;
+    }
+
+    // Returns true if the pattern has an alternation that isn't inside
+    // parentheses, the '^' then only anchors its first branch.
+    bool
+    HasTopLevelAlternation (const char *p)
+    {
+        int depth = 0;
+        while (*p)
+        {
+            switch (*p)
+            {
+                case '\\':
+                    if (p[1] == '\0')
+                        return true;
+                    p += 2;
+                    continue;
+                case '[':
+                    p = SkipBracketExpression (p);
+                    if (p == nullptr)
+                        return true;
+                    continue;
+                case '(':
+                    ++depth;
+                    break;
+                case ')':
+                    --depth;
+                    break;
+                case '|':
+                    if (depth <= 0)
+                        return true;
+                    break;
+                default:
+                    break;
+            }
+            ++p;
+        }
+        return false;
+    }
+}
+
+RegexPrefixFilter::RegexPrefixFilter () :
+    m_nodes (1),
+    m_size (0)
+{
+}
+
+void
+RegexPrefixFilter::Clear ()
+{
+    m_nodes.clear();
+    m_nodes.resize(1);
+    m_size = 0;
+}
+
+void
+RegexPrefixFilter::Append (const char *regex_text)
+{
+    const std::string prefix = GetLiteralPrefix (regex_text);
+    uint32_t node_idx = 0;
+    for (char c : prefix)
+    {
+        auto pos = m_nodes[node_idx].m_children.find(c);
+        if (pos != m_nodes[node_idx].m_children.end())
+        {
+            node_idx = pos->second;
+            continue;
+        }
+        const uint32_t child_idx = m_nodes.size();
+        m_nodes[node_idx].m_children[c] = child_idx;
+        m_nodes.push_back(Node());
+        node_idx = child_idx;
+    }
+    m_nodes[node_idx].m_indexes.push_back(m_size++);
+}
+
+void
+RegexPrefixFilter::GetCandidates (const char *name, std::vector<uint32_t> &indexes) const
+{
+    indexes.clear();
+    if (name == nullptr)
+        return;
+
+    // Each node has its indexes in increasing order, the result only needs
+    // sorting when more than one node contributed.
+    size_t num_contributing_nodes = 0;
+    uint32_t node_idx = 0;
+    for (const char *p = name; ; ++p)
+    {
+        const Node &node = m_nodes[node_idx];
+        if (!node.m_indexes.empty())
+        {
+            indexes.insert(indexes.end(), node.m_indexes.begin(), node.m_indexes.end());
+            ++num_contributing_nodes;
+        }
+        if (*p == '\0')
+            break;
+        auto pos = node.m_children.find(*p);
+        if (pos == node.m_children.end())
+            break;
+        node_idx = pos->second;
+    }
+
+    if (num_contributing_nodes > 1)
+        std::sort(indexes.begin(), indexes.end());
+}
+
+std::string
+RegexPrefixFilter::GetLiteralPrefix (const char *regex_text)
+{
+    std::string prefix;
+    if (regex_text == nullptr || regex_text[0] != '^' || HasTopLevelAlternation (regex_text))
+        return prefix;
+
+    const char *p = regex_text + 1;
+    while (*p)
+    {
+        char literal;
+        const char *next;
+        if (*p == '\\')
+        {
+            // Only escaped metacharacters are literal, others like \d or
+            // \< have special meanings in some regex libraries.
+            if (p[1] == '\0' || ::strchr (k_metachars, p[1]) == nullptr)
+                break;
+            literal = p[1];
+            next = p + 2;
+        }
+        else if (::strchr (k_metachars, *p) != nullptr)
+            break;
+        else
+        {
+            literal = *p;
+            next = p + 1;
+        }
+
+        // A quantifier can make the character optional, '+' still matches
+        // it at least once but nothing after it is at a known position.
+        if (*next == '*' || *next == '?' || *next == '{')
+            break;
+        prefix.push_back(literal);
+        if (*next == '+')
+            break;
+        p = next;
+    }
+    return prefix;
+}
@@ -11,6 +11,9 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
+#include <vector>
+
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Core/Stream.h"
@@ -754,19 +757,26 @@ ValueObjectPrinter::PrintChildren (bool value_printed,
     size_t num_children = GetMaxNumChildrenToPrint(print_dotdotdot);
     if (num_children)
     {
+        // Get the children a window at a time so the memory of children that
+        // are next to each other is read in one go.
+        const size_t children_window_size = 256;
+        std::vector<ValueObjectSP> children;
         bool any_children_printed = false;
         
-        for (size_t idx=0; idx<num_children; ++idx)
+        for (size_t start_idx=0; start_idx<num_children; start_idx+=children_window_size)
         {
-            ValueObjectSP child_sp(synth_m_valobj->GetChildAtIndex(idx, true));
-            if (child_sp)
+            synth_m_valobj->GetChildrenRange(start_idx, std::min(children_window_size, num_children - start_idx), children);
+            for (const ValueObjectSP &child_sp : children)
             {
-                if (!any_children_printed)
+                if (child_sp)
                 {
-                    PrintChildrenPreamble ();
-                    any_children_printed = true;
+                    if (!any_children_printed)
+                    {
+                        PrintChildrenPreamble ();
+                        any_children_printed = true;
+                    }
+                    PrintChild (child_sp, curr_ptr_depth);
                 }
-                PrintChild (child_sp, curr_ptr_depth);
             }
         }
         
@@ -129,6 +129,120 @@ NativeBreakpointList::DecRef (lldb::addr_t addr)
     return error;
 }
 
+void
+NativeBreakpointList::AddRefs (const std::vector<lldb::addr_t> &addrs, size_t size_hint, bool hardware, CreateBreakpointsFunc create_func, std::vector<Error> &errors)
+{
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    if (log)
+        log->Printf ("NativeBreakpointList::%s %" PRIu64 " addresses, size_hint = %lu, hardware = %s", __FUNCTION__, (uint64_t)addrs.size (), size_hint, hardware ? "true" : "false");
+
+    errors.assign (addrs.size (), Error ());
+
+    Mutex::Locker locker (m_mutex);
+
+    // Bump up the ref count of the existing breakpoints and gather the
+    // addresses that need a new one, each address only once.
+    std::map<lldb::addr_t, std::vector<size_t>> new_addr_indexes;
+    for (size_t i = 0; i < addrs.size (); ++i)
+    {
+        auto iter = m_breakpoints.find (addrs[i]);
+        if (iter != m_breakpoints.end ())
+            iter->second->AddRef ();
+        else
+            new_addr_indexes[addrs[i]].push_back (i);
+    }
+    if (new_addr_indexes.empty ())
+        return;
+
+    std::vector<lldb::addr_t> new_addrs;
+    new_addrs.reserve (new_addr_indexes.size ());
+    for (const auto &pair : new_addr_indexes)
+        new_addrs.push_back (pair.first);
+
+    std::vector<NativeBreakpointSP> breakpoints;
+    std::vector<Error> create_errors;
+    create_func (new_addrs, size_hint, hardware, breakpoints, create_errors);
+    assert (breakpoints.size () == new_addrs.size () && create_errors.size () == new_addrs.size () &&
+            "NativeBreakpoint create function returned the wrong number of results");
+
+    size_t new_idx = 0;
+    for (const auto &pair : new_addr_indexes)
+    {
+        const NativeBreakpointSP &breakpoint_sp = breakpoints[new_idx];
+        const Error &error = create_errors[new_idx++];
+        for (size_t i : pair.second)
+            errors[i] = error;
+        if (error.Fail ())
+            continue;
+
+        // Remember the breakpoint, with a reference for every time the
+        // address was given.
+        assert (breakpoint_sp && "NativeBreakpoint create function succeeded but returned NULL breakpoint");
+        for (size_t i = 1; i < pair.second.size (); ++i)
+            breakpoint_sp->AddRef ();
+        m_breakpoints.insert (BreakpointMap::value_type (pair.first, breakpoint_sp));
+    }
+}
+
+void
+NativeBreakpointList::DecRefs (const std::vector<lldb::addr_t> &addrs, std::vector<Error> &errors)
+{
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    if (log)
+        log->Printf ("NativeBreakpointList::%s %" PRIu64 " addresses", __FUNCTION__, (uint64_t)addrs.size ());
+
+    errors.assign (addrs.size (), Error ());
+
+    Mutex::Locker locker (m_mutex);
+
+    // Take the breakpoints without references left out of the list, the
+    // enabled software breakpoints among them are then disabled together.
+    std::vector<NativeBreakpointSP> removed;
+    std::vector<size_t> removed_indexes;
+    for (size_t i = 0; i < addrs.size (); ++i)
+    {
+        auto iter = m_breakpoints.find (addrs[i]);
+        if (iter == m_breakpoints.end ())
+        {
+            errors[i].SetErrorString ("breakpoint not found");
+            continue;
+        }
+
+        const int32_t new_ref_count = iter->second->DecRef ();
+        assert (new_ref_count >= 0 && "NativeBreakpoint ref count went negative");
+        if (new_ref_count > 0)
+            continue;
+
+        removed.push_back (iter->second);
+        removed_indexes.push_back (i);
+        m_breakpoints.erase (iter);
+    }
+
+    std::vector<SoftwareBreakpoint *> software_breakpoints;
+    std::vector<size_t> software_indexes;
+    for (size_t i = 0; i < removed.size (); ++i)
+    {
+        NativeBreakpoint &breakpoint = *removed[i];
+        if (!breakpoint.IsEnabled ())
+            continue;
+        if (breakpoint.IsSoftwareBreakpoint ())
+        {
+            software_breakpoints.push_back (static_cast<SoftwareBreakpoint *> (&breakpoint));
+            software_indexes.push_back (removed_indexes[i]);
+        }
+        else
+            errors[removed_indexes[i]] = breakpoint.Disable ();
+    }
+
+    if (software_breakpoints.empty ())
+        return;
+
+    std::vector<Error> disable_errors;
+    SoftwareBreakpoint::DisableSoftwareBreakpoints (software_breakpoints.front ()->m_process, software_breakpoints, disable_errors);
+    for (size_t i = 0; i < software_indexes.size (); ++i)
+        errors[software_indexes[i]] = disable_errors[i];
+}
+
 Error
 NativeBreakpointList::EnableBreakpoint (lldb::addr_t addr)
 {
@@ -64,6 +64,42 @@ NativeProcessProtocol::GetMemoryRegionInfo (lldb::addr_t load_addr, MemoryRegion
     return Error ("not implemented");
 }
 
+lldb_private::Error
+NativeProcessProtocol::ReadMemoryRanges (std::vector<MemoryRangeRead> &reads)
+{
+    Error error;
+    bool read_any = reads.empty ();
+    for (MemoryRangeRead &read : reads)
+    {
+        read.bytes_read = 0;
+        error = ReadMemory (read.addr, read.buf, read.size, read.bytes_read);
+        if (error.Fail ())
+            read.bytes_read = 0;
+        else
+            read_any = true;
+    }
+    return read_any ? Error () : error;
+}
+
+lldb_private::Error
+NativeProcessProtocol::ReadMemoryRangesWithoutTrap (std::vector<MemoryRangeRead> &reads)
+{
+    Error error = ReadMemoryRanges (reads);
+    if (error.Fail ())
+        return error;
+
+    for (const MemoryRangeRead &read : reads)
+    {
+        if (read.bytes_read > 0)
+        {
+            error = m_breakpoint_list.RemoveTrapsFromBuffer (read.addr, read.buf, read.bytes_read);
+            if (error.Fail ())
+                return error;
+        }
+    }
+    return Error ();
+}
+
 bool
 NativeProcessProtocol::GetExitStatus (ExitType *exit_type, int *status, std::string &exit_description)
 {
@@ -373,12 +409,40 @@ NativeProcessProtocol::SetSoftwareBreakpoint (lldb::addr_t addr, uint32_t size_h
             { return SoftwareBreakpoint::CreateSoftwareBreakpoint (*this, addr, size_hint, breakpoint_sp); });
 }
 
+void
+NativeProcessProtocol::SetSoftwareBreakpoints (const std::vector<lldb::addr_t> &addrs, uint32_t size_hint, std::vector<Error> &errors)
+{
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    if (log)
+        log->Printf ("NativeProcessProtocol::%s %" PRIu64 " addresses", __FUNCTION__, (uint64_t)addrs.size ());
+
+    m_breakpoint_list.AddRefs (addrs, size_hint, false,
+            [this] (const std::vector<lldb::addr_t> &addrs, size_t size_hint, bool /* hardware */, std::vector<NativeBreakpointSP> &breakpoints, std::vector<Error> &errors)
+            { SoftwareBreakpoint::CreateSoftwareBreakpoints (*this, addrs, size_hint, breakpoints, errors); },
+            errors);
+}
+
 Error
 NativeProcessProtocol::RemoveBreakpoint (lldb::addr_t addr)
 {
     return m_breakpoint_list.DecRef (addr);
 }
 
+void
+NativeProcessProtocol::SetBreakpoints (const std::vector<lldb::addr_t> &addrs, uint32_t size, bool hardware, std::vector<Error> &errors)
+{
+    errors.clear ();
+    errors.reserve (addrs.size ());
+    for (lldb::addr_t addr : addrs)
+        errors.push_back (SetBreakpoint (addr, size, hardware));
+}
+
+void
+NativeProcessProtocol::RemoveBreakpoints (const std::vector<lldb::addr_t> &addrs, std::vector<Error> &errors)
+{
+    m_breakpoint_list.DecRefs (addrs, errors);
+}
+
 Error
 NativeProcessProtocol::EnableBreakpoint (lldb::addr_t addr)
 {
@@ -16,6 +16,8 @@
 
 #include "lldb/Host/common/NativeProcessProtocol.h"
 
+#include <algorithm>
+
 using namespace lldb_private;
 
 // -------------------------------------------------------------------
@@ -89,6 +91,185 @@ SoftwareBreakpoint::CreateSoftwareBreakpoint (NativeProcessProtocol &process, ll
     return Error ();
 }
 
+void
+SoftwareBreakpoint::CreateSoftwareBreakpoints (NativeProcessProtocol &process, const std::vector<lldb::addr_t> &addrs, size_t size_hint,
+                                               std::vector<NativeBreakpointSP> &breakpoints, std::vector<Error> &errors)
+{
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    if (log)
+        log->Printf ("SoftwareBreakpoint::%s %" PRIu64 " addresses", __FUNCTION__, (uint64_t)addrs.size ());
+
+    breakpoints.assign (addrs.size (), NativeBreakpointSP ());
+    errors.assign (addrs.size (), Error ());
+
+    size_t bp_opcode_size = 0;
+    const uint8_t *bp_opcode_bytes = NULL;
+    Error error = process.GetSoftwareBreakpointTrapOpcode (size_hint, bp_opcode_size, bp_opcode_bytes);
+
+    // Addresses whose trap would overlap the trap of the previous address,
+    // and anything unusual about the trap opcode, go through the one at a
+    // time path, which also reports the errors.
+    std::vector<size_t> batch_indexes;
+    std::vector<size_t> single_indexes;
+    if (error.Fail () || bp_opcode_size == 0 || bp_opcode_size > MAX_TRAP_OPCODE_SIZE || !bp_opcode_bytes)
+    {
+        for (size_t i = 0; i < addrs.size (); ++i)
+            single_indexes.push_back (i);
+    }
+    else
+    {
+        std::vector<size_t> order (addrs.size ());
+        for (size_t i = 0; i < addrs.size (); ++i)
+            order[i] = i;
+        std::sort (order.begin (), order.end (), [&addrs] (size_t lhs, size_t rhs) { return addrs[lhs] < addrs[rhs]; });
+
+        lldb::addr_t prev_addr = LLDB_INVALID_ADDRESS;
+        for (size_t i : order)
+        {
+            const lldb::addr_t addr = addrs[i];
+            if (addr == LLDB_INVALID_ADDRESS ||
+                (prev_addr != LLDB_INVALID_ADDRESS && addr < prev_addr + bp_opcode_size && prev_addr < addr + bp_opcode_size))
+                single_indexes.push_back (i);
+            else
+            {
+                batch_indexes.push_back (i);
+                prev_addr = addr;
+            }
+        }
+    }
+
+    // Save the original opcodes of all the addresses.
+    std::vector<uint8_t> saved_opcodes (batch_indexes.size () * MAX_TRAP_OPCODE_SIZE);
+    std::vector<NativeProcessProtocol::MemoryRangeRead> reads;
+    reads.reserve (batch_indexes.size ());
+    for (size_t i = 0; i < batch_indexes.size (); ++i)
+    {
+        NativeProcessProtocol::MemoryRangeRead read = { addrs[batch_indexes[i]], &saved_opcodes[i * MAX_TRAP_OPCODE_SIZE], bp_opcode_size, 0 };
+        reads.push_back (read);
+    }
+    process.ReadMemoryRanges (reads);
+
+    // Write the traps.
+    std::vector<size_t> written;
+    for (size_t i = 0; i < batch_indexes.size (); ++i)
+    {
+        const size_t idx = batch_indexes[i];
+        if (reads[i].bytes_read != bp_opcode_size)
+        {
+            errors[idx].SetErrorStringWithFormat ("SoftwareBreakpoint::%s failed to read memory while attempting to set breakpoint at 0x%" PRIx64,
+                                                  __FUNCTION__, addrs[idx]);
+            continue;
+        }
+
+        size_t bytes_written = 0;
+        errors[idx] = process.WriteMemory (addrs[idx], bp_opcode_bytes, bp_opcode_size, bytes_written);
+        if (errors[idx].Success () && bytes_written != bp_opcode_size)
+            errors[idx].SetErrorStringWithFormat ("SoftwareBreakpoint::%s failed write memory while attempting to set breakpoint: attempted to write %lu bytes but only wrote %" PRIu64,
+                                                  __FUNCTION__, bp_opcode_size, (uint64_t)bytes_written);
+        if (errors[idx].Success ())
+            written.push_back (i);
+    }
+
+    // Verify the traps made it to memory.
+    std::vector<uint8_t> verify_opcodes (written.size () * MAX_TRAP_OPCODE_SIZE);
+    std::vector<NativeProcessProtocol::MemoryRangeRead> verify_reads;
+    verify_reads.reserve (written.size ());
+    for (size_t i = 0; i < written.size (); ++i)
+    {
+        NativeProcessProtocol::MemoryRangeRead read = { reads[written[i]].addr, &verify_opcodes[i * MAX_TRAP_OPCODE_SIZE], bp_opcode_size, 0 };
+        verify_reads.push_back (read);
+    }
+    process.ReadMemoryRanges (verify_reads);
+
+    for (size_t i = 0; i < written.size (); ++i)
+    {
+        const size_t batch_idx = written[i];
+        const size_t idx = batch_indexes[batch_idx];
+        if (verify_reads[i].bytes_read != bp_opcode_size || ::memcmp (bp_opcode_bytes, verify_reads[i].buf, bp_opcode_size) != 0)
+        {
+            errors[idx].SetErrorStringWithFormat ("SoftwareBreakpoint::%s: verification of software breakpoint writing failed - trap opcodes not successfully read back after writing when setting breakpoint at 0x%" PRIx64,
+                                                  __FUNCTION__, addrs[idx]);
+            continue;
+        }
+        breakpoints[idx].reset (new SoftwareBreakpoint (process, addrs[idx], &saved_opcodes[batch_idx * MAX_TRAP_OPCODE_SIZE], bp_opcode_bytes, bp_opcode_size));
+    }
+
+    for (size_t idx : single_indexes)
+        errors[idx] = CreateSoftwareBreakpoint (process, addrs[idx], size_hint, breakpoints[idx]);
+
+    if (log)
+    {
+        for (size_t i = 0; i < addrs.size (); ++i)
+        {
+            if (errors[i].Fail ())
+                log->Printf ("SoftwareBreakpoint::%s addr = 0x%" PRIx64 " -- FAILED: %s", __FUNCTION__, addrs[i], errors[i].AsCString ());
+        }
+    }
+}
+
+void
+SoftwareBreakpoint::DisableSoftwareBreakpoints (NativeProcessProtocol &process, const std::vector<SoftwareBreakpoint *> &breakpoints,
+                                                std::vector<Error> &errors)
+{
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    if (log)
+        log->Printf ("SoftwareBreakpoint::%s %" PRIu64 " breakpoints", __FUNCTION__, (uint64_t)breakpoints.size ());
+
+    errors.assign (breakpoints.size (), Error ());
+
+    // Read the current opcodes of all the breakpoints.
+    std::vector<uint8_t> opcodes (breakpoints.size () * MAX_TRAP_OPCODE_SIZE);
+    std::vector<NativeProcessProtocol::MemoryRangeRead> reads;
+    reads.reserve (breakpoints.size ());
+    for (size_t i = 0; i < breakpoints.size (); ++i)
+    {
+        NativeProcessProtocol::MemoryRangeRead read = { breakpoints[i]->m_addr, &opcodes[i * MAX_TRAP_OPCODE_SIZE], breakpoints[i]->m_opcode_size, 0 };
+        reads.push_back (read);
+    }
+    process.ReadMemoryRanges (reads);
+
+    // Put the original opcodes back where the traps still are.
+    std::vector<bool> break_op_found (breakpoints.size (), false);
+    for (size_t i = 0; i < breakpoints.size (); ++i)
+    {
+        const SoftwareBreakpoint &bp = *breakpoints[i];
+        if (reads[i].bytes_read != bp.m_opcode_size)
+        {
+            errors[i].SetErrorStringWithFormat ("SoftwareBreakpoint::%s addr=0x%" PRIx64 ": failed to read the breakpoint opcode", __FUNCTION__, bp.m_addr);
+            continue;
+        }
+        if (::memcmp (reads[i].buf, bp.m_trap_opcodes, bp.m_opcode_size) != 0)
+            continue;
+
+        break_op_found[i] = true;
+        size_t bytes_written = 0;
+        errors[i] = process.WriteMemory (bp.m_addr, bp.m_saved_opcodes, bp.m_opcode_size, bytes_written);
+        if (errors[i].Success () && bytes_written < bp.m_opcode_size)
+            errors[i].SetErrorStringWithFormat ("SoftwareBreakpoint::%s addr=0x%" PRIx64 ": tried to write %lu bytes but only wrote %" PRIu64,
+                                                __FUNCTION__, bp.m_addr, bp.m_opcode_size, (uint64_t)bytes_written);
+    }
+
+    // Verify that the original opcodes are in memory, even the ones that
+    // were restored by somebody else.
+    for (size_t i = 0; i < breakpoints.size (); ++i)
+        reads[i].bytes_read = 0;
+    process.ReadMemoryRanges (reads);
+
+    for (size_t i = 0; i < breakpoints.size (); ++i)
+    {
+        const SoftwareBreakpoint &bp = *breakpoints[i];
+        if (errors[i].Fail ())
+            continue;
+        if (reads[i].bytes_read != bp.m_opcode_size)
+            errors[i].SetErrorString ("Failed to read memory to verify that breakpoint trap was restored.");
+        else if (::memcmp (reads[i].buf, bp.m_saved_opcodes, bp.m_opcode_size) != 0)
+            errors[i].SetErrorString (break_op_found[i] ? "Failed to restore original opcode." : "Original breakpoint trap is no longer in memory.");
+
+        if (log && errors[i].Fail ())
+            log->Printf ("SoftwareBreakpoint::%s addr = 0x%" PRIx64 " -- FAILED: %s", __FUNCTION__, bp.m_addr, errors[i].AsCString ());
+    }
+}
+
 Error
 SoftwareBreakpoint::EnableSoftwareBreakpoint (NativeProcessProtocol &process, lldb::addr_t addr, size_t bp_opcode_size, const uint8_t *bp_opcode_bytes, uint8_t *saved_opcode_bytes)
 {
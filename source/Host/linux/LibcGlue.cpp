@@ -27,4 +27,17 @@ ssize_t process_vm_readv(::pid_t pid,
     return -1;
 #endif
 }
+
+ssize_t process_vm_writev(::pid_t pid,
+			  const struct iovec *local_iov, unsigned long liovcnt,
+			  const struct iovec *remote_iov, unsigned long riovcnt,
+			  unsigned long flags)
+{
+#ifdef HAVE_NR_PROCESS_VM_READV // The syscall numbers were added together.
+    return syscall(__NR_process_vm_writev, pid, local_iov, liovcnt, remote_iov, riovcnt, flags);
+#else // If not, let's pretend the syscall is not present.
+    errno = ENOSYS;
+    return -1;
+#endif
+}
 #endif
@@ -9,6 +9,7 @@
 
 // C Includes
 // C++ Includes
+#include <set>
 // Other libraries and framework includes
 #include "lldb/Core/PluginManager.h"
 #include "lldb/Core/Log.h"
@@ -16,11 +17,14 @@
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Target/Platform.h"
 #include "lldb/Core/Section.h"
+#include "lldb/Core/Timer.h"
 #include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Symbol/SymbolVendor.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/Thread.h"
 #include "lldb/Target/ThreadPlanRunToAddress.h"
+#include "lldb/Utility/TaskPool.h"
 #include "lldb/Breakpoint/BreakpointLocation.h"
 
 #include "AuxVector.h"
@@ -401,6 +405,7 @@ DynamicLoaderPOSIXDYLD::RefreshModules()
         ModuleList new_modules;
 
         E = m_rendezvous.loaded_end();
+        PreloadModules(m_rendezvous.loaded_begin(), E);
         for (I = m_rendezvous.loaded_begin(); I != E; ++I)
         {
             ModuleSP module_sp = LoadModuleAtAddress(I->file_spec, I->link_addr, I->base_addr, true);
@@ -516,6 +521,7 @@ DynamicLoaderPOSIXDYLD::LoadAllCurrentModules()
             module_list.Append(module_sp);
         }
     }
+    PreloadModules(m_rendezvous.begin(), m_rendezvous.end());
     for (I = m_rendezvous.begin(), E = m_rendezvous.end(); I != E; ++I)
     {
         ModuleSP module_sp = LoadModuleAtAddress(I->file_spec, I->link_addr, I->base_addr, true);
@@ -535,6 +541,54 @@ DynamicLoaderPOSIXDYLD::LoadAllCurrentModules()
     m_process->GetTarget().ModulesDidLoad(module_list);
 }
 
+void
+DynamicLoaderPOSIXDYLD::PreloadModules(DYLDRendezvous::iterator begin, DYLDRendezvous::iterator end)
+{
+    // Only the host platform resolves link map entries straight from the
+    // shared module list, remote platforms may need to download the files
+    // into their module cache first.
+    Target &target = m_process->GetTarget();
+    PlatformSP platform_sp = target.GetPlatform();
+    if (!platform_sp || !platform_sp->IsHost())
+        return;
+
+    const ModuleList &loaded_modules = target.GetImages();
+    std::set<FileSpec> file_specs;
+    std::vector<ModuleSpec> module_specs;
+    for (DYLDRendezvous::iterator I = begin; I != end; ++I)
+    {
+        ModuleSpec module_spec(I->file_spec, target.GetArchitecture());
+        if (!file_specs.insert(I->file_spec).second || loaded_modules.FindFirstModule(module_spec))
+            continue;
+        module_specs.push_back(module_spec);
+    }
+
+    if (module_specs.size() < 2)
+        return;
+
+    Timer scoped_timer(__PRETTY_FUNCTION__,
+                       "DynamicLoaderPOSIXDYLD::PreloadModules (%" PRIu64 " modules)",
+                       (uint64_t)module_specs.size());
+
+    // The modules end up in the shared module list where the serial
+    // LoadModuleAtAddress calls find them. Modules which can't be found
+    // locally are left to LoadModuleAtAddress, which reads them from memory.
+    const FileSpecList search_paths(target.GetExecutableSearchPaths());
+    TaskPool::ParallelFor(0, module_specs.size(), [&module_specs, &search_paths](size_t idx)
+    {
+        ModuleSP module_sp;
+        ModuleList::GetSharedModule(module_specs[idx], module_sp, &search_paths, nullptr, nullptr);
+        if (!module_sp)
+            return;
+
+        // Creating the symbol vendor parses the section headers and locates
+        // the separate debug file, if any.
+        SymbolVendor *symbol_vendor = module_sp->GetSymbolVendor();
+        if (symbol_vendor)
+            symbol_vendor->GetSymtab();
+    });
+}
+
 addr_t
 DynamicLoaderPOSIXDYLD::ComputeLoadOffset()
 {
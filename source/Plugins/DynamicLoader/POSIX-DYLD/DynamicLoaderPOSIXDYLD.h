@@ -153,6 +153,17 @@ protected:
     virtual void
     LoadAllCurrentModules();
 
+    /// Creates the modules of the given link map entries and parses their
+    /// sections, symbol tables and separate debug files concurrently, so
+    /// loading them in link map order only needs to find them in the shared
+    /// module list.
+    ///
+    /// @param begin The first link map entry to preload.
+    ///
+    /// @param end The end of the link map entries to preload.
+    void
+    PreloadModules(DYLDRendezvous::iterator begin, DYLDRendezvous::iterator end);
+
     /// Computes a value for m_load_offset returning the computed address on
     /// success and LLDB_INVALID_ADDRESS on failure.
     lldb::addr_t
@@ -9,6 +9,8 @@
 
 // C Includes
 // C++ Includes
+#include <vector>
+
 // Other libraries and framework includes
 // Project includes
 #include "LibCxx.h"
@@ -21,145 +23,15 @@
 #include "lldb/DataFormatters/FormattersHelpers.h"
 #include "lldb/Host/Endian.h"
 #include "lldb/Symbol/ClangASTContext.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
 
+#include "NodeLinkReader.h"
+
 using namespace lldb;
 using namespace lldb_private;
 using namespace lldb_private::formatters;
 
-namespace {
-
-    class ListEntry
-    {
-    public:
-        ListEntry() = default;
-        ListEntry (ValueObjectSP entry_sp) : m_entry_sp(entry_sp) {}
-        ListEntry(const ListEntry& rhs) = default;
-        ListEntry (ValueObject* entry) : m_entry_sp(entry ? entry->GetSP() : ValueObjectSP()) {}
-
-        ListEntry
-        next ()
-        {
-            if (!m_entry_sp)
-                return ListEntry();
-            return ListEntry(m_entry_sp->GetChildAtIndexPath({0,1}));
-        }
-
-        ListEntry
-        prev ()
-        {
-            if (!m_entry_sp)
-                return ListEntry();
-            return ListEntry(m_entry_sp->GetChildAtIndexPath({0,0}));
-        }
-
-        uint64_t
-        value () const
-        {
-            if (!m_entry_sp)
-                return 0;
-            return m_entry_sp->GetValueAsUnsigned(0);
-        }
-
-        bool
-        null()
-        {
-            return (value() == 0);
-        }
-
-        explicit operator bool ()
-        {
-            return GetEntry() && !null();
-        }
-
-        ValueObjectSP
-        GetEntry ()
-        {
-            return m_entry_sp;
-        }
-
-        void
-        SetEntry (ValueObjectSP entry)
-        {
-            m_entry_sp = entry;
-        }
-
-        bool
-        operator == (const ListEntry& rhs) const
-        {
-            return value() == rhs.value();
-        }
-
-        bool
-        operator != (const ListEntry& rhs) const
-        {
-            return !(*this == rhs);
-        }
-
-    private:
-        ValueObjectSP m_entry_sp;
-    };
-    
-    class ListIterator
-    {
-    public:
-        ListIterator() = default;
-        ListIterator (ListEntry entry) : m_entry(entry) {}
-        ListIterator (ValueObjectSP entry) : m_entry(entry) {}
-        ListIterator(const ListIterator& rhs) = default;
-        ListIterator (ValueObject* entry) : m_entry(entry) {}
-        
-        ValueObjectSP
-        value ()
-        {
-            return m_entry.GetEntry();
-        }
-        
-        ValueObjectSP
-        advance (size_t count)
-        {
-            if (count == 0)
-                return m_entry.GetEntry();
-            if (count == 1)
-            {
-                next ();
-                return m_entry.GetEntry();
-            }
-            while (count > 0)
-            {
-                next ();
-                count--;
-                if (m_entry.null())
-                    return lldb::ValueObjectSP();
-            }
-            return m_entry.GetEntry();
-        }
-        
-        bool
-        operator == (const ListIterator& rhs) const
-        {
-            return (rhs.m_entry == m_entry);
-        }
-        
-    protected:
-        void
-        next ()
-        {
-            m_entry = m_entry.next();
-        }
-        
-        void
-        prev ()
-        {
-            m_entry = m_entry.prev();
-        }
-        
-    private:
-        ListEntry m_entry;
-    };
-
-} // end anonymous namespace
-
 namespace lldb_private {
     namespace formatters {
         class LibcxxStdListSyntheticFrontEnd : public SyntheticChildrenFrontEnd
@@ -185,23 +57,39 @@ namespace lldb_private {
             GetIndexOfChildWithName(const ConstString &name) override;
             
         private:
+            // The links of __list_node_base.
+            enum
+            {
+                eLinkPrev = 0,
+                eLinkNext,
+                eNumLinks
+            };
+
             bool
             HasLoop(size_t count);
-            
+
+            lldb::addr_t
+            GetNextNode (lldb::addr_t node);
+
+            bool
+            WalkToIndex (size_t idx);
+
             size_t m_list_capping_size;
             static const bool g_use_loop_detect = true;
 
             size_t m_loop_detected; // The number of elements that have had loop detection run over them.
-            ListEntry m_slow_runner; // Used for loop detection
-            ListEntry m_fast_runner; // Used for loop detection
+            lldb::addr_t m_slow_runner; // Used for loop detection
+            lldb::addr_t m_fast_runner; // Used for loop detection
 
+            NodeLinkReader m_reader;
             lldb::addr_t m_node_address;
-            ValueObject* m_head;
-            ValueObject* m_tail;
+            lldb::addr_t m_head;
+            lldb::addr_t m_tail;
+            uint64_t m_value_offset;
             CompilerType m_element_type;
             size_t m_count;
             std::map<size_t,lldb::ValueObjectSP> m_children;
-            std::map<size_t, ListIterator> m_iterators;
+            std::vector<lldb::addr_t> m_nodes; // The nodes walked so far, in list order
         };
     } // namespace formatters
 } // namespace lldb_private
@@ -210,18 +98,31 @@ lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::LibcxxStdListSynthetic
     SyntheticChildrenFrontEnd(*valobj_sp),
     m_list_capping_size(0),
     m_loop_detected(0),
-    m_node_address(),
-    m_head(nullptr),
-    m_tail(nullptr),
+    m_slow_runner(0),
+    m_fast_runner(0),
+    m_reader(),
+    m_node_address(0),
+    m_head(0),
+    m_tail(0),
+    m_value_offset(0),
     m_element_type(),
     m_count(UINT32_MAX),
     m_children(),
-    m_iterators()
+    m_nodes()
 {
     if (valobj_sp)
         Update();
 }
 
+lldb::addr_t
+lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::GetNextNode (lldb::addr_t node)
+{
+    lldb::addr_t next = 0;
+    if (!m_reader.GetLink(node, eLinkNext, next))
+        return 0;
+    return next;
+}
+
 bool
 lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::HasLoop(size_t count)
 {
@@ -235,8 +136,8 @@ lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::HasLoop(size_t count)
     {
         // This is the first time we are being run (after the last update). Set up the loop
         // invariant for the first element.
-        m_slow_runner = ListEntry(m_head).next();
-        m_fast_runner = m_slow_runner.next();
+        m_slow_runner = GetNextNode(m_head);
+        m_fast_runner = GetNextNode(m_slow_runner);
         m_loop_detected = 1;
     }
 
@@ -249,8 +150,8 @@ lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::HasLoop(size_t count)
             && m_fast_runner
             && m_slow_runner != m_fast_runner) {
 
-        m_slow_runner = m_slow_runner.next();
-        m_fast_runner = m_fast_runner.next().next();
+        m_slow_runner = GetNextNode(m_slow_runner);
+        m_fast_runner = GetNextNode(GetNextNode(m_fast_runner));
         m_loop_detected++;
     }
     if (count <= m_loop_detected)
@@ -260,6 +161,21 @@ lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::HasLoop(size_t count)
     return m_slow_runner == m_fast_runner;
 }
 
+bool
+lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::WalkToIndex (size_t idx)
+{
+    if (m_nodes.empty())
+        m_nodes.push_back(m_head);
+    while (m_nodes.size() <= idx)
+    {
+        const lldb::addr_t next = GetNextNode(m_nodes.back());
+        if (next == 0 || next == m_node_address)
+            return false;
+        m_nodes.push_back(next);
+    }
+    return true;
+}
+
 size_t
 lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::CalculateNumChildren ()
 {
@@ -282,24 +198,12 @@ lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::CalculateNumChildren (
     }
     else
     {
-        uint64_t next_val = m_head->GetValueAsUnsigned(0);
-        uint64_t prev_val = m_tail->GetValueAsUnsigned(0);
-        if (next_val == 0 || prev_val == 0)
-            return 0;
-        if (next_val == m_node_address)
+        if (m_head == m_node_address)
             return 0;
-        if (next_val == prev_val)
+        if (m_head == m_tail)
             return 1;
-        uint64_t size = 2;
-        ListEntry current(m_head);
-        while (current.next() && current.next().value() != m_node_address)
-        {
-            size++;
-            current = current.next();
-            if (size > m_list_capping_size)
-                break;
-        }
-        return m_count = (size-1);
+        WalkToIndex(m_list_capping_size - 1);
+        return m_count = m_nodes.size();
     }
 }
 
@@ -319,51 +223,24 @@ lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::GetChildAtIndex (size_
     if (HasLoop(idx+1))
         return lldb::ValueObjectSP();
     
-    size_t actual_advance = idx;
-    
-    ListIterator current(m_head);
-    if (idx > 0)
-    {
-        auto cached_iterator = m_iterators.find(idx-1);
-        if (cached_iterator != m_iterators.end())
-        {
-            current = cached_iterator->second;
-            actual_advance = 1;
-        }
-    }
-    
-    ValueObjectSP current_sp(current.advance(actual_advance));
-    if (!current_sp)
-        return lldb::ValueObjectSP();
-    
-    m_iterators[idx] = current;
-    
-    current_sp = current_sp->GetChildAtIndex(1, true); // get the __value_ child
-    if (!current_sp)
-        return lldb::ValueObjectSP();
-    // we need to copy current_sp into a new object otherwise we will end up with all items named __value_
-    DataExtractor data;
-    Error error;
-    current_sp->GetData(data, error);
-    if (error.Fail())
+    if (!WalkToIndex(idx))
         return lldb::ValueObjectSP();
     
     StreamString name;
     name.Printf("[%" PRIu64 "]", (uint64_t)idx);
-    return (m_children[idx] = CreateValueObjectFromData(name.GetData(), data, m_backend.GetExecutionContextRef(), m_element_type));
+    return (m_children[idx] = CreateValueObjectFromAddress(name.GetData(), m_nodes[idx] + m_value_offset, m_backend.GetExecutionContextRef(), m_element_type));
 }
 
 bool
 lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::Update()
 {
     m_children.clear();
-    m_iterators.clear();
-    m_head = m_tail = nullptr;
+    m_nodes.clear();
+    m_head = m_tail = 0;
     m_node_address = 0;
     m_count = UINT32_MAX;
     m_loop_detected = 0;
-    m_slow_runner.SetEntry(nullptr);
-    m_fast_runner.SetEntry(nullptr);
+    m_slow_runner = m_fast_runner = 0;
 
     Error err;
     ValueObjectSP backend_addr(m_backend.AddressOf(err));
@@ -388,8 +265,19 @@ lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::Update()
         return false;
     lldb::TemplateArgumentKind kind;
     m_element_type = list_type.GetTemplateArgument(0, kind);
-    m_head = impl_sp->GetChildMemberWithName(ConstString("__next_"), true).get();
-    m_tail = impl_sp->GetChildMemberWithName(ConstString("__prev_"), true).get();
+    ValueObjectSP head_sp(impl_sp->GetChildMemberWithName(ConstString("__next_"), true));
+    ValueObjectSP tail_sp(impl_sp->GetChildMemberWithName(ConstString("__prev_"), true));
+    if (!head_sp || !tail_sp)
+        return false;
+    m_head = head_sp->GetValueAsUnsigned(0);
+    m_tail = tail_sp->GetValueAsUnsigned(0);
+
+    // Read the nodes with raw reads of their links instead of one ValueObject
+    // per link. Following the previous links as well walks the list from both
+    // ends, so each read brings in two nodes.
+    ProcessSP process_sp(m_backend.GetProcessSP());
+    m_reader.Reset(process_sp, 0, eNumLinks, (1u << eLinkPrev) | (1u << eLinkNext));
+    m_value_offset = GetNodeValueOffset(eNumLinks * m_reader.GetPointerSize(), m_element_type);
     return false;
 }
 
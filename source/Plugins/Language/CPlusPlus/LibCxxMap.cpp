@@ -9,6 +9,8 @@
 
 // C Includes
 // C++ Includes
+#include <vector>
+
 // Other libraries and framework includes
 // Project includes
 #include "LibCxx.h"
@@ -21,195 +23,15 @@
 #include "lldb/DataFormatters/FormattersHelpers.h"
 #include "lldb/Host/Endian.h"
 #include "lldb/Symbol/ClangASTContext.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
 
+#include "NodeLinkReader.h"
+
 using namespace lldb;
 using namespace lldb_private;
 using namespace lldb_private::formatters;
 
-class MapEntry
-{
-public:
-    MapEntry() = default;
-    explicit MapEntry (ValueObjectSP entry_sp) : m_entry_sp(entry_sp) {}
-    MapEntry(const MapEntry& rhs) = default;
-    explicit MapEntry (ValueObject* entry) : m_entry_sp(entry ? entry->GetSP() : ValueObjectSP()) {}
-    
-    ValueObjectSP
-    left () const
-    {
-        static ConstString g_left("__left_");
-        if (!m_entry_sp)
-            return m_entry_sp;
-        return m_entry_sp->GetChildMemberWithName(g_left, true);
-    }
-    
-    ValueObjectSP
-    right () const
-    {
-        static ConstString g_right("__right_");
-        if (!m_entry_sp)
-            return m_entry_sp;
-        return m_entry_sp->GetChildMemberWithName(g_right, true);
-    }
-    
-    ValueObjectSP
-    parent () const
-    {
-        static ConstString g_parent("__parent_");
-        if (!m_entry_sp)
-            return m_entry_sp;
-        return m_entry_sp->GetChildMemberWithName(g_parent, true);
-    }
-    
-    uint64_t
-    value () const
-    {
-        if (!m_entry_sp)
-            return 0;
-        return m_entry_sp->GetValueAsUnsigned(0);
-    }
-    
-    bool
-    error () const
-    {
-        if (!m_entry_sp)
-            return true;
-        return m_entry_sp->GetError().Fail();
-    }
-    
-    bool
-    null() const
-    {
-        return (value() == 0);
-    }
-    
-    ValueObjectSP
-    GetEntry () const
-    {
-        return m_entry_sp;
-    }
-    
-    void
-    SetEntry (ValueObjectSP entry)
-    {
-        m_entry_sp = entry;
-    }
-    
-    bool
-    operator == (const MapEntry& rhs) const
-    {
-        return (rhs.m_entry_sp.get() == m_entry_sp.get());
-    }
-    
-private:
-    ValueObjectSP m_entry_sp;
-};
-
-class MapIterator
-{
-public:
-    MapIterator() = default;
-    MapIterator (MapEntry entry, size_t depth = 0) : m_entry(entry), m_max_depth(depth), m_error(false) {}
-    MapIterator (ValueObjectSP entry, size_t depth = 0) : m_entry(entry), m_max_depth(depth), m_error(false) {}
-    MapIterator (const MapIterator& rhs) : m_entry(rhs.m_entry),m_max_depth(rhs.m_max_depth), m_error(false) {}
-    MapIterator (ValueObject* entry, size_t depth = 0) : m_entry(entry), m_max_depth(depth), m_error(false) {}
-    
-    ValueObjectSP
-    value ()
-    {
-        return m_entry.GetEntry();
-    }
-    
-    ValueObjectSP
-    advance (size_t count)
-    {
-        ValueObjectSP fail;
-        if (m_error)
-            return fail;
-        size_t steps = 0;
-        while (count > 0)
-        {
-            next();
-            count--, steps++;
-            if (m_error ||
-                m_entry.null() ||
-                (steps > m_max_depth))
-                return fail;
-        }
-        return m_entry.GetEntry();
-    }
-    
-protected:
-    void
-    next ()
-    {
-        if (m_entry.null())
-            return;
-        MapEntry right(m_entry.right());
-        if (!right.null())
-        {
-            m_entry = tree_min(std::move(right));
-            return;
-        }
-        size_t steps = 0;
-        while (!is_left_child(m_entry))
-        {
-            if (m_entry.error())
-            {
-                m_error = true;
-                return;
-            }
-            m_entry.SetEntry(m_entry.parent());
-            steps++;
-            if (steps > m_max_depth)
-            {
-                m_entry = MapEntry();
-                return;
-            }
-        }
-        m_entry = MapEntry(m_entry.parent());
-    }
-    
-private:
-    MapEntry
-    tree_min (MapEntry&& x)
-    {
-        if (x.null())
-            return MapEntry();
-        MapEntry left(x.left());
-        size_t steps = 0;
-        while (!left.null())
-        {
-            if (left.error())
-            {
-                m_error = true;
-                return MapEntry();
-            }
-            x = left;
-            left.SetEntry(x.left());
-            steps++;
-            if (steps > m_max_depth)
-                return MapEntry();
-        }
-        return x;
-    }
-    
-    bool
-    is_left_child (const MapEntry& x)
-    {
-        if (x.null())
-            return false;
-        MapEntry rhs(x.parent());
-        rhs.SetEntry(rhs.left());
-        return x.value() == rhs.value();
-    }
-    
-    MapEntry m_entry;
-    size_t m_max_depth;
-    bool m_error;
-};
-
 namespace lldb_private {
     namespace formatters {
         class LibcxxStdMapSyntheticFrontEnd : public SyntheticChildrenFrontEnd
@@ -235,19 +57,36 @@ namespace lldb_private {
             GetIndexOfChildWithName(const ConstString &name) override;
             
         private:
+            // The links of __tree_node_base, __left_ comes from __tree_end_node.
+            enum
+            {
+                eLinkLeft = 0,
+                eLinkRight,
+                eLinkParent,
+                eNumLinks
+            };
+
             bool
             GetDataType();
             
             void
             GetValueOffset (const lldb::ValueObjectSP& node);
             
+            lldb::addr_t
+            GetNextNode (lldb::addr_t node);
+            
+            bool
+            WalkToIndex (size_t idx);
+            
             ValueObject* m_tree;
             ValueObject* m_root_node;
             CompilerType m_element_type;
             uint32_t m_skip_size;
             size_t m_count;
+            NodeLinkReader m_reader;
+            lldb::addr_t m_end_node;
             std::map<size_t, lldb::ValueObjectSP> m_children;
-            std::map<size_t, MapIterator> m_iterators;
+            std::vector<lldb::addr_t> m_nodes; // The nodes walked so far, in order
         };
     } // namespace formatters
 } // namespace lldb_private
@@ -259,8 +98,10 @@ lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::LibcxxStdMapSyntheticFr
     m_element_type(),
     m_skip_size(UINT32_MAX),
     m_count(UINT32_MAX),
+    m_reader(),
+    m_end_node(0),
     m_children(),
-    m_iterators()
+    m_nodes()
 {
     if (valobj_sp)
         Update();
@@ -320,12 +161,63 @@ lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::GetValueOffset (const l
     m_skip_size = bit_offset / 8u;
 }
 
+// Mirrors __tree_next(), giving up on trees that take more steps than they
+// have nodes.
+lldb::addr_t
+lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::GetNextNode (lldb::addr_t node)
+{
+    size_t max_steps = m_count;
+    lldb::addr_t link = 0;
+    if (!m_reader.GetLink(node, eLinkRight, link))
+        return 0;
+    if (link != 0)
+    {
+        node = link;
+        while (m_reader.GetLink(node, eLinkLeft, link) && link != 0)
+        {
+            if (max_steps-- == 0)
+                return 0;
+            node = link;
+        }
+        return node;
+    }
+    while (true)
+    {
+        lldb::addr_t parent = 0;
+        if (!m_reader.GetLink(node, eLinkParent, parent) || parent == 0)
+            return 0;
+        // The root is the left child of the end node, which only has a
+        // __left_ link and isn't read.
+        if (parent == m_end_node)
+            return parent;
+        if (!m_reader.GetLink(parent, eLinkLeft, link))
+            return 0;
+        if (link == node)
+            return parent;
+        if (max_steps-- == 0)
+            return 0;
+        node = parent;
+    }
+}
+
+bool
+lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::WalkToIndex (size_t idx)
+{
+    while (m_nodes.size() <= idx)
+    {
+        const lldb::addr_t node = m_nodes.empty() ? m_root_node->GetValueAsUnsigned(0) : GetNextNode(m_nodes.back());
+        if (node == 0 || node == m_end_node)
+            return false;
+        m_nodes.push_back(node);
+    }
+    return true;
+}
+
 lldb::ValueObjectSP
 lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::GetChildAtIndex (size_t idx)
 {
     static ConstString g___cc("__cc");
     static ConstString g___nc("__nc");
-    static ConstString g___value_("__value_");
 
     if (idx >= CalculateNumChildren())
         return lldb::ValueObjectSP();
@@ -336,83 +228,36 @@ lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::GetChildAtIndex (size_t
     if (cached != m_children.end())
         return cached->second;
 
-    MapIterator iterator(m_root_node, CalculateNumChildren());
-    
-    const bool need_to_skip = (idx > 0);
-    size_t actual_advancde = idx;
-    if (need_to_skip)
+    if (!GetDataType())
     {
-        auto cached_iterator = m_iterators.find(idx-1);
-        if (cached_iterator != m_iterators.end())
-        {
-            iterator = cached_iterator->second;
-            actual_advancde = 1;
-        }
-    }
-    
-    ValueObjectSP iterated_sp(iterator.advance(actual_advancde));
-    if (!iterated_sp)
-    {
-        // this tree is garbage - stop
-        m_tree = nullptr; // this will stop all future searches until an Update() happens
-        return iterated_sp;
+        m_tree = nullptr;
+        return lldb::ValueObjectSP();
     }
-    if (GetDataType())
+    if (m_skip_size == UINT32_MAX)
     {
-        if (!need_to_skip)
+        // because of the way our debug info is made, we need to look at the
+        // first node to find where the values are in all of them
+        Error error;
+        ValueObjectSP node_sp = m_root_node->Dereference(error);
+        if (node_sp && error.Success())
+            GetValueOffset(node_sp);
+        if (m_skip_size == UINT32_MAX)
         {
-            Error error;
-            iterated_sp = iterated_sp->Dereference(error);
-            if (!iterated_sp || error.Fail())
-            {
-                m_tree = nullptr;
-                return lldb::ValueObjectSP();
-            }
-            GetValueOffset(iterated_sp);
-            iterated_sp = iterated_sp->GetChildMemberWithName(g___value_, true);
-            if (!iterated_sp)
-            {
-                m_tree = nullptr;
-                return lldb::ValueObjectSP();
-            }
+            m_tree = nullptr;
+            return lldb::ValueObjectSP();
         }
-        else
-        {
-            // because of the way our debug info is made, we need to read item 0 first
-            // so that we can cache information used to generate other elements
-            if (m_skip_size == UINT32_MAX)
-                GetChildAtIndex(0);
-            if (m_skip_size == UINT32_MAX)
-            {
-                m_tree = nullptr;
-                return lldb::ValueObjectSP();
-            }
-            iterated_sp = iterated_sp->GetSyntheticChildAtOffset(m_skip_size, m_element_type, true);
-            if (!iterated_sp)
-            {
-                m_tree = nullptr;
-                return lldb::ValueObjectSP();
-            }
-        }
-    }
-    else
-    {
-        m_tree = nullptr;
-        return lldb::ValueObjectSP();
     }
-    // at this point we have a valid 
-    // we need to copy current_sp into a new object otherwise we will end up with all items named __value_
-    DataExtractor data;
-    Error error;
-    iterated_sp->GetData(data, error);
-    if (error.Fail())
+
+    if (!WalkToIndex(idx))
     {
-        m_tree = nullptr;
+        // this tree is garbage - stop
+        m_tree = nullptr; // this will stop all future searches until an Update() happens
         return lldb::ValueObjectSP();
     }
+
     StreamString name;
     name.Printf("[%" PRIu64 "]", (uint64_t)idx);
-    auto potential_child_sp = CreateValueObjectFromData(name.GetData(), data, m_backend.GetExecutionContextRef(), m_element_type);
+    auto potential_child_sp = CreateValueObjectFromAddress(name.GetData(), m_nodes[idx] + m_skip_size, m_backend.GetExecutionContextRef(), m_element_type);
     if (potential_child_sp)
     {
         switch (potential_child_sp->GetNumChildren())
@@ -436,7 +281,6 @@ lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::GetChildAtIndex (size_t
         }
         potential_child_sp->SetName(ConstString(name.GetData()));
     }
-    m_iterators[idx] = iterator;
     return (m_children[idx] = potential_child_sp);
 }
 
@@ -445,14 +289,30 @@ lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::Update()
 {
     static ConstString g___tree_("__tree_");
     static ConstString g___begin_node_("__begin_node_");
+    static ConstString g___pair1_("__pair1_");
     m_count = UINT32_MAX;
     m_tree = m_root_node = nullptr;
+    m_end_node = 0;
     m_children.clear();
-    m_iterators.clear();
+    m_nodes.clear();
     m_tree = m_backend.GetChildMemberWithName(g___tree_, true).get();
     if (!m_tree)
         return false;
     m_root_node = m_tree->GetChildMemberWithName(g___begin_node_, true).get();
+
+    // The end node is the first member of __pair1_.
+    ValueObjectSP end_node_sp(m_tree->GetChildMemberWithName(g___pair1_, true));
+    if (end_node_sp)
+    {
+        m_end_node = end_node_sp->GetAddressOf(true, nullptr);
+        if (m_end_node == LLDB_INVALID_ADDRESS)
+            m_end_node = 0;
+    }
+
+    // Read the links of the nodes with raw reads instead of one ValueObject
+    // per link, the children of every node read are read along with the next
+    // node an in order walk needs.
+    m_reader.Reset(m_backend.GetProcessSP(), 0, eNumLinks, (1u << eLinkLeft) | (1u << eLinkRight));
     return false;
 }
 
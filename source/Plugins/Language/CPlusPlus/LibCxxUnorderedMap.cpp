@@ -9,6 +9,8 @@
 
 // C Includes
 // C++ Includes
+#include <vector>
+
 // Other libraries and framework includes
 // Project includes
 #include "LibCxx.h"
@@ -21,8 +23,11 @@
 #include "lldb/DataFormatters/FormattersHelpers.h"
 #include "lldb/Host/Endian.h"
 #include "lldb/Symbol/ClangASTContext.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
 
+#include "NodeLinkReader.h"
+
 using namespace lldb;
 using namespace lldb_private;
 using namespace lldb_private::formatters;
@@ -52,11 +57,16 @@ namespace lldb_private {
             GetIndexOfChildWithName(const ConstString &name) override;
 
         private:
+            bool
+            GetValueTypeAndOffset ();
+
             ValueObject* m_tree;
             size_t m_num_elements;
-            ValueObject* m_next_element;
+            NodeLinkReader m_reader;
+            CompilerType m_element_type;
+            uint64_t m_value_offset;
             std::map<size_t,lldb::ValueObjectSP> m_children;
-            std::vector<std::pair<ValueObject*, uint64_t> > m_elements_cache;
+            std::vector<lldb::addr_t> m_nodes; // The nodes walked so far, in iteration order
         };
     } // namespace formatters
 } // namespace lldb_private
@@ -65,9 +75,11 @@ lldb_private::formatters::LibcxxStdUnorderedMapSyntheticFrontEnd::LibcxxStdUnord
     SyntheticChildrenFrontEnd(*valobj_sp),
     m_tree(nullptr),
     m_num_elements(0),
-    m_next_element(nullptr),
+    m_reader(),
+    m_element_type(),
+    m_value_offset(UINT64_MAX),
     m_children(),
-    m_elements_cache()
+    m_nodes()
 {
     if (valobj_sp)
         Update();
@@ -81,6 +93,28 @@ lldb_private::formatters::LibcxxStdUnorderedMapSyntheticFrontEnd::CalculateNumCh
     return 0;
 }
 
+// The value type of the nodes comes from the debug info of the first one, it
+// is at the same offset in all of them.
+bool
+lldb_private::formatters::LibcxxStdUnorderedMapSyntheticFrontEnd::GetValueTypeAndOffset ()
+{
+    if (m_value_offset != UINT64_MAX)
+        return true;
+    Error error;
+    ValueObjectSP node_sp = m_tree->Dereference(error);
+    if (!node_sp || error.Fail())
+        return false;
+    ValueObjectSP value_sp = node_sp->GetChildMemberWithName(ConstString("__value_"), true);
+    if (!value_sp)
+        return false;
+    uint64_t bit_offset;
+    if (node_sp->GetCompilerType().GetIndexOfFieldWithName("__value_", nullptr, &bit_offset) == UINT32_MAX)
+        return false;
+    m_element_type = value_sp->GetCompilerType();
+    m_value_offset = bit_offset / 8u;
+    return true;
+}
+
 lldb::ValueObjectSP
 lldb_private::formatters::LibcxxStdUnorderedMapSyntheticFrontEnd::GetChildAtIndex (size_t idx)
 {
@@ -93,51 +127,40 @@ lldb_private::formatters::LibcxxStdUnorderedMapSyntheticFrontEnd::GetChildAtInde
     if (cached != m_children.end())
         return cached->second;
     
-    while (idx >= m_elements_cache.size())
+    if (!GetValueTypeAndOffset())
+        return lldb::ValueObjectSP();
+    
+    // Follow the __next_ links with raw reads instead of dereferencing a
+    // ValueObject per node.
+    while (idx >= m_nodes.size())
     {
-        if (m_next_element == nullptr)
+        lldb::addr_t next = 0;
+        if (m_nodes.empty())
+            next = m_tree->GetValueAsUnsigned(0);
+        else if (!m_reader.GetLink(m_nodes.back(), 0, next))
             return lldb::ValueObjectSP();
-        
-        Error error;
-        ValueObjectSP node_sp = m_next_element->Dereference(error);
-        if (!node_sp || error.Fail())
+        if (next == 0)
             return lldb::ValueObjectSP();
-        
-        ValueObjectSP value_sp = node_sp->GetChildMemberWithName(ConstString("__value_"), true);
-        ValueObjectSP hash_sp = node_sp->GetChildMemberWithName(ConstString("__hash_"), true);
-        if (!hash_sp || !value_sp)
-            return lldb::ValueObjectSP();
-        m_elements_cache.push_back({value_sp.get(),hash_sp->GetValueAsUnsigned(0)});
-        m_next_element = node_sp->GetChildMemberWithName(ConstString("__next_"),true).get();
-        if (!m_next_element || m_next_element->GetValueAsUnsigned(0) == 0)
-            m_next_element = nullptr;
+        m_nodes.push_back(next);
     }
     
-    std::pair<ValueObject*, uint64_t> val_hash = m_elements_cache[idx];
-    if (!val_hash.first)
-        return lldb::ValueObjectSP();
     StreamString stream;
     stream.Printf("[%" PRIu64 "]", (uint64_t)idx);
-    DataExtractor data;
-    Error error;
-    val_hash.first->GetData(data, error);
-    if (error.Fail())
-        return lldb::ValueObjectSP();
-    const bool thread_and_frame_only_if_stopped = true;
-    ExecutionContext exe_ctx = val_hash.first->GetExecutionContextRef().Lock(thread_and_frame_only_if_stopped);
-    return val_hash.first->CreateValueObjectFromData(stream.GetData(),
-                                                     data,
-                                                     exe_ctx,
-                                                     val_hash.first->GetCompilerType());
+    return (m_children[idx] = CreateValueObjectFromAddress(stream.GetData(),
+                                                           m_nodes[idx] + m_value_offset,
+                                                           m_backend.GetExecutionContextRef(),
+                                                           m_element_type));
 }
 
 bool
 lldb_private::formatters::LibcxxStdUnorderedMapSyntheticFrontEnd::Update()
 {
     m_num_elements = UINT32_MAX;
-    m_next_element = nullptr;
-    m_elements_cache.clear();
+    m_tree = nullptr;
+    m_value_offset = UINT64_MAX;
+    m_nodes.clear();
     m_children.clear();
+    m_reader.Reset(m_backend.GetProcessSP(), 0, 1, 0);
     ValueObjectSP table_sp = m_backend.GetChildMemberWithName(ConstString("__table_"), true);
     if (!table_sp)
         return false;
@@ -145,9 +168,8 @@ lldb_private::formatters::LibcxxStdUnorderedMapSyntheticFrontEnd::Update()
     if (!num_elements_sp)
         return false;
     m_num_elements = num_elements_sp->GetValueAsUnsigned(0);
-    m_tree = table_sp->GetChildAtNamePath({ConstString("__p1_"),ConstString("__first_"),ConstString("__next_")}).get();
     if (m_num_elements > 0)
-        m_next_element = table_sp->GetChildAtNamePath({ConstString("__p1_"),ConstString("__first_"),ConstString("__next_")}).get();
+        m_tree = table_sp->GetChildAtNamePath({ConstString("__p1_"),ConstString("__first_"),ConstString("__next_")}).get();
     return false;
 }
 
@@ -11,6 +11,10 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
+#include <map>
+#include <vector>
+
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Core/DataBufferHeap.h"
@@ -18,12 +22,16 @@
 #include "lldb/Core/Stream.h"
 #include "lldb/Core/ValueObject.h"
 #include "lldb/Core/ValueObjectConstResult.h"
+#include "lldb/DataFormatters/FormattersHelpers.h"
 #include "lldb/DataFormatters/StringPrinter.h"
 #include "lldb/DataFormatters/VectorIterator.h"
 #include "lldb/Host/Endian.h"
 #include "lldb/Symbol/ClangASTContext.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
 
+#include "NodeLinkReader.h"
+
 using namespace lldb;
 using namespace lldb_private;
 using namespace lldb_private::formatters;
@@ -366,3 +374,1368 @@ lldb_private::formatters::LibStdcppWStringSummaryProvider (ValueObject& valobj,
     }
     return false;
 }
+
+//----------------------------------------------------------------------
+// Helpers for the container synthetic children below
+//----------------------------------------------------------------------
+namespace {
+
+    CompilerType
+    GetTemplateArgumentType (CompilerType type, size_t idx)
+    {
+        if (type.IsReferenceType())
+            type = type.GetNonReferenceType();
+        type = type.GetCanonicalType();
+        if (type.GetNumTemplateArguments() <= idx)
+            return CompilerType();
+        TemplateArgumentKind kind;
+        return type.GetTemplateArgument(idx, kind);
+    }
+
+} // anonymous namespace
+
+//----------------------------------------------------------------------
+// std::vector
+//----------------------------------------------------------------------
+class LibStdcppVectorSyntheticFrontEnd : public SyntheticChildrenFrontEnd
+{
+public:
+    LibStdcppVectorSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp);
+
+    ~LibStdcppVectorSyntheticFrontEnd() override = default;
+
+    size_t
+    CalculateNumChildren() override;
+
+    lldb::ValueObjectSP
+    GetChildAtIndex(size_t idx) override;
+
+    bool
+    Update() override;
+
+    bool
+    MightHaveChildren() override;
+
+    size_t
+    GetIndexOfChildWithName (const ConstString &name) override;
+
+private:
+    lldb::addr_t m_start;
+    size_t m_count;
+    CompilerType m_element_type;
+    uint64_t m_element_size;
+    std::map<size_t, lldb::ValueObjectSP> m_children;
+};
+
+/*
+ (std::vector<int, std::allocator<int> >) numbers = {
+   _M_impl = {
+     _M_start = 0x0000000000614c20
+     _M_finish = 0x0000000000614c2c
+     _M_end_of_storage = 0x0000000000614c2c
+   }
+ }
+ */
+
+LibStdcppVectorSyntheticFrontEnd::LibStdcppVectorSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp) :
+    SyntheticChildrenFrontEnd(*valobj_sp),
+    m_start(0),
+    m_count(0),
+    m_element_type(),
+    m_element_size(0),
+    m_children()
+{
+    if (valobj_sp)
+        Update();
+}
+
+bool
+LibStdcppVectorSyntheticFrontEnd::Update()
+{
+    m_start = 0;
+    m_count = 0;
+    m_children.clear();
+
+    ValueObjectSP impl_sp(m_backend.GetChildMemberWithName(ConstString("_M_impl"), true));
+    if (!impl_sp)
+        return false;
+    ValueObjectSP start_sp(impl_sp->GetChildMemberWithName(ConstString("_M_start"), true));
+    ValueObjectSP finish_sp(impl_sp->GetChildMemberWithName(ConstString("_M_finish"), true));
+    ValueObjectSP end_sp(impl_sp->GetChildMemberWithName(ConstString("_M_end_of_storage"), true));
+    if (!start_sp || !finish_sp || !end_sp)
+        return false;
+
+    m_element_type = start_sp->GetCompilerType().GetPointeeType();
+    m_element_size = m_element_type.GetByteSize(nullptr);
+    if (m_element_size == 0)
+        return false;
+
+    // Before a vector is constructed its pointers are garbage, make sure
+    // they are consistent before trusting them.
+    const lldb::addr_t start = start_sp->GetValueAsUnsigned(0);
+    const lldb::addr_t finish = finish_sp->GetValueAsUnsigned(0);
+    const lldb::addr_t end = end_sp->GetValueAsUnsigned(0);
+    if (start == 0 || finish == 0 || end == 0 || start > finish || finish > end)
+        return false;
+    if ((finish - start) % m_element_size != 0)
+        return false;
+
+    m_start = start;
+    m_count = (finish - start) / m_element_size;
+    return false;
+}
+
+size_t
+LibStdcppVectorSyntheticFrontEnd::CalculateNumChildren ()
+{
+    return m_count;
+}
+
+lldb::ValueObjectSP
+LibStdcppVectorSyntheticFrontEnd::GetChildAtIndex (size_t idx)
+{
+    if (idx >= m_count)
+        return lldb::ValueObjectSP();
+
+    auto cached = m_children.find(idx);
+    if (cached != m_children.end())
+        return cached->second;
+
+    StreamString name;
+    name.Printf("[%" PRIu64 "]", (uint64_t)idx);
+    ValueObjectSP child_sp = CreateValueObjectFromAddress(name.GetData(), m_start + idx * m_element_size, m_backend.GetExecutionContextRef(), m_element_type);
+    m_children[idx] = child_sp;
+    return child_sp;
+}
+
+bool
+LibStdcppVectorSyntheticFrontEnd::MightHaveChildren ()
+{
+    return true;
+}
+
+size_t
+LibStdcppVectorSyntheticFrontEnd::GetIndexOfChildWithName (const ConstString &name)
+{
+    return ExtractIndexFromString(name.GetCString());
+}
+
+//----------------------------------------------------------------------
+// std::vector<bool>
+//----------------------------------------------------------------------
+class LibStdcppVectorBoolSyntheticFrontEnd : public SyntheticChildrenFrontEnd
+{
+public:
+    LibStdcppVectorBoolSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp);
+
+    ~LibStdcppVectorBoolSyntheticFrontEnd() override = default;
+
+    size_t
+    CalculateNumChildren() override;
+
+    lldb::ValueObjectSP
+    GetChildAtIndex(size_t idx) override;
+
+    bool
+    Update() override;
+
+    bool
+    MightHaveChildren() override;
+
+    size_t
+    GetIndexOfChildWithName (const ConstString &name) override;
+
+private:
+    bool
+    ReadWords (size_t word_idx);
+
+    CompilerType m_bool_type;
+    lldb::addr_t m_start;
+    size_t m_count;
+    uint32_t m_word_size;
+    DataBufferHeap m_words; // The words of bits read so far
+    std::map<size_t, lldb::ValueObjectSP> m_children;
+};
+
+/*
+ (std::vector<bool, std::allocator<bool> >) flags = {
+   std::_Bvector_base<std::allocator<bool> > = {
+     _M_impl = {
+       _M_start = (_M_p = 0x0000000000614c20, _M_offset = 0)
+       _M_finish = (_M_p = 0x0000000000614c20, _M_offset = 5)
+       _M_end_of_storage = 0x0000000000614c28
+     }
+   }
+ }
+ */
+
+LibStdcppVectorBoolSyntheticFrontEnd::LibStdcppVectorBoolSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp) :
+    SyntheticChildrenFrontEnd(*valobj_sp),
+    m_bool_type(),
+    m_start(0),
+    m_count(0),
+    m_word_size(0),
+    m_words(),
+    m_children()
+{
+    if (valobj_sp)
+    {
+        m_bool_type = valobj_sp->GetCompilerType().GetBasicTypeFromAST(lldb::eBasicTypeBool);
+        Update();
+    }
+}
+
+bool
+LibStdcppVectorBoolSyntheticFrontEnd::Update()
+{
+    m_start = 0;
+    m_count = 0;
+    m_words.SetByteSize(0);
+    m_children.clear();
+
+    ValueObjectSP impl_sp(m_backend.GetChildMemberWithName(ConstString("_M_impl"), true));
+    if (!impl_sp)
+        return false;
+    ValueObjectSP start_sp(impl_sp->GetChildAtNamePath({ConstString("_M_start"), ConstString("_M_p")}));
+    ValueObjectSP finish_sp(impl_sp->GetChildAtNamePath({ConstString("_M_finish"), ConstString("_M_p")}));
+    ValueObjectSP offset_sp(impl_sp->GetChildAtNamePath({ConstString("_M_finish"), ConstString("_M_offset")}));
+    if (!start_sp || !finish_sp || !offset_sp)
+        return false;
+
+    m_word_size = start_sp->GetCompilerType().GetPointeeType().GetByteSize(nullptr);
+    const lldb::addr_t start = start_sp->GetValueAsUnsigned(0);
+    const lldb::addr_t finish = finish_sp->GetValueAsUnsigned(0);
+    const uint64_t offset = offset_sp->GetValueAsUnsigned(0);
+    if (m_word_size == 0 || m_word_size > 8 || start == 0 || finish < start)
+        return false;
+    // A garbage offset or a range that isn't made of whole words means
+    // the vector isn't constructed yet.
+    if ((finish - start) % m_word_size != 0 || offset >= m_word_size * 8)
+        return false;
+
+    m_start = start;
+    m_count = (finish - start) * 8 + offset;
+    return false;
+}
+
+bool
+LibStdcppVectorBoolSyntheticFrontEnd::ReadWords (size_t word_idx)
+{
+    const size_t bytes_needed = (word_idx + 1) * m_word_size;
+    if (bytes_needed <= m_words.GetByteSize())
+        return true;
+
+    ProcessSP process_sp(m_backend.GetProcessSP());
+    if (!process_sp)
+        return false;
+
+    // Read ahead in chunks that double in size so printing all the bits
+    // only takes a few reads.
+    const size_t total_size = (m_count + m_word_size * 8 - 1) / (m_word_size * 8) * m_word_size;
+    size_t new_size = std::max<size_t>(std::max<size_t>(bytes_needed, 2 * m_words.GetByteSize()), 512);
+    new_size = std::min(new_size, total_size);
+    const size_t old_size = m_words.GetByteSize();
+    if (new_size <= old_size)
+        return false;
+    m_words.SetByteSize(new_size);
+    Error error;
+    const size_t bytes_read = process_sp->ReadMemory(m_start + old_size, m_words.GetBytes() + old_size, new_size - old_size, error);
+    if (bytes_read != new_size - old_size)
+    {
+        m_words.SetByteSize(old_size + bytes_read / m_word_size * m_word_size);
+        return bytes_needed <= m_words.GetByteSize();
+    }
+    return true;
+}
+
+size_t
+LibStdcppVectorBoolSyntheticFrontEnd::CalculateNumChildren ()
+{
+    return m_count;
+}
+
+lldb::ValueObjectSP
+LibStdcppVectorBoolSyntheticFrontEnd::GetChildAtIndex (size_t idx)
+{
+    if (idx >= m_count || !m_bool_type)
+        return lldb::ValueObjectSP();
+
+    auto cached = m_children.find(idx);
+    if (cached != m_children.end())
+        return cached->second;
+
+    const size_t bits_per_word = m_word_size * 8;
+    const size_t word_idx = idx / bits_per_word;
+    if (!ReadWords(word_idx))
+        return lldb::ValueObjectSP();
+
+    ProcessSP process_sp(m_backend.GetProcessSP());
+    if (!process_sp)
+        return lldb::ValueObjectSP();
+    DataExtractor words(m_words.GetBytes(), m_words.GetByteSize(), process_sp->GetByteOrder(), process_sp->GetAddressByteSize());
+    lldb::offset_t offset = word_idx * m_word_size;
+    const uint64_t word = words.GetMaxU64(&offset, m_word_size);
+    const bool bit_set = ((word >> (idx % bits_per_word)) & 1) != 0;
+
+    DataBufferSP buffer_sp(new DataBufferHeap(m_bool_type.GetByteSize(nullptr), 0));
+    if (bit_set && buffer_sp->GetByteSize() > 0)
+        *(buffer_sp->GetBytes()) = 1; // regardless of endianness, anything non-zero is true
+    StreamString name;
+    name.Printf("[%" PRIu64 "]", (uint64_t)idx);
+    ValueObjectSP child_sp(CreateValueObjectFromData(name.GetData(), DataExtractor(buffer_sp, process_sp->GetByteOrder(), process_sp->GetAddressByteSize()), m_backend.GetExecutionContextRef(), m_bool_type));
+    if (child_sp)
+        m_children[idx] = child_sp;
+    return child_sp;
+}
+
+bool
+LibStdcppVectorBoolSyntheticFrontEnd::MightHaveChildren ()
+{
+    return true;
+}
+
+size_t
+LibStdcppVectorBoolSyntheticFrontEnd::GetIndexOfChildWithName (const ConstString &name)
+{
+    const size_t idx = ExtractIndexFromString(name.GetCString());
+    if (idx < UINT32_MAX && idx >= m_count)
+        return UINT32_MAX;
+    return idx;
+}
+
+SyntheticChildrenFrontEnd*
+lldb_private::formatters::LibStdcppVectorSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP valobj_sp)
+{
+    if (!valobj_sp)
+        return nullptr;
+    CompilerType element_type(GetTemplateArgumentType(valobj_sp->GetCompilerType(), 0));
+    if (element_type && element_type.GetCanonicalType().GetBasicTypeEnumeration() == lldb::eBasicTypeBool)
+        return new LibStdcppVectorBoolSyntheticFrontEnd(valobj_sp);
+    return new LibStdcppVectorSyntheticFrontEnd(valobj_sp);
+}
+
+//----------------------------------------------------------------------
+// std::list
+//----------------------------------------------------------------------
+class LibStdcppListSyntheticFrontEnd : public SyntheticChildrenFrontEnd
+{
+public:
+    LibStdcppListSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp);
+
+    ~LibStdcppListSyntheticFrontEnd() override = default;
+
+    size_t
+    CalculateNumChildren() override;
+
+    lldb::ValueObjectSP
+    GetChildAtIndex(size_t idx) override;
+
+    bool
+    Update() override;
+
+    bool
+    MightHaveChildren() override;
+
+    size_t
+    GetIndexOfChildWithName (const ConstString &name) override;
+
+private:
+    bool
+    WalkToIndex (size_t idx);
+
+    NodeLinkReader m_reader;
+    lldb::addr_t m_head;            // The address of the list's own node, which ends the chain
+    size_t m_count;
+    size_t m_list_capping_size;
+    uint64_t m_value_offset;
+    CompilerType m_element_type;
+    std::vector<lldb::addr_t> m_nodes; // The nodes walked so far, in list order
+    std::map<size_t, lldb::ValueObjectSP> m_children;
+};
+
+/*
+ (std::__cxx11::list<int, std::allocator<int> >) numbers = {
+   std::__cxx11::_List_base<int, std::allocator<int> > = {
+     _M_impl = {
+       _M_node = {
+         std::__detail::_List_node_base = {
+           _M_next = 0x0000000000614c20
+           _M_prev = 0x0000000000614c60
+         }
+         _M_size = 3
+       }
+     }
+   }
+ }
+ */
+
+LibStdcppListSyntheticFrontEnd::LibStdcppListSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp) :
+    SyntheticChildrenFrontEnd(*valobj_sp),
+    m_reader(),
+    m_head(0),
+    m_count(0),
+    m_list_capping_size(0),
+    m_value_offset(0),
+    m_element_type(),
+    m_nodes(),
+    m_children()
+{
+    if (valobj_sp)
+        Update();
+}
+
+bool
+LibStdcppListSyntheticFrontEnd::Update()
+{
+    m_head = 0;
+    m_count = 0;
+    m_nodes.clear();
+    m_children.clear();
+
+    ProcessSP process_sp(m_backend.GetProcessSP());
+    if (!process_sp)
+        return false;
+    const uint32_t ptr_size = process_sp->GetAddressByteSize();
+    m_reader.Reset(process_sp, 0, 1, 0);
+
+    m_list_capping_size = 0;
+    if (m_backend.GetTargetSP())
+        m_list_capping_size = m_backend.GetTargetSP()->GetMaximumNumberOfChildrenToDisplay();
+    if (m_list_capping_size == 0)
+        m_list_capping_size = 255;
+
+    m_element_type = GetTemplateArgumentType(m_backend.GetCompilerType(), 0);
+    if (!m_element_type)
+        return false;
+    // The value follows the next and previous pointers of each node.
+    m_value_offset = GetNodeValueOffset(2 * ptr_size, m_element_type);
+
+    ValueObjectSP node_sp(m_backend.GetChildAtNamePath({ConstString("_M_impl"), ConstString("_M_node")}));
+    if (!node_sp)
+        return false;
+    m_head = node_sp->GetAddressOf(true, nullptr);
+    if (m_head == 0 || m_head == LLDB_INVALID_ADDRESS)
+    {
+        m_head = 0;
+        return false;
+    }
+
+    // libstdc++ 5 and 6 keep the size in the header node's _M_data, later
+    // versions in _M_size. Older versions have to walk the list.
+    ValueObjectSP size_sp(node_sp->GetChildMemberWithName(ConstString("_M_size"), true));
+    if (!size_sp)
+        size_sp = node_sp->GetChildMemberWithName(ConstString("_M_data"), true);
+    if (size_sp)
+    {
+        m_count = size_sp->GetValueAsUnsigned(0);
+        // Like the walk below, don't trust a size past the capping size
+        // unless the list really has that many nodes.
+        if (m_count > m_list_capping_size && !WalkToIndex(m_list_capping_size))
+            m_count = m_nodes.size();
+    }
+    else
+    {
+        WalkToIndex(m_list_capping_size);
+        m_count = m_nodes.size();
+    }
+    return false;
+}
+
+bool
+LibStdcppListSyntheticFrontEnd::WalkToIndex (size_t idx)
+{
+    while (m_nodes.size() <= idx)
+    {
+        const lldb::addr_t prev = m_nodes.empty() ? m_head : m_nodes.back();
+        lldb::addr_t next = 0;
+        if (!m_reader.GetLink(prev, 0, next))
+        {
+            // A node whose links can't be read isn't part of the chain.
+            if (!m_nodes.empty())
+                m_nodes.pop_back();
+            return false;
+        }
+        if (next == 0 || next == m_head)
+            return false;
+        m_nodes.push_back(next);
+    }
+    return true;
+}
+
+size_t
+LibStdcppListSyntheticFrontEnd::CalculateNumChildren ()
+{
+    return m_count;
+}
+
+lldb::ValueObjectSP
+LibStdcppListSyntheticFrontEnd::GetChildAtIndex (size_t idx)
+{
+    if (idx >= m_count || m_head == 0)
+        return lldb::ValueObjectSP();
+
+    auto cached = m_children.find(idx);
+    if (cached != m_children.end())
+        return cached->second;
+
+    if (!WalkToIndex(idx))
+    {
+        // The list ended early or is corrupt, don't claim more children
+        // than it has.
+        m_count = m_nodes.size();
+        return lldb::ValueObjectSP();
+    }
+
+    StreamString name;
+    name.Printf("[%" PRIu64 "]", (uint64_t)idx);
+    ValueObjectSP child_sp = CreateValueObjectFromAddress(name.GetData(), m_nodes[idx] + m_value_offset, m_backend.GetExecutionContextRef(), m_element_type);
+    m_children[idx] = child_sp;
+    return child_sp;
+}
+
+bool
+LibStdcppListSyntheticFrontEnd::MightHaveChildren ()
+{
+    return true;
+}
+
+size_t
+LibStdcppListSyntheticFrontEnd::GetIndexOfChildWithName (const ConstString &name)
+{
+    return ExtractIndexFromString(name.GetCString());
+}
+
+SyntheticChildrenFrontEnd*
+lldb_private::formatters::LibStdcppListSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP valobj_sp)
+{
+    return (valobj_sp ? new LibStdcppListSyntheticFrontEnd(valobj_sp) : nullptr);
+}
+
+//----------------------------------------------------------------------
+// std::map, std::multimap, std::set and std::multiset
+//----------------------------------------------------------------------
+class LibStdcppMapSyntheticFrontEnd : public SyntheticChildrenFrontEnd
+{
+public:
+    LibStdcppMapSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp);
+
+    ~LibStdcppMapSyntheticFrontEnd() override = default;
+
+    size_t
+    CalculateNumChildren() override;
+
+    lldb::ValueObjectSP
+    GetChildAtIndex(size_t idx) override;
+
+    bool
+    Update() override;
+
+    bool
+    MightHaveChildren() override;
+
+    size_t
+    GetIndexOfChildWithName (const ConstString &name) override;
+
+private:
+    // The links of _Rb_tree_node_base, which follow its color.
+    enum
+    {
+        eLinkParent = 0,
+        eLinkLeft,
+        eLinkRight,
+        eNumLinks
+    };
+
+    bool
+    WalkToIndex (size_t idx);
+
+    lldb::addr_t
+    GetNextNode (lldb::addr_t node);
+
+    NodeLinkReader m_reader;
+    lldb::addr_t m_header;          // The address of the tree's header node
+    size_t m_count;
+    size_t m_capping_size;
+    uint64_t m_value_offset;
+    CompilerType m_element_type;
+    std::vector<lldb::addr_t> m_nodes; // The nodes walked so far, in order
+    std::map<size_t, lldb::ValueObjectSP> m_children;
+};
+
+/*
+ (std::map<int, int, std::less<int>, std::allocator<std::pair<const int, int> > >) numbers = {
+   _M_t = {
+     _M_impl = {
+       _M_header = {
+         _M_color = _S_red
+         _M_parent = 0x0000000000614c20
+         _M_left = 0x0000000000614c80
+         _M_right = 0x0000000000614cb0
+       }
+       _M_node_count = 3
+     }
+   }
+ }
+ */
+
+LibStdcppMapSyntheticFrontEnd::LibStdcppMapSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp) :
+    SyntheticChildrenFrontEnd(*valobj_sp),
+    m_reader(),
+    m_header(0),
+    m_count(0),
+    m_capping_size(0),
+    m_value_offset(0),
+    m_element_type(),
+    m_nodes(),
+    m_children()
+{
+    if (valobj_sp)
+        Update();
+}
+
+bool
+LibStdcppMapSyntheticFrontEnd::Update()
+{
+    m_header = 0;
+    m_count = 0;
+    m_nodes.clear();
+    m_children.clear();
+
+    ProcessSP process_sp(m_backend.GetProcessSP());
+    if (!process_sp)
+        return false;
+    const uint32_t ptr_size = process_sp->GetAddressByteSize();
+
+    ValueObjectSP tree_sp(m_backend.GetChildMemberWithName(ConstString("_M_t"), true));
+    if (!tree_sp)
+        return false;
+    ValueObjectSP header_sp(tree_sp->GetChildAtNamePath({ConstString("_M_impl"), ConstString("_M_header")}));
+    ValueObjectSP count_sp(tree_sp->GetChildAtNamePath({ConstString("_M_impl"), ConstString("_M_node_count")}));
+    if (!header_sp || !count_sp)
+        return false;
+
+    // The value type is the second template argument of _Rb_tree, for
+    // std::map it is also the type of the allocator.
+    m_element_type = GetTemplateArgumentType(tree_sp->GetCompilerType(), 1);
+    if (!m_element_type)
+    {
+        CompilerType allocator_type(GetTemplateArgumentType(m_backend.GetCompilerType(), 3));
+        if (allocator_type)
+            m_element_type = GetTemplateArgumentType(allocator_type, 0);
+    }
+    if (!m_element_type)
+        return false;
+
+    // The value follows the _Rb_tree_node_base of each node.
+    const uint64_t node_base_size = header_sp->GetCompilerType().GetByteSize(nullptr);
+    if (node_base_size == 0)
+        return false;
+    m_value_offset = GetNodeValueOffset(node_base_size, m_element_type);
+
+    m_header = header_sp->GetAddressOf(true, nullptr);
+    if (m_header == 0 || m_header == LLDB_INVALID_ADDRESS)
+    {
+        m_header = 0;
+        return false;
+    }
+
+    // Read the children of every node along with the next node that is
+    // needed, an in order walk ends up needing most of them.
+    m_reader.Reset(process_sp, ptr_size, eNumLinks, (1u << eLinkLeft) | (1u << eLinkRight));
+    lldb::addr_t root = 0;
+    if (!m_reader.GetLink(m_header, eLinkParent, root) || root == 0)
+        return false;
+
+    m_capping_size = 0;
+    if (m_backend.GetTargetSP())
+        m_capping_size = m_backend.GetTargetSP()->GetMaximumNumberOfChildrenToDisplay();
+    if (m_capping_size == 0)
+        m_capping_size = 255;
+
+    // Don't trust a node count past the capping size unless the tree really
+    // has that many nodes.
+    m_count = count_sp->GetValueAsUnsigned(0);
+    if (m_count > m_capping_size && !WalkToIndex(m_capping_size))
+        m_count = m_nodes.size();
+    return false;
+}
+
+// Mirrors _Rb_tree_increment(), giving up on trees that take more steps
+// than they have nodes or than the height of any red-black tree, which is
+// at most twice the number of address bits. The latter keeps a garbage
+// node count from allowing a walk around a cycle for ages.
+lldb::addr_t
+LibStdcppMapSyntheticFrontEnd::GetNextNode (lldb::addr_t node)
+{
+    size_t max_steps = std::min<size_t>(m_count, 2 * 8 * sizeof(lldb::addr_t));
+    lldb::addr_t link = 0;
+    if (!m_reader.GetLink(node, eLinkRight, link))
+        return 0;
+    if (link != 0)
+    {
+        node = link;
+        while (m_reader.GetLink(node, eLinkLeft, link) && link != 0)
+        {
+            if (max_steps-- == 0)
+                return 0;
+            node = link;
+        }
+        return node;
+    }
+
+    lldb::addr_t parent = 0;
+    if (!m_reader.GetLink(node, eLinkParent, parent))
+        return 0;
+    while (m_reader.GetLink(parent, eLinkRight, link) && link == node)
+    {
+        if (max_steps-- == 0)
+            return 0;
+        node = parent;
+        if (!m_reader.GetLink(parent, eLinkParent, parent))
+            return 0;
+    }
+    if (!m_reader.GetLink(node, eLinkRight, link))
+        return 0;
+    if (link != parent)
+        node = parent;
+    return node;
+}
+
+bool
+LibStdcppMapSyntheticFrontEnd::WalkToIndex (size_t idx)
+{
+    while (m_nodes.size() <= idx)
+    {
+        lldb::addr_t node = 0;
+        if (m_nodes.empty())
+        {
+            // The header's left link is the leftmost node.
+            if (!m_reader.GetLink(m_header, eLinkLeft, node))
+                return false;
+        }
+        else
+            node = GetNextNode(m_nodes.back());
+        if (node == 0 || node == m_header)
+            return false;
+        m_nodes.push_back(node);
+    }
+    return true;
+}
+
+size_t
+LibStdcppMapSyntheticFrontEnd::CalculateNumChildren ()
+{
+    return m_count;
+}
+
+lldb::ValueObjectSP
+LibStdcppMapSyntheticFrontEnd::GetChildAtIndex (size_t idx)
+{
+    if (idx >= m_count || m_header == 0)
+        return lldb::ValueObjectSP();
+
+    auto cached = m_children.find(idx);
+    if (cached != m_children.end())
+        return cached->second;
+
+    if (!WalkToIndex(idx))
+    {
+        // A garbage tree, only show the nodes that could be walked.
+        m_count = m_nodes.size();
+        return lldb::ValueObjectSP();
+    }
+
+    StreamString name;
+    name.Printf("[%" PRIu64 "]", (uint64_t)idx);
+    ValueObjectSP child_sp = CreateValueObjectFromAddress(name.GetData(), m_nodes[idx] + m_value_offset, m_backend.GetExecutionContextRef(), m_element_type);
+    m_children[idx] = child_sp;
+    return child_sp;
+}
+
+bool
+LibStdcppMapSyntheticFrontEnd::MightHaveChildren ()
+{
+    return true;
+}
+
+size_t
+LibStdcppMapSyntheticFrontEnd::GetIndexOfChildWithName (const ConstString &name)
+{
+    return ExtractIndexFromString(name.GetCString());
+}
+
+SyntheticChildrenFrontEnd*
+lldb_private::formatters::LibStdcppMapSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP valobj_sp)
+{
+    return (valobj_sp ? new LibStdcppMapSyntheticFrontEnd(valobj_sp) : nullptr);
+}
+
+//----------------------------------------------------------------------
+// std::unordered_map, std::unordered_multimap, std::unordered_set and
+// std::unordered_multiset
+//----------------------------------------------------------------------
+class LibStdcppUnorderedSyntheticFrontEnd : public SyntheticChildrenFrontEnd
+{
+public:
+    LibStdcppUnorderedSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp);
+
+    ~LibStdcppUnorderedSyntheticFrontEnd() override = default;
+
+    size_t
+    CalculateNumChildren() override;
+
+    lldb::ValueObjectSP
+    GetChildAtIndex(size_t idx) override;
+
+    bool
+    Update() override;
+
+    bool
+    MightHaveChildren() override;
+
+    size_t
+    GetIndexOfChildWithName (const ConstString &name) override;
+
+private:
+    bool
+    WalkToIndex (size_t idx);
+
+    NodeLinkReader m_reader;
+    lldb::addr_t m_before_begin;    // The address of the node before the first one
+    size_t m_count;
+    size_t m_capping_size;
+    uint64_t m_value_offset;
+    CompilerType m_element_type;
+    std::vector<lldb::addr_t> m_nodes; // The nodes walked so far, in iteration order
+    std::map<size_t, lldb::ValueObjectSP> m_children;
+};
+
+/*
+ (std::unordered_map<int, int, std::hash<int>, std::equal_to<int>, std::allocator<std::pair<const int, int> > >) numbers = {
+   _M_h = {
+     _M_buckets = 0x0000000000614c20
+     _M_bucket_count = 7
+     _M_before_begin = {
+       _M_nxt = 0x0000000000614cb0
+     }
+     _M_element_count = 3
+     ...
+   }
+ }
+ */
+
+LibStdcppUnorderedSyntheticFrontEnd::LibStdcppUnorderedSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp) :
+    SyntheticChildrenFrontEnd(*valobj_sp),
+    m_reader(),
+    m_before_begin(0),
+    m_count(0),
+    m_capping_size(0),
+    m_value_offset(0),
+    m_element_type(),
+    m_nodes(),
+    m_children()
+{
+    if (valobj_sp)
+        Update();
+}
+
+bool
+LibStdcppUnorderedSyntheticFrontEnd::Update()
+{
+    m_before_begin = 0;
+    m_count = 0;
+    m_nodes.clear();
+    m_children.clear();
+
+    ProcessSP process_sp(m_backend.GetProcessSP());
+    if (!process_sp)
+        return false;
+    const uint32_t ptr_size = process_sp->GetAddressByteSize();
+    m_reader.Reset(process_sp, 0, 1, 0);
+
+    ValueObjectSP hashtable_sp(m_backend.GetChildMemberWithName(ConstString("_M_h"), true));
+    if (!hashtable_sp)
+        return false;
+    ValueObjectSP before_begin_sp(hashtable_sp->GetChildMemberWithName(ConstString("_M_before_begin"), true));
+    ValueObjectSP count_sp(hashtable_sp->GetChildMemberWithName(ConstString("_M_element_count"), true));
+    if (!before_begin_sp || !count_sp)
+        return false;
+
+    // The value type is the second template argument of _Hashtable.
+    m_element_type = GetTemplateArgumentType(hashtable_sp->GetCompilerType(), 1);
+    if (!m_element_type)
+        return false;
+    // The value follows the next pointer of each node.
+    m_value_offset = GetNodeValueOffset(ptr_size, m_element_type);
+
+    m_before_begin = before_begin_sp->GetAddressOf(true, nullptr);
+    if (m_before_begin == 0 || m_before_begin == LLDB_INVALID_ADDRESS)
+    {
+        m_before_begin = 0;
+        return false;
+    }
+    m_capping_size = 0;
+    if (m_backend.GetTargetSP())
+        m_capping_size = m_backend.GetTargetSP()->GetMaximumNumberOfChildrenToDisplay();
+    if (m_capping_size == 0)
+        m_capping_size = 255;
+
+    // Don't trust an element count past the capping size unless the chain
+    // really has that many nodes.
+    m_count = count_sp->GetValueAsUnsigned(0);
+    if (m_count > m_capping_size && !WalkToIndex(m_capping_size))
+        m_count = m_nodes.size();
+    return false;
+}
+
+bool
+LibStdcppUnorderedSyntheticFrontEnd::WalkToIndex (size_t idx)
+{
+    while (m_nodes.size() <= idx)
+    {
+        const lldb::addr_t prev = m_nodes.empty() ? m_before_begin : m_nodes.back();
+        lldb::addr_t next = 0;
+        if (!m_reader.GetLink(prev, 0, next))
+        {
+            // A node whose links can't be read isn't part of the chain.
+            if (!m_nodes.empty())
+                m_nodes.pop_back();
+            return false;
+        }
+        if (next == 0 || next == m_before_begin)
+            return false;
+        m_nodes.push_back(next);
+    }
+    return true;
+}
+
+size_t
+LibStdcppUnorderedSyntheticFrontEnd::CalculateNumChildren ()
+{
+    return m_count;
+}
+
+lldb::ValueObjectSP
+LibStdcppUnorderedSyntheticFrontEnd::GetChildAtIndex (size_t idx)
+{
+    if (idx >= m_count || m_before_begin == 0)
+        return lldb::ValueObjectSP();
+
+    auto cached = m_children.find(idx);
+    if (cached != m_children.end())
+        return cached->second;
+
+    if (!WalkToIndex(idx))
+    {
+        m_count = m_nodes.size();
+        return lldb::ValueObjectSP();
+    }
+
+    StreamString name;
+    name.Printf("[%" PRIu64 "]", (uint64_t)idx);
+    ValueObjectSP child_sp = CreateValueObjectFromAddress(name.GetData(), m_nodes[idx] + m_value_offset, m_backend.GetExecutionContextRef(), m_element_type);
+    m_children[idx] = child_sp;
+    return child_sp;
+}
+
+bool
+LibStdcppUnorderedSyntheticFrontEnd::MightHaveChildren ()
+{
+    return true;
+}
+
+size_t
+LibStdcppUnorderedSyntheticFrontEnd::GetIndexOfChildWithName (const ConstString &name)
+{
+    return ExtractIndexFromString(name.GetCString());
+}
+
+SyntheticChildrenFrontEnd*
+lldb_private::formatters::LibStdcppUnorderedSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP valobj_sp)
+{
+    return (valobj_sp ? new LibStdcppUnorderedSyntheticFrontEnd(valobj_sp) : nullptr);
+}
+
+//----------------------------------------------------------------------
+// std::deque
+//----------------------------------------------------------------------
+class LibStdcppDequeSyntheticFrontEnd : public SyntheticChildrenFrontEnd
+{
+public:
+    LibStdcppDequeSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp);
+
+    ~LibStdcppDequeSyntheticFrontEnd() override = default;
+
+    size_t
+    CalculateNumChildren() override;
+
+    lldb::ValueObjectSP
+    GetChildAtIndex(size_t idx) override;
+
+    bool
+    Update() override;
+
+    bool
+    MightHaveChildren() override;
+
+    size_t
+    GetIndexOfChildWithName (const ConstString &name) override;
+
+private:
+    bool
+    ReadBuffers (size_t buffer_idx);
+
+    lldb::addr_t m_first_node;      // The address of the map entry of the first buffer
+    size_t m_num_buffers;
+    size_t m_start_idx;             // The index of the first element in the first buffer
+    size_t m_buffer_size;           // The number of elements in each buffer
+    size_t m_count;
+    CompilerType m_element_type;
+    uint64_t m_element_size;
+    std::vector<lldb::addr_t> m_buffers; // The addresses of the buffers read so far
+    std::map<size_t, lldb::ValueObjectSP> m_children;
+};
+
+/*
+ (std::deque<int, std::allocator<int> >) numbers = {
+   std::_Deque_base<int, std::allocator<int> > = {
+     _M_impl = {
+       _M_map = 0x0000000000614c20
+       _M_map_size = 8
+       _M_start = (_M_cur = 0x0000000000614c90, _M_first = 0x0000000000614c90, _M_last = 0x0000000000614e90, _M_node = 0x0000000000614c38)
+       _M_finish = (_M_cur = 0x0000000000614c9c, _M_first = 0x0000000000614c90, _M_last = 0x0000000000614e90, _M_node = 0x0000000000614c38)
+     }
+   }
+ }
+ */
+
+LibStdcppDequeSyntheticFrontEnd::LibStdcppDequeSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp) :
+    SyntheticChildrenFrontEnd(*valobj_sp),
+    m_first_node(0),
+    m_num_buffers(0),
+    m_start_idx(0),
+    m_buffer_size(0),
+    m_count(0),
+    m_element_type(),
+    m_element_size(0),
+    m_buffers(),
+    m_children()
+{
+    if (valobj_sp)
+        Update();
+}
+
+bool
+LibStdcppDequeSyntheticFrontEnd::Update()
+{
+    m_first_node = 0;
+    m_num_buffers = 0;
+    m_count = 0;
+    m_buffers.clear();
+    m_children.clear();
+
+    ProcessSP process_sp(m_backend.GetProcessSP());
+    if (!process_sp)
+        return false;
+    const uint32_t ptr_size = process_sp->GetAddressByteSize();
+
+    ValueObjectSP impl_sp(m_backend.GetChildMemberWithName(ConstString("_M_impl"), true));
+    if (!impl_sp)
+        return false;
+    ValueObjectSP map_sp(impl_sp->GetChildMemberWithName(ConstString("_M_map"), true));
+    ValueObjectSP map_size_sp(impl_sp->GetChildMemberWithName(ConstString("_M_map_size"), true));
+    ValueObjectSP start_sp(impl_sp->GetChildMemberWithName(ConstString("_M_start"), true));
+    ValueObjectSP finish_sp(impl_sp->GetChildMemberWithName(ConstString("_M_finish"), true));
+    if (!map_sp || !map_size_sp || !start_sp || !finish_sp)
+        return false;
+
+    ValueObjectSP start_cur_sp(start_sp->GetChildMemberWithName(ConstString("_M_cur"), true));
+    ValueObjectSP start_first_sp(start_sp->GetChildMemberWithName(ConstString("_M_first"), true));
+    ValueObjectSP start_last_sp(start_sp->GetChildMemberWithName(ConstString("_M_last"), true));
+    ValueObjectSP start_node_sp(start_sp->GetChildMemberWithName(ConstString("_M_node"), true));
+    ValueObjectSP finish_cur_sp(finish_sp->GetChildMemberWithName(ConstString("_M_cur"), true));
+    ValueObjectSP finish_first_sp(finish_sp->GetChildMemberWithName(ConstString("_M_first"), true));
+    ValueObjectSP finish_last_sp(finish_sp->GetChildMemberWithName(ConstString("_M_last"), true));
+    ValueObjectSP finish_node_sp(finish_sp->GetChildMemberWithName(ConstString("_M_node"), true));
+    if (!start_cur_sp || !start_first_sp || !start_last_sp || !start_node_sp ||
+        !finish_cur_sp || !finish_first_sp || !finish_last_sp || !finish_node_sp)
+        return false;
+
+    m_element_type = start_cur_sp->GetCompilerType().GetPointeeType();
+    m_element_size = m_element_type.GetByteSize(nullptr);
+    if (m_element_size == 0)
+        return false;
+
+    const lldb::addr_t map = map_sp->GetValueAsUnsigned(0);
+    const uint64_t map_size = map_size_sp->GetValueAsUnsigned(0);
+    const lldb::addr_t start_cur = start_cur_sp->GetValueAsUnsigned(0);
+    const lldb::addr_t start_first = start_first_sp->GetValueAsUnsigned(0);
+    const lldb::addr_t start_last = start_last_sp->GetValueAsUnsigned(0);
+    const lldb::addr_t start_node = start_node_sp->GetValueAsUnsigned(0);
+    const lldb::addr_t finish_cur = finish_cur_sp->GetValueAsUnsigned(0);
+    const lldb::addr_t finish_first = finish_first_sp->GetValueAsUnsigned(0);
+    const lldb::addr_t finish_last = finish_last_sp->GetValueAsUnsigned(0);
+    const lldb::addr_t finish_node = finish_node_sp->GetValueAsUnsigned(0);
+
+    // Make sure an unconstructed deque's garbage doesn't turn into a huge
+    // number of children: both nodes have to be entries of the map and
+    // the iterators have to point into buffers of the same size.
+    if (map == 0 || map_size == 0 || map_size > (UINT64_MAX - map) / ptr_size)
+        return false;
+    const lldb::addr_t map_end = map + map_size * ptr_size;
+    if (start_node < map || finish_node < start_node || finish_node >= map_end)
+        return false;
+    if ((start_node - map) % ptr_size != 0 || (finish_node - start_node) % ptr_size != 0)
+        return false;
+    // An iterator that reaches the end of its buffer moves on to the next
+    // one, so _M_cur is always before _M_last.
+    if (start_first == 0 || start_first > start_cur || start_cur >= start_last)
+        return false;
+    if (finish_first == 0 || finish_first > finish_cur || finish_cur >= finish_last)
+        return false;
+    if (start_last - start_first != finish_last - finish_first)
+        return false;
+    if ((start_last - start_first) % m_element_size != 0 ||
+        (start_cur - start_first) % m_element_size != 0 ||
+        (finish_cur - finish_first) % m_element_size != 0)
+        return false;
+
+    m_buffer_size = (start_last - start_first) / m_element_size;
+    if (m_buffer_size == 0)
+        return false;
+    m_first_node = start_node;
+    m_num_buffers = (finish_node - start_node) / ptr_size + 1;
+    m_start_idx = (start_cur - start_first) / m_element_size;
+    const size_t finish_idx = (finish_cur - finish_first) / m_element_size;
+    if (m_num_buffers == 1 && finish_idx < m_start_idx)
+    {
+        m_num_buffers = 0;
+        return false;
+    }
+    m_count = (m_num_buffers - 1) * m_buffer_size + finish_idx - m_start_idx;
+    return false;
+}
+
+bool
+LibStdcppDequeSyntheticFrontEnd::ReadBuffers (size_t buffer_idx)
+{
+    if (buffer_idx < m_buffers.size())
+        return true;
+    if (buffer_idx >= m_num_buffers)
+        return false;
+
+    ProcessSP process_sp(m_backend.GetProcessSP());
+    if (!process_sp)
+        return false;
+    const uint32_t ptr_size = process_sp->GetAddressByteSize();
+
+    // The buffer addresses are contiguous in the deque's map. Read ahead in
+    // chunks that double in size, so printing the first children of a
+    // huge deque doesn't read its whole map and printing all of them only
+    // takes a few reads.
+    const size_t old_count = m_buffers.size();
+    size_t new_count = std::max<size_t>(std::max<size_t>(buffer_idx + 1, 2 * old_count), 64);
+    new_count = std::min(new_count, m_num_buffers);
+    DataBufferHeap buffer((new_count - old_count) * ptr_size, 0);
+    Error error;
+    const size_t bytes_read = process_sp->ReadMemory(m_first_node + old_count * ptr_size, buffer.GetBytes(), buffer.GetByteSize(), error);
+    DataExtractor data(buffer.GetBytes(), bytes_read, process_sp->GetByteOrder(), ptr_size);
+    lldb::offset_t offset = 0;
+    for (size_t i = 0; i < bytes_read / ptr_size; ++i)
+        m_buffers.push_back(data.GetPointer(&offset));
+    return buffer_idx < m_buffers.size();
+}
+
+size_t
+LibStdcppDequeSyntheticFrontEnd::CalculateNumChildren ()
+{
+    return m_count;
+}
+
+lldb::ValueObjectSP
+LibStdcppDequeSyntheticFrontEnd::GetChildAtIndex (size_t idx)
+{
+    if (idx >= m_count)
+        return lldb::ValueObjectSP();
+
+    auto cached = m_children.find(idx);
+    if (cached != m_children.end())
+        return cached->second;
+
+    const size_t position = m_start_idx + idx;
+    const size_t buffer_idx = position / m_buffer_size;
+    if (!ReadBuffers(buffer_idx) || m_buffers[buffer_idx] == 0)
+        return lldb::ValueObjectSP();
+
+    StreamString name;
+    name.Printf("[%" PRIu64 "]", (uint64_t)idx);
+    const lldb::addr_t element_addr = m_buffers[buffer_idx] + (position % m_buffer_size) * m_element_size;
+    ValueObjectSP child_sp = CreateValueObjectFromAddress(name.GetData(), element_addr, m_backend.GetExecutionContextRef(), m_element_type);
+    m_children[idx] = child_sp;
+    return child_sp;
+}
+
+bool
+LibStdcppDequeSyntheticFrontEnd::MightHaveChildren ()
+{
+    return true;
+}
+
+size_t
+LibStdcppDequeSyntheticFrontEnd::GetIndexOfChildWithName (const ConstString &name)
+{
+    return ExtractIndexFromString(name.GetCString());
+}
+
+SyntheticChildrenFrontEnd*
+lldb_private::formatters::LibStdcppDequeSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP valobj_sp)
+{
+    return (valobj_sp ? new LibStdcppDequeSyntheticFrontEnd(valobj_sp) : nullptr);
+}
+
+//----------------------------------------------------------------------
+// std::shared_ptr and std::weak_ptr
+//----------------------------------------------------------------------
+class LibStdcppSharedPtrSyntheticFrontEnd : public SyntheticChildrenFrontEnd
+{
+public:
+    LibStdcppSharedPtrSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp);
+
+    ~LibStdcppSharedPtrSyntheticFrontEnd() override = default;
+
+    size_t
+    CalculateNumChildren() override;
+
+    lldb::ValueObjectSP
+    GetChildAtIndex(size_t idx) override;
+
+    bool
+    Update() override;
+
+    bool
+    MightHaveChildren() override;
+
+    size_t
+    GetIndexOfChildWithName (const ConstString &name) override;
+
+private:
+    ValueObject* m_ptr;         // Raw pointers to children of the backend to avoid a circular dependency
+    ValueObject* m_use_count;
+    ValueObject* m_weak_count;
+};
+
+/*
+ (std::shared_ptr<int>) pointer = {
+   std::__shared_ptr<int, __gnu_cxx::_S_atomic> = {
+     _M_ptr = 0x0000000000614c30
+     _M_refcount = {
+       _M_pi = 0x0000000000614c20
+     }
+   }
+ }
+ */
+
+LibStdcppSharedPtrSyntheticFrontEnd::LibStdcppSharedPtrSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp) :
+    SyntheticChildrenFrontEnd(*valobj_sp),
+    m_ptr(nullptr),
+    m_use_count(nullptr),
+    m_weak_count(nullptr)
+{
+    if (valobj_sp)
+        Update();
+}
+
+bool
+LibStdcppSharedPtrSyntheticFrontEnd::Update()
+{
+    m_ptr = m_backend.GetChildMemberWithName(ConstString("_M_ptr"), true).get();
+    m_use_count = m_backend.GetChildAtNamePath({ConstString("_M_refcount"), ConstString("_M_pi"), ConstString("_M_use_count")}).get();
+    m_weak_count = m_backend.GetChildAtNamePath({ConstString("_M_refcount"), ConstString("_M_pi"), ConstString("_M_weak_count")}).get();
+    return false;
+}
+
+size_t
+LibStdcppSharedPtrSyntheticFrontEnd::CalculateNumChildren ()
+{
+    return (m_ptr ? 1 : 0);
+}
+
+lldb::ValueObjectSP
+LibStdcppSharedPtrSyntheticFrontEnd::GetChildAtIndex (size_t idx)
+{
+    ValueObject *child = nullptr;
+    switch (idx)
+    {
+        case 0: child = m_ptr; break;
+        case 1: child = m_use_count; break;
+        case 2: child = m_weak_count; break;
+        default: break;
+    }
+    return (child ? child->GetSP() : lldb::ValueObjectSP());
+}
+
+bool
+LibStdcppSharedPtrSyntheticFrontEnd::MightHaveChildren ()
+{
+    return true;
+}
+
+size_t
+LibStdcppSharedPtrSyntheticFrontEnd::GetIndexOfChildWithName (const ConstString &name)
+{
+    if (name == ConstString("_M_ptr"))
+        return 0;
+    if (name == ConstString("count"))
+        return 1;
+    if (name == ConstString("weak_count"))
+        return 2;
+    return UINT32_MAX;
+}
+
+SyntheticChildrenFrontEnd*
+lldb_private::formatters::LibStdcppSharedPtrSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP valobj_sp)
+{
+    return (valobj_sp ? new LibStdcppSharedPtrSyntheticFrontEnd(valobj_sp) : nullptr);
+}
+
+bool
+lldb_private::formatters::LibStdcppSmartPointerSummaryProvider (ValueObject& valobj, Stream& stream, const TypeSummaryOptions& options)
+{
+    ValueObjectSP valobj_sp(valobj.GetNonSyntheticValue());
+    if (!valobj_sp)
+        return false;
+    ValueObjectSP ptr_sp(valobj_sp->GetChildMemberWithName(ConstString("_M_ptr"), true));
+    if (!ptr_sp)
+        return false;
+
+    if (ptr_sp->GetValueAsUnsigned(0) == 0)
+    {
+        stream.Printf("nullptr");
+        return true;
+    }
+
+    bool print_pointee = false;
+    Error error;
+    ValueObjectSP pointee_sp = ptr_sp->Dereference(error);
+    if (pointee_sp && error.Success())
+    {
+        if (pointee_sp->DumpPrintableRepresentation(stream,
+                                                    ValueObject::eValueObjectRepresentationStyleSummary,
+                                                    lldb::eFormatInvalid,
+                                                    ValueObject::ePrintableRepresentationSpecialCasesDisable,
+                                                    false))
+            print_pointee = true;
+    }
+    if (!print_pointee)
+        stream.Printf("ptr = 0x%" PRIx64, ptr_sp->GetValueAsUnsigned(0));
+
+    // Unlike libc++, libstdc++ stores the counts themselves, the weak count
+    // includes one for all the strong references.
+    ValueObjectSP use_count_sp(valobj_sp->GetChildAtNamePath({ConstString("_M_refcount"), ConstString("_M_pi"), ConstString("_M_use_count")}));
+    ValueObjectSP weak_count_sp(valobj_sp->GetChildAtNamePath({ConstString("_M_refcount"), ConstString("_M_pi"), ConstString("_M_weak_count")}));
+    if (use_count_sp)
+        stream.Printf(" strong=%" PRIu64, use_count_sp->GetValueAsUnsigned(0));
+    if (weak_count_sp)
+        stream.Printf(" weak=%" PRIu64, weak_count_sp->GetValueAsUnsigned(0));
+    return true;
+}
@@ -24,9 +24,24 @@ namespace lldb_private {
         bool
         LibStdcppWStringSummaryProvider (ValueObject& valobj, Stream& stream, const TypeSummaryOptions& options); // libcstdc++ c++11 std::wstring
 
+        bool
+        LibStdcppSmartPointerSummaryProvider (ValueObject& valobj, Stream& stream, const TypeSummaryOptions& options); // libstdc++ std::shared_ptr<> and std::weak_ptr<>
+
         SyntheticChildrenFrontEnd* LibstdcppMapIteratorSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP);
         
         SyntheticChildrenFrontEnd* LibStdcppVectorIteratorSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP);
+
+        SyntheticChildrenFrontEnd* LibStdcppVectorSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP); // std::vector<T> and std::vector<bool>
+
+        SyntheticChildrenFrontEnd* LibStdcppListSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP);
+
+        SyntheticChildrenFrontEnd* LibStdcppMapSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP); // std::map, std::multimap, std::set and std::multiset
+
+        SyntheticChildrenFrontEnd* LibStdcppUnorderedSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP); // std::unordered_(multi)map and std::unordered_(multi)set
+
+        SyntheticChildrenFrontEnd* LibStdcppDequeSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP);
+
+        SyntheticChildrenFrontEnd* LibStdcppSharedPtrSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP); // std::shared_ptr<> and std::weak_ptr<>
     } // namespace formatters
 } // namespace lldb_private
 
@@ -0,0 +1,139 @@
+//===-- NodeLinkReader.cpp --------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "NodeLinkReader.h"
+
+// C Includes
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/DataBufferHeap.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/Error.h"
+#include "lldb/Target/Process.h"
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::formatters;
+
+namespace
+{
+    // The most nodes queued to be read along with the next node a walk
+    // over a linked container needs.
+    const size_t k_max_prefetched_nodes = 1024;
+}
+
+NodeLinkReader::NodeLinkReader () :
+    m_process_wp(),
+    m_byte_order(eByteOrderInvalid),
+    m_ptr_size(0),
+    m_links_offset(0),
+    m_num_links(0),
+    m_prefetch_link_mask(0),
+    m_node_links(),
+    m_links(),
+    m_pending()
+{
+}
+
+void
+NodeLinkReader::Reset (const ProcessSP &process_sp, uint32_t links_offset, uint32_t num_links, uint32_t prefetch_link_mask)
+{
+    m_process_wp = process_sp;
+    m_byte_order = process_sp ? process_sp->GetByteOrder() : eByteOrderInvalid;
+    m_ptr_size = process_sp ? process_sp->GetAddressByteSize() : 0;
+    m_links_offset = links_offset;
+    m_num_links = num_links;
+    m_prefetch_link_mask = prefetch_link_mask;
+    m_node_links.clear();
+    m_links.clear();
+    m_pending.clear();
+}
+
+bool
+NodeLinkReader::GetLink (addr_t node_addr, uint32_t link_idx, addr_t &link)
+{
+    if (node_addr == 0 || link_idx >= m_num_links)
+        return false;
+    auto pos = m_node_links.find(node_addr);
+    if (pos == m_node_links.end())
+    {
+        ReadNodeLinks(node_addr);
+        pos = m_node_links.find(node_addr);
+        if (pos == m_node_links.end())
+            return false;
+    }
+    link = m_links[pos->second + link_idx];
+    return true;
+}
+
+void
+NodeLinkReader::ReadNodeLinks (addr_t node_addr)
+{
+    ProcessSP process_sp(m_process_wp.lock());
+    if (!process_sp || m_ptr_size == 0)
+        return;
+
+    std::vector<addr_t> node_addrs(1, node_addr);
+    for (addr_t pending_addr : m_pending)
+    {
+        if (pending_addr != node_addr && m_node_links.find(pending_addr) == m_node_links.end())
+            node_addrs.push_back(pending_addr);
+    }
+    m_pending.clear();
+
+    const size_t links_size = m_num_links * m_ptr_size;
+    DataBufferHeap buffer(node_addrs.size() * links_size, 0);
+    Process::MemoryRangeReads reads(node_addrs.size());
+    for (size_t i = 0; i < node_addrs.size(); ++i)
+    {
+        reads[i].addr = node_addrs[i] + m_links_offset;
+        reads[i].buf = buffer.GetBytes() + i * links_size;
+        reads[i].size = links_size;
+        reads[i].bytes_read = 0;
+    }
+
+    if (reads.size() == 1)
+    {
+        // Nodes allocated one after the other are often next to each
+        // other, the memory cache reads ahead for those.
+        Error error;
+        reads[0].bytes_read = process_sp->ReadMemory(reads[0].addr, reads[0].buf, reads[0].size, error);
+    }
+    else
+        process_sp->ReadMemoryRanges(reads);
+
+    for (size_t i = 0; i < reads.size(); ++i)
+    {
+        if (reads[i].bytes_read != links_size || m_node_links.find(node_addrs[i]) != m_node_links.end())
+            continue;
+        DataExtractor data(reads[i].buf, links_size, m_byte_order, m_ptr_size);
+        offset_t offset = 0;
+        m_node_links[node_addrs[i]] = m_links.size();
+        for (uint32_t link_idx = 0; link_idx < m_num_links; ++link_idx)
+        {
+            const addr_t link = data.GetPointer(&offset);
+            m_links.push_back(link);
+            if ((m_prefetch_link_mask & (1u << link_idx)) != 0 &&
+                link != 0 &&
+                m_pending.size() < k_max_prefetched_nodes &&
+                m_node_links.find(link) == m_node_links.end())
+                m_pending.push_back(link);
+        }
+    }
+}
+
+uint64_t
+lldb_private::formatters::GetNodeValueOffset (uint64_t offset, const CompilerType &value_type)
+{
+    const uint64_t align = value_type.GetTypeBitAlign() / 8;
+    if (align > 1)
+        offset = (offset + align - 1) / align * align;
+    return offset;
+}
@@ -0,0 +1,103 @@
+//===-- NodeLinkReader.h ----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_NodeLinkReader_h_
+#define liblldb_NodeLinkReader_h_
+
+// C Includes
+// C++ Includes
+#include <map>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+#include "lldb/Symbol/CompilerType.h"
+
+namespace lldb_private {
+    namespace formatters
+    {
+        //----------------------------------------------------------------------
+        /// @class NodeLinkReader NodeLinkReader.h
+        /// @brief Reads the links of the nodes of a linked container.
+        ///
+        /// The synthetic children of lists, trees and hash tables walk their
+        /// nodes through links like the next pointer of a list node or the
+        /// parent and child pointers of a tree node. Reading those through
+        /// ValueObjects costs a memory read per link.
+        ///
+        /// This reads all the links of a node at once and keeps them. The
+        /// nodes found through the links selected by the prefetch mask are
+        /// queued and read along with the next node that isn't known yet,
+        /// with a single Process::ReadMemoryRanges() call. Walking a tree in
+        /// order then reads its nodes about one level at a time.
+        //----------------------------------------------------------------------
+        class NodeLinkReader
+        {
+        public:
+            NodeLinkReader ();
+
+            //------------------------------------------------------------------
+            /// Forget all the nodes read and describe the nodes to read.
+            ///
+            /// @param[in] process_sp
+            ///     The process to read the nodes from.
+            ///
+            /// @param[in] links_offset
+            ///     The offset of the first link in a node.
+            ///
+            /// @param[in] num_links
+            ///     The number of consecutive pointers read from each node.
+            ///
+            /// @param[in] prefetch_link_mask
+            ///     The links, as a bit per link index, whose nodes are read
+            ///     along with the next node needed.
+            //------------------------------------------------------------------
+            void
+            Reset (const lldb::ProcessSP &process_sp, uint32_t links_offset, uint32_t num_links, uint32_t prefetch_link_mask);
+
+            //------------------------------------------------------------------
+            /// Get a link of a node, reading the node if needed.
+            ///
+            /// @return
+            ///     False if the node is null or can't be read.
+            //------------------------------------------------------------------
+            bool
+            GetLink (lldb::addr_t node_addr, uint32_t link_idx, lldb::addr_t &link);
+
+            uint32_t
+            GetPointerSize () const
+            {
+                return m_ptr_size;
+            }
+
+        private:
+            void
+            ReadNodeLinks (lldb::addr_t node_addr);
+
+            lldb::ProcessWP m_process_wp;
+            lldb::ByteOrder m_byte_order;
+            uint32_t m_ptr_size;
+            uint32_t m_links_offset;
+            uint32_t m_num_links;
+            uint32_t m_prefetch_link_mask;
+            std::map<lldb::addr_t, size_t> m_node_links; // Node address to the index of its first link in m_links
+            std::vector<lldb::addr_t> m_links;
+            std::vector<lldb::addr_t> m_pending;
+        };
+
+        // The offset of a value of value_type that follows offset bytes of
+        // links in a node.
+        uint64_t
+        GetNodeValueOffset (uint64_t offset, const CompilerType &value_type);
+
+    } // namespace formatters
+} // namespace lldb_private
+
+#endif // liblldb_NodeLinkReader_h_
@@ -15,6 +15,7 @@
 
 #include "lldb/Core/ArchSpec.h"
 #include "lldb/Core/DataBuffer.h"
+#include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Core/Error.h"
 #include "lldb/Core/FileSpecList.h"
 #include "lldb/Core/Log.h"
@@ -33,6 +34,10 @@
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/MathExtras.h"
 
+#if defined (HAVE_LIBZ)
+#include <zlib.h>
+#endif
+
 #define CASE_AND_STREAM(s, def, width)                  \
     case def: s->Printf("%-*s", width, #def); break;
 
@@ -104,6 +109,10 @@ const elf_word LLDB_NT_GNU_ABI_OS_SOLARIS = 0x02;
 #define NT_METAG_RPIPE          0x501
 #define NT_METAG_TLS            0x502
 
+// Compressed section definitions
+const elf_xword LLDB_SHF_COMPRESSED     = 0x800;
+const elf_word LLDB_ELFCOMPRESS_ZLIB    = 1;
+
 //===----------------------------------------------------------------------===//
 /// @class ELFRelocation
 /// @brief Generic wrapper for ELFRel and ELFRela.
@@ -1732,6 +1741,193 @@ ObjectFileELF::StripLinkerSymbolAnnotations(llvm::StringRef symbol_name) const
     return symbol_name.substr(0, pos).str();
 }
 
+bool
+ObjectFileELF::IsSectionCompressed(const Section *section)
+{
+    static ConstString g_zdebug_prefix (".zdebug_");
+    return section->Test(LLDB_SHF_COMPRESSED) ||
+           section->GetName().GetStringRef().startswith(g_zdebug_prefix.GetStringRef());
+}
+
+size_t
+ObjectFileELF::ReadSectionData(const Section *section,
+                               lldb::offset_t section_offset,
+                               void *dst,
+                               size_t dst_len) const
+{
+    if (section->GetObjectFile() != this || IsInMemory() || !IsSectionCompressed(section))
+        return ObjectFile::ReadSectionData(section, section_offset, dst, dst_len);
+
+    DataBufferSP data_sp (GetDecompressedSectionData(section));
+    if (!data_sp || section_offset >= data_sp->GetByteSize())
+        return 0;
+
+    const size_t bytes_to_copy = std::min<size_t>(dst_len, data_sp->GetByteSize() - section_offset);
+    ::memcpy(dst, data_sp->GetBytes() + section_offset, bytes_to_copy);
+    return bytes_to_copy;
+}
+
+size_t
+ObjectFileELF::ReadSectionData(const Section *section, DataExtractor& section_data) const
+{
+    if (section->GetObjectFile() != this || IsInMemory() || !IsSectionCompressed(section))
+        return ObjectFile::ReadSectionData(section, section_data);
+
+    DataBufferSP data_sp (GetDecompressedSectionData(section));
+    if (!data_sp)
+    {
+        section_data.Clear();
+        return 0;
+    }
+
+    section_data.SetData(data_sp);
+    section_data.SetByteOrder(m_data.GetByteOrder());
+    section_data.SetAddressByteSize(m_data.GetAddressByteSize());
+    return section_data.GetByteSize();
+}
+
+DataBufferSP
+ObjectFileELF::GetDecompressedSectionData(const Section *section) const
+{
+    {
+        std::lock_guard<std::mutex> guard(m_decompressed_sections_mutex);
+        auto pos = m_decompressed_sections.find(section->GetID());
+        if (pos != m_decompressed_sections.end())
+            return pos->second;
+    }
+
+    // Decompress without holding the lock so different sections can be
+    // decompressed concurrently.
+    DataBufferSP data_sp;
+    DataExtractor compressed_data;
+    if (ObjectFile::ReadSectionData(section, compressed_data))
+        data_sp = DecompressSectionData(section, compressed_data);
+
+    if (!data_sp)
+    {
+        Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_SYMBOLS));
+        if (log)
+            log->Printf("ObjectFileELF::%s failed to decompress section %s in %s",
+                        __FUNCTION__,
+                        section->GetName().AsCString(""),
+                        m_file.GetPath().c_str());
+    }
+
+    // If an other thread decompressed the same section in the meantime keep
+    // its buffer, callers may already be using it.
+    std::lock_guard<std::mutex> guard(m_decompressed_sections_mutex);
+    return m_decompressed_sections.insert(std::make_pair(section->GetID(), data_sp)).first->second;
+}
+
+DataBufferSP
+ObjectFileELF::DecompressSectionData(const Section *section, const DataExtractor &compressed_data) const
+{
+    lldb::offset_t offset = 0;
+    uint64_t decompressed_size = 0;
+    if (section->Test(LLDB_SHF_COMPRESSED))
+    {
+        // Elf32_Chdr or Elf64_Chdr, the header starting SHF_COMPRESSED sections.
+        const elf_word ch_type = compressed_data.GetU32(&offset);
+        if (m_header.Is32Bit())
+        {
+            decompressed_size = compressed_data.GetU32(&offset);
+            offset += 4; // ch_addralign
+        }
+        else
+        {
+            offset += 4; // ch_reserved
+            decompressed_size = compressed_data.GetU64(&offset);
+            offset += 8; // ch_addralign
+        }
+
+        if (ch_type != LLDB_ELFCOMPRESS_ZLIB)
+            return DataBufferSP();
+    }
+    else
+    {
+        // Legacy .zdebug_* sections start with "ZLIB" followed by the
+        // decompressed size as a big endian 64 bit integer.
+        const uint8_t *header = compressed_data.PeekData(0, 12);
+        if (header == nullptr || ::memcmp(header, "ZLIB", 4) != 0)
+            return DataBufferSP();
+        for (size_t i = 4; i < 12; ++i)
+            decompressed_size = (decompressed_size << 8) | header[i];
+        offset = 12;
+    }
+
+    if (decompressed_size == 0 || offset >= compressed_data.GetByteSize())
+        return DataBufferSP();
+
+#if defined (HAVE_LIBZ)
+    // The size comes from the file, don't trust it with an allocation
+    // larger than what the compressed bytes can possibly inflate to.
+    // Deflate can't compress better than about 1032:1.
+    const uint64_t compressed_size = compressed_data.GetByteSize() - offset;
+    const uint64_t max_compression_ratio = 1032;
+    if (decompressed_size / max_compression_ratio > compressed_size)
+    {
+        Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_SYMBOLS));
+        if (log)
+            log->Printf("ObjectFileELF::%s section %s claims %" PRIu64 " decompressed bytes for %" PRIu64 " compressed bytes",
+                        __FUNCTION__,
+                        section->GetName().AsCString(""),
+                        decompressed_size,
+                        compressed_size);
+        return DataBufferSP();
+    }
+
+    Timer scoped_timer(__PRETTY_FUNCTION__,
+                       "ObjectFileELF::DecompressSectionData (%s)",
+                       section->GetName().AsCString(""));
+
+    DataBufferSP data_sp (new DataBufferHeap(decompressed_size, 0));
+
+    z_stream stream;
+    ::memset(&stream, 0, sizeof(z_stream));
+    if (inflateInit(&stream) != Z_OK)
+        return DataBufferSP();
+
+    // avail_in and avail_out are only 32 bits wide, feed sections of 4GB
+    // or more to inflate in chunks.
+    const uint64_t max_chunk_size = UINT32_MAX;
+    const Bytef *next_in = compressed_data.GetDataStart() + offset;
+    Bytef *next_out = data_sp->GetBytes();
+    uint64_t bytes_in_left = compressed_size;
+    uint64_t bytes_out_left = decompressed_size;
+    int status = Z_OK;
+    while (status == Z_OK)
+    {
+        const uInt chunk_in = (uInt) std::min(bytes_in_left, max_chunk_size);
+        const uInt chunk_out = (uInt) std::min(bytes_out_left, max_chunk_size);
+        stream.next_in = const_cast<Bytef *>(next_in);
+        stream.avail_in = chunk_in;
+        stream.next_out = next_out;
+        stream.avail_out = chunk_out;
+        const bool last_chunk = chunk_in == bytes_in_left;
+        status = inflate(&stream, last_chunk ? Z_FINISH : Z_NO_FLUSH);
+
+        const uInt consumed = chunk_in - stream.avail_in;
+        const uInt produced = chunk_out - stream.avail_out;
+        next_in += consumed;
+        bytes_in_left -= consumed;
+        next_out += produced;
+        bytes_out_left -= produced;
+
+        // Z_BUF_ERROR only ends the loop when no progress was possible,
+        // the input is truncated or inflates to more than the header says.
+        if (status == Z_BUF_ERROR && (consumed || produced))
+            status = Z_OK;
+    }
+    inflateEnd(&stream);
+
+    if (status != Z_STREAM_END || bytes_out_left != 0)
+        return DataBufferSP();
+    return data_sp;
+#else
+    return DataBufferSP();
+#endif
+}
+
 //----------------------------------------------------------------------
 // ParseSectionHeaders
 //----------------------------------------------------------------------
@@ -1849,6 +2045,12 @@ ObjectFileELF::CreateSections(SectionList &unified_section_list)
 
             bool is_thread_specific = false;
 
+            // Legacy compressed debug sections are named .zdebug_* and get the
+            // type of the matching .debug_* section.
+            ConstString dwarf_name (name);
+            if (name.GetStringRef().startswith(".zdebug_"))
+                dwarf_name.SetString(std::string(".") + name.GetStringRef().substr(2).str());
+
             if      (name == g_sect_name_text)                  sect_type = eSectionTypeCode;
             else if (name == g_sect_name_data)                  sect_type = eSectionTypeData;
             else if (name == g_sect_name_bss)                   sect_type = eSectionTypeZeroFill;
@@ -1876,31 +2078,31 @@ ObjectFileELF::CreateSections(SectionList &unified_section_list)
             // MISSING? .gnu_debugdata - "mini debuginfo / MiniDebugInfo" section, http://sourceware.org/gdb/onlinedocs/gdb/MiniDebugInfo.html
             // MISSING? .debug-index - http://src.chromium.org/viewvc/chrome/trunk/src/build/gdb-add-index?pathrev=144644
             // MISSING? .debug_types - Type descriptions from DWARF 4? See http://gcc.gnu.org/wiki/DwarfSeparateTypeInfo
-            else if (name == g_sect_name_dwarf_debug_abbrev)          sect_type = eSectionTypeDWARFDebugAbbrev;
-            else if (name == g_sect_name_dwarf_debug_addr)            sect_type = eSectionTypeDWARFDebugAddr;
-            else if (name == g_sect_name_dwarf_debug_aranges)         sect_type = eSectionTypeDWARFDebugAranges;
-            else if (name == g_sect_name_dwarf_debug_frame)           sect_type = eSectionTypeDWARFDebugFrame;
-            else if (name == g_sect_name_dwarf_debug_info)            sect_type = eSectionTypeDWARFDebugInfo;
-            else if (name == g_sect_name_dwarf_debug_line)            sect_type = eSectionTypeDWARFDebugLine;
-            else if (name == g_sect_name_dwarf_debug_loc)             sect_type = eSectionTypeDWARFDebugLoc;
-            else if (name == g_sect_name_dwarf_debug_macinfo)         sect_type = eSectionTypeDWARFDebugMacInfo;
-            else if (name == g_sect_name_dwarf_debug_macro)           sect_type = eSectionTypeDWARFDebugMacro;
-            else if (name == g_sect_name_dwarf_debug_pubnames)        sect_type = eSectionTypeDWARFDebugPubNames;
-            else if (name == g_sect_name_dwarf_debug_pubtypes)        sect_type = eSectionTypeDWARFDebugPubTypes;
-            else if (name == g_sect_name_dwarf_debug_ranges)          sect_type = eSectionTypeDWARFDebugRanges;
-            else if (name == g_sect_name_dwarf_debug_str)             sect_type = eSectionTypeDWARFDebugStr;
-            else if (name == g_sect_name_dwarf_debug_str_offsets)     sect_type = eSectionTypeDWARFDebugStrOffsets;
-            else if (name == g_sect_name_dwarf_debug_abbrev_dwo)      sect_type = eSectionTypeDWARFDebugAbbrev;
-            else if (name == g_sect_name_dwarf_debug_info_dwo)        sect_type = eSectionTypeDWARFDebugInfo;
-            else if (name == g_sect_name_dwarf_debug_line_dwo)        sect_type = eSectionTypeDWARFDebugLine;
-            else if (name == g_sect_name_dwarf_debug_macro_dwo)       sect_type = eSectionTypeDWARFDebugMacro;
-            else if (name == g_sect_name_dwarf_debug_loc_dwo)         sect_type = eSectionTypeDWARFDebugLoc;
-            else if (name == g_sect_name_dwarf_debug_str_dwo)         sect_type = eSectionTypeDWARFDebugStr;
-            else if (name == g_sect_name_dwarf_debug_str_offsets_dwo) sect_type = eSectionTypeDWARFDebugStrOffsets;
-            else if (name == g_sect_name_eh_frame)                    sect_type = eSectionTypeEHFrame;
-            else if (name == g_sect_name_arm_exidx)                   sect_type = eSectionTypeARMexidx;
-            else if (name == g_sect_name_arm_extab)                   sect_type = eSectionTypeARMextab;
-            else if (name == g_sect_name_go_symtab)                   sect_type = eSectionTypeGoSymtab;
+            else if (dwarf_name == g_sect_name_dwarf_debug_abbrev)          sect_type = eSectionTypeDWARFDebugAbbrev;
+            else if (dwarf_name == g_sect_name_dwarf_debug_addr)            sect_type = eSectionTypeDWARFDebugAddr;
+            else if (dwarf_name == g_sect_name_dwarf_debug_aranges)         sect_type = eSectionTypeDWARFDebugAranges;
+            else if (dwarf_name == g_sect_name_dwarf_debug_frame)           sect_type = eSectionTypeDWARFDebugFrame;
+            else if (dwarf_name == g_sect_name_dwarf_debug_info)            sect_type = eSectionTypeDWARFDebugInfo;
+            else if (dwarf_name == g_sect_name_dwarf_debug_line)            sect_type = eSectionTypeDWARFDebugLine;
+            else if (dwarf_name == g_sect_name_dwarf_debug_loc)             sect_type = eSectionTypeDWARFDebugLoc;
+            else if (dwarf_name == g_sect_name_dwarf_debug_macinfo)         sect_type = eSectionTypeDWARFDebugMacInfo;
+            else if (dwarf_name == g_sect_name_dwarf_debug_macro)           sect_type = eSectionTypeDWARFDebugMacro;
+            else if (dwarf_name == g_sect_name_dwarf_debug_pubnames)        sect_type = eSectionTypeDWARFDebugPubNames;
+            else if (dwarf_name == g_sect_name_dwarf_debug_pubtypes)        sect_type = eSectionTypeDWARFDebugPubTypes;
+            else if (dwarf_name == g_sect_name_dwarf_debug_ranges)          sect_type = eSectionTypeDWARFDebugRanges;
+            else if (dwarf_name == g_sect_name_dwarf_debug_str)             sect_type = eSectionTypeDWARFDebugStr;
+            else if (dwarf_name == g_sect_name_dwarf_debug_str_offsets)     sect_type = eSectionTypeDWARFDebugStrOffsets;
+            else if (dwarf_name == g_sect_name_dwarf_debug_abbrev_dwo)      sect_type = eSectionTypeDWARFDebugAbbrev;
+            else if (dwarf_name == g_sect_name_dwarf_debug_info_dwo)        sect_type = eSectionTypeDWARFDebugInfo;
+            else if (dwarf_name == g_sect_name_dwarf_debug_line_dwo)        sect_type = eSectionTypeDWARFDebugLine;
+            else if (dwarf_name == g_sect_name_dwarf_debug_macro_dwo)       sect_type = eSectionTypeDWARFDebugMacro;
+            else if (dwarf_name == g_sect_name_dwarf_debug_loc_dwo)         sect_type = eSectionTypeDWARFDebugLoc;
+            else if (dwarf_name == g_sect_name_dwarf_debug_str_dwo)         sect_type = eSectionTypeDWARFDebugStr;
+            else if (dwarf_name == g_sect_name_dwarf_debug_str_offsets_dwo) sect_type = eSectionTypeDWARFDebugStrOffsets;
+            else if (name == g_sect_name_eh_frame)                          sect_type = eSectionTypeEHFrame;
+            else if (name == g_sect_name_arm_exidx)                         sect_type = eSectionTypeARMexidx;
+            else if (name == g_sect_name_arm_extab)                         sect_type = eSectionTypeARMextab;
+            else if (name == g_sect_name_go_symtab)                         sect_type = eSectionTypeGoSymtab;
 
             switch (header.sh_type)
             {
@@ -2734,8 +2936,8 @@ ObjectFileELF::RelocateSection(Symtab* symtab, const ELFHeader *hdr, const ELFSe
                 if (symbol)
                 {
                     addr_t value = symbol->GetAddressRef().GetFileAddress();
-                    DataBufferSP& data_buffer_sp = debug_data.GetSharedDataBuffer();
-                    uint64_t* dst = reinterpret_cast<uint64_t*>(data_buffer_sp->GetBytes() + rel_section->GetFileOffset() + ELFRelocation::RelocOffset64(rel));
+                    uint8_t* section_bytes = const_cast<uint8_t*>(debug_data.GetDataStart());
+                    uint64_t* dst = reinterpret_cast<uint64_t*>(section_bytes + ELFRelocation::RelocOffset64(rel));
                     *dst = value + ELFRelocation::RelocAddend64(rel);
                 }
                 break;
@@ -2752,8 +2954,8 @@ ObjectFileELF::RelocateSection(Symtab* symtab, const ELFHeader *hdr, const ELFSe
                            (reloc_type(rel) == R_X86_64_32S &&
                             ((int64_t)value <= INT32_MAX && (int64_t)value >= INT32_MIN)));
                     uint32_t truncated_addr = (value & 0xFFFFFFFF);
-                    DataBufferSP& data_buffer_sp = debug_data.GetSharedDataBuffer();
-                    uint32_t* dst = reinterpret_cast<uint32_t*>(data_buffer_sp->GetBytes() + rel_section->GetFileOffset() + ELFRelocation::RelocOffset32(rel));
+                    uint8_t* section_bytes = const_cast<uint8_t*>(debug_data.GetDataStart());
+                    uint32_t* dst = reinterpret_cast<uint32_t*>(section_bytes + ELFRelocation::RelocOffset32(rel));
                     *dst = truncated_addr;
                 }
                 break;
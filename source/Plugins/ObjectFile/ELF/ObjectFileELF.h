@@ -15,6 +15,8 @@
 
 // C++ Includes
 #include <functional>
+#include <map>
+#include <mutex>
 #include <vector>
 
 // Other libraries and framework includes
@@ -198,6 +200,16 @@ public:
     std::string
     StripLinkerSymbolAnnotations(llvm::StringRef symbol_name) const override;
 
+    size_t
+    ReadSectionData(const lldb_private::Section *section,
+                    lldb::offset_t section_offset,
+                    void *dst,
+                    size_t dst_len) const override;
+
+    size_t
+    ReadSectionData(const lldb_private::Section *section,
+                    lldb_private::DataExtractor& section_data) const override;
+
 private:
     ObjectFileELF(const lldb::ModuleSP &module_sp,
                   lldb::DataBufferSP& data_sp,
@@ -267,6 +279,12 @@ private:
     /// The address class for each symbol in the elf file
     FileAddressToAddressClassMap m_address_class_map;
 
+    /// Contents of the compressed sections, keyed by section ID. Sections are
+    /// decompressed the first time they are read. A NULL buffer records a
+    /// section that failed to decompress.
+    mutable std::map<lldb::user_id_t, lldb::DataBufferSP> m_decompressed_sections;
+    mutable std::mutex m_decompressed_sections_mutex;
+
     /// Returns a 1 based index of the given section header.
     size_t
     SectionIndex(const SectionHeaderCollIter &I);
@@ -350,6 +368,20 @@ private:
     ParseUnwindSymbols(lldb_private::Symtab *symbol_table,
                        lldb_private::DWARFCallFrameInfo* eh_frame);
 
+    /// Returns true if the section is compressed, either with SHF_COMPRESSED
+    /// or as a legacy .zdebug_* section.
+    static bool
+    IsSectionCompressed(const lldb_private::Section *section);
+
+    /// Returns the decompressed contents of a compressed section or an empty
+    /// shared pointer if it can't be decompressed.
+    lldb::DataBufferSP
+    GetDecompressedSectionData(const lldb_private::Section *section) const;
+
+    lldb::DataBufferSP
+    DecompressSectionData(const lldb_private::Section *section,
+                          const lldb_private::DataExtractor &compressed_data) const;
+
     /// Relocates debug sections
     unsigned
     RelocateDebugSections(const elf::ELFSectionHeader *rel_hdr, lldb::user_id_t rel_id);
@@ -16,6 +16,7 @@
 #include <unistd.h>
 
 // C++ Includes
+#include <algorithm>
 #include <fstream>
 #include <mutex>
 #include <sstream>
@@ -48,6 +49,7 @@
 
 // System includes - They have to be included after framework includes because they define some
 // macros which collide with variable names in other modules
+#include <fcntl.h>
 #include <linux/unistd.h>
 #include <sys/socket.h>
 
@@ -1350,6 +1352,35 @@ NativeProcessLinux::MonitorTrace(NativeThreadLinux &thread)
         log->Printf("NativeProcessLinux::%s() received trace event, pid = %" PRIu64 " (single stepping)",
                 __FUNCTION__, thread.GetID());
 
+    // Check whether the instruction wrote to a software watchpoint.
+    const lldb::addr_t wp_addr = CheckSoftwareWatchpoints();
+    if (wp_addr != LLDB_INVALID_ADDRESS)
+    {
+        Log *wp_log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_WATCHPOINTS));
+        if (wp_log)
+            wp_log->Printf("NativeProcessLinux::%s() software watchpoint at 0x%" PRIx64 " hit, tid = %" PRIu64,
+                    __FUNCTION__, wp_addr, thread.GetID());
+
+        thread.SetStoppedBySoftwareWatchpoint(wp_addr);
+        StopRunningThreads(thread.GetID());
+        return;
+    }
+
+    // The thread was only stepping to check the software watchpoints, let it
+    // go on without telling anybody. If the threads are being stopped for
+    // another thread's stop, this one is stopped already.
+    if (m_threads_stepping_for_watchpoints.count(thread.GetID()))
+    {
+        if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID)
+        {
+            thread.SetStoppedWithNoReason();
+            SignalIfAllThreadsStopped();
+        }
+        else
+            ResumeThread(thread, eStateRunning, LLDB_INVALID_SIGNAL_NUMBER);
+        return;
+    }
+
     // This thread is currently stopped.
     thread.SetStoppedByTrace();
 
@@ -1760,6 +1791,7 @@ NativeProcessLinux::Resume (const ResumeActionList &resume_actions)
         {
             // Run the thread, possibly feeding it the signal.
             const int signo = action->signal;
+            m_threads_stepping_for_watchpoints.erase(thread_sp->GetID());
             ResumeThread(static_cast<NativeThreadLinux &>(*thread_sp), action->state, signo);
             break;
         }
@@ -2280,6 +2312,169 @@ NativeProcessLinux::SetBreakpoint (lldb::addr_t addr, uint32_t size, bool hardwa
         return SetSoftwareBreakpoint (addr, size);
 }
 
+void
+NativeProcessLinux::SetBreakpoints (const std::vector<lldb::addr_t> &addrs, uint32_t size, bool hardware, std::vector<Error> &errors)
+{
+    if (hardware)
+        errors.assign (addrs.size (), Error ("NativeProcessLinux does not support hardware breakpoints"));
+    else
+        SetSoftwareBreakpoints (addrs, size, errors);
+}
+
+
+Error
+NativeProcessLinux::SetWatchpoint (lldb::addr_t addr, size_t size, uint32_t watch_flags, bool hardware)
+{
+    // A debug register costs nothing while the inferior runs, single
+    // stepping every thread for a software watchpoint makes it orders of
+    // magnitude slower. Only use the latter when the debug registers are
+    // exhausted or can't watch this range.
+    Error error = NativeProcessProtocol::SetWatchpoint(addr, size, watch_flags, true);
+    if (error.Success())
+    {
+        m_software_watchpoints.erase(addr);
+        return error;
+    }
+
+    Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_WATCHPOINTS));
+    if (log)
+        log->Printf("NativeProcessLinux::%s() hardware watchpoint at 0x%" PRIx64 " failed: %s, trying a software watchpoint",
+                __FUNCTION__, addr, error.AsCString());
+
+    const Error software_error = SetSoftwareWatchpoint(addr, size, watch_flags);
+    if (software_error.Fail() && log)
+        log->Printf("NativeProcessLinux::%s() software watchpoint at 0x%" PRIx64 " failed: %s",
+                __FUNCTION__, addr, software_error.AsCString());
+    return software_error.Success() ? software_error : error;
+}
+
+Error
+NativeProcessLinux::RemoveWatchpoint (lldb::addr_t addr)
+{
+    if (m_software_watchpoints.erase(addr))
+        return m_watchpoint_list.Remove(addr);
+
+    const Error error = NativeProcessProtocol::RemoveWatchpoint(addr);
+
+    // A debug register may have been freed.
+    PromoteSoftwareWatchpoints();
+    return error;
+}
+
+Error
+NativeProcessLinux::SetSoftwareWatchpoint(lldb::addr_t addr, size_t size, uint32_t watch_flags)
+{
+    Error error;
+
+    // The memory is compared after every instruction, reads leave no trace.
+    if (watch_flags != 0x1)
+    {
+        error.SetErrorString("software watchpoints can only watch writes");
+        return error;
+    }
+    if (size == 0 || size > sizeof(SoftwareWatchpoint::m_value))
+    {
+        error.SetErrorStringWithFormat("software watchpoints can watch at most %" PRIu64 " bytes",
+                static_cast<uint64_t>(sizeof(SoftwareWatchpoint::m_value)));
+        return error;
+    }
+    if (!SupportHardwareSingleStepping())
+    {
+        error.SetErrorString("software watchpoints need hardware single stepping");
+        return error;
+    }
+
+    SoftwareWatchpoint wp;
+    wp.m_size = size;
+    wp.m_watch_flags = watch_flags;
+    size_t bytes_read = 0;
+    error = ReadMemory(addr, wp.m_value, size, bytes_read);
+    if (error.Fail())
+        return error;
+    if (bytes_read != size)
+    {
+        error.SetErrorStringWithFormat("failed to read the watched memory at 0x%" PRIx64, addr);
+        return error;
+    }
+
+    m_software_watchpoints[addr] = wp;
+    return m_watchpoint_list.Add(addr, size, watch_flags, false);
+}
+
+lldb::addr_t
+NativeProcessLinux::CheckSoftwareWatchpoints()
+{
+    if (m_software_watchpoints.empty())
+        return LLDB_INVALID_ADDRESS;
+
+    // This runs after every instruction, read all the watched values at once.
+    std::vector<uint64_t> values(m_software_watchpoints.size());
+    std::vector<MemoryRangeRead> reads;
+    reads.reserve(m_software_watchpoints.size());
+    for (const auto &pair : m_software_watchpoints)
+    {
+        MemoryRangeRead read = { pair.first, &values[reads.size()], pair.second.m_size, 0 };
+        reads.push_back(read);
+    }
+    ReadMemoryRanges(reads);
+
+    // Remember every new value so that a write isn't reported twice, even if
+    // several watchpoints changed at once.
+    lldb::addr_t changed_addr = LLDB_INVALID_ADDRESS;
+    size_t idx = 0;
+    for (auto &pair : m_software_watchpoints)
+    {
+        SoftwareWatchpoint &wp = pair.second;
+        const MemoryRangeRead &read = reads[idx++];
+        if (read.bytes_read != wp.m_size || memcmp(read.buf, wp.m_value, wp.m_size) == 0)
+            continue;
+        memcpy(wp.m_value, read.buf, wp.m_size);
+        if (changed_addr == LLDB_INVALID_ADDRESS)
+            changed_addr = pair.first;
+    }
+    return changed_addr;
+}
+
+void
+NativeProcessLinux::UpdateSoftwareWatchpointValues(lldb::addr_t addr, const void *buf, size_t size)
+{
+    // Start at the last watchpoint before addr, it can overlap the write.
+    auto it = m_software_watchpoints.upper_bound(addr);
+    if (it != m_software_watchpoints.begin())
+        --it;
+    const lldb::addr_t end_addr = addr + size;
+    for (; it != m_software_watchpoints.end() && it->first < end_addr; ++it)
+    {
+        SoftwareWatchpoint &wp = it->second;
+        const lldb::addr_t start = std::max(addr, it->first);
+        const lldb::addr_t end = std::min(end_addr, it->first + wp.m_size);
+        if (start < end)
+            memcpy(wp.m_value + (start - it->first), static_cast<const uint8_t *>(buf) + (start - addr), end - start);
+    }
+}
+
+void
+NativeProcessLinux::PromoteSoftwareWatchpoints()
+{
+    Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_WATCHPOINTS));
+
+    auto it = m_software_watchpoints.begin();
+    while (it != m_software_watchpoints.end())
+    {
+        const SoftwareWatchpoint &wp = it->second;
+        if (NativeProcessProtocol::SetWatchpoint(it->first, wp.m_size, wp.m_watch_flags, true).Fail())
+        {
+            ++it;
+            continue;
+        }
+
+        if (log)
+            log->Printf("NativeProcessLinux::%s() software watchpoint at 0x%" PRIx64 " moved to a debug register",
+                    __FUNCTION__, it->first);
+        it = m_software_watchpoints.erase(it);
+    }
+}
+
 Error
 NativeProcessLinux::GetSoftwareBreakpointTrapOpcode (size_t trap_opcode_size_hint,
                                                      size_t &actual_opcode_size,
@@ -2577,8 +2772,149 @@ NativeProcessLinux::ReadMemoryWithoutTrap(lldb::addr_t addr, void *buf, size_t s
     return m_breakpoint_list.RemoveTrapsFromBuffer(addr, buf, size);
 }
 
+Error
+NativeProcessLinux::ReadMemoryRanges(std::vector<MemoryRangeRead> &reads)
+{
+    if (!ProcessVmReadvSupported())
+        return NativeProcessProtocol::ReadMemoryRanges(reads);
+
+    Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+
+    // Gather as many ranges as the kernel accepts into each process_vm_readv
+    // call. The kernel stops at the first range it can't read, that range
+    // is retried on its own with ReadMemory (which falls back to ptrace) and
+    // gathering resumes with the next one.
+    const size_t max_iov_count = 1024; // UIO_MAXIOV
+    std::vector<struct iovec> local_iov;
+    std::vector<struct iovec> remote_iov;
+    const ::pid_t pid = GetID();
+    bool read_any = reads.empty();
+    Error error;
+
+    size_t idx = 0;
+    while (idx < reads.size())
+    {
+        const size_t end_idx = std::min(reads.size(), idx + max_iov_count);
+        local_iov.resize(end_idx - idx);
+        remote_iov.resize(end_idx - idx);
+        for (size_t i = idx; i < end_idx; ++i)
+        {
+            reads[i].bytes_read = 0;
+            local_iov[i - idx].iov_base = reads[i].buf;
+            local_iov[i - idx].iov_len = reads[i].size;
+            remote_iov[i - idx].iov_base = reinterpret_cast<void *>(reads[i].addr);
+            remote_iov[i - idx].iov_len = reads[i].size;
+        }
+
+        ssize_t result = process_vm_readv(pid, local_iov.data(), local_iov.size(), remote_iov.data(), remote_iov.size(), 0);
+        if (log)
+            log->Printf ("NativeProcessLinux::%s using process_vm_readv to read %" PRIu64 " ranges from inferior: %s",
+                    __FUNCTION__, static_cast<uint64_t> (end_idx - idx), result >= 0 ? "Success" : strerror(errno));
+        size_t bytes_left = result > 0 ? result : 0;
+
+        for (; idx < end_idx && reads[idx].size <= bytes_left; ++idx)
+        {
+            reads[idx].bytes_read = reads[idx].size;
+            bytes_left -= reads[idx].size;
+            read_any = true;
+        }
+
+        if (idx < end_idx)
+        {
+            MemoryRangeRead &read = reads[idx];
+            error = ReadMemory(read.addr, read.buf, read.size, read.bytes_read);
+            if (error.Fail())
+                read.bytes_read = 0;
+            else
+                read_any = true;
+            ++idx;
+        }
+    }
+
+    return read_any ? Error() : error;
+}
+
 Error
 NativeProcessLinux::WriteMemory(lldb::addr_t addr, const void *buf, size_t size, size_t &bytes_written)
+{
+    bytes_written = 0;
+    if (size == 0)
+        return Error();
+
+    Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+
+    if (ProcessVmReadvSupported())
+    {
+        // Like process_vm_readv for reads, this is much faster than the ptrace api. It honors the
+        // page protections though, so writes to read-only pages such as breakpoint opcodes going
+        // into code fail and are handled below.
+        const ::pid_t pid = GetID();
+
+        struct iovec local_iov, remote_iov;
+        local_iov.iov_base = const_cast<void *>(buf);
+        local_iov.iov_len = size;
+        remote_iov.iov_base = reinterpret_cast<void *>(addr);
+        remote_iov.iov_len = size;
+
+        const ssize_t result = process_vm_writev(pid, &local_iov, 1, &remote_iov, 1, 0);
+        const bool success = result >= 0 && static_cast<size_t>(result) == size;
+
+        if (log)
+            log->Printf ("NativeProcessLinux::%s using process_vm_writev to write %" PRIu64 " bytes to inferior address 0x%" PRIx64": %s",
+                    __FUNCTION__, static_cast<uint64_t> (size), addr, success ? "Success" : strerror(errno));
+
+        if (success)
+        {
+            bytes_written = size;
+            UpdateSoftwareWatchpointValues(addr, buf, bytes_written);
+            return Error();
+        }
+    }
+
+    Error error = WriteMemoryWithProcMem(addr, buf, size, bytes_written);
+    if (error.Fail())
+    {
+        if (log)
+            log->Printf ("NativeProcessLinux::%s writing to /proc/%" PRIu64 "/mem failed (%s), falling back to ptrace",
+                    __FUNCTION__, GetID(), error.AsCString());
+        error = WriteMemoryWithPtrace(addr, buf, size, bytes_written);
+    }
+    UpdateSoftwareWatchpointValues(addr, buf, bytes_written);
+    return error;
+}
+
+Error
+NativeProcessLinux::WriteMemoryWithProcMem(lldb::addr_t addr, const void *buf, size_t size, size_t &bytes_written)
+{
+    bytes_written = 0;
+
+    char mem_path[64];
+    ::snprintf(mem_path, sizeof(mem_path), "/proc/%" PRIu64 "/mem", GetID());
+    const int fd = ::open(mem_path, O_WRONLY | O_CLOEXEC);
+    if (fd < 0)
+        return Error(errno, eErrorTypePOSIX);
+
+    Error error;
+    const uint8_t *src = static_cast<const uint8_t *>(buf);
+    while (bytes_written < size)
+    {
+        const ssize_t result = ::pwrite64(fd, src + bytes_written, size - bytes_written, addr + bytes_written);
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result <= 0)
+        {
+            error.SetError(result < 0 ? errno : EIO, eErrorTypePOSIX);
+            break;
+        }
+        bytes_written += result;
+    }
+
+    ::close(fd);
+    return error;
+}
+
+Error
+NativeProcessLinux::WriteMemoryWithPtrace(lldb::addr_t addr, const void *buf, size_t size, size_t &bytes_written)
 {
     const unsigned char *src = static_cast<const unsigned char*>(buf);
     size_t remainder;
@@ -2630,7 +2966,7 @@ NativeProcessLinux::WriteMemory(lldb::addr_t addr, const void *buf, size_t size,
             memcpy(buff, src, remainder);
 
             size_t bytes_written_rec;
-            error = WriteMemory(addr, buff, k_ptrace_word_size, bytes_written_rec);
+            error = WriteMemoryWithPtrace(addr, buff, k_ptrace_word_size, bytes_written_rec);
             if (error.Fail())
             {
                 if (log)
@@ -2726,6 +3062,7 @@ NativeProcessLinux::StopTrackingThread (lldb::tid_t thread_id)
             break;
         }
     }
+    m_threads_stepping_for_watchpoints.erase(thread_id);
 
     SignalIfAllThreadsStopped();
 
@@ -2936,6 +3273,20 @@ NativeProcessLinux::ResumeThread(NativeThreadLinux &thread, lldb::StateType stat
         log->Printf("NativeProcessLinux::%s about to resume tid %" PRIu64 " per explicit request but we have a pending stop notification (tid %" PRIu64 ") that is actively waiting for this thread to stop. Valid sequence of events?", __FUNCTION__, thread.GetID(), m_pending_notification_tid);
     }
 
+    // While there are software watchpoints the threads asked to run are
+    // single stepped instead, MonitorTrace checks the watched memory after
+    // every instruction.
+    if (state == eStateRunning)
+    {
+        if (m_software_watchpoints.empty())
+            m_threads_stepping_for_watchpoints.erase(thread.GetID());
+        else
+        {
+            state = eStateStepping;
+            m_threads_stepping_for_watchpoints.insert(thread.GetID());
+        }
+    }
+
     // Request a resume.  We expect this to be synchronous and the system
     // to reflect it is running after this completes.
     switch (state)
@@ -83,6 +83,9 @@ namespace process_linux {
         Error
         ReadMemoryWithoutTrap(lldb::addr_t addr, void *buf, size_t size, size_t &bytes_read) override;
 
+        Error
+        ReadMemoryRanges(std::vector<MemoryRangeRead> &reads) override;
+
         Error
         WriteMemory(lldb::addr_t addr, const void *buf, size_t size, size_t &bytes_written) override;
 
@@ -104,6 +107,15 @@ namespace process_linux {
         Error
         SetBreakpoint (lldb::addr_t addr, uint32_t size, bool hardware) override;
 
+        void
+        SetBreakpoints (const std::vector<lldb::addr_t> &addrs, uint32_t size, bool hardware, std::vector<Error> &errors) override;
+
+        Error
+        SetWatchpoint (lldb::addr_t addr, size_t size, uint32_t watch_flags, bool hardware) override;
+
+        Error
+        RemoveWatchpoint (lldb::addr_t addr) override;
+
         void
         DoStopIDBumped (uint32_t newBumpId) override;
 
@@ -152,6 +164,21 @@ namespace process_linux {
         // the relevan breakpoint
         std::map<lldb::tid_t, lldb::addr_t> m_threads_stepping_with_breakpoint;
 
+        // A write watchpoint that didn't get a hardware debug register. Its
+        // memory is compared to the last known value after every instruction
+        // the threads execute, which are single stepped for this purpose.
+        struct SoftwareWatchpoint
+        {
+            size_t m_size;
+            uint32_t m_watch_flags;
+            uint8_t m_value[8];
+        };
+        std::map<lldb::addr_t, SoftwareWatchpoint> m_software_watchpoints;
+
+        // Threads single stepped only to check the software watchpoints, the
+        // client asked them to continue.
+        std::unordered_set<lldb::tid_t> m_threads_stepping_for_watchpoints;
+
         /// @class LauchArgs
         ///
         /// @brief Simple structure to pass data to the thread responsible for
@@ -245,6 +272,23 @@ namespace process_linux {
         Error
         SetupSoftwareSingleStepping(NativeThreadLinux &thread);
 
+        Error
+        SetSoftwareWatchpoint(lldb::addr_t addr, size_t size, uint32_t watch_flags);
+
+        // Returns the address of a software watchpoint whose memory changed
+        // since the last check, LLDB_INVALID_ADDRESS if none did.
+        lldb::addr_t
+        CheckSoftwareWatchpoints();
+
+        // Keep the last known values of the software watchpoints in sync
+        // with the memory written by the debugger, so that this write isn't
+        // reported as a hit.
+        void
+        UpdateSoftwareWatchpointValues(lldb::addr_t addr, const void *buf, size_t size);
+
+        void
+        PromoteSoftwareWatchpoints();
+
 #if 0
         static ::ProcessMessage::CrashReason
         GetCrashReasonForSIGSEGV(const siginfo_t *info);
@@ -271,6 +315,16 @@ namespace process_linux {
         Error
         GetSoftwareBreakpointPCOffset(uint32_t &actual_opcode_size);
 
+        // Writes through /proc/<pid>/mem, which ignores page protections like
+        // ptrace but transfers the whole buffer with a single syscall.
+        Error
+        WriteMemoryWithProcMem(lldb::addr_t addr, const void *buf, size_t size, size_t &bytes_written);
+
+        // Writes a word at a time with PTRACE_POKEDATA, the slowest but most
+        // widely available way to write to the inferior.
+        Error
+        WriteMemoryWithPtrace(lldb::addr_t addr, const void *buf, size_t size, size_t &bytes_written);
+
         Error
         FixupBreakpointPCAsNeeded(NativeThreadLinux &thread);
 
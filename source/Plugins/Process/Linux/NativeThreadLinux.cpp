@@ -211,6 +211,19 @@ NativeThreadLinux::Resume(uint32_t signo)
     m_stop_info.reason = StopReason::eStopReasonNone;
     m_stop_description.clear();
 
+    SetProcessWatchpoints();
+
+    intptr_t data = 0;
+
+    if (signo != LLDB_INVALID_SIGNAL_NUMBER)
+        data = signo;
+
+    return NativeProcessLinux::PtraceWrapper(PTRACE_CONT, GetID(), nullptr, reinterpret_cast<void *>(data));
+}
+
+void
+NativeThreadLinux::SetProcessWatchpoints()
+{
     // If watchpoints have been set, but none on this thread,
     // then this is a new thread. So set all existing watchpoints.
     if (m_watchpoint_index_map.empty())
@@ -222,16 +235,10 @@ NativeThreadLinux::Resume(uint32_t signo)
         for (const auto &pair : watchpoint_map)
         {
             const auto &wp = pair.second;
-            SetWatchpoint(wp.m_addr, wp.m_size, wp.m_watch_flags, wp.m_hardware);
+            if (wp.m_hardware)
+                SetWatchpoint(wp.m_addr, wp.m_size, wp.m_watch_flags, wp.m_hardware);
         }
     }
-
-    intptr_t data = 0;
-
-    if (signo != LLDB_INVALID_SIGNAL_NUMBER)
-        data = signo;
-
-    return NativeProcessLinux::PtraceWrapper(PTRACE_CONT, GetID(), nullptr, reinterpret_cast<void *>(data));
 }
 
 void
@@ -285,13 +292,22 @@ NativeThreadLinux::MaybeCleanupSingleStepWorkaround()
 Error
 NativeThreadLinux::SingleStep(uint32_t signo)
 {
+    // A thread stepped again without stopping in between, like the threads
+    // checking software watchpoints, is already set up.
+    if (m_state != StateType::eStateStepping)
+    {
+        MaybePrepareSingleStepWorkaround();
+
+        // New threads are single stepped while there are software
+        // watchpoints, they need the hardware ones too.
+        SetProcessWatchpoints();
+    }
+
     const StateType new_state = StateType::eStateStepping;
     MaybeLogStateChange (new_state);
     m_state = new_state;
     m_stop_info.reason = StopReason::eStopReasonNone;
 
-    MaybePrepareSingleStepWorkaround();
-
     intptr_t data = 0;
     if (signo != LLDB_INVALID_SIGNAL_NUMBER)
         data = signo;
@@ -413,6 +429,21 @@ NativeThreadLinux::SetStoppedByWatchpoint (uint32_t wp_index)
     m_stop_info.details.signal.signo = SIGTRAP;
 }
 
+void
+NativeThreadLinux::SetStoppedBySoftwareWatchpoint (lldb::addr_t addr)
+{
+    SetStopped();
+
+    // Software watchpoints don't use a debug register, report an invalid
+    // hardware index.
+    std::ostringstream ostr;
+    ostr << addr << " " << LLDB_INVALID_INDEX32 << " " << addr;
+    m_stop_description = ostr.str();
+
+    m_stop_info.reason = StopReason::eStopReasonWatchpoint;
+    m_stop_info.details.signal.signo = SIGTRAP;
+}
+
 bool
 NativeThreadLinux::IsStoppedAtBreakpoint ()
 {
@@ -85,6 +85,9 @@ namespace process_linux {
         void
         SetStoppedByWatchpoint (uint32_t wp_index);
 
+        void
+        SetStoppedBySoftwareWatchpoint (lldb::addr_t addr);
+
         bool
         IsStoppedAtBreakpoint ();
 
@@ -115,6 +118,9 @@ namespace process_linux {
         void
         SetStopped();
 
+        void
+        SetProcessWatchpoints();
+
         inline void
         MaybePrepareSingleStepWorkaround();
 
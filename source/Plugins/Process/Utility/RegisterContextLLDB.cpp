@@ -27,6 +27,7 @@
 #include "lldb/Target/ABI.h"
 #include "lldb/Target/DynamicLoader.h"
 #include "lldb/Target/ExecutionContext.h"
+#include "lldb/Target/FrameUnwindPlanCache.h"
 #include "lldb/Target/Platform.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/SectionLoadList.h"
@@ -689,6 +690,44 @@ RegisterContextLLDB::IsFrameZero () const
 }
 
 
+// Return the cache of the UnwindPlans picked for the frames of this process and set load_addr to the
+// key of this frame in it, or NULL if the UnwindPlans can't be cached.
+//
+// Frame zero and frames called by a trap handler or the debugger may be stopped anywhere in a
+// function and their UnwindPlans depend on more than the pc, so they are always looked up again.
+// Every other frame is stopped at a call site and picks the same UnwindPlans for a given pc (and
+// offset into the function) on every thread and every stop of the process. The choice also depends
+// on the process' ABI and DynamicLoader, so it isn't shared with other processes using the module.
+
+FrameUnwindPlanCache *
+RegisterContextLLDB::GetFrameUnwindPlanCache (addr_t &load_addr)
+{
+    if (IsFrameZero () || m_frame_type != eNormalFrame)
+        return NULL;
+
+    RegisterContextLLDB::SharedPtr next_frame = GetNextFrame();
+    if (!next_frame
+        || next_frame->m_frame_type == eTrapHandlerFrame
+        || next_frame->m_frame_type == eDebuggerFrame)
+        return NULL;
+
+    if (!m_current_pc.IsValid())
+        return NULL;
+
+    ModuleSP pc_module_sp (m_current_pc.GetModule());
+    if (!pc_module_sp || pc_module_sp->GetObjectFile() == NULL)
+        return NULL;
+
+    ProcessSP process_sp (m_thread.GetProcess());
+    if (!process_sp)
+        return NULL;
+
+    load_addr = m_current_pc.GetLoadAddress (&process_sp->GetTarget());
+    if (load_addr == LLDB_INVALID_ADDRESS)
+        return NULL;
+    return &process_sp->GetFrameUnwindPlanCache();
+}
+
 // Find a fast unwind plan for this frame, if possible.
 //
 // On entry to this method,
@@ -700,6 +739,23 @@ RegisterContextLLDB::IsFrameZero () const
 
 UnwindPlanSP
 RegisterContextLLDB::GetFastUnwindPlanForFrame ()
+{
+    addr_t load_addr;
+    FrameUnwindPlanCache *plan_cache = GetFrameUnwindPlanCache (load_addr);
+    if (plan_cache == NULL)
+        return FindFastUnwindPlanForFrame ();
+
+    UnwindPlanSP unwind_plan_sp;
+    if (plan_cache->GetFastPlan (load_addr, m_current_offset, m_current_offset_backed_up_one, unwind_plan_sp))
+        return unwind_plan_sp;
+
+    unwind_plan_sp = FindFastUnwindPlanForFrame ();
+    plan_cache->SetFastPlan (load_addr, m_current_offset, m_current_offset_backed_up_one, unwind_plan_sp);
+    return unwind_plan_sp;
+}
+
+UnwindPlanSP
+RegisterContextLLDB::FindFastUnwindPlanForFrame ()
 {
     UnwindPlanSP unwind_plan_sp;
     ModuleSP pc_module_sp (m_current_pc.GetModule());
@@ -751,6 +807,29 @@ RegisterContextLLDB::GetFastUnwindPlanForFrame ()
 
 UnwindPlanSP
 RegisterContextLLDB::GetFullUnwindPlanForFrame ()
+{
+    addr_t load_addr;
+    FrameUnwindPlanCache *plan_cache = GetFrameUnwindPlanCache (load_addr);
+    if (plan_cache == NULL)
+        return FindFullUnwindPlanForFrame ();
+
+    // The fallback UnwindPlan is picked along with the full UnwindPlan so it is cached with it.
+    UnwindPlanSP unwind_plan_sp;
+    if (plan_cache->GetFullPlan (load_addr, m_current_offset, m_current_offset_backed_up_one, unwind_plan_sp, m_fallback_unwind_plan_sp))
+    {
+        if (unwind_plan_sp)
+            UnwindLogMsgVerbose ("frame uses cached %s for full UnwindPlan", unwind_plan_sp->GetSourceName().GetCString());
+        return unwind_plan_sp;
+    }
+
+    m_fallback_unwind_plan_sp.reset();
+    unwind_plan_sp = FindFullUnwindPlanForFrame ();
+    plan_cache->SetFullPlan (load_addr, m_current_offset, m_current_offset_backed_up_one, unwind_plan_sp, m_fallback_unwind_plan_sp);
+    return unwind_plan_sp;
+}
+
+UnwindPlanSP
+RegisterContextLLDB::FindFullUnwindPlanForFrame ()
 {
     UnwindPlanSP unwind_plan_sp;
     UnwindPlanSP arch_default_unwind_plan_sp;
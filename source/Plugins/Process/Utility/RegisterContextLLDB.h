@@ -211,6 +211,15 @@ private:
     lldb::UnwindPlanSP
     GetFullUnwindPlanForFrame ();
 
+    lldb::UnwindPlanSP
+    FindFastUnwindPlanForFrame ();
+
+    lldb::UnwindPlanSP
+    FindFullUnwindPlanForFrame ();
+
+    lldb_private::FrameUnwindPlanCache *
+    GetFrameUnwindPlanCache (lldb::addr_t &load_addr);
+
     void
     UnwindLogMsg (const char *fmt, ...) __attribute__ ((format (printf, 2, 3)));
 
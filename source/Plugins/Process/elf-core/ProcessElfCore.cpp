@@ -365,6 +365,33 @@ ProcessElfCore::DoReadMemory (lldb::addr_t addr, void *buf, size_t size, Error &
     return bytes_copied + zero_fill_size;
 }
 
+bool
+ProcessElfCore::GetMemoryData (lldb::addr_t addr, size_t size, DataExtractor &data)
+{
+    ObjectFile *core_objfile = m_core_module_sp->GetObjectFile();
+    if (core_objfile == NULL || size == 0)
+        return false;
+
+    // Only reads that are entirely backed by the file data of one segment
+    // can reference the core file, zero filled ones must be copied.
+    const VMRangeToFileOffset::Entry *address_range = m_core_aranges.FindEntryThatContains (addr);
+    if (address_range == NULL)
+        return false;
+
+    const lldb::addr_t offset = addr - address_range->GetRangeBase();
+    if (offset + size > address_range->data.GetByteSize())
+        return false;
+
+    DataExtractor core_data;
+    if (core_objfile->GetData (address_range->data.GetRangeBase() + offset, size, core_data) != size ||
+        !core_data.GetSharedDataBuffer())
+        return false;
+
+    // Share the core file buffer, keeping the byte order and address size
+    // of the caller.
+    return data.SetData (core_data.GetSharedDataBuffer(), core_data.GetSharedDataOffset(), size) == size;
+}
+
 void
 ProcessElfCore::Clear()
 {
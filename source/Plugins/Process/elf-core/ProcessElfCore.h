@@ -102,6 +102,8 @@ public:
 
     size_t DoReadMemory(lldb::addr_t addr, void *buf, size_t size, lldb_private::Error &error) override;
 
+    bool GetMemoryData(lldb::addr_t addr, size_t size, lldb_private::DataExtractor &data) override;
+
     lldb::addr_t GetImageInfoAddress() override;
 
     lldb_private::ArchSpec
@@ -0,0 +1,369 @@
+//===-- AgentExpression.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "AgentExpression.h"
+
+// C Includes
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::process_gdb_remote;
+
+namespace
+{
+    // Limits protecting lldb-server from bad or looping expressions.
+    const size_t k_max_stack_depth = 256;
+    const size_t k_max_steps = 100000;
+
+    uint64_t
+    SignExtend (uint64_t value, uint32_t bits)
+    {
+        if (bits == 0 || bits >= 64)
+            return value;
+        const uint64_t sign_bit = 1ull << (bits - 1);
+        value &= (sign_bit << 1) - 1;
+        return (value ^ sign_bit) - sign_bit;
+    }
+
+    uint64_t
+    ZeroExtend (uint64_t value, uint32_t bits)
+    {
+        if (bits == 0 || bits >= 64)
+            return value;
+        return value & ((1ull << bits) - 1);
+    }
+}
+
+AgentExpression::AgentExpression () :
+    m_bytes ()
+{
+}
+
+AgentExpression::AgentExpression (const uint8_t *bytes, size_t size) :
+    m_bytes (bytes, bytes + size)
+{
+}
+
+void
+AgentExpression::AppendOpcode (Opcode opcode)
+{
+    m_bytes.push_back (opcode);
+}
+
+void
+AgentExpression::AppendOpcode (Opcode opcode, uint8_t operand)
+{
+    m_bytes.push_back (opcode);
+    m_bytes.push_back (operand);
+}
+
+void
+AgentExpression::AppendConstant (uint64_t value)
+{
+    size_t size;
+    if (value <= UINT8_MAX)
+    {
+        m_bytes.push_back (eOpConst8);
+        size = 1;
+    }
+    else if (value <= UINT16_MAX)
+    {
+        m_bytes.push_back (eOpConst16);
+        size = 2;
+    }
+    else if (value <= UINT32_MAX)
+    {
+        m_bytes.push_back (eOpConst32);
+        size = 4;
+    }
+    else
+    {
+        m_bytes.push_back (eOpConst64);
+        size = 8;
+    }
+
+    for (size_t i = size; i > 0; --i)
+        m_bytes.push_back ((value >> ((i - 1) * 8)) & 0xff);
+}
+
+void
+AgentExpression::AppendRegister (uint32_t reg_num)
+{
+    m_bytes.push_back (eOpReg);
+    m_bytes.push_back ((reg_num >> 8) & 0xff);
+    m_bytes.push_back (reg_num & 0xff);
+}
+
+size_t
+AgentExpression::AppendJump (Opcode opcode)
+{
+    m_bytes.push_back (opcode);
+    const size_t operand_offset = m_bytes.size();
+    m_bytes.push_back (0);
+    m_bytes.push_back (0);
+    return operand_offset;
+}
+
+void
+AgentExpression::SetJumpTarget (size_t operand_offset, size_t target)
+{
+    m_bytes[operand_offset] = (target >> 8) & 0xff;
+    m_bytes[operand_offset + 1] = target & 0xff;
+}
+
+bool
+AgentExpression::Evaluate (Context &context, uint64_t &result) const
+{
+    std::vector<uint64_t> stack;
+    const size_t size = m_bytes.size();
+    size_t pc = 0;
+
+    // Read a big endian operand of the current opcode.
+    auto read_operand = [this, size, &pc](size_t operand_size, uint64_t &value) -> bool
+    {
+        if (pc + operand_size > size)
+            return false;
+        value = 0;
+        for (size_t i = 0; i < operand_size; ++i)
+            value = (value << 8) | m_bytes[pc++];
+        return true;
+    };
+
+    for (size_t steps = 0; steps < k_max_steps; ++steps)
+    {
+        if (pc >= size)
+            return false;
+
+        const uint8_t opcode = m_bytes[pc++];
+        uint64_t operand = 0;
+
+        // Check the stack has enough values for the opcode.
+        size_t num_popped = 0;
+        switch (opcode)
+        {
+            case eOpAdd:
+            case eOpSub:
+            case eOpMul:
+            case eOpDivSigned:
+            case eOpDivUnsigned:
+            case eOpRemSigned:
+            case eOpRemUnsigned:
+            case eOpLsh:
+            case eOpRshSigned:
+            case eOpRshUnsigned:
+            case eOpBitAnd:
+            case eOpBitOr:
+            case eOpBitXor:
+            case eOpEqual:
+            case eOpLessSigned:
+            case eOpLessUnsigned:
+            case eOpSwap:
+                num_popped = 2;
+                break;
+            case eOpRot:
+                num_popped = 3;
+                break;
+            case eOpLogNot:
+            case eOpBitNot:
+            case eOpExt:
+            case eOpZeroExt:
+            case eOpRef8:
+            case eOpRef16:
+            case eOpRef32:
+            case eOpRef64:
+            case eOpIfGoto:
+            case eOpEnd:
+            case eOpDup:
+            case eOpPop:
+                num_popped = 1;
+                break;
+            default:
+                break;
+        }
+        if (stack.size() < num_popped)
+            return false;
+
+        switch (opcode)
+        {
+            case eOpAdd:
+            case eOpSub:
+            case eOpMul:
+            case eOpDivSigned:
+            case eOpDivUnsigned:
+            case eOpRemSigned:
+            case eOpRemUnsigned:
+            case eOpLsh:
+            case eOpRshSigned:
+            case eOpRshUnsigned:
+            case eOpBitAnd:
+            case eOpBitOr:
+            case eOpBitXor:
+            case eOpEqual:
+            case eOpLessSigned:
+            case eOpLessUnsigned:
+            {
+                const uint64_t b = stack.back();
+                stack.pop_back();
+                const uint64_t a = stack.back();
+                uint64_t value = 0;
+                switch (opcode)
+                {
+                    case eOpAdd:            value = a + b; break;
+                    case eOpSub:            value = a - b; break;
+                    case eOpMul:            value = a * b; break;
+                    case eOpBitAnd:         value = a & b; break;
+                    case eOpBitOr:          value = a | b; break;
+                    case eOpBitXor:         value = a ^ b; break;
+                    case eOpEqual:          value = a == b; break;
+                    case eOpLessSigned:     value = (int64_t)a < (int64_t)b; break;
+                    case eOpLessUnsigned:   value = a < b; break;
+                    case eOpLsh:            value = b < 64 ? a << b : 0; break;
+                    case eOpRshUnsigned:    value = b < 64 ? a >> b : 0; break;
+                    case eOpRshSigned:      value = (uint64_t)((int64_t)a >> (b < 64 ? b : 63)); break;
+                    case eOpDivSigned:
+                    case eOpDivUnsigned:
+                    case eOpRemSigned:
+                    case eOpRemUnsigned:
+                        if (b == 0)
+                            return false;
+                        if (opcode == eOpDivUnsigned)
+                            value = a / b;
+                        else if (opcode == eOpRemUnsigned)
+                            value = a % b;
+                        else if ((int64_t)b == -1)
+                            value = opcode == eOpDivSigned ? 0 - a : 0; // Avoid overflowing INT64_MIN / -1
+                        else if (opcode == eOpDivSigned)
+                            value = (uint64_t)((int64_t)a / (int64_t)b);
+                        else
+                            value = (uint64_t)((int64_t)a % (int64_t)b);
+                        break;
+                }
+                stack.back() = value;
+                break;
+            }
+
+            case eOpLogNot:
+                stack.back() = stack.back() == 0;
+                break;
+
+            case eOpBitNot:
+                stack.back() = ~stack.back();
+                break;
+
+            case eOpExt:
+            case eOpZeroExt:
+                if (!read_operand (1, operand))
+                    return false;
+                if (opcode == eOpExt)
+                    stack.back() = SignExtend (stack.back(), operand);
+                else
+                    stack.back() = ZeroExtend (stack.back(), operand);
+                break;
+
+            case eOpRef8:
+            case eOpRef16:
+            case eOpRef32:
+            case eOpRef64:
+            {
+                const size_t byte_size = 1u << (opcode - eOpRef8);
+                uint8_t buf[8];
+                if (!context.ReadMemory (stack.back(), buf, byte_size))
+                    return false;
+                uint64_t value = 0;
+                for (size_t i = 0; i < byte_size; ++i)
+                {
+                    const size_t byte_idx = context.GetByteOrder() == eByteOrderBig ? i : byte_size - 1 - i;
+                    value = (value << 8) | buf[byte_idx];
+                }
+                stack.back() = value;
+                break;
+            }
+
+            case eOpIfGoto:
+            case eOpGoto:
+            {
+                if (!read_operand (2, operand))
+                    return false;
+                bool jump = true;
+                if (opcode == eOpIfGoto)
+                {
+                    jump = stack.back() != 0;
+                    stack.pop_back();
+                }
+                if (jump)
+                    pc = operand;
+                break;
+            }
+
+            case eOpConst8:
+            case eOpConst16:
+            case eOpConst32:
+            case eOpConst64:
+                if (!read_operand (1u << (opcode - eOpConst8), operand))
+                    return false;
+                stack.push_back (operand);
+                break;
+
+            case eOpReg:
+            {
+                if (!read_operand (2, operand))
+                    return false;
+                uint64_t value;
+                if (!context.ReadRegister (operand, value))
+                    return false;
+                stack.push_back (value);
+                break;
+            }
+
+            case eOpEnd:
+                result = stack.back();
+                return true;
+
+            case eOpDup:
+                stack.push_back (stack.back());
+                break;
+
+            case eOpPop:
+                stack.pop_back();
+                break;
+
+            case eOpSwap:
+                std::swap (stack[stack.size() - 1], stack[stack.size() - 2]);
+                break;
+
+            case eOpPick:
+                if (!read_operand (1, operand) || operand >= stack.size())
+                    return false;
+                stack.push_back (stack[stack.size() - 1 - operand]);
+                break;
+
+            case eOpRot:
+            {
+                // a b c => c a b
+                const uint64_t c = stack[stack.size() - 1];
+                stack[stack.size() - 1] = stack[stack.size() - 2];
+                stack[stack.size() - 2] = stack[stack.size() - 3];
+                stack[stack.size() - 3] = c;
+                break;
+            }
+
+            default:
+                // Floating point, tracing and state variable opcodes aren't supported.
+                return false;
+        }
+
+        if (stack.size() > k_max_stack_depth)
+            return false;
+    }
+
+    return false;
+}
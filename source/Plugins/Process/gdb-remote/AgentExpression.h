@@ -0,0 +1,168 @@
+//===-- AgentExpression.h ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_AgentExpression_h_
+#define liblldb_AgentExpression_h_
+
+// C Includes
+// C++ Includes
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+
+namespace lldb_private {
+namespace process_gdb_remote {
+
+//----------------------------------------------------------------------
+/// @class AgentExpression AgentExpression.h
+/// @brief A GDB agent expression.
+///
+/// Agent expressions are the bytecode of the GDB remote protocol for
+/// expressions evaluated by the remote stub, like the conditions of the
+/// "Z" breakpoint packets. The bytecode runs on a stack of 64 bit
+/// values and can read the registers of a thread and the memory of the
+/// process. The operands of the opcodes are big endian, register
+/// numbers are the ones used by the "p" packet.
+//----------------------------------------------------------------------
+class AgentExpression
+{
+public:
+    enum Opcode
+    {
+        eOpAdd          = 0x02,
+        eOpSub          = 0x03,
+        eOpMul          = 0x04,
+        eOpDivSigned    = 0x05,
+        eOpDivUnsigned  = 0x06,
+        eOpRemSigned    = 0x07,
+        eOpRemUnsigned  = 0x08,
+        eOpLsh          = 0x09,
+        eOpRshSigned    = 0x0a,
+        eOpRshUnsigned  = 0x0b,
+        eOpLogNot       = 0x0e,
+        eOpBitAnd       = 0x0f,
+        eOpBitOr        = 0x10,
+        eOpBitXor       = 0x11,
+        eOpBitNot       = 0x12,
+        eOpEqual        = 0x13,
+        eOpLessSigned   = 0x14,
+        eOpLessUnsigned = 0x15,
+        eOpExt          = 0x16, // 1 byte operand: the number of bits to sign extend
+        eOpRef8         = 0x17,
+        eOpRef16        = 0x18,
+        eOpRef32        = 0x19,
+        eOpRef64        = 0x1a,
+        eOpIfGoto       = 0x20, // 2 byte operand: the offset to jump to
+        eOpGoto         = 0x21, // 2 byte operand: the offset to jump to
+        eOpConst8       = 0x22,
+        eOpConst16      = 0x23,
+        eOpConst32      = 0x24,
+        eOpConst64      = 0x25,
+        eOpReg          = 0x26, // 2 byte operand: the register number
+        eOpEnd          = 0x27,
+        eOpDup          = 0x28,
+        eOpPop          = 0x29,
+        eOpZeroExt      = 0x2a, // 1 byte operand: the number of bits to keep
+        eOpSwap         = 0x2b,
+        eOpPick         = 0x32, // 1 byte operand: the stack depth to copy
+        eOpRot          = 0x33
+    };
+
+    //------------------------------------------------------------------
+    /// The registers and memory an expression is evaluated against.
+    //------------------------------------------------------------------
+    class Context
+    {
+    public:
+        virtual
+        ~Context() = default;
+
+        virtual bool
+        ReadRegister (uint32_t reg_num, uint64_t &value) = 0;
+
+        virtual bool
+        ReadMemory (lldb::addr_t addr, void *buf, size_t size) = 0;
+
+        virtual lldb::ByteOrder
+        GetByteOrder () = 0;
+    };
+
+    AgentExpression ();
+
+    AgentExpression (const uint8_t *bytes, size_t size);
+
+    const std::vector<uint8_t> &
+    GetBytes () const
+    {
+        return m_bytes;
+    }
+
+    bool
+    IsEmpty () const
+    {
+        return m_bytes.empty();
+    }
+
+    //------------------------------------------------------------------
+    // Helpers to build an expression.
+    //------------------------------------------------------------------
+    void
+    AppendOpcode (Opcode opcode);
+
+    void
+    AppendOpcode (Opcode opcode, uint8_t operand);
+
+    // Push the smallest constant opcode holding value.
+    void
+    AppendConstant (uint64_t value);
+
+    void
+    AppendRegister (uint32_t reg_num);
+
+    // Append a goto or an if_goto whose target is set later with
+    // SetJumpTarget(). Returns the offset of the operand to patch.
+    size_t
+    AppendJump (Opcode opcode);
+
+    void
+    SetJumpTarget (size_t operand_offset, size_t target);
+
+    size_t
+    GetSize () const
+    {
+        return m_bytes.size();
+    }
+
+    //------------------------------------------------------------------
+    /// Run the expression.
+    ///
+    /// @param[in] context
+    ///     The registers and memory to evaluate the expression against.
+    ///
+    /// @param[out] result
+    ///     The value on top of the stack when the expression ends.
+    ///
+    /// @return
+    ///     False if the expression is invalid, uses an unsupported
+    ///     opcode, reads an unavailable register or memory, or runs for
+    ///     too long.
+    //------------------------------------------------------------------
+    bool
+    Evaluate (Context &context, uint64_t &result) const;
+
+private:
+    std::vector<uint8_t> m_bytes;
+};
+
+} // namespace process_gdb_remote
+} // namespace lldb_private
+
+#endif // liblldb_AgentExpression_h_
@@ -0,0 +1,720 @@
+//===-- AgentExpressionCompiler.cpp -----------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "AgentExpressionCompiler.h"
+
+// C Includes
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+// C++ Includes
+#include <algorithm>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleList.h"
+#include "lldb/Core/dwarf.h"
+#include "lldb/Expression/DWARFExpression.h"
+#include "lldb/Symbol/Block.h"
+#include "lldb/Symbol/CompileUnit.h"
+#include "lldb/Symbol/FuncUnwinders.h"
+#include "lldb/Symbol/Function.h"
+#include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Symbol/Type.h"
+#include "lldb/Symbol/UnwindPlan.h"
+#include "lldb/Symbol/UnwindTable.h"
+#include "lldb/Symbol/Variable.h"
+#include "lldb/Symbol/VariableList.h"
+#include "lldb/Target/Target.h"
+#include "Plugins/Process/Utility/DynamicRegisterInfo.h"
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::process_gdb_remote;
+
+namespace
+{
+    // Keep the expressions well below the size of a packet.
+    const size_t k_max_expression_size = 1024;
+
+    // The binary operators by increasing precedence, || and && are
+    // handled separately because they short circuit.
+    const char *g_binary_operators[][4] =
+    {
+        { "|", nullptr },
+        { "^", nullptr },
+        { "&", nullptr },
+        { "==", "!=", nullptr },
+        { "<=", ">=", "<", ">" },
+        { "<<", ">>", nullptr },
+        { "+", "-", nullptr },
+        { "*", "/", "%", nullptr }
+    };
+    const int k_num_precedences = sizeof(g_binary_operators) / sizeof(g_binary_operators[0]);
+
+    bool
+    IsIdentifierChar (char c)
+    {
+        return isalnum (c) || c == '_';
+    }
+}
+
+AgentExpressionCompiler::AgentExpressionCompiler (Target &target, const DynamicRegisterInfo &register_info) :
+    m_target (target),
+    m_register_info (register_info),
+    m_address (),
+    m_sc (),
+    m_pos (nullptr),
+    m_expression (),
+    m_error ()
+{
+}
+
+bool
+AgentExpressionCompiler::Compile (const char *condition, const Address &address, AgentExpression &expression, Error &error)
+{
+    m_address = address;
+    m_sc.Clear (false);
+    address.CalculateSymbolContext (&m_sc, eSymbolContextEverything);
+    m_pos = condition;
+    m_expression = AgentExpression ();
+    m_error.Clear ();
+
+    Value value;
+    bool success = condition && ParseOr (value);
+    if (success)
+    {
+        SkipSpaces ();
+        if (*m_pos != '\0')
+            success = Fail ("unsupported syntax at \"%s\"", m_pos);
+    }
+    if (success)
+    {
+        m_expression.AppendOpcode (AgentExpression::eOpEnd);
+        if (m_expression.GetSize () > k_max_expression_size)
+            success = Fail ("the condition is too long");
+    }
+
+    if (!success)
+    {
+        error = m_error;
+        if (error.Success ())
+            error.SetErrorString ("invalid condition");
+        return false;
+    }
+    expression = m_expression;
+    return true;
+}
+
+bool
+AgentExpressionCompiler::ParseOr (Value &value)
+{
+    if (!ParseAnd (value))
+        return false;
+
+    while (ConsumeOperator ("||"))
+    {
+        // Leave the first true operand on the stack.
+        EmitBoolean ();
+        m_expression.AppendOpcode (AgentExpression::eOpDup);
+        const size_t jump = m_expression.AppendJump (AgentExpression::eOpIfGoto);
+        m_expression.AppendOpcode (AgentExpression::eOpPop);
+        if (!ParseAnd (value))
+            return false;
+        EmitBoolean ();
+        m_expression.SetJumpTarget (jump, m_expression.GetSize ());
+        value = Value{ 4, true, false, 0, false };
+    }
+    return true;
+}
+
+bool
+AgentExpressionCompiler::ParseAnd (Value &value)
+{
+    if (!ParseBinary (0, value))
+        return false;
+
+    while (ConsumeOperator ("&&"))
+    {
+        // Leave the first false operand on the stack.
+        EmitBoolean ();
+        m_expression.AppendOpcode (AgentExpression::eOpDup);
+        m_expression.AppendOpcode (AgentExpression::eOpLogNot);
+        const size_t jump = m_expression.AppendJump (AgentExpression::eOpIfGoto);
+        m_expression.AppendOpcode (AgentExpression::eOpPop);
+        if (!ParseBinary (0, value))
+            return false;
+        EmitBoolean ();
+        m_expression.SetJumpTarget (jump, m_expression.GetSize ());
+        value = Value{ 4, true, false, 0, false };
+    }
+    return true;
+}
+
+bool
+AgentExpressionCompiler::ParseBinary (int precedence, Value &value)
+{
+    if (precedence == k_num_precedences)
+        return ParseUnary (value);
+
+    if (!ParseBinary (precedence + 1, value))
+        return false;
+
+    while (true)
+    {
+        const char *op = nullptr;
+        for (const char *candidate : g_binary_operators[precedence])
+        {
+            if (candidate && ConsumeOperator (candidate))
+            {
+                op = candidate;
+                break;
+            }
+        }
+        if (op == nullptr)
+            return true;
+
+        Value rhs;
+        if (!ParseBinary (precedence + 1, rhs))
+            return false;
+        if (!EmitBinary (op, value, rhs, value))
+            return false;
+    }
+}
+
+bool
+AgentExpressionCompiler::ParseUnary (Value &value)
+{
+    if (ConsumeOperator ("!"))
+    {
+        if (!ParseUnary (value))
+            return false;
+        m_expression.AppendOpcode (AgentExpression::eOpLogNot);
+        value = Value{ 4, true, false, 0, false };
+        return true;
+    }
+    if (ConsumeOperator ("-"))
+    {
+        if (!ParseUnary (value))
+            return false;
+        // 0 - value
+        m_expression.AppendConstant (0);
+        m_expression.AppendOpcode (AgentExpression::eOpSwap);
+        return EmitBinary ("-", Value{ 4, true, false, 0, false }, value, value);
+    }
+    if (ConsumeOperator ("~"))
+    {
+        if (!ParseUnary (value))
+            return false;
+        if (value.is_pointer)
+            return Fail ("pointer arithmetic isn't supported");
+        m_expression.AppendOpcode (AgentExpression::eOpBitNot);
+        // Keep the value in the range of its promoted type.
+        value.is_signed = value.is_signed || value.byte_size < 4;
+        value.byte_size = std::max (value.byte_size, 4u);
+        if (value.byte_size == 4)
+            m_expression.AppendOpcode (value.is_signed ? AgentExpression::eOpExt : AgentExpression::eOpZeroExt, 32);
+        return true;
+    }
+    if (ConsumeOperator ("*"))
+    {
+        if (!ParseUnary (value))
+            return false;
+        if (!value.is_pointer || value.pointee_byte_size == 0)
+            return Fail ("only pointers to integers can be dereferenced");
+        const Value pointee{ value.pointee_byte_size, value.pointee_is_signed, false, 0, false };
+        if (!EmitLoad (pointee.byte_size, pointee.is_signed))
+            return false;
+        value = pointee;
+        return true;
+    }
+    return ParsePrimary (value);
+}
+
+bool
+AgentExpressionCompiler::ParsePrimary (Value &value)
+{
+    SkipSpaces ();
+
+    if (*m_pos == '(')
+    {
+        ++m_pos;
+        if (!ParseOr (value))
+            return false;
+        SkipSpaces ();
+        if (*m_pos != ')')
+            return Fail ("expected ')'");
+        ++m_pos;
+        return true;
+    }
+
+    if (isdigit (*m_pos))
+    {
+        char *end = nullptr;
+        const uint64_t number = ::strtoull (m_pos, &end, 0);
+        m_pos = end;
+        bool is_unsigned = false;
+        while (*m_pos == 'u' || *m_pos == 'U' || *m_pos == 'l' || *m_pos == 'L')
+        {
+            if (*m_pos == 'u' || *m_pos == 'U')
+                is_unsigned = true;
+            ++m_pos;
+        }
+        if (IsIdentifierChar (*m_pos) || *m_pos == '.')
+            return Fail ("unsupported number at \"%s\"", m_pos);
+
+        m_expression.AppendConstant (number);
+        if (number <= (is_unsigned ? UINT32_MAX : INT32_MAX))
+            value = Value{ 4, !is_unsigned, false, 0, false };
+        else
+            value = Value{ 8, !is_unsigned && number <= INT64_MAX, false, 0, false };
+        return true;
+    }
+
+    if (*m_pos == '$')
+    {
+        const char *start = ++m_pos;
+        while (IsIdentifierChar (*m_pos))
+            ++m_pos;
+        const std::string name (start, m_pos - start);
+
+        const size_t num_registers = m_register_info.GetNumRegisters ();
+        for (size_t i = 0; i < num_registers; ++i)
+        {
+            const RegisterInfo *reg_info = m_register_info.GetRegisterInfoAtIndex (i);
+            if (!reg_info || !((reg_info->name && name == reg_info->name) ||
+                               (reg_info->alt_name && name == reg_info->alt_name)))
+                continue;
+            if (reg_info->byte_size > 8 || reg_info->encoding == eEncodingIEEE754 || reg_info->encoding == eEncodingVector)
+                return Fail ("register $%s isn't an integer register", name.c_str ());
+            if (!EmitRegister (eRegisterKindLLDB, i))
+                return false;
+            value = Value{ std::max (reg_info->byte_size, 4u), false, false, 0, false };
+            return true;
+        }
+        return Fail ("unknown register $%s", name.c_str ());
+    }
+
+    if (IsIdentifierChar (*m_pos))
+    {
+        const char *start = m_pos;
+        while (IsIdentifierChar (*m_pos))
+            ++m_pos;
+        return EmitIdentifier (std::string (start, m_pos - start), value);
+    }
+
+    return Fail ("unsupported syntax at \"%s\"", m_pos);
+}
+
+bool
+AgentExpressionCompiler::EmitBinary (const char *op, const Value &lhs, const Value &rhs, Value &value)
+{
+    const bool is_comparison = ::strcmp (op, "==") == 0 || ::strcmp (op, "!=") == 0 ||
+                               op[0] == '<' || op[0] == '>';
+    const bool is_shift = ::strcmp (op, "<<") == 0 || ::strcmp (op, ">>") == 0;
+    if ((lhs.is_pointer || rhs.is_pointer) && (!is_comparison || is_shift))
+        return Fail ("pointer arithmetic isn't supported");
+
+    // The usual arithmetic conversions: integers narrower than int are
+    // promoted to int, then the unsigned operand wins unless the signed one
+    // is wider.
+    const uint32_t lhs_size = std::max (lhs.byte_size, 4u);
+    const uint32_t rhs_size = std::max (rhs.byte_size, 4u);
+    const bool lhs_signed = lhs.is_signed || lhs.byte_size < 4;
+    const bool rhs_signed = rhs.is_signed || rhs.byte_size < 4;
+    Value common{ std::max (lhs_size, rhs_size), lhs_signed && rhs_signed, false, 0, false };
+    if (lhs_signed != rhs_signed)
+        common.is_signed = lhs_signed ? lhs_size > rhs_size : rhs_size > lhs_size;
+    if (is_shift)
+        common = Value{ lhs_size, lhs_signed, false, 0, false };
+
+    // The operands are on the stack extended to 64 bits according to their
+    // own type, which is already their value in a 64 bit common type. A 32
+    // bit common type needs them extended again like it, the int -1 is
+    // 0xffffffff as an unsigned int. The shift count keeps its type.
+    typedef AgentExpression E;
+    if (common.byte_size == 4 && !is_shift)
+    {
+        const E::Opcode convert = common.is_signed ? E::eOpExt : E::eOpZeroExt;
+        if (rhs_signed != common.is_signed)
+            m_expression.AppendOpcode (convert, 32);
+        if (lhs_signed != common.is_signed)
+        {
+            m_expression.AppendOpcode (E::eOpSwap);
+            m_expression.AppendOpcode (convert, 32);
+            m_expression.AppendOpcode (E::eOpSwap);
+        }
+    }
+
+    bool truncate = false;
+    if (::strcmp (op, "+") == 0)
+    {
+        m_expression.AppendOpcode (E::eOpAdd);
+        truncate = true;
+    }
+    else if (::strcmp (op, "-") == 0)
+    {
+        m_expression.AppendOpcode (E::eOpSub);
+        truncate = true;
+    }
+    else if (::strcmp (op, "*") == 0)
+    {
+        m_expression.AppendOpcode (E::eOpMul);
+        truncate = true;
+    }
+    else if (::strcmp (op, "<<") == 0)
+    {
+        m_expression.AppendOpcode (E::eOpLsh);
+        truncate = true;
+    }
+    else if (::strcmp (op, "|") == 0)
+        m_expression.AppendOpcode (E::eOpBitOr);
+    else if (::strcmp (op, "/") == 0)
+        m_expression.AppendOpcode (common.is_signed ? E::eOpDivSigned : E::eOpDivUnsigned);
+    else if (::strcmp (op, "%") == 0)
+        m_expression.AppendOpcode (common.is_signed ? E::eOpRemSigned : E::eOpRemUnsigned);
+    else if (::strcmp (op, ">>") == 0)
+        m_expression.AppendOpcode (common.is_signed ? E::eOpRshSigned : E::eOpRshUnsigned);
+    else if (::strcmp (op, "&") == 0)
+        m_expression.AppendOpcode (E::eOpBitAnd);
+    else if (::strcmp (op, "^") == 0)
+        m_expression.AppendOpcode (E::eOpBitXor);
+    else if (is_comparison)
+    {
+        const E::Opcode less = common.is_signed ? E::eOpLessSigned : E::eOpLessUnsigned;
+        if (::strcmp (op, "==") == 0)
+            m_expression.AppendOpcode (E::eOpEqual);
+        else if (::strcmp (op, "!=") == 0)
+        {
+            m_expression.AppendOpcode (E::eOpEqual);
+            m_expression.AppendOpcode (E::eOpLogNot);
+        }
+        else if (::strcmp (op, "<") == 0)
+            m_expression.AppendOpcode (less);
+        else if (::strcmp (op, ">") == 0)
+        {
+            m_expression.AppendOpcode (E::eOpSwap);
+            m_expression.AppendOpcode (less);
+        }
+        else if (::strcmp (op, "<=") == 0)
+        {
+            m_expression.AppendOpcode (E::eOpSwap);
+            m_expression.AppendOpcode (less);
+            m_expression.AppendOpcode (E::eOpLogNot);
+        }
+        else
+        {
+            m_expression.AppendOpcode (less);
+            m_expression.AppendOpcode (E::eOpLogNot);
+        }
+        value = Value{ 4, true, false, 0, false };
+        return true;
+    }
+    else
+        return Fail ("unsupported operator %s", op);
+
+    // Wrap around like the C arithmetic on 32 bit integers.
+    if (truncate && common.byte_size == 4)
+        m_expression.AppendOpcode (common.is_signed ? E::eOpExt : E::eOpZeroExt, 32);
+
+    value = common;
+    return true;
+}
+
+bool
+AgentExpressionCompiler::EmitIdentifier (const std::string &name, Value &value)
+{
+    if (name == "true" || name == "false")
+    {
+        m_expression.AppendConstant (name == "true");
+        value = Value{ 4, true, false, 0, false };
+        return true;
+    }
+    if (name == "nullptr" || name == "NULL")
+    {
+        m_expression.AppendConstant (0);
+        value = Value{ 8, false, true, 0, false };
+        return true;
+    }
+
+    // Look the variable up in the scope of the breakpoint.
+    const ConstString var_name (name.c_str ());
+    bool has_this = false;
+    for (Block *block = m_sc.block; block; block = block->GetParent ())
+    {
+        VariableListSP variables_sp = block->GetBlockVariableList (true);
+        if (!variables_sp)
+            continue;
+        VariableSP var_sp = variables_sp->FindVariable (var_name);
+        if (var_sp)
+            return EmitVariable (var_sp, value);
+        if (variables_sp->FindVariable (ConstString ("this")) || variables_sp->FindVariable (ConstString ("self")))
+            has_this = true;
+    }
+
+    // In a method the name could be a member, leave that to lldb.
+    if (has_this)
+        return Fail ("\"%s\" isn't a local variable", name.c_str ());
+
+    if (m_sc.comp_unit)
+    {
+        VariableListSP variables_sp = m_sc.comp_unit->GetVariableList (true);
+        VariableSP var_sp = variables_sp ? variables_sp->FindVariable (var_name) : VariableSP ();
+        if (var_sp)
+            return EmitVariable (var_sp, value);
+    }
+
+    VariableList variables;
+    if (m_target.GetImages ().FindGlobalVariables (var_name, true, 2, variables) == 1)
+        return EmitVariable (variables.GetVariableAtIndex (0), value);
+
+    return Fail ("can't find variable \"%s\"", name.c_str ());
+}
+
+bool
+AgentExpressionCompiler::EmitVariable (const VariableSP &var_sp, Value &value)
+{
+    const char *name = var_sp->GetName ().AsCString ("<unnamed>");
+    Type *type = var_sp->GetType ();
+    if (!type)
+        return Fail ("variable \"%s\" has no type", name);
+
+    CompilerType compiler_type = type->GetFullCompilerType ();
+    CompilerType pointee_type;
+    const uint32_t type_flags = compiler_type.GetTypeInfo (&pointee_type);
+    const uint64_t byte_size = compiler_type.GetByteSize (nullptr);
+    if ((type_flags & (eTypeIsFloat | eTypeIsComplex | eTypeIsVector | eTypeIsReference)) ||
+        !(type_flags & (eTypeIsScalar | eTypeIsEnumeration | eTypeIsPointer)) ||
+        (byte_size != 1 && byte_size != 2 && byte_size != 4 && byte_size != 8))
+        return Fail ("variable \"%s\" isn't an integer or a pointer", name);
+
+    value = Value{ static_cast<uint32_t> (byte_size), (type_flags & eTypeIsSigned) != 0, false, 0, false };
+    if (type_flags & eTypeIsPointer)
+    {
+        value.is_signed = false;
+        value.is_pointer = true;
+        const uint32_t pointee_flags = pointee_type.GetTypeInfo ();
+        const uint64_t pointee_byte_size = pointee_type.GetByteSize (nullptr);
+        if ((pointee_flags & (eTypeIsScalar | eTypeIsEnumeration)) &&
+            !(pointee_flags & (eTypeIsFloat | eTypeIsComplex | eTypeIsVector | eTypeIsPointer)) &&
+            (pointee_byte_size == 1 || pointee_byte_size == 2 || pointee_byte_size == 4 || pointee_byte_size == 8))
+        {
+            value.pointee_byte_size = pointee_byte_size;
+            value.pointee_is_signed = (pointee_flags & eTypeIsSigned) != 0;
+        }
+    }
+
+    // Only locations made of a single operation valid for the whole scope
+    // of the variable are supported.
+    const DWARFExpression &location = var_sp->LocationExpression ();
+    if (var_sp->GetLocationIsConstantValueData () || location.IsLocationList ())
+        return Fail ("the location of variable \"%s\" isn't supported", name);
+
+    DataExtractor data;
+    location.GetExpressionData (data);
+    lldb::offset_t offset = 0;
+    const uint8_t op = data.GetU8 (&offset);
+    bool in_memory = true;
+    if (op == DW_OP_addr)
+    {
+        const lldb::addr_t file_addr = data.GetAddress (&offset);
+        ModuleSP module_sp;
+        if (SymbolContextScope *scope = var_sp->GetSymbolContextScope ())
+            module_sp = scope->CalculateSymbolContextModule ();
+        Address so_addr;
+        if (!module_sp || !module_sp->ResolveFileAddress (file_addr, so_addr))
+            return Fail ("can't resolve the address of variable \"%s\"", name);
+        const lldb::addr_t load_addr = so_addr.GetLoadAddress (&m_target);
+        if (load_addr == LLDB_INVALID_ADDRESS)
+            return Fail ("variable \"%s\" isn't loaded", name);
+        m_expression.AppendConstant (load_addr);
+    }
+    else if (op == DW_OP_fbreg)
+    {
+        const int64_t frame_offset = data.GetSLEB128 (&offset);
+        if (!EmitFrameBase ())
+            return false;
+        EmitAddOffset (frame_offset);
+    }
+    else if ((op >= DW_OP_breg0 && op <= DW_OP_breg31) || op == DW_OP_bregx)
+    {
+        const uint32_t reg_num = op == DW_OP_bregx ? data.GetULEB128 (&offset) : op - DW_OP_breg0;
+        const int64_t reg_offset = data.GetSLEB128 (&offset);
+        if (!EmitRegister (eRegisterKindDWARF, reg_num))
+            return false;
+        EmitAddOffset (reg_offset);
+    }
+    else if ((op >= DW_OP_reg0 && op <= DW_OP_reg31) || op == DW_OP_regx)
+    {
+        const uint32_t reg_num = op == DW_OP_regx ? data.GetULEB128 (&offset) : op - DW_OP_reg0;
+        if (!EmitRegister (eRegisterKindDWARF, reg_num))
+            return false;
+        in_memory = false;
+    }
+    else
+        return Fail ("the location of variable \"%s\" isn't supported", name);
+
+    if (offset != data.GetByteSize ())
+        return Fail ("the location of variable \"%s\" isn't supported", name);
+
+    if (in_memory)
+        return EmitLoad (value.byte_size, value.is_signed);
+
+    // The variable is in the low bytes of a register.
+    if (value.byte_size < 8)
+        m_expression.AppendOpcode (value.is_signed ? AgentExpression::eOpExt : AgentExpression::eOpZeroExt,
+                                   value.byte_size * 8);
+    return true;
+}
+
+bool
+AgentExpressionCompiler::EmitLoad (uint32_t byte_size, bool is_signed)
+{
+    switch (byte_size)
+    {
+        case 1: m_expression.AppendOpcode (AgentExpression::eOpRef8); break;
+        case 2: m_expression.AppendOpcode (AgentExpression::eOpRef16); break;
+        case 4: m_expression.AppendOpcode (AgentExpression::eOpRef32); break;
+        case 8: m_expression.AppendOpcode (AgentExpression::eOpRef64); break;
+        default:
+            return Fail ("can't read a %u byte value", byte_size);
+    }
+    if (is_signed && byte_size < 8)
+        m_expression.AppendOpcode (AgentExpression::eOpExt, byte_size * 8);
+    return true;
+}
+
+bool
+AgentExpressionCompiler::EmitFrameBase ()
+{
+    if (!m_sc.function)
+        return Fail ("the breakpoint isn't in a function");
+
+    const DWARFExpression &frame_base = m_sc.function->GetFrameBaseExpression ();
+    if (frame_base.IsLocationList ())
+        return Fail ("the frame base location isn't supported");
+
+    DataExtractor data;
+    frame_base.GetExpressionData (data);
+    lldb::offset_t offset = 0;
+    const uint8_t op = data.GetU8 (&offset);
+    bool success;
+    if (op == DW_OP_call_frame_cfa)
+        success = EmitCanonicalFrameAddress ();
+    else if ((op >= DW_OP_reg0 && op <= DW_OP_reg31) || op == DW_OP_regx)
+        success = EmitRegister (eRegisterKindDWARF, op == DW_OP_regx ? data.GetULEB128 (&offset) : op - DW_OP_reg0);
+    else if ((op >= DW_OP_breg0 && op <= DW_OP_breg31) || op == DW_OP_bregx)
+    {
+        const uint32_t reg_num = op == DW_OP_bregx ? data.GetULEB128 (&offset) : op - DW_OP_breg0;
+        const int64_t reg_offset = data.GetSLEB128 (&offset);
+        success = EmitRegister (eRegisterKindDWARF, reg_num);
+        if (success)
+            EmitAddOffset (reg_offset);
+    }
+    else
+        return Fail ("the frame base location isn't supported");
+
+    if (success && offset != data.GetByteSize ())
+        return Fail ("the frame base location isn't supported");
+    return success;
+}
+
+bool
+AgentExpressionCompiler::EmitCanonicalFrameAddress ()
+{
+    // Compute the CFA at the breakpoint address from the eh_frame row,
+    // it is valid at every instruction unlike the frame pointer.
+    ObjectFile *object_file = m_sc.module_sp ? m_sc.module_sp->GetObjectFile () : nullptr;
+    if (!object_file)
+        return Fail ("can't find the unwind information of the breakpoint address");
+
+    SymbolContext sc;
+    FuncUnwindersSP func_unwinders_sp = object_file->GetUnwindTable ().GetFuncUnwindersContainingAddress (m_address, sc);
+    if (!func_unwinders_sp)
+        return Fail ("can't find the unwind information of the breakpoint address");
+
+    const int function_offset = m_address.GetFileAddress () - func_unwinders_sp->GetFunctionStartAddress ().GetFileAddress ();
+    UnwindPlanSP unwind_plan_sp = func_unwinders_sp->GetEHFrameUnwindPlan (m_target, function_offset);
+    UnwindPlan::RowSP row_sp = unwind_plan_sp ? unwind_plan_sp->GetRowForFunctionOffset (function_offset) : UnwindPlan::RowSP ();
+    if (!row_sp || !row_sp->GetCFAValue ().IsRegisterPlusOffset ())
+        return Fail ("can't compute the canonical frame address at the breakpoint address");
+
+    if (!EmitRegister (unwind_plan_sp->GetRegisterKind (), row_sp->GetCFAValue ().GetRegisterNumber ()))
+        return false;
+    EmitAddOffset (row_sp->GetCFAValue ().GetOffset ());
+    return true;
+}
+
+bool
+AgentExpressionCompiler::EmitRegister (RegisterKind kind, uint32_t reg_num)
+{
+    // The stub numbers the registers like the "p" packet.
+    const uint32_t lldb_reg_num = kind == eRegisterKindLLDB ? reg_num : m_register_info.ConvertRegisterKindToRegisterNumber (kind, reg_num);
+    const RegisterInfo *reg_info = m_register_info.GetRegisterInfoAtIndex (lldb_reg_num);
+    if (!reg_info || reg_info->kinds[eRegisterKindProcessPlugin] == LLDB_INVALID_REGNUM ||
+        reg_info->kinds[eRegisterKindProcessPlugin] > UINT16_MAX)
+        return Fail ("the stub has no register numbered %u", reg_num);
+
+    m_expression.AppendRegister (reg_info->kinds[eRegisterKindProcessPlugin]);
+    return true;
+}
+
+void
+AgentExpressionCompiler::EmitAddOffset (int64_t offset)
+{
+    if (offset == 0)
+        return;
+    m_expression.AppendConstant (offset < 0 ? -static_cast<uint64_t> (offset) : offset);
+    m_expression.AppendOpcode (offset < 0 ? AgentExpression::eOpSub : AgentExpression::eOpAdd);
+}
+
+void
+AgentExpressionCompiler::EmitBoolean ()
+{
+    m_expression.AppendOpcode (AgentExpression::eOpLogNot);
+    m_expression.AppendOpcode (AgentExpression::eOpLogNot);
+}
+
+void
+AgentExpressionCompiler::SkipSpaces ()
+{
+    while (isspace (*m_pos))
+        ++m_pos;
+}
+
+bool
+AgentExpressionCompiler::ConsumeOperator (const char *op)
+{
+    SkipSpaces ();
+    const size_t len = ::strlen (op);
+    if (::strncmp (m_pos, op, len) != 0)
+        return false;
+
+    // Don't match the start of a longer operator, like < in <= or <<.
+    const char next = m_pos[len];
+    if (len == 1 && (next == '=' || (next == op[0] && ::strchr ("|&<>", next))))
+        return false;
+
+    m_pos += len;
+    return true;
+}
+
+bool
+AgentExpressionCompiler::Fail (const char *format, ...)
+{
+    va_list args;
+    va_start (args, format);
+    m_error.SetErrorStringWithVarArg (format, args);
+    va_end (args);
+    return false;
+}
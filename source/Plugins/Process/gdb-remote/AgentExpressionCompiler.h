@@ -0,0 +1,115 @@
+//===-- AgentExpressionCompiler.h -------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_AgentExpressionCompiler_h_
+#define liblldb_AgentExpressionCompiler_h_
+
+// C Includes
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+#include "lldb/Core/Address.h"
+#include "lldb/Core/Error.h"
+#include "lldb/Symbol/SymbolContext.h"
+#include "AgentExpression.h"
+
+class DynamicRegisterInfo;
+
+namespace lldb_private {
+namespace process_gdb_remote {
+
+//----------------------------------------------------------------------
+/// @class AgentExpressionCompiler AgentExpressionCompiler.h
+/// @brief Compiles breakpoint conditions to agent expressions.
+///
+/// Only a subset of C is supported, enough for the common conditions
+/// that compare variables and registers to constants:
+///
+///     ||, &&, |, ^, &, ==, !=, <, <=, >, >=, <<, >>, +, -, *, /, %
+///     unary !, ~, - and * (dereferencing a pointer to an integer)
+///     integer constants, true, false, nullptr
+///     local, static and global variables of integer, enumeration or
+///     pointer type whose location doesn't depend on the pc
+///     registers like $rax or $pc
+///
+/// Anything else fails to compile, the condition is then evaluated by
+/// lldb when the stub reports the breakpoint hit.
+//----------------------------------------------------------------------
+class AgentExpressionCompiler
+{
+public:
+    AgentExpressionCompiler (Target &target, const DynamicRegisterInfo &register_info);
+
+    //------------------------------------------------------------------
+    /// Compile the condition of a breakpoint.
+    ///
+    /// @param[in] condition
+    ///     The condition text.
+    ///
+    /// @param[in] address
+    ///     The address of the breakpoint, the variables of the condition
+    ///     are looked up in its scope.
+    ///
+    /// @param[out] expression
+    ///     The compiled condition.
+    ///
+    /// @param[out] error
+    ///     Why the condition can't be compiled.
+    ///
+    /// @return
+    ///     True if the condition was compiled.
+    //------------------------------------------------------------------
+    bool
+    Compile (const char *condition, const Address &address, AgentExpression &expression, Error &error);
+
+private:
+    // What is known about the value on top of the stack.
+    struct Value
+    {
+        uint32_t byte_size;
+        bool is_signed;
+        bool is_pointer;
+        uint32_t pointee_byte_size; // Zero if the pointee can't be dereferenced
+        bool pointee_is_signed;
+    };
+
+    bool ParseOr (Value &value);
+    bool ParseAnd (Value &value);
+    bool ParseBinary (int precedence, Value &value);
+    bool ParseUnary (Value &value);
+    bool ParsePrimary (Value &value);
+
+    bool EmitBinary (const char *op, const Value &lhs, const Value &rhs, Value &value);
+    bool EmitIdentifier (const std::string &name, Value &value);
+    bool EmitVariable (const lldb::VariableSP &var_sp, Value &value);
+    bool EmitLoad (uint32_t byte_size, bool is_signed);
+    bool EmitFrameBase ();
+    bool EmitCanonicalFrameAddress ();
+    bool EmitRegister (lldb::RegisterKind kind, uint32_t reg_num);
+    void EmitAddOffset (int64_t offset);
+    void EmitBoolean ();
+
+    void SkipSpaces ();
+    bool ConsumeOperator (const char *op);
+    bool Fail (const char *format, ...) __attribute__ ((format (printf, 2, 3)));
+
+    Target &m_target;
+    const DynamicRegisterInfo &m_register_info;
+    Address m_address;
+    SymbolContext m_sc;
+    const char *m_pos;
+    AgentExpression m_expression;
+    Error m_error;
+};
+
+} // namespace process_gdb_remote
+} // namespace lldb_private
+
+#endif // liblldb_AgentExpressionCompiler_h_
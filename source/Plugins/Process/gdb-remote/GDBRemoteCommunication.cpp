@@ -51,6 +51,10 @@
 #include <zlib.h>
 #endif
 
+#if defined (HAVE_LIBLZ4)
+#include <lz4.h>
+#endif
+
 using namespace lldb;
 using namespace lldb_private;
 using namespace lldb_private::process_gdb_remote;
@@ -168,6 +172,8 @@ GDBRemoteCommunication::GDBRemoteCommunication(const char *comm_name,
     m_history (512),
     m_send_acks (true),
     m_compression_type (CompressionType::None),
+    m_send_compression_type (CompressionType::None),
+    m_send_compression_min_size (384),
     m_listen_url ()
 {
 }
@@ -238,6 +244,14 @@ GDBRemoteCommunication::SendPacketNoLock (const char *payload, size_t payload_le
 {
     if (IsConnected())
     {
+        std::string compressed_payload;
+        if (m_send_compression_type != CompressionType::None)
+        {
+            compressed_payload = CompressPayload (payload, payload_length);
+            payload = compressed_payload.data();
+            payload_length = compressed_payload.size();
+        }
+
         StreamString packet(0, 4, eByteOrderBig);
 
         packet.PutChar('$');
@@ -757,6 +771,21 @@ GDBRemoteCommunication::DecompressPacket ()
     }
 #endif
 
+#if defined (HAVE_LIBLZ4)
+    if (decompressed_bytes == 0
+        && decompressed_bufsize != ULONG_MAX
+        && decompressed_buffer != nullptr
+        && m_compression_type == CompressionType::LZ4)
+    {
+        const int result = LZ4_decompress_safe ((const char *) unescaped_content.data(),
+                                                (char *) decompressed_buffer,
+                                                (int) unescaped_content.size(),
+                                                (int) decompressed_bufsize);
+        if (result > 0)
+            decompressed_bytes = result;
+    }
+#endif
+
     if (decompressed_bytes == 0 || decompressed_buffer == nullptr)
     {
         if (decompressed_buffer)
@@ -789,6 +818,84 @@ GDBRemoteCommunication::DecompressPacket ()
     return true;
 }
 
+std::string
+GDBRemoteCommunication::CompressPayload (const char *payload, size_t payload_length) const
+{
+    std::string compressed;
+    std::vector<uint8_t> encoded_data;
+    size_t compressed_size = 0;
+
+    if (payload_length > m_send_compression_min_size)
+    {
+#if defined (HAVE_LIBZ)
+        if (m_send_compression_type == CompressionType::ZlibDeflate)
+        {
+            // Raw deflate stream without zlib header, matching what
+            // DecompressPacket and debugserver expect.
+            z_stream stream;
+            memset (&stream, 0, sizeof (z_stream));
+            stream.zalloc = Z_NULL;
+            stream.zfree = Z_NULL;
+            stream.opaque = Z_NULL;
+            if (deflateInit2 (&stream, 5, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) == Z_OK)
+            {
+                encoded_data.resize (deflateBound (&stream, payload_length));
+                stream.next_in = (Bytef *) payload;
+                stream.avail_in = (uInt) payload_length;
+                stream.next_out = (Bytef *) encoded_data.data();
+                stream.avail_out = (uInt) encoded_data.size();
+                if (deflate (&stream, Z_FINISH) == Z_STREAM_END)
+                    compressed_size = stream.total_out;
+                deflateEnd (&stream);
+            }
+        }
+#endif
+
+#if defined (HAVE_LIBLZ4)
+        if (m_send_compression_type == CompressionType::LZ4)
+        {
+            encoded_data.resize (LZ4_compressBound (payload_length));
+            const int result = LZ4_compress_default (payload,
+                                                     (char *) encoded_data.data(),
+                                                     (int) payload_length,
+                                                     (int) encoded_data.size());
+            if (result > 0)
+                compressed_size = result;
+        }
+#endif
+    }
+
+    // Send the payload as is if it's small or doesn't compress, the 'N'
+    // prefix tells the receiver that it isn't compressed.
+    if (compressed_size == 0 || compressed_size >= payload_length)
+    {
+        compressed.reserve (payload_length + 1);
+        compressed.push_back ('N');
+        compressed.append (payload, payload_length);
+        return compressed;
+    }
+
+    char size_prefix[32];
+    snprintf (size_prefix, sizeof (size_prefix), "C%" PRIu64 ":", (uint64_t) payload_length);
+    compressed.reserve (compressed_size + compressed_size / 16 + sizeof (size_prefix));
+    compressed.append (size_prefix);
+    for (size_t i = 0; i < compressed_size; ++i)
+    {
+        // Apply the gdb-remote binary escaping to the compressed data.
+        const uint8_t byte = encoded_data[i];
+        if (byte == '#' || byte == '$' || byte == '}' || byte == '*' || byte == '\0')
+        {
+            compressed.push_back (0x7d);
+            compressed.push_back (byte ^ 0x20);
+        }
+        else
+        {
+            compressed.push_back (byte);
+        }
+    }
+    return compressed;
+}
+
 GDBRemoteCommunication::PacketType
 GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, StringExtractorGDBRemote &packet)
 {
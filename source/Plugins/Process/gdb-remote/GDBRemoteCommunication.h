@@ -297,7 +297,9 @@ protected:
                         // false if this class represents a debug session for
                         // a single process
     
-    CompressionType m_compression_type;
+    CompressionType m_compression_type;      // Compression of the packets we receive
+    CompressionType m_send_compression_type; // Compression of the packets we send, only used by servers
+    size_t m_send_compression_min_size;      // Smaller payloads are sent without being compressed
 
     PacketResult
     SendPacket (const char *payload,
@@ -338,6 +340,21 @@ protected:
     bool
     DecompressPacket ();
 
+    // Enable compression of the packets we send from now on. Servers call
+    // this after replying to QEnableCompression.
+    void
+    SetSendCompression (CompressionType type, size_t min_size)
+    {
+        m_send_compression_type = type;
+        m_send_compression_min_size = min_size;
+    }
+
+    // Encode a payload with the compression type set by SetSendCompression,
+    // e.g. "C1024:<escaped binary>" or "N<payload>" if the payload is too
+    // small to be compressed or doesn't get any smaller.
+    std::string
+    CompressPayload (const char *payload, size_t payload_length) const;
+
     Error
     StartListenThread (const char *hostname = "127.0.0.1", uint16_t port = 0);
 
@@ -86,6 +86,8 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient() :
     m_supports_qXfer_libraries_svr4_read (eLazyBoolCalculate),
     m_supports_qXfer_features_read (eLazyBoolCalculate),
     m_supports_augmented_libraries_svr4_read (eLazyBoolCalculate),
+    m_supports_conditional_breakpoints (eLazyBoolCalculate),
+    m_supports_multi_breakpoint (eLazyBoolCalculate),
     m_supports_jThreadExtendedInfo (eLazyBoolCalculate),
     m_supports_jLoadedDynamicLibrariesInfos (eLazyBoolCalculate),
     m_supports_qProcessInfoPID (true),
@@ -104,6 +106,7 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient() :
     m_qSymbol_requests_done (false),
     m_supports_qModuleInfo (true),
     m_supports_jThreadsInfo (true),
+    m_supports_jMultiMemRead (true),
     m_curr_pid (LLDB_INVALID_PROCESS_ID),
     m_curr_tid (LLDB_INVALID_THREAD_ID),
     m_curr_tid_run (LLDB_INVALID_THREAD_ID),
@@ -200,6 +203,26 @@ GDBRemoteCommunicationClient::GetAugmentedLibrariesSVR4ReadSupported ()
     return m_supports_augmented_libraries_svr4_read == eLazyBoolYes;
 }
 
+bool
+GDBRemoteCommunicationClient::GetConditionalBreakpointsSupported ()
+{
+    if (m_supports_conditional_breakpoints == eLazyBoolCalculate)
+    {
+        GetRemoteQSupported();
+    }
+    return m_supports_conditional_breakpoints == eLazyBoolYes;
+}
+
+bool
+GDBRemoteCommunicationClient::GetMultiBreakpointSupported ()
+{
+    if (m_supports_multi_breakpoint == eLazyBoolCalculate)
+    {
+        GetRemoteQSupported();
+    }
+    return m_supports_multi_breakpoint == eLazyBoolYes;
+}
+
 bool
 GDBRemoteCommunicationClient::GetQXferLibrariesSVR4ReadSupported ()
 {
@@ -365,6 +388,8 @@ GDBRemoteCommunicationClient::ResetDiscoverableSettings (bool did_exec)
         m_supports_qXfer_libraries_svr4_read = eLazyBoolCalculate;
         m_supports_qXfer_features_read = eLazyBoolCalculate;
         m_supports_augmented_libraries_svr4_read = eLazyBoolCalculate;
+        m_supports_conditional_breakpoints = eLazyBoolCalculate;
+        m_supports_multi_breakpoint = eLazyBoolCalculate;
         m_supports_qProcessInfoPID = true;
         m_supports_qfProcessInfo = true;
         m_supports_qUserName = true;
@@ -408,6 +433,8 @@ GDBRemoteCommunicationClient::GetRemoteQSupported ()
     m_supports_qXfer_libraries_svr4_read = eLazyBoolNo;
     m_supports_augmented_libraries_svr4_read = eLazyBoolNo;
     m_supports_qXfer_features_read = eLazyBoolNo;
+    m_supports_conditional_breakpoints = eLazyBoolNo;
+    m_supports_multi_breakpoint = eLazyBoolNo;
     m_max_packet_size = UINT64_MAX;  // It's supposed to always be there, but if not, we assume no limit
 
     // build the qSupported packet
@@ -439,6 +466,10 @@ GDBRemoteCommunicationClient::GetRemoteQSupported ()
             m_supports_qXfer_libraries_read = eLazyBoolYes;
         if (::strstr (response_cstr, "qXfer:features:read+"))
             m_supports_qXfer_features_read = eLazyBoolYes;
+        if (::strstr (response_cstr, "ConditionalBreakpoints+"))
+            m_supports_conditional_breakpoints = eLazyBoolYes;
+        if (::strstr (response_cstr, "jMultiBreakpoint+"))
+            m_supports_multi_breakpoint = eLazyBoolYes;
 
 
         // Look for a list of compressions in the features list e.g.
@@ -639,6 +670,53 @@ GDBRemoteCommunicationClient::GetThreadsInfo()
 }
 
 
+bool
+GDBRemoteCommunicationClient::ReadMemoryRanges (const std::vector<std::pair<lldb::addr_t, size_t>> &ranges,
+                                                std::vector<size_t> &bytes_read,
+                                                std::string &data)
+{
+    if (!m_supports_jMultiMemRead || ranges.empty())
+        return false;
+
+    StreamString packet;
+    packet.PutCString("jMultiMemRead:");
+    for (size_t i = 0; i < ranges.size(); ++i)
+        packet.Printf("%s%" PRIx64 ",%" PRIx64, i > 0 ? ";" : "", (uint64_t)ranges[i].first, (uint64_t)ranges[i].second);
+
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse(packet.GetData(), packet.GetSize(), response, true) != PacketResult::Success)
+        return false;
+
+    if (response.IsUnsupportedResponse())
+    {
+        m_supports_jMultiMemRead = false;
+        return false;
+    }
+    if (!response.IsNormalResponse())
+        return false;
+
+    // The reply lists the number of bytes read for each range followed by
+    // the bytes of all the ranges: <count>[,<count>]...;<binary data>
+    // The packet receive layer already removed the binary escaping.
+    bytes_read.clear();
+    size_t total_bytes_read = 0;
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+        const uint64_t count = response.GetHexMaxU64(false, UINT64_MAX);
+        if (count > ranges[i].second)
+            return false;
+        if (response.GetChar() != (i + 1 < ranges.size() ? ',' : ';'))
+            return false;
+        bytes_read.push_back(count);
+        total_bytes_read += count;
+    }
+
+    if (response.GetBytesLeft() != total_bytes_read)
+        return false;
+    data.assign(response.GetStringRef(), response.GetFilePos(), total_bytes_read);
+    return true;
+}
+
 bool
 GDBRemoteCommunicationClient::GetThreadExtendedInfoSupported ()
 {
@@ -1889,6 +1967,21 @@ GDBRemoteCommunicationClient::MaybeEnableCompression (std::vector<std::string> s
     }
 #endif
 
+#if defined (HAVE_LIBLZ4)
+    if (avail_type == CompressionType::None)
+    {
+        for (auto compression : supported_compressions)
+        {
+            if (compression == "lz4")
+            {
+                avail_type = CompressionType::LZ4;
+                avail_name = compression;
+                break;
+            }
+        }
+    }
+#endif
+
 #if defined (HAVE_LIBCOMPRESSION)
     // libcompression is weak linked so test if compression_decode_buffer() is available
     if (compression_decode_buffer != NULL && avail_type == CompressionType::None)
@@ -3550,7 +3643,11 @@ GDBRemoteCommunicationClient::GetThreadStopInfo (lldb::tid_t tid, StringExtracto
 
 
 uint8_t
-GDBRemoteCommunicationClient::SendGDBStoppointTypePacket (GDBStoppointType type, bool insert,  addr_t addr, uint32_t length)
+GDBRemoteCommunicationClient::SendGDBStoppointTypePacket (GDBStoppointType type,
+                                                          bool insert,
+                                                          addr_t addr,
+                                                          uint32_t length,
+                                                          const std::vector<std::vector<uint8_t>> *conditions)
 {
     Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
     if (log)
@@ -3561,19 +3658,20 @@ GDBRemoteCommunicationClient::SendGDBStoppointTypePacket (GDBStoppointType type,
     if (!SupportsGDBStoppointPacket(type))
         return UINT8_MAX;
     // Construct the breakpoint packet
-    char packet[64];
-    const int packet_len = ::snprintf (packet, 
-                                       sizeof(packet), 
-                                       "%c%i,%" PRIx64 ",%x",
-                                       insert ? 'Z' : 'z', 
-                                       type, 
-                                       addr, 
-                                       length);
-    // Check we haven't overwritten the end of the packet buffer
-    assert (packet_len + 1 < (int)sizeof(packet));
+    StreamString packet;
+    packet.Printf ("%c%i,%" PRIx64 ",%x", insert ? 'Z' : 'z', type, addr, length);
+    // Append the conditions as agent expressions: ;X{length},{bytes}
+    if (insert && conditions)
+    {
+        for (const std::vector<uint8_t> &condition : *conditions)
+        {
+            packet.Printf (";X%" PRIx64 ",", (uint64_t)condition.size());
+            packet.PutBytesAsRawHex8 (condition.data(), condition.size());
+        }
+    }
     StringExtractorGDBRemote response;
     // Try to send the breakpoint packet, and check that it was correctly sent
-    if (SendPacketAndWaitForResponse(packet, packet_len, response, true) == PacketResult::Success)
+    if (SendPacketAndWaitForResponse(packet.GetData(), packet.GetSize(), response, true) == PacketResult::Success)
     {
         // Receive and OK packet when the breakpoint successfully placed
         if (response.IsOKResponse())
@@ -3602,6 +3700,74 @@ GDBRemoteCommunicationClient::SendGDBStoppointTypePacket (GDBStoppointType type,
     return UINT8_MAX;
 }
 
+bool
+GDBRemoteCommunicationClient::SendGDBStoppointTypePackets (GDBStoppointType type,
+                                                           bool insert,
+                                                           const std::vector<std::pair<lldb::addr_t, uint32_t>> &stoppoints,
+                                                           std::vector<bool> &succeeded)
+{
+    succeeded.assign (stoppoints.size(), false);
+    if (!GetMultiBreakpointSupported() || !SupportsGDBStoppointPacket (type))
+        return false;
+    if (type != eBreakpointSoftware && type != eBreakpointHardware)
+        return false;
+
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    if (log)
+        log->Printf ("GDBRemoteCommunicationClient::%s() %s %" PRIu64 " breakpoints",
+                     __FUNCTION__, insert ? "add" : "remove", (uint64_t)stoppoints.size());
+
+    // Keep the packets small enough for the stub, a request is at most
+    // "Z1,<16 hex digits>,<8 hex digits>;" long.
+    const size_t max_request_size = 32;
+    const uint64_t max_packet_size = std::min<uint64_t> (GetRemoteMaxPacketSize(), 64 * 1024);
+
+    size_t idx = 0;
+    while (idx < stoppoints.size())
+    {
+        const size_t first_idx = idx;
+        StreamString packet;
+        packet.PutCString ("jMultiBreakpoint:");
+        for (; idx < stoppoints.size(); ++idx)
+        {
+            if (idx > first_idx && packet.GetSize() + max_request_size > max_packet_size)
+                break;
+            packet.Printf ("%s%c%i,%" PRIx64 ",%x",
+                           idx > first_idx ? ";" : "",
+                           insert ? 'Z' : 'z',
+                           type,
+                           stoppoints[idx].first,
+                           stoppoints[idx].second);
+        }
+
+        StringExtractorGDBRemote response;
+        if (SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), response, true) != PacketResult::Success)
+            return true;
+
+        if (response.IsUnsupportedResponse())
+        {
+            m_supports_multi_breakpoint = eLazyBoolNo;
+            // Nothing was done yet, let the caller fall back to the single
+            // breakpoint packets.
+            return first_idx > 0;
+        }
+
+        // The reply has an "OK" or "Exx" for each request, separated by
+        // commas. Requests without a reply are treated as failed.
+        const std::string &reply = response.GetStringRef();
+        size_t pos = 0;
+        for (size_t i = first_idx; i < idx && pos < reply.size(); ++i)
+        {
+            size_t end = reply.find (',', pos);
+            if (end == std::string::npos)
+                end = reply.size();
+            succeeded[i] = reply.compare (pos, end - pos, "OK") == 0;
+            pos = end + 1;
+        }
+    }
+    return true;
+}
+
 size_t
 GDBRemoteCommunicationClient::GetCurrentThreadIDs (std::vector<lldb::tid_t> &thread_ids, 
                                                    bool &sequence_mutex_unavailable)
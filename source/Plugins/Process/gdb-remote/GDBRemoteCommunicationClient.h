@@ -406,7 +406,28 @@ public:
     SendGDBStoppointTypePacket (GDBStoppointType type,   // Type of breakpoint or watchpoint
                                 bool insert,              // Insert or remove?
                                 lldb::addr_t addr,        // Address of breakpoint or watchpoint
-                                uint32_t length);         // Byte Size of breakpoint or watchpoint
+                                uint32_t length,          // Byte Size of breakpoint or watchpoint
+                                const std::vector<std::vector<uint8_t>> *conditions = nullptr); // Agent expression conditions of the breakpoint
+
+    //------------------------------------------------------------------
+    /// Insert or remove many breakpoints of the same type with as few
+    /// jMultiBreakpoint packets as possible.
+    ///
+    /// @param[in] stoppoints
+    ///     The address and byte size of each breakpoint.
+    ///
+    /// @param[out] succeeded
+    ///     Whether each breakpoint was inserted or removed.
+    ///
+    /// @return
+    ///     False if the stub doesn't support jMultiBreakpoint, nothing
+    ///     was sent and the breakpoints must be handled one at a time.
+    //------------------------------------------------------------------
+    bool
+    SendGDBStoppointTypePackets (GDBStoppointType type,
+                                 bool insert,
+                                 const std::vector<std::pair<lldb::addr_t, uint32_t>> &stoppoints,
+                                 std::vector<bool> &succeeded);
 
     bool
     SetNonStopMode (const bool enable);
@@ -450,6 +471,16 @@ public:
     bool
     GetQXferFeaturesReadSupported ();
 
+    // Whether the stub evaluates agent expression conditions sent with
+    // software breakpoints.
+    bool
+    GetConditionalBreakpointsSupported ();
+
+    // Whether the stub inserts and removes breakpoints in bulk with the
+    // jMultiBreakpoint packet.
+    bool
+    GetMultiBreakpointSupported ();
+
     LazyBool
     SupportsAllocDeallocMemory () // const
     {
@@ -552,6 +583,34 @@ public:
     StructuredData::ObjectSP
     GetThreadsInfo();
 
+    //------------------------------------------------------------------
+    /// Read several memory ranges with a single jMultiMemRead packet.
+    ///
+    /// @param[in] ranges
+    ///     The address and size of each range to read.
+    ///
+    /// @param[out] bytes_read
+    ///     The number of bytes read for each range.
+    ///
+    /// @param[out] data
+    ///     The bytes read for all the ranges, one after the other.
+    ///
+    /// @return
+    ///     False if the stub doesn't support the packet or the reply
+    ///     couldn't be parsed, true otherwise, even if some of the
+    ///     ranges couldn't be read.
+    //------------------------------------------------------------------
+    bool
+    ReadMemoryRanges (const std::vector<std::pair<lldb::addr_t, size_t>> &ranges,
+                      std::vector<size_t> &bytes_read,
+                      std::string &data);
+
+    bool
+    GetMultiMemReadSupported () const
+    {
+        return m_supports_jMultiMemRead;
+    }
+
     bool
     GetThreadExtendedInfoSupported();
 
@@ -602,6 +661,8 @@ protected:
     LazyBool m_supports_qXfer_libraries_svr4_read;
     LazyBool m_supports_qXfer_features_read;
     LazyBool m_supports_augmented_libraries_svr4_read;
+    LazyBool m_supports_conditional_breakpoints;
+    LazyBool m_supports_multi_breakpoint;
     LazyBool m_supports_jThreadExtendedInfo;
     LazyBool m_supports_jLoadedDynamicLibrariesInfos;
 
@@ -621,7 +682,8 @@ protected:
         m_supports_qSymbol:1,
         m_qSymbol_requests_done:1,
         m_supports_qModuleInfo:1,
-        m_supports_jThreadsInfo:1;
+        m_supports_jThreadsInfo:1,
+        m_supports_jMultiMemRead:1;
     
     lldb::pid_t m_curr_pid;
     lldb::tid_t m_curr_tid;         // Current gdb remote protocol thread index for all other operations
@@ -840,9 +840,16 @@ GDBRemoteCommunicationServerCommon::Handle_qSupported (StringExtractorGDBRemote
     response.PutCString (";qXfer:auxv:read+");
 #endif
 
+    AppendSupportedFeatures (response);
+
     return SendPacketNoLock(response.GetData(), response.GetSize());
 }
 
+void
+GDBRemoteCommunicationServerCommon::AppendSupportedFeatures (Stream &response)
+{
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerCommon::Handle_QThreadSuffixSupported (StringExtractorGDBRemote &packet)
 {
@@ -199,6 +199,13 @@ protected:
 
     virtual FileSpec
     FindModuleFile (const std::string& module_path, const ArchSpec& arch);
+
+    //------------------------------------------------------------------
+    /// Append the features specific to this kind of server to the
+    /// qSupported reply, each of them preceded by a ';'.
+    //------------------------------------------------------------------
+    virtual void
+    AppendSupportedFeatures (Stream &response);
 };
 
 } // namespace process_gdb_remote
@@ -16,6 +16,7 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
 #include <cstring>
 #include <chrono>
 #include <thread>
@@ -24,6 +25,7 @@
 #include "llvm/ADT/Triple.h"
 #include "lldb/Interpreter/Args.h"
 #include "lldb/Core/DataBuffer.h"
+#include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/RegisterValue.h"
 #include "lldb/Core/State.h"
@@ -71,6 +73,53 @@ namespace
         eErrorResume,
         eErrorExitStatus
     };
+
+    // Evaluates breakpoint conditions against a stopped thread.
+    class ThreadAgentExpressionContext : public AgentExpression::Context
+    {
+    public:
+        ThreadAgentExpressionContext (NativeProcessProtocol &process, NativeThreadProtocol &thread) :
+            m_process (process),
+            m_thread (thread)
+        {
+        }
+
+        bool
+        ReadRegister (uint32_t reg_num, uint64_t &value) override
+        {
+            NativeRegisterContextSP reg_ctx_sp = m_thread.GetRegisterContext ();
+            if (!reg_ctx_sp)
+                return false;
+            const RegisterInfo *reg_info = reg_ctx_sp->GetRegisterInfoAtIndex (reg_num);
+            if (!reg_info)
+                return false;
+            RegisterValue reg_value;
+            if (reg_ctx_sp->ReadRegister (reg_info, reg_value).Fail ())
+                return false;
+            bool success = false;
+            value = reg_value.GetAsUInt64 (0, &success);
+            return success;
+        }
+
+        bool
+        ReadMemory (lldb::addr_t addr, void *buf, size_t size) override
+        {
+            size_t bytes_read = 0;
+            return m_process.ReadMemoryWithoutTrap (addr, buf, size, bytes_read).Success () && bytes_read == size;
+        }
+
+        lldb::ByteOrder
+        GetByteOrder () override
+        {
+            lldb::ByteOrder byte_order = lldb::eByteOrderInvalid;
+            m_process.GetByteOrder (byte_order);
+            return byte_order;
+        }
+
+    private:
+        NativeProcessProtocol &m_process;
+        NativeThreadProtocol &m_thread;
+    };
 }
 
 //----------------------------------------------------------------------
@@ -92,7 +141,11 @@ GDBRemoteCommunicationServerLLGS::GDBRemoteCommunicationServerLLGS(
     m_saved_registers_mutex (),
     m_saved_registers_map (),
     m_next_saved_registers_id (1),
-    m_handshake_completed (false)
+    m_handshake_completed (false),
+    m_compression_enabled (false),
+    m_breakpoint_conditions (),
+    m_condition_step_over_addrs (),
+    m_last_resume_actions ()
 {
     assert(platform_sp);
     RegisterPacketHandlers();
@@ -145,12 +198,18 @@ GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers()
                                   &GDBRemoteCommunicationServerLLGS::Handle_QSetDisableASLR);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QSetWorkingDir,
                                   &GDBRemoteCommunicationServerLLGS::Handle_QSetWorkingDir);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QEnableCompression,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_QEnableCompression);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qsThreadInfo,
                                   &GDBRemoteCommunicationServerLLGS::Handle_qsThreadInfo);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qThreadStopInfo,
                                   &GDBRemoteCommunicationServerLLGS::Handle_qThreadStopInfo);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_jThreadsInfo,
                                   &GDBRemoteCommunicationServerLLGS::Handle_jThreadsInfo);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_jMultiMemRead,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_jMultiMemRead);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_jMultiBreakpoint,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_jMultiBreakpoint);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qWatchpointSupportInfo,
                                   &GDBRemoteCommunicationServerLLGS::Handle_qWatchpointSupportInfo);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qXfer_auxv_read,
@@ -497,6 +556,62 @@ GetRegistersAsJSON(NativeThreadProtocol &thread, bool abridged)
     return register_object_sp;
 }
 
+// Expedite the frame pointer chain of a thread: the saved frame pointer and return address
+// pointed to by each frame pointer. The client adds these to its memory cache so it can
+// backtrace the top frames of the threads without sending a memory read packet for each.
+// Only a few frames are sent to keep the reply small for processes with many threads.
+static JSONArray::SP
+GetFramePointerChainAsJSON(NativeProcessProtocol &process, NativeThreadProtocol &thread)
+{
+    static const uint32_t k_max_expedited_frames = 8;
+
+    ArchSpec arch;
+    lldb::ByteOrder byte_order;
+    if (!process.GetArchitecture(arch) || !process.GetByteOrder(byte_order))
+        return nullptr;
+
+    const uint32_t addr_size = arch.GetAddressByteSize();
+    if (addr_size != 4 && addr_size != 8)
+        return nullptr;
+
+    NativeRegisterContextSP reg_ctx_sp = thread.GetRegisterContext ();
+    if (! reg_ctx_sp)
+        return nullptr;
+
+    JSONArray::SP memory_array_sp = std::make_shared<JSONArray>();
+    lldb::addr_t fp = reg_ctx_sp->GetFP(0);
+    for (uint32_t i = 0; i < k_max_expedited_frames; ++i)
+    {
+        if (fp == 0 || (fp % addr_size) != 0)
+            break;
+
+        uint8_t frame_bytes[16];
+        const size_t frame_size = addr_size * 2;
+        size_t bytes_read = 0;
+        Error error = process.ReadMemoryWithoutTrap(fp, frame_bytes, frame_size, bytes_read);
+        if (error.Fail() || bytes_read != frame_size)
+            break;
+
+        StreamString bytes;
+        AppendHexValue(bytes, frame_bytes, frame_size, false);
+
+        JSONObject::SP memory_obj_sp = std::make_shared<JSONObject>();
+        memory_obj_sp->SetObject("address", std::make_shared<JSONNumber>(fp));
+        memory_obj_sp->SetObject("bytes", std::make_shared<JSONString>(bytes.GetString()));
+        memory_array_sp->AppendObject(memory_obj_sp);
+
+        // The stack grows down, so the frame pointers of the callers must be increasing.
+        DataExtractor data(frame_bytes, frame_size, byte_order, addr_size);
+        lldb::offset_t offset = 0;
+        const lldb::addr_t caller_fp = data.GetAddress(&offset);
+        if (caller_fp <= fp)
+            break;
+        fp = caller_fp;
+    }
+
+    return memory_array_sp;
+}
+
 static const char *
 GetStopReasonString(StopReason stop_reason)
 {
@@ -592,7 +707,12 @@ GetJSONThreadsInfo(NativeProcessProtocol &process, bool abridged)
             thread_obj_sp->SetObject("medata", medata_array_sp);
         }
 
-        // TODO: Expedite interesting regions of inferior memory
+        if (!abridged)
+        {
+            JSONArray::SP memory_sp = GetFramePointerChainAsJSON(process, *thread_sp);
+            if (memory_sp && memory_sp->GetNumElements() > 0)
+                thread_obj_sp->SetObject("memory", memory_sp);
+        }
     }
 
     return threads_array_sp;
@@ -848,6 +968,163 @@ GDBRemoteCommunicationServerLLGS::HandleInferiorState_Stopped (NativeProcessProt
     }
 }
 
+bool
+GDBRemoteCommunicationServerLLGS::BreakpointConditionIsFalse (NativeProcessProtocol &process,
+                                                              NativeThreadProtocol &thread,
+                                                              lldb::addr_t addr)
+{
+    auto pos = m_breakpoint_conditions.find (addr);
+    if (pos == m_breakpoint_conditions.end () || pos->second.empty ())
+        return false;
+
+    // The breakpoint stops if any of its conditions is true or can't be
+    // evaluated, the client then evaluates the condition itself.
+    ThreadAgentExpressionContext context (process, thread);
+    for (const AgentExpression &condition : pos->second)
+    {
+        uint64_t result = 0;
+        if (!condition.Evaluate (context, result) || result != 0)
+            return false;
+    }
+    return true;
+}
+
+bool
+GDBRemoteCommunicationServerLLGS::ResumeIfBreakpointConditionsAreFalse (NativeProcessProtocol *process)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS|LIBLLDB_LOG_BREAKPOINTS));
+
+    if (!m_condition_step_over_addrs.empty ())
+        return ResumeAfterConditionStepOver (process);
+
+    // Only stops of a continue requested by the client are candidates, the
+    // client expects to see every stop of a step.
+    if (m_inferior_prev_state != eStateRunning || m_breakpoint_conditions.empty () ||
+        m_last_resume_actions.NumActionsWithState (eStateStepping) > 0)
+        return false;
+
+    // Every thread must either not have stopped for a reason or be stopped
+    // at a breakpoint whose conditions are all false.
+    ResumeActionList step_actions;
+    std::vector<lldb::addr_t> addrs;
+    NativeThreadProtocolSP thread_sp;
+    for (uint32_t i = 0; (thread_sp = process->GetThreadAtIndex (i)); ++i)
+    {
+        ThreadStopInfo stop_info;
+        std::string description;
+        if (!thread_sp->GetStopReason (stop_info, description))
+            return false;
+        if (stop_info.reason == eStopReasonNone)
+            continue;
+        if (stop_info.reason != eStopReasonBreakpoint)
+            return false;
+
+        NativeRegisterContextSP reg_ctx_sp = thread_sp->GetRegisterContext ();
+        if (!reg_ctx_sp)
+            return false;
+        const lldb::addr_t pc = reg_ctx_sp->GetPC ();
+        if (!BreakpointConditionIsFalse (*process, *thread_sp, pc))
+            return false;
+
+        step_actions.AppendAction (thread_sp->GetID (), eStateStepping);
+        if (std::find (addrs.begin (), addrs.end (), pc) == addrs.end ())
+            addrs.push_back (pc);
+    }
+    if (step_actions.IsEmpty ())
+        return false;
+
+    // Step the threads over their breakpoints with the breakpoints disabled,
+    // the other threads stay stopped. The breakpoints are enabled again and
+    // the process resumed by ResumeAfterConditionStepOver().
+    for (lldb::addr_t addr : addrs)
+    {
+        const Error error = process->DisableBreakpoint (addr);
+        if (error.Fail ())
+        {
+            if (log)
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to disable breakpoint at 0x%" PRIx64 ": %s",
+                             __FUNCTION__, addr, error.AsCString ());
+            for (lldb::addr_t disabled_addr : m_condition_step_over_addrs)
+                process->EnableBreakpoint (disabled_addr);
+            m_condition_step_over_addrs.clear ();
+            return false;
+        }
+        m_condition_step_over_addrs.push_back (addr);
+    }
+
+    if (log)
+        log->Printf ("GDBRemoteCommunicationServerLLGS::%s breakpoint conditions are false, stepping %zu threads over %zu breakpoints",
+                     __FUNCTION__, step_actions.GetSize (), addrs.size ());
+
+    const Error error = process->Resume (step_actions);
+    if (error.Fail ())
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to step over breakpoints: %s",
+                         __FUNCTION__, error.AsCString ());
+        for (lldb::addr_t addr : m_condition_step_over_addrs)
+            process->EnableBreakpoint (addr);
+        m_condition_step_over_addrs.clear ();
+        return false;
+    }
+    return true;
+}
+
+bool
+GDBRemoteCommunicationServerLLGS::ResumeAfterConditionStepOver (NativeProcessProtocol *process)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS|LIBLLDB_LOG_BREAKPOINTS));
+
+    // Put back the breakpoints the client didn't remove in the meantime.
+    for (lldb::addr_t addr : m_condition_step_over_addrs)
+    {
+        if (m_breakpoint_conditions.count (addr))
+            process->EnableBreakpoint (addr);
+    }
+    m_condition_step_over_addrs.clear ();
+
+    // Report anything else than the end of the steps, like a signal or a
+    // watchpoint hit by the stepped instruction.
+    NativeThreadProtocolSP thread_sp;
+    for (uint32_t i = 0; (thread_sp = process->GetThreadAtIndex (i)); ++i)
+    {
+        ThreadStopInfo stop_info;
+        std::string description;
+        if (!thread_sp->GetStopReason (stop_info, description))
+            return false;
+        if (stop_info.reason != eStopReasonNone && stop_info.reason != eStopReasonTrace)
+            return false;
+    }
+
+    // Resume like the client asked, the signals were already delivered.
+    ResumeActionList actions;
+    for (size_t i = 0; i < m_last_resume_actions.GetSize (); ++i)
+    {
+        ResumeAction action = m_last_resume_actions.GetFirst ()[i];
+        action.signal = 0;
+        actions.Append (action);
+    }
+
+    const Error error = process->Resume (actions);
+    if (error.Fail ())
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to resume after stepping over breakpoints: %s",
+                         __FUNCTION__, error.AsCString ());
+        return false;
+    }
+    return true;
+}
+
+Error
+GDBRemoteCommunicationServerLLGS::ResumeProcess (const ResumeActionList &actions)
+{
+    // Remember the actions to resume the same way after stepping over a
+    // breakpoint whose conditions are false.
+    m_last_resume_actions = actions;
+    return m_debugged_process_sp->Resume (actions);
+}
+
 void
 GDBRemoteCommunicationServerLLGS::ProcessStateChanged (NativeProcessProtocol *process, lldb::StateType state)
 {
@@ -875,6 +1152,10 @@ GDBRemoteCommunicationServerLLGS::ProcessStateChanged (NativeProcessProtocol *pr
         // Then stop the forwarding, so that any late output (see llvm.org/pr25652) does not
         // interfere with our protocol.
         StopSTDIOForwarding();
+        // Don't report stops at breakpoints whose conditions are false, the
+        // nested running state change already updated the previous state.
+        if (ResumeIfBreakpointConditionsAreFalse (process))
+            return;
         HandleInferiorState_Stopped (process);
         break;
 
@@ -1150,6 +1431,61 @@ GDBRemoteCommunicationServerLLGS::Handle_QSetWorkingDir (StringExtractorGDBRemot
     return SendOKResponse ();
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_QEnableCompression (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS));
+
+    // Behave like a server without compression support unless it was
+    // enabled at launch.
+    if (!m_compression_enabled)
+        return SendUnimplementedResponse (packet.GetStringRef().c_str());
+
+    // Parse out type:<name>;[minsize:<decimal>;]
+    packet.SetFilePos (::strlen ("QEnableCompression:"));
+    CompressionType type = CompressionType::None;
+    std::string type_name;
+    size_t min_size = 384;
+
+    std::string name;
+    std::string value;
+    while (packet.GetNameColonValue (name, value))
+    {
+        if (name == "type")
+        {
+            type_name = value;
+#if defined (HAVE_LIBZ)
+            if (value == "zlib-deflate")
+                type = CompressionType::ZlibDeflate;
+#endif
+#if defined (HAVE_LIBLZ4)
+            if (value == "lz4")
+                type = CompressionType::LZ4;
+#endif
+        }
+        else if (name == "minsize")
+        {
+            min_size = StringConvert::ToUInt64 (value.c_str (), min_size, 10);
+        }
+    }
+
+    if (type_name.empty ())
+        return SendIllFormedResponse (packet, "QEnableCompression missing type");
+
+    if (type == CompressionType::None)
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s unsupported compression type %s", __FUNCTION__, type_name.c_str ());
+        return SendErrorResponse (0x88);
+    }
+
+    // The reply to this packet is sent uncompressed, compression starts with
+    // the next packet we send.
+    PacketResult result = SendOKResponse ();
+    SetSendCompression (type, min_size);
+    return result;
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_qGetWorkingDir (StringExtractorGDBRemote &packet)
 {
@@ -1235,7 +1571,7 @@ GDBRemoteCommunicationServerLLGS::Handle_C (StringExtractorGDBRemote &packet)
     }
 
     // Resume the threads.
-    error = m_debugged_process_sp->Resume (resume_actions);
+    error = ResumeProcess (resume_actions);
     if (error.Fail ())
     {
         if (log)
@@ -1280,7 +1616,7 @@ GDBRemoteCommunicationServerLLGS::Handle_c (StringExtractorGDBRemote &packet)
     // Build the ResumeActionList
     ResumeActionList actions (StateType::eStateRunning, 0);
 
-    Error error = m_debugged_process_sp->Resume (actions);
+    Error error = ResumeProcess (actions);
     if (error.Fail ())
     {
         if (log)
@@ -1404,7 +1740,7 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont (StringExtractorGDBRemote &packet
         thread_actions.Append (thread_action);
     }
 
-    Error error = m_debugged_process_sp->Resume (thread_actions);
+    Error error = ResumeProcess (thread_actions);
     if (error.Fail ())
     {
         if (log)
@@ -2067,6 +2403,78 @@ GDBRemoteCommunicationServerLLGS::Handle_memory_read(StringExtractorGDBRemote &p
     return SendPacketNoLock(response.GetData(), response.GetSize());
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_jMultiMemRead (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no process available", __FUNCTION__);
+        return SendErrorResponse (0x15);
+    }
+
+    // The packet is a list of address/length pairs:
+    // jMultiMemRead:<addr>,<length>[;<addr>,<length>]...
+    packet.SetFilePos (strlen("jMultiMemRead:"));
+    if (packet.GetBytesLeft() < 1)
+        return SendIllFormedResponse(packet, "No ranges in jMultiMemRead packet");
+
+    // Don't let a garbled packet make us allocate unbounded amounts of memory.
+    const uint64_t max_total_byte_count = 16 * 1024 * 1024;
+    std::vector<std::pair<lldb::addr_t, uint64_t>> ranges;
+    uint64_t total_byte_count = 0;
+    while (packet.GetBytesLeft() > 0)
+    {
+        if (!ranges.empty() && packet.GetChar() != ';')
+            return SendIllFormedResponse(packet, "Range separator missing in jMultiMemRead packet");
+
+        const lldb::addr_t read_addr = packet.GetHexMaxU64(false, LLDB_INVALID_ADDRESS);
+        if (read_addr == LLDB_INVALID_ADDRESS || (packet.GetBytesLeft() < 1) || (packet.GetChar() != ','))
+            return SendIllFormedResponse(packet, "Invalid address in jMultiMemRead packet");
+
+        const uint64_t byte_count = packet.GetHexMaxU64(false, UINT64_MAX);
+        if (byte_count == UINT64_MAX)
+            return SendIllFormedResponse(packet, "Invalid length in jMultiMemRead packet");
+
+        total_byte_count += byte_count;
+        if (total_byte_count > max_total_byte_count)
+            return SendErrorResponse (0x78);
+
+        ranges.push_back(std::make_pair(read_addr, byte_count));
+    }
+
+    // Read all the ranges at once, a range that fails doesn't fail the
+    // whole packet.
+    std::string buf(total_byte_count, '\0');
+    std::vector<NativeProcessProtocol::MemoryRangeRead> reads(ranges.size());
+    size_t buf_offset = 0;
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+        reads[i].addr = ranges[i].first;
+        reads[i].buf = &buf[buf_offset];
+        reads[i].size = ranges[i].second;
+        reads[i].bytes_read = 0;
+        buf_offset += ranges[i].second;
+    }
+
+    Error error = m_debugged_process_sp->ReadMemoryRangesWithoutTrap(reads);
+    if (error.Fail () && log)
+        log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 ": failed to read memory. Error: %s", __FUNCTION__, m_debugged_process_sp->GetID (), error.AsCString ());
+
+    // The reply lists the number of bytes read for each range followed by
+    // the bytes of all the ranges: <count>[,<count>]...;<binary data>
+    StreamGDBRemote response;
+    for (size_t i = 0; i < reads.size(); ++i)
+        response.Printf("%s%" PRIx64, i > 0 ? "," : "", (uint64_t)reads[i].bytes_read);
+    response.PutChar(';');
+    for (const auto &read : reads)
+        response.PutEscapedBytes(read.buf, read.bytes_read);
+
+    return SendPacketNoLock(response.GetData(), response.GetSize());
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_M (StringExtractorGDBRemote &packet)
 {
@@ -2293,12 +2701,50 @@ GDBRemoteCommunicationServerLLGS::Handle_Z (StringExtractorGDBRemote &packet)
     if (size == std::numeric_limits<uint32_t>::max ())
         return SendIllFormedResponse(packet, "Malformed Z packet, failed to parse size argument");
 
+    // Parse out the optional breakpoint conditions, each one is an agent
+    // expression: ;X{length},{expression bytes}.
+    std::vector<AgentExpression> conditions;
+    while (packet.GetBytesLeft () && *packet.Peek () == ';')
+    {
+        packet.GetChar ();
+        if (packet.GetBytesLeft () < 1 || packet.GetChar () != 'X')
+            return SendIllFormedResponse(packet, "Malformed Z packet, unsupported breakpoint condition");
+
+        const uint32_t length = packet.GetHexMaxU32 (false, 0);
+        if (length == 0 || (packet.GetBytesLeft() < 1) || packet.GetChar () != ',')
+            return SendIllFormedResponse(packet, "Malformed Z packet, failed to parse condition length");
+
+        std::vector<uint8_t> bytes (length);
+        if (packet.GetHexBytes (bytes.data (), length, 0) != length)
+            return SendIllFormedResponse(packet, "Malformed Z packet, failed to parse condition expression");
+        conditions.push_back (AgentExpression (bytes.data (), length));
+    }
+
+    // Conditions are only evaluated for software breakpoints.
+    if (!conditions.empty () && stoppoint_type != eBreakpointSoftware)
+        return SendUnimplementedResponse (packet.GetStringRef().c_str());
+
     if (want_breakpoint)
     {
+        // Setting a software breakpoint again only replaces its conditions.
+        if (stoppoint_type == eBreakpointSoftware)
+        {
+            auto pos = m_breakpoint_conditions.find (addr);
+            if (pos != m_breakpoint_conditions.end ())
+            {
+                pos->second = std::move (conditions);
+                return SendOKResponse ();
+            }
+        }
+
         // Try to set the breakpoint.
         const Error error = m_debugged_process_sp->SetBreakpoint (addr, size, want_hardware);
         if (error.Success ())
+        {
+            if (stoppoint_type == eBreakpointSoftware)
+                m_breakpoint_conditions[addr] = std::move (conditions);
             return SendOKResponse ();
+        }
         Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
         if (log)
             log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64
@@ -2326,6 +2772,132 @@ GDBRemoteCommunicationServerLLGS::Handle_Z (StringExtractorGDBRemote &packet)
     }
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_jMultiBreakpoint (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
+
+    // Ensure we have a process.
+    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no process available", __FUNCTION__);
+        return SendErrorResponse (0x15);
+    }
+
+    // The packet is a list of breakpoint insertions and removals, in the
+    // format of the Z and z packets without conditions:
+    // jMultiBreakpoint:<Z|z><type>,<addr>,<kind>[;<Z|z><type>,<addr>,<kind>]...
+    struct Request
+    {
+        bool insert;
+        GDBStoppointType type;
+        lldb::addr_t addr;
+        uint32_t kind;
+    };
+    std::vector<Request> requests;
+
+    packet.SetFilePos (strlen("jMultiBreakpoint:"));
+    if (packet.GetBytesLeft() < 1)
+        return SendIllFormedResponse(packet, "No breakpoints in jMultiBreakpoint packet");
+
+    while (packet.GetBytesLeft() > 0)
+    {
+        if (!requests.empty() && packet.GetChar() != ';')
+            return SendIllFormedResponse(packet, "Breakpoint separator missing in jMultiBreakpoint packet");
+
+        Request request;
+        const char op = packet.GetChar();
+        if (op != 'Z' && op != 'z')
+            return SendIllFormedResponse(packet, "Expected Z or z in jMultiBreakpoint packet");
+        request.insert = op == 'Z';
+
+        request.type = GDBStoppointType(packet.GetS32 (eStoppointInvalid));
+        if (request.type != eBreakpointSoftware && request.type != eBreakpointHardware)
+            return SendIllFormedResponse(packet, "jMultiBreakpoint packet only supports breakpoints");
+
+        if ((packet.GetBytesLeft() < 1) || packet.GetChar () != ',')
+            return SendIllFormedResponse(packet, "Malformed jMultiBreakpoint packet, expecting comma after stoppoint type");
+        request.addr = packet.GetHexMaxU64(false, LLDB_INVALID_ADDRESS);
+        if (request.addr == LLDB_INVALID_ADDRESS || (packet.GetBytesLeft() < 1) || packet.GetChar () != ',')
+            return SendIllFormedResponse(packet, "Malformed jMultiBreakpoint packet, failed to parse address");
+        request.kind = packet.GetHexMaxU32 (false, std::numeric_limits<uint32_t>::max ());
+        if (request.kind == std::numeric_limits<uint32_t>::max ())
+            return SendIllFormedResponse(packet, "Malformed jMultiBreakpoint packet, failed to parse size argument");
+
+        requests.push_back (request);
+    }
+
+    // Apply the requests in order, runs of consecutive requests of the same
+    // kind go to the process together.
+    std::vector<Error> errors (requests.size ());
+    size_t run_start = 0;
+    while (run_start < requests.size ())
+    {
+        const Request &first = requests[run_start];
+        size_t run_end = run_start + 1;
+        while (run_end < requests.size () && requests[run_end].insert == first.insert &&
+               requests[run_end].type == first.type && requests[run_end].kind == first.kind)
+            ++run_end;
+
+        // Like the Z and z packets, a software breakpoint is only set once
+        // by the client, setting it again clears its conditions.
+        std::vector<size_t> indexes;
+        std::vector<lldb::addr_t> addrs;
+        for (size_t i = run_start; i < run_end; ++i)
+        {
+            const lldb::addr_t addr = requests[i].addr;
+            if (first.type == eBreakpointSoftware)
+            {
+                auto pos = m_breakpoint_conditions.find (addr);
+                if (first.insert && pos != m_breakpoint_conditions.end ())
+                {
+                    pos->second.clear ();
+                    continue;
+                }
+                if (!first.insert && pos != m_breakpoint_conditions.end ())
+                    m_breakpoint_conditions.erase (pos);
+            }
+            indexes.push_back (i);
+            addrs.push_back (addr);
+        }
+
+        std::vector<Error> run_errors;
+        if (first.insert)
+            m_debugged_process_sp->SetBreakpoints (addrs, first.kind, first.type == eBreakpointHardware, run_errors);
+        else
+            m_debugged_process_sp->RemoveBreakpoints (addrs, run_errors);
+
+        for (size_t i = 0; i < indexes.size (); ++i)
+        {
+            errors[indexes[i]] = run_errors[i];
+            if (first.insert && first.type == eBreakpointSoftware && run_errors[i].Success ())
+                m_breakpoint_conditions[addrs[i]];
+        }
+        run_start = run_end;
+    }
+
+    // The reply has the result of each request in order: OK or an error.
+    StreamGDBRemote response;
+    for (size_t i = 0; i < errors.size (); ++i)
+    {
+        if (i > 0)
+            response.PutChar (',');
+        if (errors[i].Success ())
+            response.PutCString ("OK");
+        else
+        {
+            if (log)
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 " failed to %s breakpoint at 0x%" PRIx64 ": %s",
+                        __FUNCTION__, m_debugged_process_sp->GetID (), requests[i].insert ? "set" : "remove",
+                        requests[i].addr, errors[i].AsCString ());
+            response.PutCString ("E09");
+        }
+    }
+
+    return SendPacketNoLock(response.GetData(), response.GetSize());
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_z (StringExtractorGDBRemote &packet)
 {
@@ -2380,6 +2952,8 @@ GDBRemoteCommunicationServerLLGS::Handle_z (StringExtractorGDBRemote &packet)
     if (want_breakpoint)
     {
         // Try to clear the breakpoint.
+        if (stoppoint_type == eBreakpointSoftware)
+            m_breakpoint_conditions.erase (addr);
         const Error error = m_debugged_process_sp->RemoveBreakpoint (addr);
         if (error.Success ())
             return SendOKResponse ();
@@ -2445,7 +3019,7 @@ GDBRemoteCommunicationServerLLGS::Handle_s (StringExtractorGDBRemote &packet)
 
     // All other threads stop while we're single stepping a thread.
     actions.SetDefaultThreadActionIfNeeded(eStateStopped, 0);
-    Error error = m_debugged_process_sp->Resume (actions);
+    Error error = ResumeProcess (actions);
     if (error.Fail ())
     {
         if (log)
@@ -2967,6 +3541,10 @@ GDBRemoteCommunicationServerLLGS::ClearProcessSpecificData ()
                      m_active_auxv_buffer_sp ? "was set" : "was not set");
     m_active_auxv_buffer_sp.reset ();
 #endif
+
+    // The breakpoints are gone with the old process image.
+    m_breakpoint_conditions.clear ();
+    m_condition_step_over_addrs.clear ();
 }
 
 FileSpec
@@ -2985,3 +3563,24 @@ GDBRemoteCommunicationServerLLGS::FindModuleFile(const std::string& module_path,
 
     return GDBRemoteCommunicationServerCommon::FindModuleFile(module_path, arch);
 }
+
+void
+GDBRemoteCommunicationServerLLGS::AppendSupportedFeatures (Stream &response)
+{
+    const char *compressions = nullptr;
+#if defined (HAVE_LIBZ) && defined (HAVE_LIBLZ4)
+    compressions = "zlib-deflate,lz4";
+#elif defined (HAVE_LIBZ)
+    compressions = "zlib-deflate";
+#elif defined (HAVE_LIBLZ4)
+    compressions = "lz4";
+#endif
+    if (compressions && m_compression_enabled)
+        response.Printf (";SupportedCompressions=%s;DefaultCompressionMinSize=384", compressions);
+
+    // Software breakpoints accept agent expression conditions.
+    response.PutCString (";ConditionalBreakpoints+");
+
+    // Breakpoints can be set and removed in bulk.
+    response.PutCString (";jMultiBreakpoint+");
+}
@@ -12,16 +12,20 @@
 
 // C Includes
 // C++ Includes
+#include <map>
 #include <unordered_map>
+#include <vector>
 
 // Other libraries and framework includes
 #include "lldb/lldb-private-forward.h"
 #include "lldb/Core/Communication.h"
+#include "lldb/Host/Debug.h"
 #include "lldb/Host/Mutex.h"
 #include "lldb/Host/common/NativeProcessProtocol.h"
 #include "lldb/Host/MainLoop.h"
 
 // Project includes
+#include "AgentExpression.h"
 #include "GDBRemoteCommunicationServerCommon.h"
 
 class StringExtractorGDBRemote;
@@ -98,6 +102,19 @@ public:
     Error
     AttachToProcess (lldb::pid_t pid);
 
+    //------------------------------------------------------------------
+    /// Allow the client to enable packet compression.
+    ///
+    /// Compression is off unless lldb-server is launched with
+    /// --enable-compression, it only pays off on slow connections and
+    /// costs CPU time on both ends otherwise.
+    //------------------------------------------------------------------
+    void
+    SetCompressionEnabled (bool enabled)
+    {
+        m_compression_enabled = enabled;
+    }
+
     //------------------------------------------------------------------
     // NativeProcessProtocol::NativeDelegate overrides
     //------------------------------------------------------------------
@@ -131,6 +148,16 @@ protected:
     std::unordered_map<uint32_t, lldb::DataBufferSP> m_saved_registers_map;
     uint32_t m_next_saved_registers_id;
     bool m_handshake_completed : 1;
+    bool m_compression_enabled : 1;
+
+    // The conditions of the software breakpoints set with "Z0" packets, a
+    // breakpoint without conditions always stops.
+    std::map<lldb::addr_t, std::vector<AgentExpression>> m_breakpoint_conditions;
+    // The breakpoints disabled to step over them after their conditions
+    // were false.
+    std::vector<lldb::addr_t> m_condition_step_over_addrs;
+    // The actions of the last resume requested by the client.
+    ResumeActionList m_last_resume_actions;
 
     PacketResult
     SendONotification (const char *buffer, uint32_t len);
@@ -159,6 +186,11 @@ protected:
     PacketResult
     Handle_QSetWorkingDir (StringExtractorGDBRemote &packet);
 
+    // Handles $QEnableCompression, compressing the packets we send from
+    // then on.
+    PacketResult
+    Handle_QEnableCompression (StringExtractorGDBRemote &packet);
+
     PacketResult
     Handle_qGetWorkingDir (StringExtractorGDBRemote &packet);
 
@@ -205,6 +237,10 @@ protected:
     PacketResult
     Handle_memory_read (StringExtractorGDBRemote &packet);
 
+    // Handles $jMultiMemRead packets, reading several memory ranges at once.
+    PacketResult
+    Handle_jMultiMemRead (StringExtractorGDBRemote &packet);
+
     PacketResult
     Handle_M (StringExtractorGDBRemote &packet);
 
@@ -220,6 +256,11 @@ protected:
     PacketResult
     Handle_z (StringExtractorGDBRemote &packet);
 
+    // Handles $jMultiBreakpoint packets, setting and removing several
+    // breakpoints at once.
+    PacketResult
+    Handle_jMultiBreakpoint (StringExtractorGDBRemote &packet);
+
     PacketResult
     Handle_s (StringExtractorGDBRemote &packet);
 
@@ -268,6 +309,9 @@ protected:
     FileSpec
     FindModuleFile (const std::string& module_path, const ArchSpec& arch) override;
 
+    void
+    AppendSupportedFeatures (Stream &response) override;
+
 private:
     void
     HandleInferiorState_Exited (NativeProcessProtocol *process);
@@ -275,6 +319,18 @@ private:
     void
     HandleInferiorState_Stopped (NativeProcessProtocol *process);
 
+    bool
+    ResumeIfBreakpointConditionsAreFalse (NativeProcessProtocol *process);
+
+    bool
+    ResumeAfterConditionStepOver (NativeProcessProtocol *process);
+
+    bool
+    BreakpointConditionIsFalse (NativeProcessProtocol &process, NativeThreadProtocol &thread, lldb::addr_t addr);
+
+    Error
+    ResumeProcess (const ResumeActionList &actions);
+
     NativeThreadProtocolSP
     GetThreadFromSuffix (StringExtractorGDBRemote &packet);
 
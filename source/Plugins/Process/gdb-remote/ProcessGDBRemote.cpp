@@ -25,6 +25,9 @@
 #include <map>
 #include <mutex>
 
+#include "lldb/Breakpoint/Breakpoint.h"
+#include "lldb/Breakpoint/BreakpointLocation.h"
+#include "lldb/Breakpoint/BreakpointSite.h"
 #include "lldb/Breakpoint/Watchpoint.h"
 #include "lldb/Interpreter/Args.h"
 #include "lldb/Core/ArchSpec.h"
@@ -72,6 +75,7 @@
 #include "Plugins/Process/Utility/StopInfoMachException.h"
 #include "Plugins/Platform/MacOSX/PlatformRemoteiOS.h"
 #include "Utility/StringExtractorGDBRemote.h"
+#include "AgentExpressionCompiler.h"
 #include "GDBRemoteRegisterContext.h"
 #include "ProcessGDBRemote.h"
 #include "ProcessGDBRemoteLog.h"
@@ -107,13 +111,15 @@ namespace {
     {
         { "packet-timeout" , OptionValue::eTypeUInt64 , true , 1, NULL, NULL, "Specify the default packet timeout in seconds." },
         { "target-definition-file" , OptionValue::eTypeFileSpec , true, 0 , NULL, NULL, "The file that provides the description for remote target registers." },
+        { "use-remote-breakpoint-conditions" , OptionValue::eTypeBoolean , true, false, NULL, NULL, "If true, simple breakpoint conditions are sent to stubs that can evaluate them, so breakpoints whose condition is false don't stop the process." },
         {  NULL            , OptionValue::eTypeInvalid, false, 0, NULL, NULL, NULL  }
     };
 
     enum
     {
         ePropertyPacketTimeout,
-        ePropertyTargetDefinitionFile
+        ePropertyTargetDefinitionFile,
+        ePropertyUseRemoteBreakpointConditions
     };
 
     class PluginProperties : public Properties
@@ -158,6 +164,13 @@ namespace {
             const uint32_t idx = ePropertyTargetDefinitionFile;
             return m_collection_sp->GetPropertyAtIndexAsFileSpec (NULL, idx);
         }
+
+        bool
+        GetUseRemoteBreakpointConditions () const
+        {
+            const uint32_t idx = ePropertyUseRemoteBreakpointConditions;
+            return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
+        }
     };
 
     typedef std::shared_ptr<PluginProperties> ProcessKDPPropertiesSP;
@@ -3095,6 +3108,56 @@ ProcessGDBRemote::DoReadMemory (addr_t addr, void *buf, size_t size, Error &erro
     return 0;
 }
 
+void
+ProcessGDBRemote::DoReadMemoryRanges (MemoryRangeReads &reads)
+{
+    if (!m_gdb_comm.GetMultiMemReadSupported())
+        return;
+
+    GetMaxMemorySize ();
+
+    // Keep each reply within the memory transfer size and each request
+    // within a reasonable packet size. Ranges too big to fit in a reply
+    // are left for Process::ReadMemoryRanges() to read on their own.
+    const size_t max_ranges_per_packet = 256;
+    std::vector<std::pair<addr_t, size_t>> ranges;
+    std::vector<size_t> range_indexes;
+    uint64_t batch_byte_size = 0;
+    for (size_t i = 0; i <= reads.size(); ++i)
+    {
+        const bool last = i == reads.size();
+        if (!ranges.empty() &&
+            (last || ranges.size() == max_ranges_per_packet || batch_byte_size + reads[i].size > m_max_memory_size))
+        {
+            std::vector<size_t> bytes_read;
+            std::string data;
+            if (!m_gdb_comm.ReadMemoryRanges (ranges, bytes_read, data))
+                return;
+
+            size_t data_offset = 0;
+            for (size_t j = 0; j < range_indexes.size(); ++j)
+            {
+                MemoryRangeRead &read = reads[range_indexes[j]];
+                memcpy (read.buf, data.data() + data_offset, bytes_read[j]);
+                read.bytes_read = bytes_read[j];
+                data_offset += bytes_read[j];
+            }
+
+            ranges.clear();
+            range_indexes.clear();
+            batch_byte_size = 0;
+        }
+
+        if (last)
+            break;
+        if (reads[i].size > m_max_memory_size)
+            continue;
+        ranges.push_back (std::make_pair (reads[i].addr, reads[i].size));
+        range_indexes.push_back (i);
+        batch_byte_size += reads[i].size;
+    }
+}
+
 size_t
 ProcessGDBRemote::DoWriteMemory (addr_t addr, const void *buf, size_t size, Error &error)
 {
@@ -3289,8 +3352,12 @@ ProcessGDBRemote::EnableBreakpointSite (BreakpointSite *bp_site)
     // skip over software breakpoints.
     if (m_gdb_comm.SupportsGDBStoppointPacket(eBreakpointSoftware) && (!bp_site->HardwareRequired()))
     {
+        // Have the stub evaluate the conditions of the breakpoint when it can.
+        std::vector<std::vector<uint8_t>> conditions;
+        GetBreakpointSiteConditions (bp_site, conditions);
+
         // Try to send off a software breakpoint packet ($Z0)
-        if (m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, true, addr, bp_op_size) == 0)
+        if (m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, true, addr, bp_op_size, &conditions) == 0)
         {
             // The breakpoint was placed successfully
             bp_site->SetEnabled(true);
@@ -3358,6 +3425,80 @@ ProcessGDBRemote::EnableBreakpointSite (BreakpointSite *bp_site)
     return EnableSoftwareBreakpoint(bp_site);
 }
 
+void
+ProcessGDBRemote::UpdateBreakpointSiteConditions (BreakpointSite *bp_site)
+{
+    // Only the breakpoints set with a "Z0" packet have conditions.
+    if (!bp_site->IsEnabled() || bp_site->GetType() != BreakpointSite::eExternal ||
+        !m_gdb_comm.GetConditionalBreakpointsSupported())
+        return;
+
+    // Setting the breakpoint again replaces its conditions.
+    std::vector<std::vector<uint8_t>> conditions;
+    GetBreakpointSiteConditions (bp_site, conditions);
+    const size_t bp_op_size = GetSoftwareBreakpointTrapOpcode(bp_site);
+    if (m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, true, bp_site->GetLoadAddress(), bp_op_size, &conditions) != 0)
+    {
+        Log *log(ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_BREAKPOINTS));
+        if (log)
+            log->Printf("ProcessGDBRemote::UpdateBreakpointSiteConditions (site_id = %" PRIu64 ") address = 0x%" PRIx64 " -- failed",
+                        bp_site->GetID(), bp_site->GetLoadAddress());
+    }
+}
+
+bool
+ProcessGDBRemote::GetBreakpointSiteConditions (BreakpointSite *bp_site, std::vector<std::vector<uint8_t>> &conditions)
+{
+    conditions.clear();
+    if (!GetGlobalPluginProperties()->GetUseRemoteBreakpointConditions() ||
+        !m_gdb_comm.GetConditionalBreakpointsSupported())
+        return false;
+
+    // The stub stops when any of the conditions is true, so every owner of
+    // the site needs a condition that compiles. Otherwise the stub stops
+    // every time and lldb evaluates the conditions like it always did.
+    Log *log(ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_BREAKPOINTS));
+    AgentExpressionCompiler compiler (GetTarget(), m_register_info);
+    const size_t num_owners = bp_site->GetNumberOfOwners();
+    for (size_t i = 0; i < num_owners; ++i)
+    {
+        BreakpointLocationSP location_sp = bp_site->GetOwnerAtIndex(i);
+        const char *condition = location_sp ? location_sp->GetConditionText() : nullptr;
+        if (condition == nullptr || condition[0] == '\0')
+        {
+            conditions.clear();
+            return false;
+        }
+
+        // lldb counts every hit against the ignore count before it looks at
+        // the condition, so the stub can't skip any hits until the ignore
+        // count is used up. The conditions are sent again when it drops to
+        // zero.
+        if (location_sp->GetIgnoreCount() != 0 || location_sp->GetBreakpoint().GetIgnoreCount() != 0)
+        {
+            if (log)
+                log->Printf("ProcessGDBRemote::%s condition \"%s\" of breakpoint %d.%d is evaluated by lldb: ignore count is not zero",
+                            __FUNCTION__, condition, location_sp->GetBreakpoint().GetID(), location_sp->GetID());
+            conditions.clear();
+            return false;
+        }
+
+        AgentExpression expression;
+        Error error;
+        if (!compiler.Compile (condition, location_sp->GetAddress(), expression, error))
+        {
+            if (log)
+                log->Printf("ProcessGDBRemote::%s condition \"%s\" of breakpoint %d.%d is evaluated by lldb: %s",
+                            __FUNCTION__, condition, location_sp->GetBreakpoint().GetID(), location_sp->GetID(),
+                            error.AsCString());
+            conditions.clear();
+            return false;
+        }
+        conditions.push_back (expression.GetBytes());
+    }
+    return !conditions.empty();
+}
+
 Error
 ProcessGDBRemote::DisableBreakpointSite (BreakpointSite *bp_site)
 {
@@ -3413,6 +3554,99 @@ ProcessGDBRemote::DisableBreakpointSite (BreakpointSite *bp_site)
     return error;
 }
 
+void
+ProcessGDBRemote::EnableBreakpointSites (const std::vector<BreakpointSite *> &bp_sites, std::vector<Error> &errors)
+{
+    errors.assign (bp_sites.size(), Error());
+
+    // Plain software breakpoints are sent to the stub together, the ones
+    // with conditions or special needs take the usual path.
+    const bool use_multi_breakpoint = m_gdb_comm.GetMultiBreakpointSupported() &&
+                                      m_gdb_comm.SupportsGDBStoppointPacket(eBreakpointSoftware);
+    std::vector<size_t> batch_indexes;
+    std::vector<std::pair<addr_t, uint32_t>> stoppoints;
+    for (size_t i = 0; i < bp_sites.size(); ++i)
+    {
+        BreakpointSite *bp_site = bp_sites[i];
+        std::vector<std::vector<uint8_t>> conditions;
+        if (!use_multi_breakpoint || bp_site->IsEnabled() || bp_site->HardwareRequired() ||
+            GetBreakpointSiteConditions (bp_site, conditions))
+        {
+            errors[i] = EnableBreakpointSite (bp_site);
+            continue;
+        }
+        batch_indexes.push_back (i);
+        stoppoints.push_back (std::make_pair (bp_site->GetLoadAddress(), (uint32_t)GetSoftwareBreakpointTrapOpcode (bp_site)));
+    }
+    if (batch_indexes.empty())
+        return;
+
+    std::vector<bool> succeeded;
+    const bool sent = m_gdb_comm.SendGDBStoppointTypePackets (eBreakpointSoftware, true, stoppoints, succeeded);
+    for (size_t i = 0; i < batch_indexes.size(); ++i)
+    {
+        BreakpointSite *bp_site = bp_sites[batch_indexes[i]];
+        if (sent && succeeded[i])
+        {
+            bp_site->SetEnabled(true);
+            bp_site->SetType(BreakpointSite::eExternal);
+        }
+        else
+        {
+            // Give the usual fallbacks a chance.
+            errors[batch_indexes[i]] = EnableBreakpointSite (bp_site);
+        }
+    }
+}
+
+void
+ProcessGDBRemote::DisableBreakpointSites (const std::vector<BreakpointSite *> &bp_sites, std::vector<Error> &errors)
+{
+    errors.assign (bp_sites.size(), Error());
+
+    // Only the sites set with "Z0" or "Z1" packets can be removed together.
+    // The kind of a "z" packet is the one of the "Z" packet, the size of the
+    // trap opcode the site recorded when it was enabled.
+    const bool use_multi_breakpoint = m_gdb_comm.GetMultiBreakpointSupported();
+    std::vector<size_t> batch_indexes[2];
+    std::vector<std::pair<addr_t, uint32_t>> stoppoints[2];
+    for (size_t i = 0; i < bp_sites.size(); ++i)
+    {
+        BreakpointSite *bp_site = bp_sites[i];
+        if (!bp_site->IsEnabled())
+            continue;
+        const BreakpointSite::Type bp_type = bp_site->GetType();
+        if (!use_multi_breakpoint || bp_type == BreakpointSite::eSoftware || bp_site->GetByteSize() == 0)
+        {
+            errors[i] = DisableBreakpointSite (bp_site);
+            continue;
+        }
+        const size_t kind = (bp_type == BreakpointSite::eHardware || bp_site->IsHardware()) ? 1 : 0;
+        batch_indexes[kind].push_back (i);
+        stoppoints[kind].push_back (std::make_pair (bp_site->GetLoadAddress(), bp_site->GetByteSize()));
+    }
+
+    for (size_t kind = 0; kind < 2; ++kind)
+    {
+        if (batch_indexes[kind].empty())
+            continue;
+        std::vector<bool> succeeded;
+        const bool sent = m_gdb_comm.SendGDBStoppointTypePackets (kind ? eBreakpointHardware : eBreakpointSoftware,
+                                                                  false, stoppoints[kind], succeeded);
+        for (size_t i = 0; i < batch_indexes[kind].size(); ++i)
+        {
+            BreakpointSite *bp_site = bp_sites[batch_indexes[kind][i]];
+            if (sent && succeeded[i])
+                bp_site->SetEnabled(false);
+            else if (sent)
+                errors[batch_indexes[kind][i]].SetErrorStringWithFormat ("failed to remove breakpoint at 0x%" PRIx64,
+                                                                         bp_site->GetLoadAddress());
+            else
+                errors[batch_indexes[kind][i]] = DisableBreakpointSite (bp_site);
+        }
+    }
+}
+
 // Pre-requisite: wp != NULL.
 static GDBStoppointType
 GetGDBStoppointType (Watchpoint *wp)
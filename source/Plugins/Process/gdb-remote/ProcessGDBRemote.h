@@ -157,6 +157,13 @@ public:
     bool
     IsAlive () override;
 
+    bool
+    SupportsParallelThreadUnwind () const override
+    {
+        // Every packet exchange takes the sequence mutex of the connection.
+        return true;
+    }
+
     lldb::addr_t
     GetImageInfoAddress() override;
 
@@ -169,6 +176,9 @@ public:
     size_t
     DoReadMemory (lldb::addr_t addr, void *buf, size_t size, Error &error) override;
 
+    void
+    DoReadMemoryRanges (MemoryRangeReads &reads) override;
+
     size_t
     DoWriteMemory (lldb::addr_t addr, const void *buf, size_t size, Error &error) override;
 
@@ -196,6 +206,15 @@ public:
     Error
     DisableBreakpointSite (BreakpointSite *bp_site) override;
 
+    void
+    EnableBreakpointSites (const std::vector<BreakpointSite *> &bp_sites, std::vector<Error> &errors) override;
+
+    void
+    DisableBreakpointSites (const std::vector<BreakpointSite *> &bp_sites, std::vector<Error> &errors) override;
+
+    void
+    UpdateBreakpointSiteConditions (BreakpointSite *bp_site) override;
+
     //----------------------------------------------------------------------
     // Process Watchpoints
     //----------------------------------------------------------------------
@@ -414,6 +433,9 @@ protected:
     lldb::StateType
     SetThreadStopInfo (StringExtractor& stop_packet);
 
+    bool
+    GetBreakpointSiteConditions (BreakpointSite *bp_site, std::vector<std::vector<uint8_t>> &conditions);
+
     bool
     GetThreadStopInfoFromJSON (ThreadGDBRemote *thread, const StructuredData::ObjectSP &thread_infos_sp);
 
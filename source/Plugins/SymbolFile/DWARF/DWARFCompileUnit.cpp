@@ -9,6 +9,8 @@
 
 #include "DWARFCompileUnit.h"
 
+#include <algorithm>
+
 #include "lldb/Core/Mangled.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/Stream.h"
@@ -57,7 +59,14 @@ DWARFCompileUnit::DWARFCompileUnit(SymbolFileDWARF* dwarf2Data) :
     m_is_dwarf64    (false),
     m_is_optimized  (eLazyBoolCalculate),
     m_addr_base (0),
-    m_base_obj_offset (DW_INVALID_OFFSET)
+    m_base_obj_offset (DW_INVALID_OFFSET),
+    m_transient_users (0),
+    m_dies_are_transient (false),
+    m_transient_byte_size (0),
+    m_transient_pos (),
+    m_dies_pending_clear (false),
+    m_num_parsed_dies (0),
+    m_die_array_mutex ()
 {
 }
 
@@ -74,6 +83,7 @@ DWARFCompileUnit::Clear()
     m_addr_size     = DWARFCompileUnit::GetDefaultAddressSize();
     m_base_addr     = 0;
     m_die_array.clear();
+    m_num_parsed_dies = 0;
     m_func_aranges_ap.reset();
     m_user_data     = NULL;
     m_producer      = eProducerInvalid;
@@ -122,6 +132,13 @@ DWARFCompileUnit::Extract(const DWARFDataExtractor &debug_info, lldb::offset_t *
 
 void
 DWARFCompileUnit::ClearDIEs(bool keep_compile_unit_die)
+{
+    std::lock_guard<std::mutex> guard (m_die_array_mutex);
+    ClearDIEsLocked (keep_compile_unit_die);
+}
+
+void
+DWARFCompileUnit::ClearDIEsLocked (bool keep_compile_unit_die)
 {
     if (m_die_array.size() > 1)
     {
@@ -138,12 +155,42 @@ DWARFCompileUnit::ClearDIEs(bool keep_compile_unit_die)
         m_die_array.swap(tmp_array);
         if (keep_compile_unit_die)
             m_die_array.push_back(tmp_array.front());
+        m_num_parsed_dies = m_die_array.size();
     }
 
     if (m_dwo_symbol_file)
         m_dwo_symbol_file->GetCompileUnit()->ClearDIEs(keep_compile_unit_die);
 }
 
+void
+DWARFCompileUnit::AcquireTransientDIEs()
+{
+    m_dwarf2Data->DebugInfo()->AcquireTransientDIEs(this);
+}
+
+void
+DWARFCompileUnit::ReleaseTransientDIEs()
+{
+    m_dwarf2Data->DebugInfo()->ReleaseTransientDIEs(this);
+}
+
+void
+DWARFCompileUnit::ClearTransientDIEs ()
+{
+    std::lock_guard<std::mutex> guard (m_die_array_mutex);
+    if (m_dies_pending_clear.exchange (false))
+        ClearDIEsLocked (true);
+}
+
+size_t
+DWARFCompileUnit::GetDIEArrayByteSize () const
+{
+    size_t byte_size = m_die_array.capacity() * sizeof(DWARFDebugInfoEntry);
+    if (m_dwo_symbol_file)
+        byte_size += m_dwo_symbol_file->GetCompileUnit()->GetDIEArrayByteSize();
+    return byte_size;
+}
+
 //----------------------------------------------------------------------
 // ParseCompileUnitDIEsIfNeeded
 //
@@ -152,10 +199,37 @@ DWARFCompileUnit::ClearDIEs(bool keep_compile_unit_die)
 //----------------------------------------------------------------------
 size_t
 DWARFCompileUnit::ExtractDIEsIfNeeded (bool cu_die_only)
+{
+    // DIEs that are parsed and not transient are never freed, they don't
+    // need the lock. m_num_parsed_dies is published after the transient
+    // state is set when parsing and m_dies_pending_clear is set before it
+    // is cleared when evicting, so a reader can't miss either of them.
+    const size_t num_parsed_dies = m_num_parsed_dies;
+    if (((cu_die_only && num_parsed_dies > 0) || num_parsed_dies > 1) &&
+        !m_dies_are_transient && !m_dies_pending_clear)
+        return 0; // Already parsed
+
+    // Parallel scans can parse the DIEs of a compile unit they look up
+    // while another one is parsing or freeing them.
+    std::lock_guard<std::mutex> guard (m_die_array_mutex);
+    const size_t num_dies = ExtractDIEsLocked (cu_die_only);
+    m_num_parsed_dies = m_die_array.size();
+    return num_dies;
+}
+
+size_t
+DWARFCompileUnit::ExtractDIEsLocked (bool cu_die_only)
 {
     const size_t initial_die_array_size = m_die_array.size();
     if ((cu_die_only && initial_die_array_size > 0) || initial_die_array_size > 1)
+    {
+        // DIEs parsed for a scan that has finished, or evicted but not
+        // freed yet, are being accessed in a way that can keep DIE
+        // pointers around, so they must stay parsed.
+        if (!cu_die_only && (m_dies_pending_clear || (m_dies_are_transient && m_transient_users == 0)))
+            m_dwarf2Data->DebugInfo()->PinTransientDIEs(this);
         return 0; // Already parsed
+    }
 
     Timer scoped_timer (__PRETTY_FUNCTION__,
                         "%8.8x: DWARFCompileUnit::ExtractDIEsIfNeeded( cu_die_only = %i )",
@@ -508,9 +582,8 @@ DWARFCompileUnit::BuildAddressRangeTable (SymbolFileDWARF* dwarf2Data,
     // We don't have a DW_AT_ranges attribute, so we need to parse the DWARF
     
     // If the DIEs weren't parsed, then we don't want all dies for all compile units
-    // to stay loaded when they weren't needed. So we can end up parsing the DWARF
-    // and then throwing them all away to keep memory usage down.
-    const bool clear_dies = ExtractDIEsIfNeeded (false) > 1;
+    // to stay loaded when they weren't needed, so only parse them transiently.
+    AcquireTransientDIEs();
     
     die = DIEPtr();
     if (die)
@@ -570,11 +643,7 @@ DWARFCompileUnit::BuildAddressRangeTable (SymbolFileDWARF* dwarf2Data,
         }
     }
     
-    // Keep memory down by clearing DIEs if this generate function
-    // caused them to be parsed
-    if (clear_dies)
-        ClearDIEs (true);
-
+    ReleaseTransientDIEs();
 }
 
 
@@ -732,8 +801,13 @@ DWARFCompileUnit::Index (NameToDIE& func_basenames,
     const LanguageType cu_language = GetLanguageType();
     DWARFFormValue::FixedFormSizes fixed_form_sizes =
         DWARFFormValue::GetFixedFormSizesForAddressSize (GetAddressByteSize(), m_is_dwarf64);
+
+    // The other compile units whose DIEs are looked up while indexing this
+    // one, they stay parsed until it is done.
+    std::vector<DWARFCompileUnit*> referenced_cus;
     
     IndexPrivate(this,
+                 referenced_cus,
                  cu_language,
                  fixed_form_sizes,
                  GetOffset(),
@@ -750,6 +824,7 @@ DWARFCompileUnit::Index (NameToDIE& func_basenames,
     if (dwo_symbol_file)
     {
         IndexPrivate(dwo_symbol_file->GetCompileUnit(),
+                     referenced_cus,
                      cu_language,
                      fixed_form_sizes,
                      GetOffset(),
@@ -762,10 +837,14 @@ DWARFCompileUnit::Index (NameToDIE& func_basenames,
                      types,
                      namespaces);
     }
+
+    for (DWARFCompileUnit *referenced_cu : referenced_cus)
+        referenced_cu->ReleaseTransientDIEs();
 }
 
 void
 DWARFCompileUnit::IndexPrivate (DWARFCompileUnit* dwarf_cu,
+                                std::vector<DWARFCompileUnit*>& referenced_cus,
                                 const LanguageType cu_language,
                                 const DWARFFormValue::FixedFormSizes& fixed_form_sizes,
                                 const dw_offset_t cu_offset,
@@ -955,7 +1034,18 @@ DWARFCompileUnit::IndexPrivate (DWARFCompileUnit* dwarf_cu,
                         {
                             if (specification_die_form.IsValid())
                             {
-                                DWARFDIE specification_die = dwarf_cu->GetSymbolFileDWARF()->DebugInfo()->GetDIE (DIERef(specification_die_form));
+                                // A specification in another compile unit must
+                                // not be freed by the scan indexing that one.
+                                DWARFDebugInfo *debug_info = dwarf_cu->GetSymbolFileDWARF()->DebugInfo();
+                                const DIERef specification_ref (specification_die_form);
+                                DWARFCompileUnit *specification_cu = debug_info->GetCompileUnitContainingDIE (specification_ref);
+                                if (specification_cu && specification_cu != dwarf_cu &&
+                                    std::find (referenced_cus.begin(), referenced_cus.end(), specification_cu) == referenced_cus.end())
+                                {
+                                    specification_cu->AcquireTransientDIEs();
+                                    referenced_cus.push_back (specification_cu);
+                                }
+                                DWARFDIE specification_die = debug_info->GetDIE (specification_ref);
                                 if (specification_die.GetParent().IsStructOrClass())
                                     is_method = true;
                             }
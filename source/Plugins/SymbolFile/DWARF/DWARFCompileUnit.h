@@ -10,6 +10,11 @@
 #ifndef SymbolFileDWARF_DWARFCompileUnit_h_
 #define SymbolFileDWARF_DWARFCompileUnit_h_
 
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <vector>
+
 #include "lldb/lldb-enumerations.h"
 #include "DWARFDebugInfoEntry.h"
 #include "DWARFDIE.h"
@@ -56,6 +61,24 @@ public:
     dw_addr_t   GetAddrBase() const { return m_addr_base; }
     void        SetAddrBase(dw_addr_t addr_base, dw_offset_t base_obj_offset);
     void        ClearDIEs(bool keep_compile_unit_die);
+
+    //------------------------------------------------------------------
+    // Parse all DIEs for a scan (indexing, building address ranges...)
+    // that doesn't keep any DWARFDIE or DIE pointer after the matching
+    // call to ReleaseTransientDIEs(). Instead of being freed at the end
+    // of the scan, DIEs parsed this way stay in a least recently used
+    // list shared by all compile units of the symbol file, bounded by
+    // the "die-cache-size" setting, so scanning the same compile unit
+    // again doesn't need to parse it again. Accessing the DIEs through
+    // ExtractDIEsIfNeeded() outside of a scan makes them permanent, as
+    // they were before, and they no longer count against the setting.
+    //
+    // A scan that looks up DIEs of another compile unit must acquire
+    // that compile unit too, the DIEs of a compile unit can be freed as
+    // soon as the scan using it releases them.
+    //------------------------------------------------------------------
+    void        AcquireTransientDIEs();
+    void        ReleaseTransientDIEs();
     void        BuildAddressRangeTable (SymbolFileDWARF* dwarf2Data,
                                         DWARFDebugAranges* debug_aranges);
 
@@ -201,6 +224,23 @@ public:
     }
 
 protected:
+    friend class DWARFDebugInfo; // Manages the transient DIE list
+
+    size_t
+    GetDIEArrayByteSize () const;
+
+    // Frees the DIEs unless they were used again since DWARFDebugInfo
+    // decided to evict them.
+    void
+    ClearTransientDIEs ();
+
+    // ExtractDIEsIfNeeded() and ClearDIEs() with m_die_array_mutex held
+    size_t
+    ExtractDIEsLocked (bool cu_die_only);
+
+    void
+    ClearDIEsLocked (bool keep_compile_unit_die);
+
     SymbolFileDWARF*    m_dwarf2Data;
     std::unique_ptr<SymbolFileDWARFDwo> m_dwo_symbol_file;
     const DWARFAbbreviationDeclarationSet *m_abbrevs;
@@ -222,12 +262,20 @@ protected:
     dw_addr_t           m_addr_base;       // Value of DW_AT_addr_base
     dw_offset_t         m_base_obj_offset; // If this is a dwo compile unit this is the offset of
                                            // the base compile unit in the main object file
+    std::atomic<uint32_t> m_transient_users;     // Number of scans using the DIEs through AcquireTransientDIEs()
+    std::atomic<bool>   m_dies_are_transient;  // True if m_die_array is in the transient DIE list of DWARFDebugInfo
+    size_t              m_transient_byte_size; // Memory accounted for m_die_array in the transient DIE list
+    std::list<DWARFCompileUnit*>::iterator m_transient_pos; // Position in the transient DIE list
+    std::atomic<bool>   m_dies_pending_clear;  // True if m_die_array was evicted from the transient DIE list but not cleared yet
+    std::atomic<size_t> m_num_parsed_dies;     // The size of m_die_array, published once the DIEs are parsed
+    std::mutex          m_die_array_mutex;     // Serializes parsing and clearing m_die_array when the DIEs can be freed
 
     void
     ParseProducerInfo ();
 
     static void
     IndexPrivate (DWARFCompileUnit* dwarf_cu,
+                  std::vector<DWARFCompileUnit*>& referenced_cus,
                   const lldb::LanguageType cu_language,
                   const DWARFFormValue::FixedFormSizes& fixed_form_sizes,
                   const dw_offset_t cu_offset,
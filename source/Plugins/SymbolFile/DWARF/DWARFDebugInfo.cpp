@@ -34,7 +34,10 @@ using namespace std;
 DWARFDebugInfo::DWARFDebugInfo() :
     m_dwarf2Data(NULL),
     m_compile_units(),
-    m_cu_aranges_ap ()
+    m_cu_aranges_ap (),
+    m_transient_dies_mutex (),
+    m_transient_dies (),
+    m_transient_dies_byte_size (0)
 {
 }
 
@@ -103,6 +106,102 @@ DWARFDebugInfo::GetCompileUnitAranges ()
     return *m_cu_aranges_ap.get();
 }
 
+void
+DWARFDebugInfo::AcquireTransientDIEs (DWARFCompileUnit *cu)
+{
+    {
+        std::lock_guard<std::mutex> guard (m_transient_dies_mutex);
+        ++cu->m_transient_users;
+        if (cu->m_dies_are_transient)
+        {
+            m_transient_dies.splice (m_transient_dies.begin(), m_transient_dies, cu->m_transient_pos);
+            return;
+        }
+    }
+
+    // Parse and track the DIEs under the lock of the compile unit, and only
+    // publish them afterwards, so no other thread can get to them untracked
+    // and miss pinning them.
+    std::lock_guard<std::mutex> cu_guard (cu->m_die_array_mutex);
+    const bool evicted = cu->m_dies_pending_clear;
+    if (!evicted && cu->ExtractDIEsLocked (false) <= 1)
+    {
+        // Nothing to track if the DIEs were already parsed for other uses
+        cu->m_num_parsed_dies = cu->m_die_array.size();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard (m_transient_dies_mutex);
+        cu->m_dies_are_transient = true;
+        // Take back DIEs that were evicted but not freed yet
+        cu->m_dies_pending_clear = false;
+        cu->m_transient_byte_size = cu->GetDIEArrayByteSize();
+        cu->m_transient_pos = m_transient_dies.insert (m_transient_dies.begin(), cu);
+        m_transient_dies_byte_size += cu->m_transient_byte_size;
+    }
+    cu->m_num_parsed_dies = cu->m_die_array.size();
+}
+
+void
+DWARFDebugInfo::ReleaseTransientDIEs (DWARFCompileUnit *cu)
+{
+    std::vector<DWARFCompileUnit *> evicted_cus;
+    {
+        std::lock_guard<std::mutex> guard (m_transient_dies_mutex);
+        --cu->m_transient_users;
+
+        // The DIEs of a .dwo compile unit can be reached without going through
+        // the skeleton compile unit so they can't be kept after the scan.
+        if (cu->m_dies_are_transient && cu->m_transient_users == 0 && cu->GetDwoSymbolFile())
+        {
+            RemoveTransientDIEs (cu, true);
+            evicted_cus.push_back (cu);
+        }
+
+        const uint64_t max_byte_size = SymbolFileDWARF::GetDIECacheByteSize();
+        auto pos = m_transient_dies.end();
+        while (m_transient_dies_byte_size > max_byte_size && pos != m_transient_dies.begin())
+        {
+            --pos;
+            DWARFCompileUnit *lru_cu = *pos;
+            if (lru_cu->m_transient_users == 0)
+            {
+                pos = RemoveTransientDIEs (lru_cu, true);
+                evicted_cus.push_back (lru_cu);
+            }
+        }
+    }
+
+    // Freeing the DIEs takes the lock of each compile unit, which must not
+    // be done while holding m_transient_dies_mutex.
+    for (DWARFCompileUnit *evicted_cu : evicted_cus)
+        evicted_cu->ClearTransientDIEs();
+}
+
+void
+DWARFDebugInfo::PinTransientDIEs (DWARFCompileUnit *cu)
+{
+    std::lock_guard<std::mutex> guard (m_transient_dies_mutex);
+    if (cu->m_dies_are_transient && cu->m_transient_users == 0)
+        RemoveTransientDIEs (cu, false);
+    // Cancel an eviction that hasn't freed the DIEs yet
+    cu->m_dies_pending_clear = false;
+}
+
+std::list<DWARFCompileUnit*>::iterator
+DWARFDebugInfo::RemoveTransientDIEs (DWARFCompileUnit *cu, bool clear_dies)
+{
+    m_transient_dies_byte_size -= cu->m_transient_byte_size;
+    cu->m_transient_byte_size = 0;
+    // Mark the DIEs to be freed before they stop being transient, readers
+    // check the flags in the opposite order.
+    if (clear_dies)
+        cu->m_dies_pending_clear = true;
+    cu->m_dies_are_transient = false;
+    return m_transient_dies.erase (cu->m_transient_pos);
+}
+
 void
 DWARFDebugInfo::ParseCompileUnitHeadersIfNeeded()
 {
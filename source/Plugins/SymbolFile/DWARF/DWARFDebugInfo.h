@@ -10,8 +10,10 @@
 #ifndef SymbolFileDWARF_DWARFDebugInfo_h_
 #define SymbolFileDWARF_DWARFDebugInfo_h_
 
-#include <vector>
+#include <list>
 #include <map>
+#include <mutex>
+#include <vector>
 
 #include "lldb/lldb-private.h"
 #include "lldb/lldb-private.h"
@@ -61,6 +63,23 @@ public:
     DWARFDebugAranges &
     GetCompileUnitAranges ();
 
+    //------------------------------------------------------------------
+    // Bookkeeping for DWARFCompileUnit::AcquireTransientDIEs() and
+    // DWARFCompileUnit::ReleaseTransientDIEs(). The compile units with
+    // transient DIEs are kept in least recently used order and the
+    // least recently used ones not in use by a scan are cleared when
+    // they take more memory than SymbolFileDWARF::GetDIECacheByteSize().
+    //------------------------------------------------------------------
+    void
+    AcquireTransientDIEs (DWARFCompileUnit *cu);
+
+    void
+    ReleaseTransientDIEs (DWARFCompileUnit *cu);
+
+    // Must be called with the lock of the compile unit held
+    void
+    PinTransientDIEs (DWARFCompileUnit *cu);
+
 protected:
     typedef std::shared_ptr<DWARFCompileUnit> DWARFCompileUnitSP;
 
@@ -75,11 +94,20 @@ protected:
     SymbolFileDWARF* m_dwarf2Data;
     CompileUnitColl m_compile_units;
     std::unique_ptr<DWARFDebugAranges> m_cu_aranges_ap; // A quick address to compile unit table
+    std::mutex m_transient_dies_mutex;
+    std::list<DWARFCompileUnit*> m_transient_dies; // Compile units with transient DIEs, most recently used first
+    size_t m_transient_dies_byte_size;
 
 private:
     // All parsing needs to be done partially any managed by this class as accessors are called.
     void ParseCompileUnitHeadersIfNeeded();
 
+    // Must be called with m_transient_dies_mutex held. When clear_dies is
+    // true the DIEs are only marked to be freed, the caller frees them with
+    // DWARFCompileUnit::ClearTransientDIEs() after releasing the mutex.
+    std::list<DWARFCompileUnit*>::iterator
+    RemoveTransientDIEs (DWARFCompileUnit *cu, bool clear_dies);
+
     DISALLOW_COPY_AND_ASSIGN (DWARFDebugInfo);
 };
 
@@ -508,46 +508,24 @@ DWARFDebugLine::ParseSupportFiles (const lldb::ModuleSP &module_sp,
 }
 
 //----------------------------------------------------------------------
-// ParseStatementTable
+// ParseStatementOpcodes
 //
-// Parse a single line table (prologue and all rows) and call the
-// callback function once for the prologue (row in state will be zero)
-// and each time a row is to be added to the line table.
+// Run the statement program from *offset_ptr and call the state
+// callback for each row. Stops at end_offset, or right after the next
+// DW_LNE_end_sequence when single_sequence is true. Returns true if it
+// stopped at the end of a sequence.
 //----------------------------------------------------------------------
-bool
-DWARFDebugLine::ParseStatementTable
+static bool
+ParseStatementOpcodes
 (
     const DWARFDataExtractor& debug_line_data,
     lldb::offset_t* offset_ptr,
-    DWARFDebugLine::State::Callback callback,
-    void* userData
+    dw_offset_t end_offset,
+    DWARFDebugLine::State& state,
+    bool single_sequence
 )
 {
-    Log *log (LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_LINE));
-    Prologue::shared_ptr prologue(new Prologue());
-
-
-    const dw_offset_t debug_line_offset = *offset_ptr;
-
-    Timer scoped_timer (__PRETTY_FUNCTION__,
-                        "DWARFDebugLine::ParseStatementTable (.debug_line[0x%8.8x])",
-                        debug_line_offset);
-
-    if (!ParsePrologue(debug_line_data, offset_ptr, prologue.get()))
-    {
-        if (log)
-            log->Error ("failed to parse DWARF line table prologue");
-        // Restore our offset and return false to indicate failure!
-        *offset_ptr = debug_line_offset;
-        return false;
-    }
-
-    if (log)
-        prologue->Dump (log);
-
-    const dw_offset_t end_offset = debug_line_offset + prologue->total_length + (debug_line_data.GetDWARFSizeofInitialLength());
-
-    State state(prologue, log, callback, userData);
+    const DWARFDebugLine::Prologue *prologue = state.prologue.get();
 
     while (*offset_ptr < end_offset)
     {
@@ -577,6 +555,8 @@ DWARFDebugLine::ParseStatementTable
                 state.end_sequence = true;
                 state.AppendRowToMatrix(*offset_ptr);
                 state.Reset();
+                if (single_sequence)
+                    return true;
                 break;
 
             case DW_LNE_set_address:
@@ -613,7 +593,7 @@ DWARFDebugLine::ParseStatementTable
                 // the DW_LNE_define_file instruction. These numbers are used in the
                 // file register of the state machine.
                 {
-                    FileNameEntry fileEntry;
+                    DWARFDebugLine::FileNameEntry fileEntry;
                     fileEntry.name      = debug_line_data.GetCStr(offset_ptr);
                     fileEntry.dir_idx   = debug_line_data.GetULEB128(offset_ptr);
                     fileEntry.mod_time  = debug_line_data.GetULEB128(offset_ptr);
@@ -784,11 +764,86 @@ DWARFDebugLine::ParseStatementTable
         }
     }
 
+    return false;
+}
+
+//----------------------------------------------------------------------
+// ParseStatementTable
+//
+// Parse a single line table (prologue and all rows) and call the
+// callback function once for the prologue (row in state will be zero)
+// and each time a row is to be added to the line table.
+//----------------------------------------------------------------------
+bool
+DWARFDebugLine::ParseStatementTable
+(
+    const DWARFDataExtractor& debug_line_data,
+    lldb::offset_t* offset_ptr,
+    DWARFDebugLine::State::Callback callback,
+    void* userData
+)
+{
+    Log *log (LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_LINE));
+    Prologue::shared_ptr prologue(new Prologue());
+
+
+    const dw_offset_t debug_line_offset = *offset_ptr;
+
+    Timer scoped_timer (__PRETTY_FUNCTION__,
+                        "DWARFDebugLine::ParseStatementTable (.debug_line[0x%8.8x])",
+                        debug_line_offset);
+
+    if (!ParsePrologue(debug_line_data, offset_ptr, prologue.get()))
+    {
+        if (log)
+            log->Error ("failed to parse DWARF line table prologue");
+        // Restore our offset and return false to indicate failure!
+        *offset_ptr = debug_line_offset;
+        return false;
+    }
+
+    if (log)
+        prologue->Dump (log);
+
+    const dw_offset_t end_offset = debug_line_offset + prologue->total_length + (debug_line_data.GetDWARFSizeofInitialLength());
+
+    State state(prologue, log, callback, userData);
+
+    ParseStatementOpcodes(debug_line_data, offset_ptr, end_offset, state, false);
+
     state.Finalize( *offset_ptr );
 
     return end_offset;
 }
 
+//----------------------------------------------------------------------
+// ParseStatementSequence
+//
+// Parse the rows of a single sequence of a line table whose prologue was
+// already parsed. *offset_ptr must be the offset of the first opcode of
+// the sequence, which is the end of the prologue for the first sequence
+// or the end of the previous DW_LNE_end_sequence for the others. The
+// callback is called like for ParseStatementTable. Returns true if a
+// DW_LNE_end_sequence was found before end_offset.
+//----------------------------------------------------------------------
+bool
+DWARFDebugLine::ParseStatementSequence
+(
+    const DWARFDataExtractor& debug_line_data,
+    const Prologue::shared_ptr& prologue_sp,
+    lldb::offset_t* offset_ptr,
+    dw_offset_t end_offset,
+    DWARFDebugLine::State::Callback callback,
+    void* userData
+)
+{
+    Prologue::shared_ptr prologue(prologue_sp);
+    State state(prologue, nullptr, callback, userData);
+    const bool ended = ParseStatementOpcodes(debug_line_data, offset_ptr, end_offset, state, true);
+    state.Finalize( *offset_ptr );
+    return ended;
+}
+
 
 //----------------------------------------------------------------------
 // ParseStatementTableCallback
@@ -88,7 +88,7 @@ DWARFDebugPubnames::GeneratePubnames(SymbolFileDWARF* dwarf2Data)
                 DWARFFormValue::GetFixedFormSizesForAddressSize (cu->GetAddressByteSize(),
                                                                  cu->IsDWARF64());
 
-            bool clear_dies = cu->ExtractDIEsIfNeeded (false) > 1;
+            cu->AcquireTransientDIEs();
 
             DWARFDIECollection dies;
             const size_t die_count = cu->AppendDIEsWithTag (DW_TAG_subprogram, dies) +
@@ -182,10 +182,7 @@ DWARFDebugPubnames::GeneratePubnames(SymbolFileDWARF* dwarf2Data)
                 m_sets.push_back(pubnames_set);
             }
             
-            // Keep memory down by clearing DIEs if this generate function
-            // caused them to be parsed
-            if (clear_dies)
-                cu->ClearDIEs (true);
+            cu->ReleaseTransientDIEs();
         }
     }
     if (m_sets.empty())
@@ -207,6 +204,7 @@ DWARFDebugPubnames::GeneratePubBaseTypes(SymbolFileDWARF* dwarf2Data)
         for (cu_idx = 0; cu_idx < num_compile_units; ++cu_idx)
         {
             DWARFCompileUnit* cu = debug_info->GetCompileUnitAtIndex(cu_idx);
+            cu->AcquireTransientDIEs();
             DWARFDIECollection dies;
             const size_t die_count = cu->AppendDIEsWithTag (DW_TAG_base_type, dies);
             dw_offset_t cu_offset = cu->GetOffset();
@@ -222,6 +220,8 @@ DWARFDebugPubnames::GeneratePubBaseTypes(SymbolFileDWARF* dwarf2Data)
                     pubnames_set.AddDescriptor(die.GetCompileUnitRelativeOffset(), name);
             }
 
+            cu->ReleaseTransientDIEs();
+
             if (pubnames_set.NumDescriptors() > 0)
             {
                 m_sets.push_back(pubnames_set);
@@ -9,16 +9,20 @@
 
 #include "NameToDIE.h"
 #include "lldb/Core/ConstString.h"
+#include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Core/StreamString.h"
 #include "lldb/Core/RegularExpression.h"
 #include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Utility/TaskPool.h"
 
 #include "DWARFCompileUnit.h"
 #include "DWARFDebugInfo.h"
 #include "DWARFDebugInfoEntry.h"
 #include "SymbolFileDWARF.h"
 
+#include <algorithm>
+
 using namespace lldb;
 using namespace lldb_private;
 
@@ -29,6 +33,86 @@ NameToDIE::Finalize()
     m_map.SizeToFit ();
 }
 
+void
+NameToDIE::Merge (std::vector<NameToDIE> &maps)
+{
+    typedef UniqueCStringMap<DIERef>::Entry Entry;
+
+    const size_t num_maps = maps.size();
+    TaskPool::ParallelFor(0, num_maps, [&maps](size_t i) { maps[i].m_map.Sort(); });
+
+    size_t total_size = 0;
+    for (const NameToDIE &map : maps)
+        total_size += map.m_map.GetSize();
+
+    m_map.Clear();
+    m_map.SizeToFit();
+    if (total_size == 0)
+        return;
+
+    // Pick the partition boundaries from evenly spaced samples of the
+    // concatenated maps so the partitions end up with similar sizes.
+    // Entries with the same name always end up in the same partition.
+    std::vector<const char *> splitters;
+    const size_t max_partitions = std::min<size_t>(TaskPool::GetThreadCount() * 4, total_size / 4096);
+    if (max_partitions > 1)
+    {
+        const size_t samples_per_partition = 16;
+        const size_t stride = std::max<size_t>(1, total_size / (max_partitions * samples_per_partition));
+        std::vector<const char *> samples;
+        size_t map_offset = 0;
+        for (const NameToDIE &map : maps)
+        {
+            const size_t size = map.m_map.GetSize();
+            for (size_t i = (stride - map_offset % stride) % stride; i < size; i += stride)
+                samples.push_back(map.m_map.GetCStringAtIndexUnchecked(i));
+            map_offset += size;
+        }
+        std::sort(samples.begin(), samples.end());
+        for (size_t p = 1; p < max_partitions; ++p)
+            splitters.push_back(samples[p * samples.size() / max_partitions]);
+        splitters.erase(std::unique(splitters.begin(), splitters.end()), splitters.end());
+    }
+    const size_t num_partitions = splitters.size() + 1;
+
+    // bounds[i * (num_partitions + 1) + p] is the index of the first entry
+    // of map "i" that belongs to partition "p".
+    std::vector<size_t> bounds(num_maps * (num_partitions + 1));
+    TaskPool::ParallelFor(0, num_maps, [&maps, &splitters, &bounds, num_partitions](size_t i) {
+        const Entry *entries = maps[i].m_map.GetEntries();
+        const size_t size = maps[i].m_map.GetSize();
+        size_t *map_bounds = &bounds[i * (num_partitions + 1)];
+        map_bounds[0] = 0;
+        for (size_t p = 1; p < num_partitions; ++p)
+            map_bounds[p] = std::lower_bound(entries + map_bounds[p - 1], entries + size, Entry(splitters[p - 1])) - entries;
+        map_bounds[num_partitions] = size;
+    });
+
+    std::vector<size_t> partition_offsets(num_partitions + 1, 0);
+    for (size_t i = 0; i < num_maps; ++i)
+    {
+        const size_t *map_bounds = &bounds[i * (num_partitions + 1)];
+        for (size_t p = 0; p < num_partitions; ++p)
+            partition_offsets[p + 1] += map_bounds[p + 1] - map_bounds[p];
+    }
+    for (size_t p = 0; p < num_partitions; ++p)
+        partition_offsets[p + 1] += partition_offsets[p];
+
+    m_map.Resize(total_size);
+    Entry *merged_entries = m_map.GetEntries();
+    TaskPool::ParallelFor(0, num_partitions, [&](size_t p) {
+        Entry *partition_begin = merged_entries + partition_offsets[p];
+        Entry *pos = partition_begin;
+        for (size_t i = 0; i < num_maps; ++i)
+        {
+            const size_t *map_bounds = &bounds[i * (num_partitions + 1)];
+            const Entry *entries = maps[i].m_map.GetEntries();
+            pos = std::copy(entries + map_bounds[p], entries + map_bounds[p + 1], pos);
+        }
+        std::sort(partition_begin, pos);
+    });
+}
+
 void
 NameToDIE::Insert (const ConstString& name, const DIERef& die_ref)
 {
@@ -94,3 +178,59 @@ NameToDIE::Append (const NameToDIE& other)
                      other.m_map.GetValueAtIndexUnchecked (i));
     }
 }
+
+void
+NameToDIE::Encode (Stream &strm) const
+{
+    const uint32_t size = m_map.GetSize();
+    uint32_t num_names = 0;
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        if (i == 0 || m_map.GetCStringAtIndexUnchecked(i) != m_map.GetCStringAtIndexUnchecked(i - 1))
+            ++num_names;
+    }
+
+    strm.PutHex32(num_names);
+    uint32_t i = 0;
+    while (i < size)
+    {
+        const char *cstr = m_map.GetCStringAtIndexUnchecked(i);
+        uint32_t end = i + 1;
+        while (end < size && m_map.GetCStringAtIndexUnchecked(end) == cstr)
+            ++end;
+
+        strm.Write(cstr, strlen(cstr) + 1);
+        strm.PutHex32(end - i);
+        for (; i < end; ++i)
+        {
+            const DIERef& die_ref = m_map.GetValueRefAtIndexUnchecked(i);
+            strm.PutHex32(die_ref.cu_offset);
+            strm.PutHex32(die_ref.die_offset);
+        }
+    }
+}
+
+bool
+NameToDIE::Decode (const DataExtractor &data, lldb::offset_t *offset_ptr)
+{
+    const uint32_t num_names = data.GetU32(offset_ptr);
+    for (uint32_t name_idx = 0; name_idx < num_names; ++name_idx)
+    {
+        const char *cstr = data.GetCStr(offset_ptr);
+        if (cstr == nullptr)
+            return false;
+        const uint32_t num_dies = data.GetU32(offset_ptr);
+        // Each DIE reference takes 8 bytes, make sure a corrupt count
+        // can't make us reserve or read past the end of the data.
+        if (!data.ValidOffsetForDataOfSize(*offset_ptr, num_dies * 8ull))
+            return false;
+        const char *unique_cstr = ConstString(cstr).GetCString();
+        for (uint32_t i = 0; i < num_dies; ++i)
+        {
+            const dw_offset_t cu_offset = data.GetU32(offset_ptr);
+            const dw_offset_t die_offset = data.GetU32(offset_ptr);
+            m_map.Append(unique_cstr, DIERef(cu_offset, die_offset));
+        }
+    }
+    return true;
+}
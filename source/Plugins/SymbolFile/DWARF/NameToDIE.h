@@ -11,10 +11,12 @@
 #define SymbolFileDWARF_NameToDIE_h_
 
 #include <functional>
+#include <vector>
 
 #include "lldb/Core/dwarf.h"
 #include "lldb/Core/UniqueCStringMap.h"
 #include "lldb/lldb-defines.h"
+#include "lldb/lldb-forward.h"
 #include "DIERef.h"
 
 class SymbolFileDWARF;
@@ -43,6 +45,17 @@ public:
     void
     Finalize();
 
+    //------------------------------------------------------------------
+    // Replace the contents of this map with all entries of "maps" (for
+    // example the per compile unit maps built while indexing) and
+    // finalize it. The entries are range partitioned by name, each
+    // partition is filled and sorted in parallel directly into a map
+    // sized to fit, so no serial append or global sort is needed. The
+    // maps in "maps" are sorted as a side effect.
+    //------------------------------------------------------------------
+    void
+    Merge (std::vector<NameToDIE> &maps);
+
     size_t
     Find (const lldb_private::ConstString &name, DIEArray &info_array) const;
     
@@ -55,6 +68,20 @@ public:
     void
     ForEach (std::function <bool(const char *name, const DIERef& die_ref)> const &callback) const;
 
+    //------------------------------------------------------------------
+    // Serialize a finalized map into a binary stream so it can be
+    // stored in the on-disk index cache. Entries sharing a name are
+    // written once per name. Decode() appends the entries found in
+    // "data" to this map, the caller must call Finalize() afterwards
+    // because the sort order depends on the ConstString pool layout of
+    // the current process.
+    //------------------------------------------------------------------
+    void
+    Encode (lldb_private::Stream &strm) const;
+
+    bool
+    Decode (const lldb_private::DataExtractor &data, lldb::offset_t *offset_ptr);
+
 protected:
     lldb_private::UniqueCStringMap<DIERef> m_map;
 };
@@ -9,10 +9,14 @@
 
 #include "SymbolFileDWARF.h"
 
+// C++ Includes
+#include <algorithm>
+
 // Other libraries and framework includes
 #include "llvm/Support/Casting.h"
 
 #include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/IndexCache.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ModuleList.h"
 #include "lldb/Core/ModuleSpec.h"
@@ -23,6 +27,7 @@
 #include "lldb/Core/StreamFile.h"
 #include "lldb/Core/StreamString.h"
 #include "lldb/Core/Timer.h"
+#include "lldb/Core/UUID.h"
 #include "lldb/Core/Value.h"
 
 #include "Plugins/ExpressionParser/Clang/ClangModulesDeclVendor.h"
@@ -50,6 +55,7 @@
 #include "Plugins/Language/ObjC/ObjCLanguage.h"
 
 #include "lldb/Target/Language.h"
+#include "lldb/Target/Target.h"
 
 #include "lldb/Utility/TaskPool.h"
 
@@ -110,12 +116,16 @@ namespace {
     g_properties[] =
     {
         { "comp-dir-symlink-paths" , OptionValue::eTypeFileSpecList, true,  0 ,   nullptr, nullptr, "If the DW_AT_comp_dir matches any of these paths the symbolic links will be resolved at DWARF parse time." },
+        { "die-cache-size"         , OptionValue::eTypeUInt64      , true,  0,    nullptr, nullptr, "Maximum memory in megabytes used to keep DIEs that were only parsed to index or scan a compile unit, the least recently used ones are freed when it is exceeded. Zero, the default, frees them right after each scan." },
+        { "lazy-line-tables"       , OptionValue::eTypeBoolean     , true,  true, nullptr, nullptr, "Only find where the sequences of a line table are when it is parsed and decode each sequence the first time an address in it is looked up." },
         {  nullptr                 , OptionValue::eTypeInvalid     , false, 0,    nullptr, nullptr, nullptr }
     };
 
     enum
     {
-        ePropertySymLinkPaths
+        ePropertySymLinkPaths,
+        ePropertyDIECacheSize,
+        ePropertyLazyLineTables
     };
 
 
@@ -142,6 +152,20 @@ namespace {
             return option_value->GetCurrentValue();
         }
 
+        uint64_t
+        GetDIECacheByteSize() const
+        {
+            const uint32_t idx = ePropertyDIECacheSize;
+            return m_collection_sp->GetPropertyAtIndexAsUInt64 (nullptr, idx, g_properties[idx].default_uint_value) * 1024 * 1024;
+        }
+
+        bool
+        GetLazyLineTables() const
+        {
+            const uint32_t idx = ePropertyLazyLineTables;
+            return m_collection_sp->GetPropertyAtIndexAsBoolean (nullptr, idx, g_properties[idx].default_uint_value != 0);
+        }
+
     };
 
     typedef std::shared_ptr<PluginProperties> SymbolFileDWARFPropertiesSP;
@@ -254,6 +278,12 @@ SymbolFileDWARF::Terminate()
 }
 
 
+uint64_t
+SymbolFileDWARF::GetDIECacheByteSize()
+{
+    return GetGlobalPluginProperties()->GetDIECacheByteSize();
+}
+
 lldb_private::ConstString
 SymbolFileDWARF::GetPluginNameStatic()
 {
@@ -460,6 +490,7 @@ SymbolFileDWARF::SymbolFileDWARF(ObjectFile* objfile) :
     m_global_index(),
     m_type_index(),
     m_namespace_index(),
+    m_file_basename_index(),
     m_indexed (false),
     m_using_apple_tables (false),
     m_fetched_external_modules (false),
@@ -1034,6 +1065,9 @@ SymbolFileDWARF::ParseCompileUnitFunctions(const SymbolContext &sc)
     DWARFCompileUnit* dwarf_cu = GetDWARFCompileUnit(sc.comp_unit);
     if (dwarf_cu)
     {
+        // The functions keep pointers to their DIEs, make sure they are
+        // parsed and stay parsed.
+        dwarf_cu->ExtractDIEsIfNeeded (false);
         DWARFDIECollection function_dies;
         const size_t num_functions = dwarf_cu->AppendDIEsWithTag (DW_TAG_subprogram, function_dies);
         size_t func_idx;
@@ -1066,6 +1100,12 @@ SymbolFileDWARF::ParseCompileUnitSupportFiles (const SymbolContext& sc, FileSpec
             const dw_offset_t stmt_list = cu_die.GetAttributeValueAsUnsigned(DW_AT_stmt_list, DW_INVALID_OFFSET);
             if (stmt_list != DW_INVALID_OFFSET)
             {
+                Log *log (LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_LINE));
+                if (log)
+                    GetObjectFile()->GetModule()->LogMessage (log,
+                                                              "SymbolFileDWARF::ParseCompileUnitSupportFiles (compile unit = %s)",
+                                                              sc.comp_unit->GetPath().c_str());
+
                 // All file indexes in DWARF are one based and a file of index zero is
                 // supposed to be the compile unit itself.
                 support_files.Append (*sc.comp_unit);
@@ -1183,6 +1223,142 @@ ParseDWARFLineTableCallback(dw_offset_t offset, const DWARFDebugLine::State& sta
     }
 }
 
+struct ScanDWARFLineSequenceCallbackInfo
+{
+    lldb::addr_t addr_mask;
+    lldb::addr_t low_addr;
+    lldb::addr_t high_addr;
+};
+
+//----------------------------------------------------------------------
+// ScanDWARFLineSequenceCallback
+//
+// Only remember the address range of a sequence, its first row has the
+// lowest address and its end_sequence row the end address.
+//----------------------------------------------------------------------
+static void
+ScanDWARFLineSequenceCallback(dw_offset_t offset, const DWARFDebugLine::State& state, void* userData)
+{
+    if (state.row == DWARFDebugLine::State::StartParsingLineTable ||
+        state.row == DWARFDebugLine::State::DoneParsingLineTable)
+        return;
+
+    ScanDWARFLineSequenceCallbackInfo* info = (ScanDWARFLineSequenceCallbackInfo*)userData;
+    if (info->low_addr == LLDB_INVALID_ADDRESS)
+        info->low_addr = state.address & info->addr_mask;
+    if (state.end_sequence)
+        info->high_addr = state.address & info->addr_mask;
+}
+
+struct DecodeDWARFLineSequenceCallbackInfo
+{
+    LineTable* line_table;
+    LineSequence* sequence;
+    lldb::addr_t addr_mask;
+};
+
+//----------------------------------------------------------------------
+// DecodeDWARFLineSequenceCallback
+//----------------------------------------------------------------------
+static void
+DecodeDWARFLineSequenceCallback(dw_offset_t offset, const DWARFDebugLine::State& state, void* userData)
+{
+    if (state.row == DWARFDebugLine::State::StartParsingLineTable ||
+        state.row == DWARFDebugLine::State::DoneParsingLineTable)
+        return;
+
+    DecodeDWARFLineSequenceCallbackInfo* info = (DecodeDWARFLineSequenceCallbackInfo*)userData;
+    info->line_table->AppendLineEntryToSequence (info->sequence,
+                                                 state.address & info->addr_mask,
+                                                 state.line,
+                                                 state.column,
+                                                 state.file,
+                                                 state.is_stmt,
+                                                 state.basic_block,
+                                                 state.prologue_end,
+                                                 state.epilogue_begin,
+                                                 state.end_sequence);
+}
+
+namespace {
+
+    //------------------------------------------------------------------
+    // Decodes the sequences of a lazily populated line table from the
+    // .debug_line data, the cookie of a sequence is the offset of its
+    // first opcode.
+    //------------------------------------------------------------------
+    class DWARFLineSequenceDecoder : public LineTable::SequenceDecoder
+    {
+    public:
+        DWARFLineSequenceDecoder (const DWARFDataExtractor &debug_line_data,
+                                  const DWARFDebugLine::Prologue::shared_ptr &prologue_sp,
+                                  dw_offset_t end_offset,
+                                  lldb::addr_t addr_mask) :
+            m_debug_line_data (debug_line_data),
+            m_prologue_sp (prologue_sp),
+            m_num_file_names (prologue_sp->file_names.size()),
+            m_end_offset (end_offset),
+            m_addr_mask (addr_mask)
+        {
+        }
+
+        bool
+        DecodeSequence (LineTable &line_table, lldb::offset_t cookie, LineSequence *sequence) override
+        {
+            DecodeDWARFLineSequenceCallbackInfo info;
+            info.line_table = &line_table;
+            info.sequence = sequence;
+            info.addr_mask = m_addr_mask;
+            lldb::offset_t offset = cookie;
+            const bool ended = DWARFDebugLine::ParseStatementSequence(m_debug_line_data, m_prologue_sp, &offset, m_end_offset, DecodeDWARFLineSequenceCallback, &info);
+            // Drop the files DW_LNE_define_file opcodes added so decoding the
+            // same sequence again doesn't grow the prologue.
+            m_prologue_sp->file_names.resize(m_num_file_names);
+            return ended;
+        }
+
+    private:
+        DWARFDataExtractor m_debug_line_data;
+        DWARFDebugLine::Prologue::shared_ptr m_prologue_sp;
+        size_t m_num_file_names;
+        dw_offset_t m_end_offset;
+        lldb::addr_t m_addr_mask;
+    };
+
+}
+
+bool
+SymbolFileDWARF::ParseLazyLineTable (dw_offset_t cu_line_offset, lldb::addr_t addr_mask, LineTable &line_table)
+{
+    const DWARFDataExtractor &debug_line_data = get_debug_line_data();
+    lldb::offset_t offset = cu_line_offset;
+    DWARFDebugLine::Prologue::shared_ptr prologue_sp (new DWARFDebugLine::Prologue());
+    if (!DWARFDebugLine::ParsePrologue(debug_line_data, &offset, prologue_sp.get()))
+        return false;
+
+    const dw_offset_t end_offset = cu_line_offset + prologue_sp->total_length + debug_line_data.GetDWARFSizeofInitialLength();
+    const size_t num_file_names = prologue_sp->file_names.size();
+
+    // Run the line program once to find where each sequence starts and which
+    // addresses it covers without creating any line entries.
+    while (offset < end_offset)
+    {
+        const lldb::offset_t sequence_offset = offset;
+        ScanDWARFLineSequenceCallbackInfo info;
+        info.addr_mask = addr_mask;
+        info.low_addr = LLDB_INVALID_ADDRESS;
+        info.high_addr = LLDB_INVALID_ADDRESS;
+        if (!DWARFDebugLine::ParseStatementSequence(debug_line_data, prologue_sp, &offset, end_offset, ScanDWARFLineSequenceCallback, &info))
+            break;
+        if (info.low_addr != LLDB_INVALID_ADDRESS && info.high_addr != LLDB_INVALID_ADDRESS)
+            line_table.AddLazySequence(info.low_addr, info.high_addr, sequence_offset);
+    }
+    prologue_sp->file_names.resize(num_file_names);
+
+    line_table.SetSequenceDecoder(std::unique_ptr<LineTable::SequenceDecoder>(new DWARFLineSequenceDecoder(debug_line_data, prologue_sp, end_offset, addr_mask)));
+    return true;
+}
+
 bool
 SymbolFileDWARF::ParseCompileUnitLineTable (const SymbolContext &sc)
 {
@@ -1226,6 +1402,16 @@ SymbolFileDWARF::ParseCompileUnitLineTable (const SymbolContext &sc)
                         break;
                     }
 
+                    // Line tables of .o files are linked into a new line table
+                    // right away, there is nothing to gain from parsing them lazily.
+                    if (!m_debug_map_symfile &&
+                        GetGlobalPluginProperties()->GetLazyLineTables() &&
+                        ParseLazyLineTable(cu_line_offset, info.addr_mask, *line_table_ap))
+                    {
+                        sc.comp_unit->SetLineTable(line_table_ap.release());
+                        return true;
+                    }
+
                     lldb::offset_t offset = cu_line_offset;
                     DWARFDebugLine::ParseStatementTable(get_debug_line_data(), &offset, ParseDWARFLineTableCallback, &info);
                     if (m_debug_map_symfile)
@@ -2008,11 +2194,21 @@ SymbolFileDWARF::ResolveSymbolContext(const FileSpec& file_spec, uint32_t line,
         DWARFDebugInfo* debug_info = DebugInfo();
         if (debug_info)
         {
-            uint32_t cu_idx;
-            DWARFCompileUnit* dwarf_cu = NULL;
+            // Only the compile units with a file of the same base name can
+            // match, look at all of them when the index can't tell.
+            std::vector<uint32_t> cu_indexes;
+            if (!FindCompileUnitsForFile (file_spec, cu_indexes))
+            {
+                const uint32_t num_compile_units = debug_info->GetNumCompileUnits();
+                for (uint32_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx)
+                    cu_indexes.push_back (cu_idx);
+            }
 
-            for (cu_idx = 0; (dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx)) != NULL; ++cu_idx)
+            for (uint32_t cu_idx : cu_indexes)
             {
+                DWARFCompileUnit* dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
+                if (dwarf_cu == NULL)
+                    continue;
                 CompileUnit *dc_cu = GetCompUnitForDWARFCompUnit(dwarf_cu, cu_idx);
                 const bool full_match = (bool)file_spec.GetDirectory();
                 bool file_spec_matches_cu_file_spec = dc_cu != NULL && FileSpec::Equal(file_spec, *dc_cu, full_match);
@@ -2118,10 +2314,21 @@ SymbolFileDWARF::Index ()
     if (m_indexed)
         return;
     m_indexed = true;
+
+    if (LoadIndexCache())
+        return;
+
     Timer scoped_timer (__PRETTY_FUNCTION__,
                         "SymbolFileDWARF::Index (%s)",
                         GetObjectFile()->GetFileSpec().GetFilename().AsCString("<Unknown>"));
 
+    // Load the sections needed for indexing concurrently, so compressed
+    // sections are decompressed in parallel.
+    TaskPool::RunTasks([this]() { get_debug_info_data(); },
+                       [this]() { get_debug_abbrev_data(); },
+                       [this]() { get_debug_str_data(); },
+                       [this]() { get_debug_line_data(); });
+
     DWARFDebugInfo* debug_info = DebugInfo();
     if (debug_info)
     {
@@ -2134,6 +2341,7 @@ SymbolFileDWARF::Index ()
         std::vector<NameToDIE> global_index(num_compile_units);
         std::vector<NameToDIE> type_index(num_compile_units);
         std::vector<NameToDIE> namespace_index(num_compile_units);
+        std::vector<NameToDIE> file_basename_index(num_compile_units);
         
         auto parser_fn = [this,
                           debug_info,
@@ -2144,10 +2352,11 @@ SymbolFileDWARF::Index ()
                           &objc_class_selectors_index,
                           &global_index,
                           &type_index,
-                          &namespace_index](uint32_t cu_idx)
+                          &namespace_index,
+                          &file_basename_index](size_t cu_idx)
         {
             DWARFCompileUnit* dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
-            bool clear_dies = dwarf_cu->ExtractDIEsIfNeeded(false) > 1;
+            dwarf_cu->AcquireTransientDIEs();
 
             dwarf_cu->Index(function_basename_index[cu_idx],
                             function_fullname_index[cu_idx],
@@ -2158,44 +2367,23 @@ SymbolFileDWARF::Index ()
                             type_index[cu_idx],
                             namespace_index[cu_idx]);
 
-            // Keep memory down by clearing DIEs if this generate function
-            // caused them to be parsed
-            if (clear_dies)
-                dwarf_cu->ClearDIEs(true);
+            IndexCompileUnitFiles(dwarf_cu, file_basename_index[cu_idx]);
 
-            return cu_idx;
+            dwarf_cu->ReleaseTransientDIEs();
         };
 
-        TaskRunner<uint32_t> task_runner;
-        for (uint32_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx)
-            task_runner.AddTask(parser_fn, cu_idx);
-
-        while (true)
-        {
-            std::future<uint32_t> f = task_runner.WaitForNextCompletedTask();
-            if (!f.valid())
-                break;
-            uint32_t cu_idx = f.get();
-
-            m_function_basename_index.Append(function_basename_index[cu_idx]);
-            m_function_fullname_index.Append(function_fullname_index[cu_idx]);
-            m_function_method_index.Append(function_method_index[cu_idx]);
-            m_function_selector_index.Append(function_selector_index[cu_idx]);
-            m_objc_class_selectors_index.Append(objc_class_selectors_index[cu_idx]);
-            m_global_index.Append(global_index[cu_idx]);
-            m_type_index.Append(type_index[cu_idx]);
-            m_namespace_index.Append(namespace_index[cu_idx]);
-        }
+        TaskPool::ParallelFor(0, num_compile_units, parser_fn);
 
         TaskPool::RunTasks(
-            [&]() { m_function_basename_index.Finalize(); },
-            [&]() { m_function_fullname_index.Finalize(); },
-            [&]() { m_function_method_index.Finalize(); },
-            [&]() { m_function_selector_index.Finalize(); },
-            [&]() { m_objc_class_selectors_index.Finalize(); },
-            [&]() { m_global_index.Finalize(); },
-            [&]() { m_type_index.Finalize(); },
-            [&]() { m_namespace_index.Finalize(); });
+            [&]() { m_function_basename_index.Merge(function_basename_index); },
+            [&]() { m_function_fullname_index.Merge(function_fullname_index); },
+            [&]() { m_function_method_index.Merge(function_method_index); },
+            [&]() { m_function_selector_index.Merge(function_selector_index); },
+            [&]() { m_objc_class_selectors_index.Merge(objc_class_selectors_index); },
+            [&]() { m_global_index.Merge(global_index); },
+            [&]() { m_type_index.Merge(type_index); },
+            [&]() { m_namespace_index.Merge(namespace_index); },
+            [&]() { m_file_basename_index.Merge(file_basename_index); });
 
 #if defined (ENABLE_DEBUG_PRINTF)
         StreamFile s(stdout, false);
@@ -2209,8 +2397,183 @@ SymbolFileDWARF::Index ()
         s.Printf("\nGlobals and statics:\n");   m_global_index.Dump (&s); 
         s.Printf("\nTypes:\n");                 m_type_index.Dump (&s);
         s.Printf("\nNamespaces:\n")             m_namespace_index.Dump (&s);
+        s.Printf("\nFile base names:\n");       m_file_basename_index.Dump (&s);
 #endif
+
+        SaveIndexCache();
+    }
+}
+
+void
+SymbolFileDWARF::IndexCompileUnitFiles (DWARFCompileUnit *dwarf_cu, NameToDIE &file_basename_index)
+{
+    const DWARFDIE cu_die = dwarf_cu->GetCompileUnitDIEOnly();
+    if (!cu_die)
+        return;
+
+    // The compile unit file and the files of its line table, which are
+    // the files that can have line entries in this compile unit.
+    std::vector<const char *> basenames;
+    const char *cu_name = cu_die.GetName();
+    if (cu_name && cu_name[0])
+        basenames.push_back (FileSpec(cu_name, false).GetFilename().GetCString());
+
+    const dw_offset_t stmt_list = cu_die.GetAttributeValueAsUnsigned(DW_AT_stmt_list, DW_INVALID_OFFSET);
+    if (stmt_list != DW_INVALID_OFFSET)
+    {
+        DWARFDebugLine::Prologue prologue;
+        lldb::offset_t offset = stmt_list;
+        if (DWARFDebugLine::ParsePrologue (get_debug_line_data(), &offset, &prologue))
+        {
+            for (const DWARFDebugLine::FileNameEntry &file_entry : prologue.file_names)
+                basenames.push_back (FileSpec(file_entry.name, false).GetFilename().GetCString());
+        }
     }
+
+    // Headers are usually listed more than once, keep one entry per name.
+    std::sort (basenames.begin(), basenames.end());
+    basenames.erase (std::unique (basenames.begin(), basenames.end()), basenames.end());
+
+    const DIERef cu_ref (dwarf_cu->GetOffset(), cu_die.GetOffset());
+    for (const char *basename : basenames)
+    {
+        if (basename)
+            file_basename_index.Insert (ConstString(basename), cu_ref);
+    }
+}
+
+bool
+SymbolFileDWARF::FindCompileUnitsForFile (const FileSpec &file_spec, std::vector<uint32_t> &cu_indexes)
+{
+    cu_indexes.clear();
+
+    // The index is only built when there are no accelerator tables, and it
+    // compares base names exactly.
+    if (m_using_apple_tables || !file_spec.GetFilename() || !file_spec.IsCaseSensitive())
+        return false;
+
+    if (!m_indexed)
+        Index ();
+
+    DWARFDebugInfo* debug_info = DebugInfo();
+    if (debug_info == NULL)
+        return false;
+
+    DIEArray cu_refs;
+    m_file_basename_index.Find (file_spec.GetFilename(), cu_refs);
+    for (const DIERef &cu_ref : cu_refs)
+    {
+        uint32_t cu_idx = UINT32_MAX;
+        if (debug_info->GetCompileUnit (cu_ref.cu_offset, &cu_idx) && cu_idx != UINT32_MAX)
+            cu_indexes.push_back (cu_idx);
+    }
+
+    // Keep the compile unit order, the first match wins when inlined
+    // functions aren't searched.
+    std::sort (cu_indexes.begin(), cu_indexes.end());
+    cu_indexes.erase (std::unique (cu_indexes.begin(), cu_indexes.end()), cu_indexes.end());
+    return true;
+}
+
+// Returns the index cache to use for this symbol file along with the
+// key for this symbol file in the cache, or nullptr if the manual index
+// for this symbol file shouldn't be cached.
+static std::unique_ptr<IndexCache>
+GetIndexCache (ObjectFile *obj_file, UUID &uuid, TimeValue &mod_time)
+{
+    TargetPropertiesSP properties_sp (Target::GetGlobalProperties());
+    if (obj_file == nullptr || !properties_sp || !properties_sp->GetUseIndexCache())
+        return nullptr;
+
+    const FileSpec cache_dir (properties_sp->GetIndexCacheDirectory());
+    if (!cache_dir || !obj_file->GetUUID(&uuid) || !uuid.IsValid())
+        return nullptr;
+
+    mod_time = obj_file->GetFileSpec().GetModificationTime();
+    if (!mod_time.IsValid())
+        return nullptr;
+
+    return std::unique_ptr<IndexCache>(new IndexCache(cache_dir, properties_sp->GetIndexCacheMaxByteSize(), ".dwarf-index", 2));
+}
+
+bool
+SymbolFileDWARF::LoadIndexCache ()
+{
+    UUID uuid;
+    TimeValue mod_time;
+    std::unique_ptr<IndexCache> index_cache (GetIndexCache (m_obj_file, uuid, mod_time));
+    if (!index_cache)
+        return false;
+
+    Timer scoped_timer (__PRETTY_FUNCTION__,
+                        "SymbolFileDWARF::LoadIndexCache (%s)",
+                        m_obj_file->GetFileSpec().GetFilename().AsCString("<Unknown>"));
+
+    DataExtractor data;
+    if (!index_cache->Read (uuid, m_obj_file->GetFileSpec(), mod_time, data))
+        return false;
+
+    NameToDIE *indexes[] = { &m_function_basename_index, &m_function_fullname_index,
+                             &m_function_method_index, &m_function_selector_index,
+                             &m_objc_class_selectors_index, &m_global_index,
+                             &m_type_index, &m_namespace_index,
+                             &m_file_basename_index };
+
+    lldb::offset_t offset = 0;
+    for (NameToDIE *index : indexes)
+    {
+        if (!index->Decode (data, &offset))
+        {
+            Log *log (LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_INFO));
+            if (log)
+                GetObjectFile()->GetModule()->LogMessage (log, "Ignoring corrupt DWARF index cache");
+            for (NameToDIE *clear_index : indexes)
+                *clear_index = NameToDIE();
+            return false;
+        }
+    }
+
+    TaskPool::RunTasks(
+        [&]() { m_function_basename_index.Finalize(); },
+        [&]() { m_function_fullname_index.Finalize(); },
+        [&]() { m_function_method_index.Finalize(); },
+        [&]() { m_function_selector_index.Finalize(); },
+        [&]() { m_objc_class_selectors_index.Finalize(); },
+        [&]() { m_global_index.Finalize(); },
+        [&]() { m_type_index.Finalize(); },
+        [&]() { m_namespace_index.Finalize(); },
+        [&]() { m_file_basename_index.Finalize(); });
+    return true;
+}
+
+void
+SymbolFileDWARF::SaveIndexCache ()
+{
+    UUID uuid;
+    TimeValue mod_time;
+    std::unique_ptr<IndexCache> index_cache (GetIndexCache (m_obj_file, uuid, mod_time));
+    if (!index_cache)
+        return;
+
+    Timer scoped_timer (__PRETTY_FUNCTION__,
+                        "SymbolFileDWARF::SaveIndexCache (%s)",
+                        m_obj_file->GetFileSpec().GetFilename().AsCString("<Unknown>"));
+
+    StreamString strm (Stream::eBinary, 4, eByteOrderLittle);
+    m_function_basename_index.Encode (strm);
+    m_function_fullname_index.Encode (strm);
+    m_function_method_index.Encode (strm);
+    m_function_selector_index.Encode (strm);
+    m_objc_class_selectors_index.Encode (strm);
+    m_global_index.Encode (strm);
+    m_type_index.Encode (strm);
+    m_namespace_index.Encode (strm);
+    m_file_basename_index.Encode (strm);
+
+    Error error (index_cache->Write (uuid, m_obj_file->GetFileSpec(), mod_time, strm.GetData(), strm.GetSize()));
+    Log *log (LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_INFO));
+    if (log && error.Fail())
+        GetObjectFile()->GetModule()->LogMessage (log, "Failed to write DWARF index cache: %s", error.AsCString());
 }
 
 bool
@@ -4668,6 +5031,7 @@ SymbolFileDWARF::DumpIndexes ()
     s.Printf("\nGlobals and statics:\n");   m_global_index.Dump (&s); 
     s.Printf("\nTypes:\n");                 m_type_index.Dump (&s);
     s.Printf("\nNamespaces:\n");            m_namespace_index.Dump (&s);
+    s.Printf("\nFile base names:\n");       m_file_basename_index.Dump (&s);
 }
 
 
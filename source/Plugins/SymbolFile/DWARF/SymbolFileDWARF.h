@@ -93,6 +93,10 @@ public:
     static lldb_private::SymbolFile*
     CreateInstance (lldb_private::ObjectFile* obj_file);
 
+    // Memory budget for DIEs parsed with DWARFCompileUnit::AcquireTransientDIEs()
+    static uint64_t
+    GetDIECacheByteSize();
+
     //------------------------------------------------------------------
     // Constructors and Destructors
     //------------------------------------------------------------------
@@ -182,6 +186,10 @@ public:
                           uint32_t resolve_scope,
                           lldb_private::SymbolContextList& sc_list) override;
 
+    bool
+    FindCompileUnitsForFile (const lldb_private::FileSpec &file_spec,
+                             std::vector<uint32_t> &cu_indexes) override;
+
     uint32_t
     FindGlobalVariables (const lldb_private::ConstString &name,
                          const lldb_private::CompilerDeclContext *parent_decl_ctx,
@@ -370,6 +378,11 @@ protected:
     ParseCompileUnitFunction (const lldb_private::SymbolContext& sc,
                               const DWARFDIE &die);
 
+    bool
+    ParseLazyLineTable (dw_offset_t cu_line_offset,
+                        lldb::addr_t addr_mask,
+                        lldb_private::LineTable &line_table);
+
     size_t
     ParseFunctionBlocks (const lldb_private::SymbolContext& sc,
                          lldb_private::Block *parent_block,
@@ -462,6 +475,15 @@ protected:
 
     void
     Index();
+
+    void
+    IndexCompileUnitFiles (DWARFCompileUnit *dwarf_cu, NameToDIE &file_basename_index);
+
+    bool
+    LoadIndexCache();
+
+    void
+    SaveIndexCache();
     
     void
     DumpIndexes();
@@ -578,6 +600,7 @@ protected:
     NameToDIE                           m_global_index;             // Global and static variables
     NameToDIE                           m_type_index;               // All type DIE offsets
     NameToDIE                           m_namespace_index;          // All type DIE offsets
+    NameToDIE                           m_file_basename_index;      // Base names of the compile unit and line table files to compile unit DIE offsets
     bool                                m_indexed:1,
                                         m_using_apple_tables:1,
                                         m_fetched_external_modules:1;
@@ -18,12 +18,19 @@
 using namespace lldb;
 using namespace lldb_private;
 
+// The number of decoded sequences each lazily populated line table keeps.
+static const size_t k_max_decoded_sequences = 64;
+
 //----------------------------------------------------------------------
 // LineTable constructor
 //----------------------------------------------------------------------
 LineTable::LineTable(CompileUnit* comp_unit) :
     m_comp_unit(comp_unit),
-    m_entries()
+    m_entries(),
+    m_lazy_mutex(),
+    m_decoder_ap(),
+    m_lazy_sequences(),
+    m_decoded_sequences()
 {
 }
 
@@ -162,6 +169,58 @@ LineTable::InsertSequence (LineSequence* sequence)
     m_entries.insert(pos, seq->m_entries.begin(), seq->m_entries.end());
 }
 
+void
+LineTable::AddLazySequence (lldb::addr_t low_addr, lldb::addr_t high_addr, lldb::offset_t cookie)
+{
+    if (low_addr >= high_addr)
+        return;
+    LazySequence lazy_sequence;
+    lazy_sequence.low_addr = low_addr;
+    lazy_sequence.high_addr = high_addr;
+    lazy_sequence.max_high_addr = high_addr;
+    lazy_sequence.cookie = cookie;
+    m_lazy_sequences.push_back(lazy_sequence);
+}
+
+void
+LineTable::SetSequenceDecoder (std::unique_ptr<SequenceDecoder> &&decoder_ap)
+{
+    std::lock_guard<std::mutex> guard(m_lazy_mutex);
+    m_decoder_ap = std::move(decoder_ap);
+    m_decoded_sequences.clear();
+
+    // Sequences can overlap, for example the ones of functions that the
+    // linker dead stripped, so remember the highest end address seen so far
+    // to know when to stop looking backwards for a sequence that contains
+    // an address.
+    std::stable_sort(m_lazy_sequences.begin(), m_lazy_sequences.end(), LazySequence::LowAddressLessThan);
+    lldb::addr_t max_high_addr = 0;
+    for (LazySequence &lazy_sequence : m_lazy_sequences)
+    {
+        max_high_addr = std::max(max_high_addr, lazy_sequence.high_addr);
+        lazy_sequence.max_high_addr = max_high_addr;
+    }
+}
+
+void
+LineTable::DecodeAllSequences ()
+{
+    std::lock_guard<std::mutex> guard(m_lazy_mutex);
+    if (!m_decoder_ap)
+        return;
+
+    LineSequenceImpl sequence;
+    for (const LazySequence &lazy_sequence : m_lazy_sequences)
+    {
+        if (m_decoder_ap->DecodeSequence(*this, lazy_sequence.cookie, &sequence))
+            InsertSequence(&sequence);
+        sequence.Clear();
+    }
+    m_decoder_ap.reset();
+    m_lazy_sequences.clear();
+    m_decoded_sequences.clear();
+}
+
 //----------------------------------------------------------------------
 LineTable::Entry::LessThanBinaryPredicate::LessThanBinaryPredicate(LineTable *line_table) :
     m_line_table (line_table)
@@ -190,14 +249,16 @@ LineTable::Entry::LessThanBinaryPredicate::operator() (const LineTable::Entry& a
 
 
 uint32_t
-LineTable::GetSize() const
+LineTable::GetSize()
 {
+    DecodeAllSequences();
     return m_entries.size();
 }
 
 bool
 LineTable::GetLineEntryAtIndex(uint32_t idx, LineEntry& line_entry)
 {
+    DecodeAllSequences();
     if (idx < m_entries.size())
     {
         ConvertEntryAtIndexToLineEntry (idx, line_entry);
@@ -217,98 +278,188 @@ LineTable::FindLineEntryByAddress (const Address &so_addr, LineEntry& line_entry
 
     if (so_addr.GetModule().get() == m_comp_unit->GetModule().get())
     {
-        Entry search_entry;
-        search_entry.file_addr = so_addr.GetFileAddress();
-        if (search_entry.file_addr != LLDB_INVALID_ADDRESS)
+        const lldb::addr_t file_addr = so_addr.GetFileAddress();
+        if (file_addr != LLDB_INVALID_ADDRESS)
+        {
+            // Lazily populated line tables only decode the sequence that contains
+            // the address unless the caller wants the index of the entry.
+            if (index_ptr == nullptr && FindLazyLineEntryByFileAddress(file_addr, line_entry, success))
+                return success;
+
+            DecodeAllSequences();
+            const uint32_t match_idx = FindEntryIndexByFileAddress(m_entries, file_addr);
+            if (match_idx != UINT32_MAX)
+            {
+                success = ConvertEntryAtIndexToLineEntry(match_idx, line_entry);
+                if (index_ptr != nullptr && success)
+                    *index_ptr = match_idx;
+            }
+        }
+    }
+    return success;
+}
+
+uint32_t
+LineTable::FindEntryIndexByFileAddress (const entry_collection &entries, lldb::addr_t file_addr)
+{
+    Entry search_entry;
+    search_entry.file_addr = file_addr;
+    entry_collection::const_iterator begin_pos = entries.begin();
+    entry_collection::const_iterator end_pos = entries.end();
+    entry_collection::const_iterator pos = lower_bound(begin_pos, end_pos, search_entry, Entry::EntryAddressLessThan);
+    if (pos != end_pos)
+    {
+        if (pos != begin_pos)
         {
-            entry_collection::const_iterator begin_pos = m_entries.begin();
-            entry_collection::const_iterator end_pos = m_entries.end();
-            entry_collection::const_iterator pos = lower_bound(begin_pos, end_pos, search_entry, Entry::EntryAddressLessThan);
-            if (pos != end_pos)
+            if (pos->file_addr != search_entry.file_addr)
+                --pos;
+            else if (pos->file_addr == search_entry.file_addr)
             {
-                if (pos != begin_pos)
+                // If this is a termination entry, it shouldn't match since
+                // entries with the "is_terminal_entry" member set to true 
+                // are termination entries that define the range for the 
+                // previous entry.
+                if (pos->is_terminal_entry)
                 {
-                    if (pos->file_addr != search_entry.file_addr)
-                        --pos;
-                    else if (pos->file_addr == search_entry.file_addr)
+                    // The matching entry is a terminal entry, so we skip
+                    // ahead to the next entry to see if there is another
+                    // entry following this one whose section/offset matches.
+                    ++pos;
+                    if (pos != end_pos)
                     {
-                        // If this is a termination entry, it shouldn't match since
-                        // entries with the "is_terminal_entry" member set to true 
-                        // are termination entries that define the range for the 
-                        // previous entry.
-                        if (pos->is_terminal_entry)
-                        {
-                            // The matching entry is a terminal entry, so we skip
-                            // ahead to the next entry to see if there is another
-                            // entry following this one whose section/offset matches.
-                            ++pos;
-                            if (pos != end_pos)
-                            {
-                                if (pos->file_addr != search_entry.file_addr)
-                                    pos = end_pos;
-                            }
-                        }
-                        
-                        if (pos != end_pos)
-                        {
-                            // While in the same section/offset backup to find the first
-                            // line entry that matches the address in case there are 
-                            // multiple
-                            while (pos != begin_pos)
-                            {
-                                entry_collection::const_iterator prev_pos = pos - 1;
-                                if (prev_pos->file_addr == search_entry.file_addr &&
-                                    prev_pos->is_terminal_entry == false)
-                                    --pos;
-                                else
-                                    break;
-                            }
-                        }
+                        if (pos->file_addr != search_entry.file_addr)
+                            pos = end_pos;
                     }
-
                 }
                 
-                // Make sure we have a valid match and that the match isn't a terminating
-                // entry for a previous line...
-                if (pos != end_pos && pos->is_terminal_entry == false)
+                if (pos != end_pos)
                 {
-                    uint32_t match_idx = std::distance (begin_pos, pos);
-                    success = ConvertEntryAtIndexToLineEntry(match_idx, line_entry);
-                    if (index_ptr != nullptr && success)
-                        *index_ptr = match_idx;
+                    // While in the same section/offset backup to find the first
+                    // line entry that matches the address in case there are 
+                    // multiple
+                    while (pos != begin_pos)
+                    {
+                        entry_collection::const_iterator prev_pos = pos - 1;
+                        if (prev_pos->file_addr == search_entry.file_addr &&
+                            prev_pos->is_terminal_entry == false)
+                            --pos;
+                        else
+                            break;
+                    }
                 }
             }
+
         }
     }
-    return success;
-}
 
+    // Make sure we have a valid match and that the match isn't a terminating
+    // entry for a previous line...
+    if (pos != end_pos && pos->is_terminal_entry == false)
+        return std::distance (begin_pos, pos);
+    return UINT32_MAX;
+}
 
 bool
-LineTable::ConvertEntryAtIndexToLineEntry (uint32_t idx, LineEntry &line_entry)
+LineTable::FindLazyLineEntryByFileAddress (lldb::addr_t file_addr, LineEntry &line_entry, bool &success)
 {
-    if (idx < m_entries.size())
+    Entry entry;
+    Entry next_entry;
+    bool has_next_entry = false;
     {
-        const Entry& entry = m_entries[idx];
-        ModuleSP module_sp (m_comp_unit->GetModule());
-        if (module_sp && module_sp->ResolveFileAddress(entry.file_addr, line_entry.range.GetBaseAddress()))
+        std::lock_guard<std::mutex> guard(m_lazy_mutex);
+        if (!m_decoder_ap)
+            return false;
+
+        success = false;
+
+        // Find the sequence with the highest start address that contains file_addr.
+        LazySequence search_sequence;
+        search_sequence.low_addr = file_addr;
+        search_sequence.high_addr = LLDB_INVALID_ADDRESS;
+        lazy_sequence_collection::const_iterator begin_pos = m_lazy_sequences.begin();
+        lazy_sequence_collection::const_iterator end_pos = m_lazy_sequences.end();
+        lazy_sequence_collection::const_iterator pos = upper_bound(begin_pos, end_pos, search_sequence, LazySequence::LowAddressLessThan);
+        uint32_t sequence_idx = UINT32_MAX;
+        while (pos != begin_pos)
+        {
+            --pos;
+            if (pos->max_high_addr <= file_addr)
+                break;
+            if (file_addr < pos->high_addr)
+            {
+                sequence_idx = std::distance (begin_pos, pos);
+                break;
+            }
+        }
+        if (sequence_idx == UINT32_MAX)
+            return true;
+
+        decoded_sequence_collection::iterator decoded_pos = m_decoded_sequences.begin();
+        const decoded_sequence_collection::iterator decoded_end = m_decoded_sequences.end();
+        while (decoded_pos != decoded_end && decoded_pos->first != sequence_idx)
+            ++decoded_pos;
+        if (decoded_pos != decoded_end)
+        {
+            m_decoded_sequences.splice(m_decoded_sequences.begin(), m_decoded_sequences, decoded_pos);
+        }
+        else
         {
-            if (!entry.is_terminal_entry && idx + 1 < m_entries.size())
-                line_entry.range.SetByteSize(m_entries[idx+1].file_addr - entry.file_addr);
-            else
-                line_entry.range.SetByteSize(0);
-
-            line_entry.file = m_comp_unit->GetSupportFiles().GetFileSpecAtIndex (entry.file_idx);
-            line_entry.line = entry.line;
-            line_entry.column = entry.column;
-            line_entry.is_start_of_statement = entry.is_start_of_statement;
-            line_entry.is_start_of_basic_block = entry.is_start_of_basic_block;
-            line_entry.is_prologue_end = entry.is_prologue_end;
-            line_entry.is_epilogue_begin = entry.is_epilogue_begin;
-            line_entry.is_terminal_entry = entry.is_terminal_entry;
+            LineSequenceImpl sequence;
+            if (!m_decoder_ap->DecodeSequence(*this, m_lazy_sequences[sequence_idx].cookie, &sequence))
+                sequence.Clear();
+            m_decoded_sequences.push_front(std::make_pair(sequence_idx, std::move(sequence.m_entries)));
+            if (m_decoded_sequences.size() > k_max_decoded_sequences)
+                m_decoded_sequences.pop_back();
+        }
+
+        const entry_collection &entries = m_decoded_sequences.front().second;
+        const uint32_t match_idx = FindEntryIndexByFileAddress(entries, file_addr);
+        if (match_idx == UINT32_MAX)
             return true;
+        entry = entries[match_idx];
+        if (match_idx + 1 < entries.size())
+        {
+            next_entry = entries[match_idx + 1];
+            has_next_entry = true;
         }
     }
+
+    // Resolving the address and the file can take other locks, do it once
+    // the entries were copied out of the cache.
+    success = ConvertEntryToLineEntry(entry, has_next_entry ? &next_entry : nullptr, line_entry);
+    return true;
+}
+
+
+bool
+LineTable::ConvertEntryAtIndexToLineEntry (uint32_t idx, LineEntry &line_entry)
+{
+    if (idx < m_entries.size())
+        return ConvertEntryToLineEntry (m_entries[idx], idx + 1 < m_entries.size() ? &m_entries[idx + 1] : nullptr, line_entry);
+    return false;
+}
+
+bool
+LineTable::ConvertEntryToLineEntry (const Entry &entry, const Entry *next_entry, LineEntry &line_entry)
+{
+    ModuleSP module_sp (m_comp_unit->GetModule());
+    if (module_sp && module_sp->ResolveFileAddress(entry.file_addr, line_entry.range.GetBaseAddress()))
+    {
+        if (!entry.is_terminal_entry && next_entry != nullptr)
+            line_entry.range.SetByteSize(next_entry->file_addr - entry.file_addr);
+        else
+            line_entry.range.SetByteSize(0);
+
+        line_entry.file = m_comp_unit->GetSupportFiles().GetFileSpecAtIndex (entry.file_idx);
+        line_entry.line = entry.line;
+        line_entry.column = entry.column;
+        line_entry.is_start_of_statement = entry.is_start_of_statement;
+        line_entry.is_start_of_basic_block = entry.is_start_of_basic_block;
+        line_entry.is_prologue_end = entry.is_prologue_end;
+        line_entry.is_epilogue_begin = entry.is_epilogue_begin;
+        line_entry.is_terminal_entry = entry.is_terminal_entry;
+        return true;
+    }
     return false;
 }
 
@@ -323,6 +474,7 @@ LineTable::FindLineEntryIndexByFileIndex
 )
 {
 
+    DecodeAllSequences();
     const size_t count = m_entries.size();
     std::vector<uint32_t>::const_iterator begin_pos = file_indexes.begin();
     std::vector<uint32_t>::const_iterator end_pos = file_indexes.end();
@@ -373,6 +525,7 @@ LineTable::FindLineEntryIndexByFileIndex
 uint32_t
 LineTable::FindLineEntryIndexByFileIndex (uint32_t start_idx, uint32_t file_idx, uint32_t line, bool exact, LineEntry* line_entry_ptr)
 {
+    DecodeAllSequences();
     const size_t count = m_entries.size();
     size_t best_match = UINT32_MAX;
 
@@ -428,6 +581,7 @@ LineTable::FineLineEntriesForFileIndex (uint32_t file_idx,
         sc_list.Clear();
 
     size_t num_added = 0;
+    DecodeAllSequences();
     const size_t count = m_entries.size();
     if (count > 0)
     {
@@ -456,6 +610,7 @@ LineTable::FineLineEntriesForFileIndex (uint32_t file_idx,
 void
 LineTable::Dump (Stream *s, Target *target, Address::DumpStyle style, Address::DumpStyle fallback_style, bool show_line_ranges)
 {
+    DecodeAllSequences();
     const size_t count = m_entries.size();
     LineEntry line_entry;
     FileSpec prev_file;
@@ -472,6 +627,7 @@ LineTable::Dump (Stream *s, Target *target, Address::DumpStyle style, Address::D
 void
 LineTable::GetDescription (Stream *s, Target *target, DescriptionLevel level)
 {
+    DecodeAllSequences();
     const size_t count = m_entries.size();
     LineEntry line_entry;
     for (size_t idx = 0; idx < count; ++idx)
@@ -488,7 +644,18 @@ LineTable::GetContiguousFileAddressRanges (FileAddressRanges &file_ranges, bool
     if (!append)
         file_ranges.Clear();
     const size_t initial_count = file_ranges.GetSize();
-    
+
+    {
+        // Every sequence of a lazily populated line table is one contiguous range.
+        std::lock_guard<std::mutex> guard(m_lazy_mutex);
+        if (m_decoder_ap)
+        {
+            for (const LazySequence &lazy_sequence : m_lazy_sequences)
+                file_ranges.Append(FileAddressRanges::Entry(lazy_sequence.low_addr, lazy_sequence.high_addr - lazy_sequence.low_addr));
+            return file_ranges.GetSize() - initial_count;
+        }
+    }
+
     const size_t count = m_entries.size();
     LineEntry line_entry;
     FileAddressRanges::Entry range (LLDB_INVALID_ADDRESS, 0);
@@ -518,6 +685,7 @@ LineTable::LinkLineTable (const FileRangeMap &file_range_map)
 {
     std::unique_ptr<LineTable> line_table_ap (new LineTable (m_comp_unit));
     LineSequenceImpl sequence;
+    DecodeAllSequences();
     const size_t count = m_entries.size();
     LineEntry line_entry;
     const FileRangeMap::Entry *file_range_entry = nullptr;
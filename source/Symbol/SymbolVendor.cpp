@@ -304,6 +304,19 @@ SymbolVendor::ResolveSymbolContext (const FileSpec& file_spec, uint32_t line, bo
     return 0;
 }
 
+bool
+SymbolVendor::FindCompileUnitsForFile (const FileSpec &file_spec, std::vector<uint32_t> &cu_indexes)
+{
+    ModuleSP module_sp(GetModule());
+    if (module_sp)
+    {
+        lldb_private::Mutex::Locker locker(module_sp->GetMutex());
+        if (m_sym_file_ap.get())
+            return m_sym_file_ap->FindCompileUnitsForFile(file_spec, cu_indexes);
+    }
+    return false;
+}
+
 size_t
 SymbolVendor::FindGlobalVariables (const ConstString &name, const CompilerDeclContext *parent_decl_ctx, bool append, size_t max_matches, VariableList& variables)
 {
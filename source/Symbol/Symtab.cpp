@@ -10,15 +10,24 @@
 #include <map>
 #include <set>
 
+#include "llvm/ADT/DenseMap.h"
+
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/IndexCache.h"
+#include "lldb/Core/Log.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/RegularExpression.h"
 #include "lldb/Core/Section.h"
 #include "lldb/Core/Stream.h"
+#include "lldb/Core/StreamString.h"
 #include "lldb/Core/Timer.h"
+#include "lldb/Core/UUID.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/Symbol.h"
 #include "lldb/Symbol/SymbolContext.h"
 #include "lldb/Symbol/Symtab.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Utility/TaskPool.h"
 #include "Plugins/Language/ObjC/ObjCLanguage.h"
 #include "Plugins/Language/CPlusPlus/CPlusPlusLanguage.h"
 
@@ -34,7 +43,8 @@ Symtab::Symtab(ObjectFile *objfile) :
     m_name_to_index (),
     m_mutex (Mutex::eMutexTypeRecursive),
     m_file_addr_to_index_computed (false),
-    m_name_indexes_computed (false)
+    m_name_indexes_computed (false),
+    m_index_cache_checked (false)
 {
 }
 
@@ -259,210 +269,594 @@ Symtab::SymbolAtIndex(size_t idx) const
 //----------------------------------------------------------------------
 // InitNameIndexes
 //----------------------------------------------------------------------
-void
-Symtab::InitNameIndexes()
+
+// The name index entries computed for a slice of the symbol table
+struct Symtab::NameIndexSlice
 {
-    // Protected function, no need to lock mutex...
-    if (!m_name_indexes_computed)
-    {
-        m_name_indexes_computed = true;
-        Timer scoped_timer (__PRETTY_FUNCTION__, "%s", __PRETTY_FUNCTION__);
-        // Create the name index vector to be able to quickly search by name
-        const size_t num_symbols = m_symbols.size();
-#if 1
-        m_name_to_index.Reserve (num_symbols);
-#else
-        // TODO: benchmark this to see if we save any memory. Otherwise we
-        // will always keep the memory reserved in the vector unless we pull
-        // some STL swap magic and then recopy...
-        uint32_t actual_count = 0;
-        for (const_iterator pos = m_symbols.begin(), end = m_symbols.end();
-             pos != end; 
-             ++pos)
-        {
-            const Mangled &mangled = pos->GetMangled();
-            if (mangled.GetMangledName())
-                ++actual_count;
-            
-            if (mangled.GetDemangledName())
-                ++actual_count;
-        }
+    NameToIndexMap name_to_index;
+    NameToIndexMap basename_to_index;
+    NameToIndexMap method_to_index;
+    NameToIndexMap selector_to_index;
+    // Entries with a context that isn't known to be a class yet
+    NameToIndexMap mangled_name_to_index;
+    // The "const char *" in "class_contexts" must come from a ConstString::GetCString()
+    std::set<const char *> class_contexts;
+};
 
-        m_name_to_index.Reserve (actual_count);
-#endif
+namespace
+{
+    // Symbols are indexed in slices of this size in parallel. Indexing is
+    // dominated by demangling, so a slice is large enough to make the
+    // cost of merging the slices negligible.
+    const size_t kSymbolsPerSlice = 16384;
 
-        NameToIndexMap::Entry entry;
+    void
+    AppendNameIndexEntries (Symtab::NameToIndexMap &map, const Symtab::NameToIndexMap &slice_map)
+    {
+        const Symtab::NameToIndexMap::Entry *entries = slice_map.GetEntries();
+        const size_t count = slice_map.GetSize();
+        for (size_t i = 0; i < count; ++i)
+            map.Append (entries[i]);
+    }
+}
 
-        // The "const char *" in "class_contexts" must come from a ConstString::GetCString()
-        std::set<const char *> class_contexts;
-        UniqueCStringMap<uint32_t> mangled_name_to_index;
-        std::vector<const char *> symbol_contexts(num_symbols, nullptr);
+void
+Symtab::IndexSymbolNames (size_t start_idx,
+                          size_t end_idx,
+                          NameIndexSlice &slice,
+                          std::vector<const char *> &symbol_contexts) const
+{
+    NameToIndexMap::Entry entry;
 
-        for (entry.value = 0; entry.value<num_symbols; ++entry.value)
+    for (entry.value = start_idx; entry.value<end_idx; ++entry.value)
+    {
+        const Symbol *symbol = &m_symbols[entry.value];
+
+        // Don't let trampolines get into the lookup by name map
+        // If we ever need the trampoline symbols to be searchable by name
+        // we can remove this and then possibly add a new bool to any of the
+        // Symtab functions that lookup symbols by name to indicate if they
+        // want trampolines.
+        if (symbol->IsTrampoline())
+            continue;
+
+        const Mangled &mangled = symbol->GetMangled();
+        entry.cstring = mangled.GetMangledName().GetCString();
+        if (entry.cstring && entry.cstring[0])
         {
-            const Symbol *symbol = &m_symbols[entry.value];
+            slice.name_to_index.Append (entry);
 
-            // Don't let trampolines get into the lookup by name map
-            // If we ever need the trampoline symbols to be searchable by name
-            // we can remove this and then possibly add a new bool to any of the
-            // Symtab functions that lookup symbols by name to indicate if they
-            // want trampolines.
-            if (symbol->IsTrampoline())
-                continue;
-
-            const Mangled &mangled = symbol->GetMangled();
-            entry.cstring = mangled.GetMangledName().GetCString();
-            if (entry.cstring && entry.cstring[0])
+            if (symbol->ContainsLinkerAnnotations()) {
+                // If the symbol has linker annotations, also add the version without the
+                // annotations.
+                entry.cstring = ConstString(m_objfile->StripLinkerSymbolAnnotations(entry.cstring)).GetCString();
+                slice.name_to_index.Append (entry);
+            }
+            
+            const SymbolType symbol_type = symbol->GetType();
+            if (symbol_type == eSymbolTypeCode || symbol_type == eSymbolTypeResolver)
             {
-                m_name_to_index.Append (entry);
-
-                if (symbol->ContainsLinkerAnnotations()) {
-                    // If the symbol has linker annotations, also add the version without the
-                    // annotations.
-                    entry.cstring = ConstString(m_objfile->StripLinkerSymbolAnnotations(entry.cstring)).GetCString();
-                    m_name_to_index.Append (entry);
-                }
-                
-                const SymbolType symbol_type = symbol->GetType();
-                if (symbol_type == eSymbolTypeCode || symbol_type == eSymbolTypeResolver)
+                if (entry.cstring[0] == '_' && entry.cstring[1] == 'Z' &&
+                    (entry.cstring[2] != 'T' && // avoid virtual table, VTT structure, typeinfo structure, and typeinfo name
+                     entry.cstring[2] != 'G' && // avoid guard variables
+                     entry.cstring[2] != 'Z'))  // named local entities (if we eventually handle eSymbolTypeData, we will want this back)
                 {
-                    if (entry.cstring[0] == '_' && entry.cstring[1] == 'Z' &&
-                        (entry.cstring[2] != 'T' && // avoid virtual table, VTT structure, typeinfo structure, and typeinfo name
-                         entry.cstring[2] != 'G' && // avoid guard variables
-                         entry.cstring[2] != 'Z'))  // named local entities (if we eventually handle eSymbolTypeData, we will want this back)
+                    CPlusPlusLanguage::MethodName cxx_method (mangled.GetDemangledName(lldb::eLanguageTypeC_plus_plus));
+                    entry.cstring = ConstString(cxx_method.GetBasename()).GetCString();
+                    if (entry.cstring && entry.cstring[0])
                     {
-                        CPlusPlusLanguage::MethodName cxx_method (mangled.GetDemangledName(lldb::eLanguageTypeC_plus_plus));
-                        entry.cstring = ConstString(cxx_method.GetBasename()).GetCString();
-                        if (entry.cstring && entry.cstring[0])
-                        {
-                            // ConstString objects permanently store the string in the pool so calling
-                            // GetCString() on the value gets us a const char * that will never go away
-                            const char *const_context = ConstString(cxx_method.GetContext()).GetCString();
+                        // ConstString objects permanently store the string in the pool so calling
+                        // GetCString() on the value gets us a const char * that will never go away
+                        const char *const_context = ConstString(cxx_method.GetContext()).GetCString();
 
-                            if (entry.cstring[0] == '~' || !cxx_method.GetQualifiers().empty())
-                            {
-                                // The first character of the demangled basename is '~' which
-                                // means we have a class destructor. We can use this information
-                                // to help us know what is a class and what isn't.
-                                if (class_contexts.find(const_context) == class_contexts.end())
-                                    class_contexts.insert(const_context);
-                                m_method_to_index.Append (entry);
-                            }
-                            else
+                        if (entry.cstring[0] == '~' || !cxx_method.GetQualifiers().empty())
+                        {
+                            // The first character of the demangled basename is '~' which
+                            // means we have a class destructor. We can use this information
+                            // to help us know what is a class and what isn't.
+                            if (slice.class_contexts.find(const_context) == slice.class_contexts.end())
+                                slice.class_contexts.insert(const_context);
+                            slice.method_to_index.Append (entry);
+                        }
+                        else
+                        {
+                            if (const_context && const_context[0])
                             {
-                                if (const_context && const_context[0])
+                                if (slice.class_contexts.find(const_context) != slice.class_contexts.end())
                                 {
-                                    if (class_contexts.find(const_context) != class_contexts.end())
-                                    {
-                                        // The current decl context is in our "class_contexts" which means
-                                        // this is a method on a class
-                                        m_method_to_index.Append (entry);
-                                    }
-                                    else
-                                    {
-                                        // We don't know if this is a function basename or a method,
-                                        // so put it into a temporary collection so once we are done
-                                        // we can look in class_contexts to see if each entry is a class
-                                        // or just a function and will put any remaining items into
-                                        // m_method_to_index or m_basename_to_index as needed
-                                        mangled_name_to_index.Append (entry);
-                                        symbol_contexts[entry.value] = const_context;
-                                    }
+                                    // The current decl context is in our "class_contexts" which means
+                                    // this is a method on a class
+                                    slice.method_to_index.Append (entry);
                                 }
                                 else
                                 {
-                                    // No context for this function so this has to be a basename
-                                    m_basename_to_index.Append(entry);
+                                    // We don't know if this is a function basename or a method,
+                                    // so put it into a temporary collection so once all slices
+                                    // are done we can look in the class contexts of all slices
+                                    // to see if each entry is a class or just a function and
+                                    // will put any remaining items into m_method_to_index or
+                                    // m_basename_to_index as needed
+                                    slice.mangled_name_to_index.Append (entry);
+                                    symbol_contexts[entry.value] = const_context;
                                 }
                             }
+                            else
+                            {
+                                // No context for this function so this has to be a basename
+                                slice.basename_to_index.Append(entry);
+                            }
                         }
                     }
                 }
             }
-            
-            entry.cstring = mangled.GetDemangledName(symbol->GetLanguage()).GetCString();
-            if (entry.cstring && entry.cstring[0]) {
-                m_name_to_index.Append (entry);
-
-                if (symbol->ContainsLinkerAnnotations()) {
-                    // If the symbol has linker annotations, also add the version without the
-                    // annotations.
-                    entry.cstring = ConstString(m_objfile->StripLinkerSymbolAnnotations(entry.cstring)).GetCString();
-                    m_name_to_index.Append (entry);
-                }
+        }
+        
+        entry.cstring = mangled.GetDemangledName(symbol->GetLanguage()).GetCString();
+        if (entry.cstring && entry.cstring[0]) {
+            slice.name_to_index.Append (entry);
+
+            if (symbol->ContainsLinkerAnnotations()) {
+                // If the symbol has linker annotations, also add the version without the
+                // annotations.
+                entry.cstring = ConstString(m_objfile->StripLinkerSymbolAnnotations(entry.cstring)).GetCString();
+                slice.name_to_index.Append (entry);
             }
-                
-            // If the demangled name turns out to be an ObjC name, and
-            // is a category name, add the version without categories to the index too.
-            ObjCLanguage::MethodName objc_method (entry.cstring, true);
-            if (objc_method.IsValid(true))
+        }
+            
+        // If the demangled name turns out to be an ObjC name, and
+        // is a category name, add the version without categories to the index too.
+        ObjCLanguage::MethodName objc_method (entry.cstring, true);
+        if (objc_method.IsValid(true))
+        {
+            entry.cstring = objc_method.GetSelector().GetCString();
+            slice.selector_to_index.Append (entry);
+            
+            ConstString objc_method_no_category (objc_method.GetFullNameWithoutCategory(true));
+            if (objc_method_no_category)
             {
-                entry.cstring = objc_method.GetSelector().GetCString();
-                m_selector_to_index.Append (entry);
-                
-                ConstString objc_method_no_category (objc_method.GetFullNameWithoutCategory(true));
-                if (objc_method_no_category)
-                {
-                    entry.cstring = objc_method_no_category.GetCString();
-                    m_name_to_index.Append (entry);
-                }
+                entry.cstring = objc_method_no_category.GetCString();
+                slice.name_to_index.Append (entry);
             }
-                                                        
         }
-        
-        size_t count;
-        if (!mangled_name_to_index.IsEmpty())
+    }
+}
+
+void
+Symtab::InitNameIndexes()
+{
+    // Protected function, no need to lock mutex...
+    if (!m_name_indexes_computed)
+    {
+        m_name_indexes_computed = true;
+        Timer scoped_timer (__PRETTY_FUNCTION__, "%s", __PRETTY_FUNCTION__);
+
+        // Only the first computation of the indexes goes through the index
+        // cache so symbols added later on don't make every debug session
+        // replace the cache file.
+        const bool use_index_cache = !m_index_cache_checked;
+        m_index_cache_checked = true;
+        if (use_index_cache && LoadIndexCache())
+            return;
+
+        // Create the name index vector to be able to quickly search by name.
+        // Demangling the names is the expensive part, so the symbols are
+        // indexed in slices on the task pool and the slices are merged in
+        // order.
+        const size_t num_symbols = m_symbols.size();
+        const size_t num_slices = std::max<size_t>(1, num_symbols / kSymbolsPerSlice);
+        std::vector<NameIndexSlice> slices (num_slices);
+        std::vector<const char *> symbol_contexts(num_symbols, nullptr);
+
+        TaskPool::ParallelFor (0, num_slices, [this, num_symbols, num_slices, &slices, &symbol_contexts](size_t slice_idx)
+        {
+            IndexSymbolNames (slice_idx * num_symbols / num_slices,
+                              (slice_idx + 1) * num_symbols / num_slices,
+                              slices[slice_idx],
+                              symbol_contexts);
+        });
+
+        std::set<const char *> class_contexts;
+        size_t num_names = 0;
+        for (const NameIndexSlice &slice : slices)
+        {
+            class_contexts.insert(slice.class_contexts.begin(), slice.class_contexts.end());
+            num_names += slice.name_to_index.GetSize();
+        }
+
+        m_name_to_index.Reserve (num_names);
+        for (const NameIndexSlice &slice : slices)
         {
-            count = mangled_name_to_index.GetSize();
+            AppendNameIndexEntries (m_name_to_index, slice.name_to_index);
+            AppendNameIndexEntries (m_basename_to_index, slice.basename_to_index);
+            AppendNameIndexEntries (m_method_to_index, slice.method_to_index);
+            AppendNameIndexEntries (m_selector_to_index, slice.selector_to_index);
+        }
+
+        for (const NameIndexSlice &slice : slices)
+        {
+            const NameToIndexMap::Entry *entries = slice.mangled_name_to_index.GetEntries();
+            const size_t count = slice.mangled_name_to_index.GetSize();
             for (size_t i=0; i<count; ++i)
             {
-                if (mangled_name_to_index.GetValueAtIndex(i, entry.value))
+                const NameToIndexMap::Entry &entry = entries[i];
+                if (class_contexts.find(symbol_contexts[entry.value]) != class_contexts.end())
                 {
-                    entry.cstring = mangled_name_to_index.GetCStringAtIndex(i);
-                    if (symbol_contexts[entry.value] && class_contexts.find(symbol_contexts[entry.value]) != class_contexts.end())
-                    {
-                        m_method_to_index.Append (entry);
-                    }
-                    else
-                    {
-                        // If we got here, we have something that had a context (was inside a namespace or class)
-                        // yet we don't know if the entry
-                        m_method_to_index.Append (entry);
-                        m_basename_to_index.Append (entry);
-                    }
+                    m_method_to_index.Append (entry);
+                }
+                else
+                {
+                    // If we got here, we have something that had a context (was inside a namespace or class)
+                    // yet we don't know if the entry
+                    m_method_to_index.Append (entry);
+                    m_basename_to_index.Append (entry);
                 }
             }
         }
-        m_name_to_index.Sort();
-        m_name_to_index.SizeToFit();
-        m_selector_to_index.Sort();
-        m_selector_to_index.SizeToFit();
-        m_basename_to_index.Sort();
-        m_basename_to_index.SizeToFit();
-        m_method_to_index.Sort();
-        m_method_to_index.SizeToFit();
-    
-//        static StreamFile a ("/tmp/a.txt");
+
+        TaskPool::RunTasks(
+            [&]() { m_name_to_index.Sort(); m_name_to_index.SizeToFit(); },
+            [&]() { m_selector_to_index.Sort(); m_selector_to_index.SizeToFit(); },
+            [&]() { m_basename_to_index.Sort(); m_basename_to_index.SizeToFit(); },
+            [&]() { m_method_to_index.Sort(); m_method_to_index.SizeToFit(); });
+
+        if (use_index_cache)
+            SaveIndexCache();
+    }
+}
+
+//----------------------------------------------------------------------
+// Index cache
+//
+// The cache payload holds the demangled names and the finalized name and
+// address indexes of the symbol table:
 //
-//        count = m_basename_to_index.GetSize();
-//        if (count)
-//        {
-//            for (size_t i=0; i<count; ++i)
-//            {
-//                if (m_basename_to_index.GetValueAtIndex(i, entry.value))
-//                    a.Printf ("%s BASENAME\n", m_symbols[entry.value].GetMangled().GetName().GetCString());
-//            }
-//        }
-//        count = m_method_to_index.GetSize();
-//        if (count)
-//        {
-//            for (size_t i=0; i<count; ++i)
-//            {
-//                if (m_method_to_index.GetValueAtIndex(i, entry.value))
-//                    a.Printf ("%s METHOD\n", m_symbols[entry.value].GetMangled().GetName().GetCString());
-//            }
-//        }
+//   num_symbols     U32
+//   symbols_hash    U64   hash of the names, types and addresses of the
+//                         symbols the indexes were computed from
+//   num_strings     U32   followed by NULL terminated strings
+//   num_demangled   U32   followed by (symbol index, string index) pairs
+//   name indexes    for each of the name, basename, method and selector
+//                   maps, a U32 count followed by (string index, symbol
+//                   index) pairs
+//   num_addresses   U32   followed by (base U64, size U64, symbol index
+//                         U32) entries of the address index
+//----------------------------------------------------------------------
+namespace
+{
+    const char *kSymtabIndexCacheExtension = ".symtab-index";
+    const uint32_t kSymtabIndexCacheVersion = 1;
+
+    // Returns the index cache to use for the symbol table of an object
+    // file along with the key for the object file in the cache, or nullptr
+    // if the symbol table indexes shouldn't be cached.
+    std::unique_ptr<IndexCache>
+    GetIndexCache (ObjectFile *objfile, UUID &uuid, TimeValue &mod_time)
+    {
+        TargetPropertiesSP properties_sp (Target::GetGlobalProperties());
+        if (objfile == nullptr || !properties_sp || !properties_sp->GetUseIndexCache())
+            return nullptr;
+
+        const FileSpec cache_dir (properties_sp->GetIndexCacheDirectory());
+        if (!cache_dir || !objfile->GetUUID(&uuid) || !uuid.IsValid())
+            return nullptr;
+
+        mod_time = objfile->GetFileSpec().GetModificationTime();
+        if (!mod_time.IsValid())
+            return nullptr;
+
+        return std::unique_ptr<IndexCache>(new IndexCache(cache_dir,
+                                                          properties_sp->GetIndexCacheMaxByteSize(),
+                                                          kSymtabIndexCacheExtension,
+                                                          kSymtabIndexCacheVersion));
     }
+
+    void
+    HashBytes (uint64_t &hash, const void *bytes, size_t length)
+    {
+        // 64 bit FNV-1a
+        const uint8_t *p = static_cast<const uint8_t *>(bytes);
+        for (size_t i = 0; i < length; ++i)
+        {
+            hash ^= p[i];
+            hash *= 0x100000001b3ULL;
+        }
+    }
+
+    class StringTableBuilder
+    {
+    public:
+        uint32_t
+        Add (const char *cstr)
+        {
+            auto pos = m_indexes.find(cstr);
+            if (pos != m_indexes.end())
+                return pos->second;
+            const uint32_t idx = m_strings.size();
+            m_indexes[cstr] = idx;
+            m_strings.push_back(cstr);
+            return idx;
+        }
+
+        void
+        Encode (Stream &strm) const
+        {
+            strm.PutHex32(m_strings.size());
+            for (const char *cstr : m_strings)
+                strm.Write(cstr, strlen(cstr) + 1);
+        }
+
+    private:
+        llvm::DenseMap<const char *, uint32_t> m_indexes;
+        std::vector<const char *> m_strings;
+    };
+
+    void
+    EncodeNameIndex (const Symtab::NameToIndexMap &map, StringTableBuilder &strings, Stream &strm)
+    {
+        const Symtab::NameToIndexMap::Entry *entries = map.GetEntries();
+        const size_t count = map.GetSize();
+        strm.PutHex32(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            strm.PutHex32(strings.Add(entries[i].cstring));
+            strm.PutHex32(entries[i].value);
+        }
+    }
+
+    bool
+    DecodeNameIndex (const DataExtractor &data,
+                     lldb::offset_t *offset_ptr,
+                     const std::vector<const char *> &strings,
+                     size_t num_symbols,
+                     Symtab::NameToIndexMap &map)
+    {
+        const uint32_t count = data.GetU32(offset_ptr);
+        // Each entry takes 8 bytes, make sure a corrupt count can't make us
+        // reserve or read past the end of the data.
+        if (!data.ValidOffsetForDataOfSize(*offset_ptr, count * 8ull))
+            return false;
+        map.Resize(count);
+        Symtab::NameToIndexMap::Entry *entries = map.GetEntries();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const uint32_t string_idx = data.GetU32(offset_ptr);
+            const uint32_t symbol_idx = data.GetU32(offset_ptr);
+            if (string_idx >= strings.size() || symbol_idx >= num_symbols)
+                return false;
+            entries[i].cstring = strings[string_idx];
+            entries[i].value = symbol_idx;
+        }
+        return true;
+    }
+}
+
+// Hash of the symbol properties the indexes depend on, so a cache entry
+// is only used for exactly the same symbols, even if the object file
+// parsing code changed between the debug sessions. Symbol sizes aren't
+// included as they can be synthesized after the indexes were computed.
+static uint64_t
+HashSymbols (const std::vector<Symbol> &symbols)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (const Symbol &symbol : symbols)
+    {
+        const Mangled &mangled = symbol.GetMangled();
+        // Only the mangled name of a symbol with a mangled name is looked at
+        // as getting its demangled name is what the cache is avoiding.
+        ConstString name (mangled.GetMangledName());
+        if (!name)
+            name = mangled.GetDemangledName(symbol.GetLanguage());
+        HashBytes(hash, name.GetCString() ? name.GetCString() : "", name.GetLength() + 1);
+
+        const uint32_t type = symbol.GetType();
+        HashBytes(hash, &type, sizeof(type));
+        const uint8_t flags = (symbol.ContainsLinkerAnnotations() ? 1 : 0) | (symbol.ValueIsAddress() ? 2 : 0);
+        HashBytes(hash, &flags, sizeof(flags));
+        if (symbol.ValueIsAddress())
+        {
+            const addr_t file_addr = symbol.GetAddressRef().GetFileAddress();
+            HashBytes(hash, &file_addr, sizeof(file_addr));
+        }
+    }
+    return hash;
+}
+
+bool
+Symtab::LoadIndexCache ()
+{
+    // Protected function, no need to lock mutex...
+    UUID uuid;
+    TimeValue mod_time;
+    std::unique_ptr<IndexCache> index_cache (GetIndexCache (m_objfile, uuid, mod_time));
+    if (!index_cache)
+        return false;
+
+    Timer scoped_timer (__PRETTY_FUNCTION__,
+                        "Symtab::LoadIndexCache (%s)",
+                        m_objfile->GetFileSpec().GetFilename().AsCString("<Unknown>"));
+
+    DataExtractor data;
+    if (!index_cache->Read (uuid, m_objfile->GetFileSpec(), mod_time, data))
+        return false;
+
+    Log *log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_SYMBOLS));
+    lldb::offset_t offset = 0;
+    const uint32_t num_symbols = data.GetU32(&offset);
+    const uint64_t symbols_hash = data.GetU64(&offset);
+    if (num_symbols != m_symbols.size() || symbols_hash != HashSymbols(m_symbols))
+    {
+        if (log)
+            m_objfile->GetModule()->LogMessage (log, "Ignoring symbol table index cache for different symbols");
+        return false;
+    }
+
+    // Find the strings first and add them to the string pool in parallel,
+    // this is the bulk of the work when loading the indexes.
+    const uint32_t num_strings = data.GetU32(&offset);
+    if (!data.ValidOffsetForDataOfSize(offset, num_strings))
+        return false;
+    std::vector<const char *> strings (num_strings, nullptr);
+    for (uint32_t i = 0; i < num_strings; ++i)
+    {
+        strings[i] = data.GetCStr(&offset);
+        if (strings[i] == nullptr)
+            return false;
+    }
+    TaskPool::ParallelFor (0, num_strings, [&strings](size_t idx)
+    {
+        strings[idx] = ConstString(strings[idx]).GetCString();
+    });
+
+    NameToIndexMap name_to_index;
+    NameToIndexMap basename_to_index;
+    NameToIndexMap method_to_index;
+    NameToIndexMap selector_to_index;
+    std::vector<std::pair<uint32_t, uint32_t>> demangled_names;
+
+    bool success = true;
+    const uint32_t num_demangled = data.GetU32(&offset);
+    if (data.ValidOffsetForDataOfSize(offset, num_demangled * 8ull))
+    {
+        demangled_names.resize(num_demangled);
+        for (auto &demangled : demangled_names)
+        {
+            demangled.first = data.GetU32(&offset);
+            demangled.second = data.GetU32(&offset);
+            if (demangled.first >= num_symbols || demangled.second >= num_strings)
+                success = false;
+        }
+    }
+    else
+        success = false;
+
+    success = success &&
+              DecodeNameIndex (data, &offset, strings, num_symbols, name_to_index) &&
+              DecodeNameIndex (data, &offset, strings, num_symbols, basename_to_index) &&
+              DecodeNameIndex (data, &offset, strings, num_symbols, method_to_index) &&
+              DecodeNameIndex (data, &offset, strings, num_symbols, selector_to_index);
+
+    FileRangeToIndexMap file_addr_to_index;
+    const uint32_t num_addresses = success ? data.GetU32(&offset) : 0;
+    if (success && !data.ValidOffsetForDataOfSize(offset, num_addresses * 20ull))
+        success = false;
+    for (uint32_t i = 0; success && i < num_addresses; ++i)
+    {
+        FileRangeToIndexMap::Entry entry;
+        entry.SetRangeBase(data.GetU64(&offset));
+        entry.SetByteSize(data.GetU64(&offset));
+        entry.data = data.GetU32(&offset);
+        if (entry.data >= num_symbols)
+            success = false;
+        file_addr_to_index.Append(entry);
+    }
+
+    if (!success)
+    {
+        if (log)
+            m_objfile->GetModule()->LogMessage (log, "Ignoring corrupt symbol table index cache");
+        return false;
+    }
+
+    // Restore the demangled names of the symbols along with the mangled
+    // counterparts in the string pool so nothing needs to be demangled.
+    for (const auto &demangled : demangled_names)
+    {
+        Mangled &mangled = m_symbols[demangled.first].GetMangled();
+        const char *demangled_cstr = strings[demangled.second];
+        ConstString demangled_name;
+        if (demangled_cstr[0] && mangled.GetMangledName())
+            demangled_name.SetCStringWithMangledCounterpart(demangled_cstr, mangled.GetMangledName());
+        else
+            demangled_name.SetCString(demangled_cstr);
+        mangled.SetDemangledName(demangled_name);
+    }
+
+    // The maps are sorted by string pointer which differ between debug
+    // sessions, so they need to be sorted again.
+    m_name_to_index = std::move(name_to_index);
+    m_basename_to_index = std::move(basename_to_index);
+    m_method_to_index = std::move(method_to_index);
+    m_selector_to_index = std::move(selector_to_index);
+    TaskPool::RunTasks(
+        [&]() { m_name_to_index.Sort(); },
+        [&]() { m_selector_to_index.Sort(); },
+        [&]() { m_basename_to_index.Sort(); },
+        [&]() { m_method_to_index.Sort(); });
+
+    if (!m_file_addr_to_index_computed)
+    {
+        m_file_addr_to_index = std::move(file_addr_to_index);
+        m_file_addr_to_index_computed = true;
+    }
+    return true;
+}
+
+void
+Symtab::SaveIndexCache ()
+{
+    // Protected function, no need to lock mutex...
+    UUID uuid;
+    TimeValue mod_time;
+    std::unique_ptr<IndexCache> index_cache (GetIndexCache (m_objfile, uuid, mod_time));
+    if (!index_cache)
+        return;
+
+    Timer scoped_timer (__PRETTY_FUNCTION__,
+                        "Symtab::SaveIndexCache (%s)",
+                        m_objfile->GetFileSpec().GetFilename().AsCString("<Unknown>"));
+
+    // Cache the address index too so later debug sessions don't have to
+    // compute it.
+    InitAddressIndexes();
+
+    StringTableBuilder strings;
+    StreamString demangled_strm (Stream::eBinary, 4, eByteOrderLittle);
+    uint32_t num_demangled = 0;
+    const size_t num_symbols = m_symbols.size();
+    for (size_t i = 0; i < num_symbols; ++i)
+    {
+        // The demangled names of all symbols with a mangled name except
+        // trampolines have been computed while building the name indexes.
+        const Symbol &symbol = m_symbols[i];
+        const Mangled &mangled = symbol.GetMangled();
+        if (symbol.IsTrampoline() || !mangled.GetMangledName())
+            continue;
+        const char *demangled_cstr = mangled.GetDemangledName(symbol.GetLanguage()).GetCString();
+        if (demangled_cstr == nullptr)
+            continue;
+        demangled_strm.PutHex32(i);
+        demangled_strm.PutHex32(strings.Add(demangled_cstr));
+        ++num_demangled;
+    }
+
+    StreamString indexes_strm (Stream::eBinary, 4, eByteOrderLittle);
+    EncodeNameIndex (m_name_to_index, strings, indexes_strm);
+    EncodeNameIndex (m_basename_to_index, strings, indexes_strm);
+    EncodeNameIndex (m_method_to_index, strings, indexes_strm);
+    EncodeNameIndex (m_selector_to_index, strings, indexes_strm);
+
+    const size_t num_addresses = m_file_addr_to_index.GetSize();
+    indexes_strm.PutHex32(num_addresses);
+    for (size_t i = 0; i < num_addresses; ++i)
+    {
+        const FileRangeToIndexMap::Entry &entry = m_file_addr_to_index.GetEntryRef(i);
+        indexes_strm.PutHex64(entry.GetRangeBase());
+        indexes_strm.PutHex64(entry.GetByteSize());
+        indexes_strm.PutHex32(entry.data);
+    }
+
+    StreamString strm (Stream::eBinary, 4, eByteOrderLittle);
+    strm.PutHex32(num_symbols);
+    strm.PutHex64(HashSymbols(m_symbols));
+    strings.Encode(strm);
+    strm.PutHex32(num_demangled);
+    strm.Write(demangled_strm.GetData(), demangled_strm.GetSize());
+    strm.Write(indexes_strm.GetData(), indexes_strm.GetSize());
+
+    Error error (index_cache->Write (uuid, m_objfile->GetFileSpec(), mod_time, strm.GetData(), strm.GetSize()));
+    Log *log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_SYMBOLS));
+    if (log && error.Fail())
+        m_objfile->GetModule()->LogMessage (log, "Failed to write symbol table index cache: %s", error.AsCString());
 }
 
 void
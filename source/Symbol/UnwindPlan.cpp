@@ -9,6 +9,8 @@
 
 #include "lldb/Symbol/UnwindPlan.h"
 
+#include <algorithm>
+
 #include "lldb/Core/ConstString.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Target/Process.h"
@@ -363,14 +365,15 @@ UnwindPlan::GetRowForFunctionOffset (int offset) const
             row = m_row_list.back();
         else
         {
-            collection::const_iterator pos, end = m_row_list.end();
-            for (pos = m_row_list.begin(); pos != end; ++pos)
-            {
-                if ((*pos)->GetOffset() <= static_cast<lldb::offset_t>(offset))
-                    row = *pos;
-                else
-                    break;
-            }
+            // The rows are sorted by offset, find the last one starting at or before offset.
+            collection::const_iterator pos = std::upper_bound (m_row_list.begin(),
+                                                               m_row_list.end(),
+                                                               static_cast<lldb::offset_t>(offset),
+                                                               [](lldb::offset_t offset, const RowSP &row_sp) {
+                                                                   return offset < row_sp->GetOffset();
+                                                               });
+            if (pos != m_row_list.begin())
+                row = *(pos - 1);
         }
     }
     return row;
@@ -0,0 +1,82 @@
+//===-- FrameUnwindPlanCache.cpp --------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C Includes
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Target/FrameUnwindPlanCache.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+FrameUnwindPlanCache::FrameUnwindPlanCache () :
+    m_mutex (),
+    m_frame_unwind_plans ()
+{
+}
+
+FrameUnwindPlanCache::~FrameUnwindPlanCache () = default;
+
+bool
+FrameUnwindPlanCache::GetFastPlan (addr_t load_addr, int offset, int offset_backed_up_one, UnwindPlanSP &plan_sp)
+{
+    Mutex::Locker locker(m_mutex);
+    FrameUnwindPlansMap::const_iterator pos = m_frame_unwind_plans.find (FrameKey (load_addr, offset, offset_backed_up_one));
+    if (pos == m_frame_unwind_plans.end() || !pos->second.has_fast_plan)
+        return false;
+    plan_sp = pos->second.fast_plan_sp;
+    return true;
+}
+
+void
+FrameUnwindPlanCache::SetFastPlan (addr_t load_addr, int offset, int offset_backed_up_one, const UnwindPlanSP &plan_sp)
+{
+    Mutex::Locker locker(m_mutex);
+    FrameUnwindPlans &plans = m_frame_unwind_plans[FrameKey (load_addr, offset, offset_backed_up_one)];
+    plans.fast_plan_sp = plan_sp;
+    plans.has_fast_plan = true;
+}
+
+bool
+FrameUnwindPlanCache::GetFullPlan (addr_t load_addr,
+                                   int offset,
+                                   int offset_backed_up_one,
+                                   UnwindPlanSP &plan_sp,
+                                   UnwindPlanSP &fallback_plan_sp)
+{
+    Mutex::Locker locker(m_mutex);
+    FrameUnwindPlansMap::const_iterator pos = m_frame_unwind_plans.find (FrameKey (load_addr, offset, offset_backed_up_one));
+    if (pos == m_frame_unwind_plans.end() || !pos->second.has_full_plan)
+        return false;
+    plan_sp = pos->second.full_plan_sp;
+    fallback_plan_sp = pos->second.fallback_plan_sp;
+    return true;
+}
+
+void
+FrameUnwindPlanCache::SetFullPlan (addr_t load_addr,
+                                   int offset,
+                                   int offset_backed_up_one,
+                                   const UnwindPlanSP &plan_sp,
+                                   const UnwindPlanSP &fallback_plan_sp)
+{
+    Mutex::Locker locker(m_mutex);
+    FrameUnwindPlans &plans = m_frame_unwind_plans[FrameKey (load_addr, offset, offset_backed_up_one)];
+    plans.full_plan_sp = plan_sp;
+    plans.fallback_plan_sp = fallback_plan_sp;
+    plans.has_full_plan = true;
+}
+
+void
+FrameUnwindPlanCache::Clear ()
+{
+    Mutex::Locker locker(m_mutex);
+    m_frame_unwind_plans.clear();
+}
@@ -11,6 +11,7 @@
 // C Includes
 #include <inttypes.h>
 // C++ Includes
+#include <algorithm>
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Core/DataBufferHeap.h"
@@ -22,6 +23,10 @@
 using namespace lldb;
 using namespace lldb_private;
 
+// The maximum number of cache lines read at once when the cache detects
+// sequential accesses, such as a formatter walking a large array.
+static const uint32_t g_max_prefetch_line_count = 16;
+
 //----------------------------------------------------------------------
 // MemoryCache constructor
 //----------------------------------------------------------------------
@@ -31,7 +36,10 @@ MemoryCache::MemoryCache(Process &process) :
     m_L2_cache (),
     m_invalid_ranges (),
     m_process (process),
-    m_L2_cache_line_byte_size (process.GetMemoryCacheLineSize())
+    m_L2_cache_line_byte_size (process.GetMemoryCacheLineSize()),
+    m_L2_next_sequential_addr (LLDB_INVALID_ADDRESS),
+    m_L2_prefetch_line_count (1),
+    m_stats ()
 {
 }
 
@@ -51,6 +59,62 @@ MemoryCache::Clear(bool clear_invalid_ranges)
     if (clear_invalid_ranges)
         m_invalid_ranges.Clear();
     m_L2_cache_line_byte_size = m_process.GetMemoryCacheLineSize();
+    m_L2_next_sequential_addr = LLDB_INVALID_ADDRESS;
+    m_L2_prefetch_line_count = 1;
+}
+
+bool
+MemoryCache::ReadFromCache (addr_t addr, void *dst, size_t dst_len)
+{
+    if (dst == nullptr || dst_len == 0)
+        return false;
+
+    Mutex::Locker locker (m_mutex);
+    if (!m_L1_cache.empty())
+    {
+        AddrRange read_range(addr, dst_len);
+        BlockMap::iterator pos = m_L1_cache.upper_bound(addr);
+        if (pos != m_L1_cache.begin ())
+        {
+            --pos;
+        }
+        AddrRange chunk_range(pos->first, pos->second->GetByteSize());
+        if (chunk_range.Contains(read_range))
+        {
+            memcpy(dst, pos->second->GetBytes() + addr - chunk_range.GetRangeBase(), dst_len);
+            ++m_stats.hits;
+            return true;
+        }
+    }
+
+    const uint32_t cache_line_byte_size = m_L2_cache_line_byte_size;
+    uint8_t *dst_buf = (uint8_t *)dst;
+    size_t bytes_copied = 0;
+    while (bytes_copied < dst_len)
+    {
+        const addr_t curr_addr = addr + bytes_copied;
+        const addr_t line_addr = curr_addr - (curr_addr % cache_line_byte_size);
+        BlockMap::const_iterator pos = m_L2_cache.find (line_addr);
+        if (pos == m_L2_cache.end())
+            return false;
+
+        // Lines at the end of readable memory can be shorter than a full line
+        const size_t line_offset = curr_addr - line_addr;
+        if (line_offset >= pos->second->GetByteSize())
+            return false;
+        const size_t curr_size = std::min<size_t>(dst_len - bytes_copied, pos->second->GetByteSize() - line_offset);
+        memcpy (dst_buf + bytes_copied, pos->second->GetBytes() + line_offset, curr_size);
+        bytes_copied += curr_size;
+    }
+    ++m_stats.hits;
+    return true;
+}
+
+MemoryCache::Statistics
+MemoryCache::GetStatistics ()
+{
+    Mutex::Locker locker (m_mutex);
+    return m_stats;
 }
 
 void
@@ -78,13 +142,19 @@ MemoryCache::Flush (addr_t addr, size_t size)
     if (!m_L1_cache.empty())
     {
         AddrRange flush_range(addr, size);
-        BlockMap::iterator pos = m_L1_cache.lower_bound(addr);
+        // Start at the block before addr, it can extend into the range
+        BlockMap::iterator pos = m_L1_cache.upper_bound(addr);
+        if (pos != m_L1_cache.begin())
+            --pos;
         while (pos != m_L1_cache.end())
         {
             AddrRange chunk_range(pos->first, pos->second->GetByteSize());
-            if (!chunk_range.DoesIntersect(flush_range))
+            if (chunk_range.DoesIntersect(flush_range))
+                pos = m_L1_cache.erase(pos);
+            else if (chunk_range.GetRangeBase() >= flush_range.GetRangeEnd())
                 break;
-            pos = m_L1_cache.erase(pos);
+            else
+                ++pos;
         }
     }
 
@@ -173,6 +243,7 @@ MemoryCache::Read (addr_t addr,
         if (chunk_range.Contains(read_range))
         {
             memcpy(dst, pos->second->GetBytes() + addr - chunk_range.GetRangeBase(), dst_len);
+            ++m_stats.hits;
             return dst_len;
         }
     }
@@ -188,6 +259,9 @@ MemoryCache::Read (addr_t addr,
     if (dst && dst_len > m_L2_cache_line_byte_size)
     {
         size_t bytes_read = m_process.ReadMemoryFromInferior (addr, dst, dst_len, error);
+        ++m_stats.misses;
+        ++m_stats.process_reads;
+        m_stats.bytes_read += bytes_read;
         // Add this non block sized range to the L1 cache if we actually read anything
         if (bytes_read > 0)
             AddL1CacheData(addr, dst, bytes_read);
@@ -200,6 +274,7 @@ MemoryCache::Read (addr_t addr,
         uint8_t *dst_buf = (uint8_t *)dst;
         addr_t curr_addr = addr - (addr % cache_line_byte_size);
         addr_t cache_offset = addr - curr_addr;
+        bool read_from_process = false;
 
         while (bytes_left > 0)
         {
@@ -257,26 +332,85 @@ MemoryCache::Read (addr_t addr,
             if (bytes_left > 0)
             {
                 assert ((curr_addr % cache_line_byte_size) == 0);
-                std::unique_ptr<DataBufferHeap> data_buffer_heap_ap(new DataBufferHeap (cache_line_byte_size, 0));
-                size_t process_bytes_read = m_process.ReadMemoryFromInferior (curr_addr, 
-                                                                              data_buffer_heap_ap->GetBytes(), 
-                                                                              data_buffer_heap_ap->GetByteSize(), 
-                                                                              error);
-                if (process_bytes_read == 0)
+                // Fetch every line the rest of the read needs with a single
+                // read from the process.
+                const uint32_t num_lines = (cache_offset + bytes_left + cache_line_byte_size - 1) / cache_line_byte_size;
+                read_from_process = true;
+                if (ReadL2CacheLines (curr_addr, num_lines, error) == 0)
                     return dst_len - bytes_left;
-                
-                if (process_bytes_read != cache_line_byte_size)
-                    data_buffer_heap_ap->SetByteSize (process_bytes_read);
-                m_L2_cache[curr_addr] = DataBufferSP (data_buffer_heap_ap.release());
                 // We have read data and put it into the cache, continue through the
                 // loop again to get the data out of the cache...
             }
         }
+
+        if (!read_from_process)
+            ++m_stats.hits;
     }
     
     return dst_len - bytes_left;
 }
 
+//----------------------------------------------------------------------
+// Read at least min_line_count L2 cache lines starting at line_addr
+// from the process with a single memory read. When misses are
+// sequential, each one reads twice as many lines as the previous one,
+// up to g_max_prefetch_line_count, so walking a large object costs a
+// few round trips instead of one per cache line. Must be called with
+// m_mutex held.
+//----------------------------------------------------------------------
+size_t
+MemoryCache::ReadL2CacheLines (addr_t line_addr, uint32_t min_line_count, Error &error)
+{
+    const uint32_t cache_line_byte_size = m_L2_cache_line_byte_size;
+
+    if (line_addr == m_L2_next_sequential_addr)
+        m_L2_prefetch_line_count = std::min<uint32_t>(m_L2_prefetch_line_count * 2, g_max_prefetch_line_count);
+    else
+        m_L2_prefetch_line_count = 1;
+
+    // Stop at the first line that is already cached or known to be
+    // unreadable, or that would wrap around the address space.
+    const uint32_t max_line_count = std::max<uint32_t>(min_line_count, m_L2_prefetch_line_count);
+    uint32_t line_count = 1;
+    for (; line_count < max_line_count; ++line_count)
+    {
+        const addr_t curr_addr = line_addr + line_count * cache_line_byte_size;
+        if (curr_addr < line_addr ||
+            m_L2_cache.find (curr_addr) != m_L2_cache.end() ||
+            m_invalid_ranges.FindEntryThatContains (curr_addr))
+            break;
+    }
+
+    ++m_stats.misses;
+
+    const size_t read_size = line_count * cache_line_byte_size;
+    DataBufferHeap data_buffer (read_size, 0);
+    ++m_stats.process_reads;
+    size_t process_bytes_read = m_process.ReadMemoryFromInferior (line_addr, data_buffer.GetBytes(), read_size, error);
+    m_stats.bytes_read += process_bytes_read;
+
+    if (process_bytes_read < cache_line_byte_size && line_count > 1)
+    {
+        // A stub can fail the whole read when the lines we added run into
+        // unmapped memory, so read the first line on its own.
+        error.Clear();
+        line_count = 1;
+        m_L2_prefetch_line_count = 1;
+        ++m_stats.process_reads;
+        process_bytes_read = m_process.ReadMemoryFromInferior (line_addr, data_buffer.GetBytes(), cache_line_byte_size, error);
+        m_stats.bytes_read += process_bytes_read;
+    }
+
+    m_L2_next_sequential_addr = line_addr + line_count * cache_line_byte_size;
+
+    for (size_t offset = 0; offset < process_bytes_read; offset += cache_line_byte_size)
+    {
+        const size_t line_size = std::min<size_t>(cache_line_byte_size, process_bytes_read - offset);
+        m_L2_cache[line_addr + offset] = DataBufferSP (new DataBufferHeap (data_buffer.GetBytes() + offset, line_size));
+    }
+    return process_bytes_read;
+}
+
 
 
 AllocatedBlock::AllocatedBlock (lldb::addr_t addr, 
@@ -9,6 +9,7 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
 #include <atomic>
 #include <mutex>
 
@@ -124,6 +125,7 @@ g_properties[] =
     { "detach-keeps-stopped" , OptionValue::eTypeBoolean, true, false, nullptr, nullptr, "If true, detach will attempt to keep the process stopped." },
     { "memory-cache-line-size" , OptionValue::eTypeUInt64, false, 512, nullptr, nullptr, "The memory cache line size" },
     { "optimization-warnings" , OptionValue::eTypeBoolean, false, true, nullptr, nullptr, "If true, warn when stopped in code that is optimized where stepping and variable availability may not behave as expected." },
+    { "parallel-thread-unwind" , OptionValue::eTypeBoolean, false, false, nullptr, nullptr, "If true, the stack frames of several threads are computed concurrently when backtracing all threads, for the process plug-ins that support it." },
     {  nullptr                  , OptionValue::eTypeInvalid, false, 0, nullptr, nullptr, nullptr  }
 };
 
@@ -136,7 +138,8 @@ enum {
     ePropertyStopOnSharedLibraryEvents,
     ePropertyDetachKeepsStopped,
     ePropertyMemCacheLineSize,
-    ePropertyWarningOptimization
+    ePropertyWarningOptimization,
+    ePropertyParallelThreadUnwind
 };
 
 ProcessProperties::ProcessProperties (lldb_private::Process *process) :
@@ -277,6 +280,13 @@ ProcessProperties::GetWarningsOptimization () const
     return m_collection_sp->GetPropertyAtIndexAsBoolean(nullptr, idx, g_properties[idx].default_uint_value != 0);
 }
 
+bool
+ProcessProperties::GetParallelThreadUnwind () const
+{
+    const uint32_t idx = ePropertyParallelThreadUnwind;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean(nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
 void
 ProcessInstanceInfo::Dump (Stream &s, Platform *platform) const
 {
@@ -744,6 +754,8 @@ Process::Process(lldb::TargetSP target_sp, ListenerSP listener_sp, const UnixSig
     m_image_tokens (),
     m_listener_sp (listener_sp),
     m_breakpoint_site_list (),
+    m_breakpoint_site_batch_mutex (Mutex::eMutexTypeNormal),
+    m_breakpoint_site_batches (),
     m_dynamic_checkers_ap (),
     m_unix_signals_sp (unix_signals_sp),
     m_abi_sp (),
@@ -757,6 +769,7 @@ Process::Process(lldb::TargetSP target_sp, ListenerSP listener_sp, const UnixSig
     m_profile_data (),
     m_iohandler_sync (0),
     m_memory_cache (*this),
+    m_frame_unwind_plan_cache (),
     m_allocated_memory_cache (*this),
     m_should_detach (false),
     m_next_event_action_ap(),
@@ -893,6 +906,7 @@ Process::Finalize()
     m_notifications.swap(empty_notifications);
     m_image_tokens.clear();
     m_memory_cache.Clear();
+    m_frame_unwind_plan_cache.Clear();
     m_allocated_memory_cache.Clear();
     m_language_runtimes.clear();
     m_instrumentation_runtimes.clear();
@@ -1958,10 +1972,194 @@ Process::GetBreakpointSiteList() const
 void
 Process::DisableAllBreakpointSites ()
 {
-    m_breakpoint_site_list.ForEach([this](BreakpointSite *bp_site) -> void {
-//        bp_site->SetEnabled(true);
-        DisableBreakpointSite(bp_site);
+    FlushBreakpointSiteBatch (true);
+
+    std::vector<BreakpointSiteSP> bp_site_sps;
+    m_breakpoint_site_list.ForEach([this, &bp_site_sps](BreakpointSite *bp_site) -> void {
+        // The list mutex is recursive, get a shared pointer to keep the
+        // site alive while it is disabled outside of ForEach.
+        bp_site_sps.push_back (m_breakpoint_site_list.FindByAddress (bp_site->GetLoadAddress()));
     });
+
+    std::vector<BreakpointSite *> bp_sites;
+    for (const BreakpointSiteSP &bp_site_sp : bp_site_sps)
+    {
+        if (bp_site_sp)
+            bp_sites.push_back (bp_site_sp.get());
+    }
+    std::vector<Error> errors;
+    DisableBreakpointSites (bp_sites, errors);
+}
+
+void
+Process::EnableBreakpointSites (const std::vector<BreakpointSite *> &bp_sites, std::vector<Error> &errors)
+{
+    errors.clear();
+    errors.reserve (bp_sites.size());
+    for (BreakpointSite *bp_site : bp_sites)
+        errors.push_back (EnableBreakpointSite (bp_site));
+}
+
+void
+Process::DisableBreakpointSites (const std::vector<BreakpointSite *> &bp_sites, std::vector<Error> &errors)
+{
+    errors.clear();
+    errors.reserve (bp_sites.size());
+    for (BreakpointSite *bp_site : bp_sites)
+        errors.push_back (DisableBreakpointSite (bp_site));
+}
+
+void
+Process::BeginBreakpointSiteBatch ()
+{
+    Mutex::Locker locker (m_breakpoint_site_batch_mutex);
+    ++m_breakpoint_site_batches[Host::GetCurrentThreadID()].depth;
+}
+
+void
+Process::EndBreakpointSiteBatch ()
+{
+    {
+        Mutex::Locker locker (m_breakpoint_site_batch_mutex);
+        auto pos = m_breakpoint_site_batches.find (Host::GetCurrentThreadID());
+        assert (pos != m_breakpoint_site_batches.end() && pos->second.depth > 0);
+        if (pos == m_breakpoint_site_batches.end() || pos->second.depth == 0 || --pos->second.depth > 0)
+            return;
+    }
+    FlushBreakpointSiteBatch (false);
+}
+
+bool
+Process::DeferBreakpointSiteRemoval (const BreakpointSiteSP &bp_site_sp)
+{
+    Mutex::Locker locker (m_breakpoint_site_batch_mutex);
+
+    // A site created in a batch was never enabled, it can go right away.
+    const addr_t load_addr = bp_site_sp->GetLoadAddress();
+    for (auto &pair : m_breakpoint_site_batches)
+    {
+        auto pos = pair.second.enables.find (load_addr);
+        if (pos != pair.second.enables.end() && pos->second == bp_site_sp)
+        {
+            pair.second.enables.erase (pos);
+            m_breakpoint_site_list.RemoveByAddress (load_addr);
+            return true;
+        }
+    }
+
+    // Keep the site in the list until it is disabled, memory reads must
+    // still hide its trap opcode.
+    auto pos = m_breakpoint_site_batches.find (Host::GetCurrentThreadID());
+    if (pos == m_breakpoint_site_batches.end() || pos->second.depth == 0 || !bp_site_sp->IsEnabled())
+        return false;
+    pos->second.disables.push_back (bp_site_sp);
+    return true;
+}
+
+void
+Process::FlushBreakpointSiteBatch (bool all_threads)
+{
+    std::map<addr_t, BreakpointSiteSP> enables;
+    std::vector<BreakpointSiteSP> disables;
+    {
+        Mutex::Locker locker (m_breakpoint_site_batch_mutex);
+        const lldb::tid_t current_tid = Host::GetCurrentThreadID();
+        auto pos = m_breakpoint_site_batches.begin();
+        while (pos != m_breakpoint_site_batches.end())
+        {
+            if (!all_threads && pos->first != current_tid)
+            {
+                ++pos;
+                continue;
+            }
+            BreakpointSiteBatchState &batch = pos->second;
+            enables.insert (batch.enables.begin(), batch.enables.end());
+            batch.enables.clear();
+            disables.insert (disables.end(), batch.disables.begin(), batch.disables.end());
+            batch.disables.clear();
+            if (batch.depth == 0)
+                pos = m_breakpoint_site_batches.erase (pos);
+            else
+                ++pos;
+        }
+    }
+
+    // A site can get an owner again after it lost them all, it then stays.
+    std::sort (disables.begin(), disables.end());
+    disables.erase (std::unique (disables.begin(), disables.end()), disables.end());
+    disables.erase (std::remove_if (disables.begin(), disables.end(),
+                                    [](const BreakpointSiteSP &bp_site_sp) { return bp_site_sp->GetNumberOfOwners() > 0; }),
+                    disables.end());
+
+    const bool is_alive = IsAlive();
+    std::vector<Error> errors;
+    if (!disables.empty())
+    {
+        if (is_alive)
+        {
+            std::vector<BreakpointSite *> bp_sites;
+            for (const BreakpointSiteSP &bp_site_sp : disables)
+                bp_sites.push_back (bp_site_sp.get());
+            DisableBreakpointSites (bp_sites, errors);
+        }
+        for (const BreakpointSiteSP &bp_site_sp : disables)
+        {
+            if (m_breakpoint_site_list.FindByAddress (bp_site_sp->GetLoadAddress()) == bp_site_sp)
+                m_breakpoint_site_list.RemoveByAddress (bp_site_sp->GetLoadAddress());
+        }
+    }
+
+    if (enables.empty() || !is_alive)
+        return;
+
+    std::vector<BreakpointSite *> bp_sites;
+    for (const auto &pair : enables)
+        bp_sites.push_back (pair.second.get());
+    EnableBreakpointSites (bp_sites, errors);
+
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    for (size_t i = 0; i < bp_sites.size(); ++i)
+    {
+        if (errors[i].Success())
+            continue;
+
+        // CreateBreakpointSite already gave the site to its owners, take it
+        // back so that they are unresolved again and the site is removed,
+        // like when enabling it fails right away.
+        BreakpointSiteSP bp_site_sp = enables[bp_sites[i]->GetLoadAddress()];
+        std::vector<BreakpointLocationSP> owners;
+        const size_t num_owners = bp_site_sp->GetNumberOfOwners();
+        for (size_t owner_idx = 0; owner_idx < num_owners; ++owner_idx)
+            owners.push_back (bp_site_sp->GetOwnerAtIndex (owner_idx));
+        for (const BreakpointLocationSP &owner : owners)
+        {
+            if (!owner)
+                continue;
+            const char *error_cstr = errors[i].AsCString() ? errors[i].AsCString() : "unknown error";
+            if (log)
+                log->Printf ("Process::%s failed to enable breakpoint site at 0x%" PRIx64 " for breakpoint %i.%i: %s",
+                             __FUNCTION__, bp_site_sp->GetLoadAddress(), owner->GetBreakpoint().GetID(), owner->GetID(), error_cstr);
+            GetTarget().GetDebugger().GetErrorFile()->Printf ("warning: failed to set breakpoint site at 0x%" PRIx64 " for breakpoint %i.%i: %s\n",
+                                                               bp_site_sp->GetLoadAddress(),
+                                                               owner->GetBreakpoint().GetID(),
+                                                               owner->GetID(),
+                                                               error_cstr);
+            owner->ClearBreakpointSite();
+        }
+    }
+}
+
+Process::BreakpointSiteBatch::BreakpointSiteBatch (Target &target) :
+    m_process_sp (target.GetProcessSP())
+{
+    if (m_process_sp)
+        m_process_sp->BeginBreakpointSiteBatch();
+}
+
+Process::BreakpointSiteBatch::~BreakpointSiteBatch ()
+{
+    if (m_process_sp)
+        m_process_sp->EndBreakpointSiteBatch();
 }
 
 Error
@@ -2081,6 +2279,7 @@ Process::CreateBreakpointSite (const BreakpointLocationSP &owner, bool use_hardw
         {
             bp_site_sp->AddOwner (owner);
             owner->SetBreakpointSite (bp_site_sp);
+            UpdateBreakpointSiteConditions (bp_site_sp.get());
             return bp_site_sp->GetID();
         }
         else
@@ -2088,6 +2287,17 @@ Process::CreateBreakpointSite (const BreakpointLocationSP &owner, bool use_hardw
             bp_site_sp.reset (new BreakpointSite (&m_breakpoint_site_list, owner, load_addr, use_hardware));
             if (bp_site_sp)
             {
+                {
+                    Mutex::Locker locker (m_breakpoint_site_batch_mutex);
+                    auto pos = m_breakpoint_site_batches.find (Host::GetCurrentThreadID());
+                    if (pos != m_breakpoint_site_batches.end() && pos->second.depth > 0)
+                    {
+                        // Enabled when the batch is flushed.
+                        pos->second.enables[load_addr] = bp_site_sp;
+                        owner->SetBreakpointSite (bp_site_sp);
+                        return m_breakpoint_site_list.Add (bp_site_sp);
+                    }
+                }
                 Error error = EnableBreakpointSite (bp_site_sp.get());
                 if (error.Success())
                 {
@@ -2119,11 +2329,15 @@ Process::RemoveOwnerFromBreakpointSite (lldb::user_id_t owner_id, lldb::user_id_
     uint32_t num_owners = bp_site_sp->RemoveOwner (owner_id, owner_loc_id);
     if (num_owners == 0)
     {
+        if (DeferBreakpointSiteRemoval (bp_site_sp))
+            return;
         // Don't try to disable the site if we don't have a live process anymore.
         if (IsAlive())
             DisableBreakpointSite (bp_site_sp.get());
         m_breakpoint_site_list.RemoveByAddress(bp_site_sp->GetLoadAddress());
     }
+    else if (IsAlive())
+        UpdateBreakpointSiteConditions (bp_site_sp.get());
 }
 
 size_t
@@ -2535,6 +2749,63 @@ Process::ReadMemoryFromInferior (addr_t addr, void *buf, size_t size, Error &err
     return bytes_read;
 }
 
+size_t
+Process::ReadMemoryRanges (MemoryRangeReads &reads)
+{
+    const bool use_cache = !GetDisableMemoryCache();
+
+    // Copy what we can from the memory cache and gather the other ranges
+    // so they can be read from the process all at once.
+    MemoryRangeReads uncached_reads;
+    std::vector<size_t> uncached_indexes;
+    for (size_t i = 0; i < reads.size(); ++i)
+    {
+        MemoryRangeRead &read = reads[i];
+        read.bytes_read = 0;
+        if (read.buf == nullptr || read.size == 0)
+            continue;
+        if (use_cache && m_memory_cache.ReadFromCache (read.addr, read.buf, read.size))
+            read.bytes_read = read.size;
+        else
+        {
+            uncached_reads.push_back (read);
+            uncached_indexes.push_back (i);
+        }
+    }
+
+    if (uncached_reads.size() > 1)
+    {
+        DoReadMemoryRanges (uncached_reads);
+        for (size_t i = 0; i < uncached_reads.size(); ++i)
+        {
+            const MemoryRangeRead &read = uncached_reads[i];
+            if (read.bytes_read != read.size)
+                continue;
+
+            // Replace any software breakpoint opcodes that fall into this
+            // range back into the buffer like ReadMemoryFromInferior() does.
+            RemoveBreakpointOpcodesFromBuffer (read.addr, read.bytes_read, (uint8_t *)read.buf);
+            if (use_cache)
+                m_memory_cache.AddL1CacheData (read.addr, read.buf, read.bytes_read);
+            reads[uncached_indexes[i]].bytes_read = read.bytes_read;
+        }
+    }
+
+    // Read anything that couldn't be read in bulk one range at a time.
+    size_t num_ranges_read = 0;
+    for (MemoryRangeRead &read : reads)
+    {
+        if (read.bytes_read < read.size)
+        {
+            Error error;
+            read.bytes_read = ReadMemory (read.addr, read.buf, read.size, error);
+        }
+        if (read.bytes_read == read.size)
+            ++num_ranges_read;
+    }
+    return num_ranges_read;
+}
+
 uint64_t
 Process::ReadUnsignedIntegerFromMemory (lldb::addr_t vm_addr, size_t integer_byte_size, uint64_t fail_value, Error &error)
 {
@@ -3543,6 +3814,10 @@ Process::PrivateResume ()
                     StateAsCString(m_public_state.GetValue()),
                     StateAsCString(m_private_state.GetValue()));
 
+    // Breakpoint sites batched on other threads must be in place before
+    // the process runs.
+    FlushBreakpointSiteBatch (true);
+
     Error error (WillResume());
     // Tell the process it is about to resume before the thread list
     if (error.Success())
@@ -6321,6 +6596,7 @@ Process::DidExec ()
     m_dyld_ap.reset();
     m_jit_loaders_ap.reset();
     m_image_tokens.clear();
+    m_frame_unwind_plan_cache.Clear();
     m_allocated_memory_cache.Clear();
     m_language_runtimes.clear();
     m_instrumentation_runtimes.clear();
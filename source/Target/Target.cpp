@@ -21,6 +21,7 @@
 #include "lldb/Breakpoint/Watchpoint.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/Event.h"
+#include "lldb/Core/IndexCache.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ModuleSpec.h"
@@ -57,6 +58,7 @@
 #include "lldb/Target/Thread.h"
 #include "lldb/Target/ThreadSpec.h"
 #include "lldb/Utility/LLDBAssert.h"
+#include "lldb/Utility/TaskPool.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -794,6 +796,7 @@ Target::RemoveAllBreakpoints (bool internal_also)
     if (log)
         log->Printf ("Target::%s (internal_also = %s)\n", __FUNCTION__, internal_also ? "yes" : "no");
 
+    Process::BreakpointSiteBatch batch (*this);
     m_breakpoint_list.RemoveAll (true);
     if (internal_also)
         m_internal_breakpoint_list.RemoveAll (false);
@@ -808,6 +811,7 @@ Target::DisableAllBreakpoints (bool internal_also)
     if (log)
         log->Printf ("Target::%s (internal_also = %s)\n", __FUNCTION__, internal_also ? "yes" : "no");
 
+    Process::BreakpointSiteBatch batch (*this);
     m_breakpoint_list.SetEnabledAll (false);
     if (internal_also)
         m_internal_breakpoint_list.SetEnabledAll (false);
@@ -820,6 +824,7 @@ Target::EnableAllBreakpoints (bool internal_also)
     if (log)
         log->Printf ("Target::%s (internal_also = %s)\n", __FUNCTION__, internal_also ? "yes" : "no");
 
+    Process::BreakpointSiteBatch batch (*this);
     m_breakpoint_list.SetEnabledAll (true);
     if (internal_also)
         m_internal_breakpoint_list.SetEnabledAll (true);
@@ -1401,8 +1406,11 @@ Target::ModulesDidLoad (ModuleList &module_list)
 {
     if (m_valid && module_list.GetSize())
     {
-        m_breakpoint_list.UpdateBreakpoints (module_list, true, false);
-        m_internal_breakpoint_list.UpdateBreakpoints (module_list, true, false);
+        {
+            Process::BreakpointSiteBatch batch (*this);
+            m_breakpoint_list.UpdateBreakpoints (module_list, true, false);
+            m_internal_breakpoint_list.UpdateBreakpoints (module_list, true, false);
+        }
         if (m_process_sp)
         {
             m_process_sp->ModulesDidLoad (module_list);
@@ -1426,8 +1434,11 @@ Target::SymbolsDidLoad (ModuleList &module_list)
             }
         }
         
-        m_breakpoint_list.UpdateBreakpoints (module_list, true, false);
-        m_internal_breakpoint_list.UpdateBreakpoints (module_list, true, false);
+        {
+            Process::BreakpointSiteBatch batch (*this);
+            m_breakpoint_list.UpdateBreakpoints (module_list, true, false);
+            m_internal_breakpoint_list.UpdateBreakpoints (module_list, true, false);
+        }
         BroadcastEvent (eBroadcastBitSymbolsLoaded, new TargetEventData (this->shared_from_this(), module_list));
     }
 }
@@ -1438,8 +1449,17 @@ Target::ModulesDidUnload (ModuleList &module_list, bool delete_locations)
     if (m_valid && module_list.GetSize())
     {
         UnloadModuleSections (module_list);
-        m_breakpoint_list.UpdateBreakpoints (module_list, false, delete_locations);
-        m_internal_breakpoint_list.UpdateBreakpoints (module_list, false, delete_locations);
+
+        // The UnwindPlans cached for the frames in these modules are keyed by load address, which
+        // other code can now be loaded at.
+        if (m_process_sp)
+            m_process_sp->GetFrameUnwindPlanCache().Clear();
+
+        {
+            Process::BreakpointSiteBatch batch (*this);
+            m_breakpoint_list.UpdateBreakpoints (module_list, false, delete_locations);
+            m_internal_breakpoint_list.UpdateBreakpoints (module_list, false, delete_locations);
+        }
         BroadcastEvent (eBroadcastBitModulesUnloaded, new TargetEventData (this->shared_from_this(), module_list));
     }
 }
@@ -3448,6 +3468,10 @@ g_properties[] =
     { "trap-handler-names"                 , OptionValue::eTypeArray     , true,  OptionValue::eTypeString,   nullptr, nullptr, "A list of trap handler function names, e.g. a common Unix user process one is _sigtramp." },
     { "display-runtime-support-values"     , OptionValue::eTypeBoolean   , false, false,                      nullptr, nullptr, "If true, LLDB will show variables that are meant to support the operation of a language's runtime support." },
     { "non-stop-mode"                      , OptionValue::eTypeBoolean   , false, 0,                          nullptr, nullptr, "Disable lock-step debugging, instead control threads independently." },
+    { "parallel-threads"                   , OptionValue::eTypeUInt64    , true,  0,                          nullptr, nullptr, "The number of threads LLDB uses for parallel work like indexing debug information. Zero means one thread for each hardware thread." },
+    { "index-cache"                        , OptionValue::eTypeBoolean   , true,  false,                      nullptr, nullptr, "Store symbol table and DWARF name indexes on disk and reuse them in later debug sessions." },
+    { "index-cache-directory"              , OptionValue::eTypeFileSpec  , true,  0,                          nullptr, nullptr, "Root directory for cached symbol table and DWARF name indexes, ~/.lldb/index_cache by default." },
+    { "index-cache-max-size"               , OptionValue::eTypeUInt64    , true,  1024,                       nullptr, nullptr, "Maximum size in megabytes of the index cache directory, the oldest entries are removed when it grows larger. Zero means unlimited." },
     { nullptr                                 , OptionValue::eTypeInvalid   , false, 0                         , nullptr, nullptr, nullptr }
 };
 
@@ -3490,7 +3514,11 @@ enum
     ePropertyDisplayExpressionsInCrashlogs,
     ePropertyTrapHandlerNames,
     ePropertyDisplayRuntimeSupportValues,
-    ePropertyNonStopModeEnabled
+    ePropertyNonStopModeEnabled,
+    ePropertyParallelThreads,
+    ePropertyIndexCache,
+    ePropertyIndexCacheDirectory,
+    ePropertyIndexCacheMaxSize
 };
 
 class TargetOptionValueProperties : public OptionValueProperties
@@ -3635,6 +3663,12 @@ TargetProperties::TargetProperties (Target *target) :
     {
         m_collection_sp.reset (new TargetOptionValueProperties(ConstString("target")));
         m_collection_sp->Initialize(g_properties);
+        m_collection_sp->SetValueChangedCallback(ePropertyParallelThreads, TargetProperties::ParallelThreadsValueChangedCallback, this);
+
+        const FileSpec index_cache_dir (IndexCache::GetDefaultCacheDirectory());
+        if (index_cache_dir)
+            m_collection_sp->SetPropertyAtIndexAsFileSpec (nullptr, ePropertyIndexCacheDirectory, index_cache_dir);
+
         m_collection_sp->AppendProperty(ConstString("process"),
                                         ConstString("Settings specify to processes."),
                                         true,
@@ -4029,6 +4063,27 @@ TargetProperties::SetNonStopModeEnabled (bool b)
     m_collection_sp->SetPropertyAtIndexAsBoolean(nullptr, idx, b);
 }
 
+bool
+TargetProperties::GetUseIndexCache () const
+{
+    const uint32_t idx = ePropertyIndexCache;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean(nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
+FileSpec
+TargetProperties::GetIndexCacheDirectory () const
+{
+    const uint32_t idx = ePropertyIndexCacheDirectory;
+    return m_collection_sp->GetPropertyAtIndexAsFileSpec(nullptr, idx);
+}
+
+uint64_t
+TargetProperties::GetIndexCacheMaxByteSize () const
+{
+    const uint32_t idx = ePropertyIndexCacheMaxSize;
+    return m_collection_sp->GetPropertyAtIndexAsUInt64(nullptr, idx, g_properties[idx].default_uint_value) * 1024 * 1024;
+}
+
 const ProcessLaunchInfo &
 TargetProperties::GetProcessLaunchInfo ()
 {
@@ -4145,6 +4200,14 @@ TargetProperties::DisableSTDIOValueChangedCallback(void *target_property_ptr, Op
         this_->m_launch_info.GetFlags().Clear(lldb::eLaunchFlagDisableSTDIO);
 }
 
+void
+TargetProperties::ParallelThreadsValueChangedCallback(void *target_property_ptr, OptionValue *)
+{
+    TargetProperties *this_ = reinterpret_cast<TargetProperties *>(target_property_ptr);
+    const uint32_t idx = ePropertyParallelThreads;
+    TaskPool::SetThreadCount(this_->m_collection_sp->GetPropertyAtIndexAsUInt64(nullptr, idx, g_properties[idx].default_uint_value));
+}
+
 //----------------------------------------------------------------------
 // Target::TargetEventData
 //----------------------------------------------------------------------
@@ -24,6 +24,7 @@
 #include "lldb/Target/Process.h"
 #include "lldb/Utility/ConvertEnum.h"
 #include "lldb/Utility/LLDBAssert.h"
+#include "lldb/Utility/TaskPool.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -521,6 +522,46 @@ ThreadList::DiscardThreadPlans ()
 
 }
 
+void
+ThreadList::ComputeStackFrames (uint32_t num_frames)
+{
+    if (num_frames == 0)
+        return;
+
+    // Work on a copy of the list so the thread list mutex isn't held while unwinding.  Getting
+    // the stop info or the register context of a thread can need it, which would deadlock with
+    // the unwinds running on other threads.
+    collection threads;
+    {
+        Mutex::Locker locker(GetMutex());
+        m_process->UpdateThreadListIfNeeded();
+        threads = m_threads;
+    }
+
+    // Asking for the last frame unwinds all the frames before it.
+    auto compute_frames = [&threads, num_frames](size_t idx)
+    {
+        threads[idx]->GetStackFrameAtIndex (num_frames - 1);
+    };
+
+    // The threads of a stopped process are unwound independently of each other, with the
+    // memory and register reads serialized by the process plug-in when it supports that.
+    // Operating system plug-ins are implemented in Python and may need locks held by the
+    // caller, so their threads are always unwound one after the other.
+    if (threads.size() > 1 &&
+        m_process->GetParallelThreadUnwind() &&
+        m_process->SupportsParallelThreadUnwind() &&
+        m_process->GetOperatingSystem() == nullptr)
+    {
+        TaskPool::ParallelFor (0, threads.size(), compute_frames);
+    }
+    else
+    {
+        for (size_t idx = 0; idx < threads.size(); ++idx)
+            compute_frames (idx);
+    }
+}
+
 bool
 ThreadList::WillResume ()
 {
@@ -90,6 +90,7 @@ StringExtractorGDBRemote::GetServerPacketType () const
         case 'E':
             if (PACKET_STARTS_WITH ("QEnvironment:"))           return eServerPacketType_QEnvironment;
             if (PACKET_STARTS_WITH ("QEnvironmentHexEncoded:")) return eServerPacketType_QEnvironmentHexEncoded;
+            if (PACKET_STARTS_WITH ("QEnableCompression:"))     return eServerPacketType_QEnableCompression;
             break;
 
         case 'S':
@@ -227,6 +228,8 @@ StringExtractorGDBRemote::GetServerPacketType () const
     case 'j':
         if (PACKET_MATCHES("jSignalsInfo"))                     return eServerPacketType_jSignalsInfo;
         if (PACKET_MATCHES("jThreadsInfo"))                     return eServerPacketType_jThreadsInfo;
+        if (PACKET_STARTS_WITH("jMultiMemRead:"))               return eServerPacketType_jMultiMemRead;
+        if (PACKET_STARTS_WITH("jMultiBreakpoint:"))            return eServerPacketType_jMultiBreakpoint;
         break;
 
     case 'v':
@@ -87,6 +87,7 @@ public:
         eServerPacketType_vFile_symlink,
         eServerPacketType_vFile_unlink,
       // debug server packages
+        eServerPacketType_QEnableCompression,
         eServerPacketType_QEnvironmentHexEncoded,
         eServerPacketType_QListThreadsInStopReply,
         eServerPacketType_QRestoreRegisterState,
@@ -99,6 +100,8 @@ public:
         eServerPacketType_QThreadSuffixSupported,
 
         eServerPacketType_jThreadsInfo,
+        eServerPacketType_jMultiMemRead,
+        eServerPacketType_jMultiBreakpoint,
         eServerPacketType_qsThreadInfo,
         eServerPacketType_qfThreadInfo,
         eServerPacketType_qGetPid,
@@ -9,6 +9,12 @@
 
 #include "lldb/Utility/TaskPool.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+
 namespace
 {
     class TaskPoolImpl
@@ -20,24 +26,66 @@ namespace
         void
         AddTask(std::function<void()>&& task_fn);
 
+        bool
+        RunPendingTask();
+
+        void
+        SetThreadCount(uint32_t thread_count);
+
+        uint32_t
+        GetThreadCount() const
+        {
+            return m_active_count;
+        }
+
     private:
+        struct WorkQueue
+        {
+            std::mutex                        mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
         TaskPoolImpl();
 
+        void
+        StartThreads(uint32_t thread_count);
+
+        bool
+        PopTask(int32_t worker_index, std::function<void()>& task_fn);
+
         static void
-        Worker(TaskPoolImpl* pool);
+        Worker(TaskPoolImpl* pool, uint32_t worker_index);
 
-        std::queue<std::function<void()>> m_tasks;
-        std::mutex                        m_tasks_mutex;
-        uint32_t                          m_thread_count;
+        // The queues are allocated up front so workers can access them without any locking.
+        std::vector<std::unique_ptr<WorkQueue>> m_queues;
+        std::atomic<uint32_t>                   m_active_count;
+        std::atomic<uint32_t>                   m_next_queue;
+        std::atomic<size_t>                     m_pending_count;
+        std::atomic<uint32_t>                   m_thread_count; // Only modified with m_wait_mutex held
+        std::mutex                              m_wait_mutex;
+        std::condition_variable                 m_work_cv;
+        std::condition_variable                 m_resize_cv;
     };
 
+    // Index of the worker queue owned by the current thread or -1 if the current thread isn't a
+    // worker of the task pool.
+    thread_local int32_t g_worker_index = -1;
+
+    uint32_t
+    GetDefaultThreadCount()
+    {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
 } // end of anonymous namespace
 
 TaskPoolImpl&
 TaskPoolImpl::GetInstance()
 {
-    static TaskPoolImpl g_task_pool_impl;
-    return g_task_pool_impl;
+    // The worker threads are detached and live until the process exits so the pool is never
+    // destroyed.
+    static TaskPoolImpl* g_task_pool_impl = new TaskPoolImpl();
+    return *g_task_pool_impl;
 }
 
 void
@@ -46,43 +94,230 @@ TaskPool::AddTaskImpl(std::function<void()>&& task_fn)
     TaskPoolImpl::GetInstance().AddTask(std::move(task_fn));
 }
 
+bool
+TaskPool::RunPendingTask()
+{
+    return TaskPoolImpl::GetInstance().RunPendingTask();
+}
+
+void
+TaskPool::SetThreadCount(uint32_t thread_count)
+{
+    TaskPoolImpl::GetInstance().SetThreadCount(thread_count);
+}
+
+uint32_t
+TaskPool::GetThreadCount()
+{
+    return TaskPoolImpl::GetInstance().GetThreadCount();
+}
+
+bool
+TaskPool::ParallelFor(size_t begin,
+                      size_t end,
+                      const std::function<void(size_t)>& fn,
+                      const std::atomic<bool>* cancel)
+{
+    if (begin >= end)
+        return true;
+
+    struct State
+    {
+        std::atomic<size_t>     next;
+        std::atomic<size_t>     remaining;
+        std::atomic<bool>       cancelled;
+        size_t                  end;
+        size_t                  chunk_size;
+        std::mutex              mutex;
+        std::condition_variable cv;
+    };
+
+    const size_t count = end - begin;
+    const size_t thread_count = GetThreadCount();
+
+    auto state = std::make_shared<State>();
+    state->next = begin;
+    state->remaining = count;
+    state->cancelled = false;
+    state->end = end;
+    // Use a few chunks per thread so a thread hitting expensive indexes doesn't hold up the rest.
+    state->chunk_size = std::max<size_t>(1, count / (thread_count * 4));
+
+    // Process chunks until there are none left. The state is shared with the helper tasks which
+    // can outlive this call, but fn and cancel are only accessed after grabbing a chunk and the
+    // caller can't return before every chunk is finished.
+    auto worker_fn = [state, &fn, cancel]()
+    {
+        while (true)
+        {
+            const size_t chunk_begin = state->next.fetch_add(state->chunk_size);
+            if (chunk_begin >= state->end)
+                return;
+            const size_t chunk_end = std::min(chunk_begin + state->chunk_size, state->end);
+
+            if (cancel && cancel->load())
+                state->cancelled = true;
+            if (!state->cancelled)
+            {
+                for (size_t idx = chunk_begin; idx < chunk_end; ++idx)
+                    fn(idx);
+            }
+
+            if (state->remaining.fetch_sub(chunk_end - chunk_begin) == chunk_end - chunk_begin)
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->cv.notify_all();
+            }
+        }
+    };
+
+    const size_t num_chunks = (count + state->chunk_size - 1) / state->chunk_size;
+    const size_t num_helpers = std::min(num_chunks, thread_count) - 1;
+    for (size_t i = 0; i < num_helpers; ++i)
+        AddTaskImpl(worker_fn);
+
+    worker_fn();
+
+    // All chunks are handed out, wait for the ones still running on the other threads.
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->cv.wait(lock, [&state]() { return state->remaining == 0; });
+
+    return !state->cancelled;
+}
+
 TaskPoolImpl::TaskPoolImpl() :
+    m_active_count(0),
+    m_next_queue(0),
+    m_pending_count(0),
     m_thread_count(0)
 {
+    const uint32_t max_queues = std::max(64u, GetDefaultThreadCount() * 4);
+    for (uint32_t i = 0; i < max_queues; ++i)
+        m_queues.emplace_back(new WorkQueue());
+
+    SetThreadCount(0);
+}
+
+void
+TaskPoolImpl::StartThreads(uint32_t thread_count)
+{
+    // Must be called with m_wait_mutex held
+    for (; m_thread_count < thread_count; ++m_thread_count)
+        std::thread(Worker, this, m_thread_count.load()).detach();
+}
+
+void
+TaskPoolImpl::SetThreadCount(uint32_t thread_count)
+{
+    if (thread_count == 0)
+        thread_count = GetDefaultThreadCount();
+    thread_count = std::min<uint32_t>(thread_count, m_queues.size());
+
+    std::unique_lock<std::mutex> lock(m_wait_mutex);
+    m_active_count = thread_count;
+    StartThreads(thread_count);
+    lock.unlock();
+
+    // Wake up the workers being enabled and the ones being disabled.
+    m_work_cv.notify_all();
+    m_resize_cv.notify_all();
 }
 
 void
 TaskPoolImpl::AddTask(std::function<void()>&& task_fn)
 {
-    static const uint32_t max_threads = std::thread::hardware_concurrency();
+    // Tasks added by a worker go to its own queue, which is the cheapest one to access and keeps
+    // nested tasks on the thread having their data in cache. Other threads distribute their
+    // tasks between the queues of the active workers.
+    uint32_t queue_index;
+    if (g_worker_index >= 0 && static_cast<uint32_t>(g_worker_index) < m_active_count)
+        queue_index = g_worker_index;
+    else
+        queue_index = m_next_queue++ % m_active_count;
 
-    std::unique_lock<std::mutex> lock(m_tasks_mutex);
-    m_tasks.emplace(std::move(task_fn));
-    if (m_thread_count < max_threads)
+    WorkQueue& queue = *m_queues[queue_index];
     {
-        m_thread_count++;
-        lock.unlock();
+        std::lock_guard<std::mutex> queue_lock(queue.mutex);
+        queue.tasks.push_back(std::move(task_fn));
+    }
+
+    m_pending_count++;
+    {
+        // Acquire the mutex so a worker can't miss the notification between checking
+        // m_pending_count and starting to wait.
+        std::lock_guard<std::mutex> lock(m_wait_mutex);
+    }
+    m_work_cv.notify_one();
+}
+
+bool
+TaskPoolImpl::PopTask(int32_t worker_index, std::function<void()>& task_fn)
+{
+    if (m_pending_count == 0)
+        return false;
+
+    // Take the most recently added task from our own queue first...
+    if (worker_index >= 0)
+    {
+        WorkQueue& queue = *m_queues[worker_index];
+        std::lock_guard<std::mutex> queue_lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task_fn = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            m_pending_count--;
+            return true;
+        }
+    }
 
-        std::thread (Worker, this).detach();
+    // ...then steal the oldest task from an other queue. Queues of disabled workers are checked
+    // too so their tasks don't get stuck after the thread count is reduced.
+    const uint32_t num_queues = std::max<uint32_t>(m_thread_count, m_active_count);
+    const uint32_t start = worker_index >= 0 ? worker_index + 1 : 0;
+    for (uint32_t i = 0; i < num_queues; ++i)
+    {
+        WorkQueue& queue = *m_queues[(start + i) % num_queues];
+        std::lock_guard<std::mutex> queue_lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task_fn = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            m_pending_count--;
+            return true;
+        }
     }
+    return false;
+}
+
+bool
+TaskPoolImpl::RunPendingTask()
+{
+    std::function<void()> task_fn;
+    if (!PopTask(g_worker_index, task_fn))
+        return false;
+    task_fn();
+    return true;
 }
 
 void
-TaskPoolImpl::Worker(TaskPoolImpl* pool)
+TaskPoolImpl::Worker(TaskPoolImpl* pool, uint32_t worker_index)
 {
+    g_worker_index = worker_index;
     while (true)
     {
-        std::unique_lock<std::mutex> lock(pool->m_tasks_mutex);
-        if (pool->m_tasks.empty())
+        if (worker_index >= pool->m_active_count)
         {
-            pool->m_thread_count--;
-            break;
+            std::unique_lock<std::mutex> lock(pool->m_wait_mutex);
+            pool->m_resize_cv.wait(lock, [pool, worker_index]() { return worker_index < pool->m_active_count; });
+            continue;
         }
 
-        std::function<void()> f = pool->m_tasks.front();
-        pool->m_tasks.pop();
-        lock.unlock();
+        if (pool->RunPendingTask())
+            continue;
 
-        f();
+        std::unique_lock<std::mutex> lock(pool->m_wait_mutex);
+        pool->m_work_cv.wait(lock, [pool, worker_index]() {
+            return pool->m_pending_count > 0 || worker_index >= pool->m_active_count;
+        });
     }
 }
@@ -72,6 +72,7 @@ static struct option g_long_options[] =
     { "native-regs",        no_argument,        NULL,               'r' },  // Specify to use the native registers instead of the gdb defaults for the architecture.  NOTE: this is a do-nothing arg as it's behavior is default now.  FIXME remove call from lldb-platform.
     { "reverse-connect",    no_argument,        NULL,               'R' },  // Specifies that llgs attaches to the client address:port rather than llgs listening for a connection from address on port.
     { "setsid",             no_argument,        NULL,               'S' },  // Call setsid() to make llgs run in its own session.
+    { "enable-compression", no_argument,        NULL,               'z' },  // Let the client enable packet compression with QEnableCompression.
     { NULL,                 0,                  NULL,               0   }
 };
 
@@ -125,6 +126,7 @@ display_usage (const char *progname, const char* subcommand)
             "[--setsid] "
             "[--named-pipe named-pipe-path] "
             "[--native-regs] "
+            "[--enable-compression] "
             "[--attach pid] "
             "[[HOST]:PORT] "
             "[-- PROGRAM ARG1 ARG2 ...]\n", progname, subcommand);
@@ -428,6 +430,7 @@ main_gdbserver (int argc, char *argv[])
     StringRef log_channels; // e.g. "lldb process threads:gdb-remote default:linux all"
     int unnamed_pipe_fd = -1;
     bool reverse_connect = false;
+    bool enable_compression = false;
 
     // ProcessLaunchInfo launch_info;
     ProcessAttachInfo attach_info;
@@ -483,6 +486,10 @@ main_gdbserver (int argc, char *argv[])
             reverse_connect = true;
             break;
 
+        case 'z':
+            enable_compression = true;
+            break;
+
 #ifndef _WIN32
         case 'S':
             // Put llgs into a new session. Terminals group processes
@@ -552,6 +559,7 @@ main_gdbserver (int argc, char *argv[])
     lldb::PlatformSP platform_sp = setup_platform (platform_name);
 
     GDBRemoteCommunicationServerLLGS gdb_server (platform_sp, mainloop);
+    gdb_server.SetCompressionEnabled (enable_compression);
 
     const char *const host_and_port = argv[0];
     argc -= 1;
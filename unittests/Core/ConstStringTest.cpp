@@ -0,0 +1,108 @@
+//===-- ConstStringTest.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#if defined(_MSC_VER) && (_HAS_EXCEPTIONS == 0)
+// Workaround for MSVC standard library bug, which fails to include <thread> when
+// exceptions are disabled.
+#include <eh.h>
+#endif
+
+#include "gtest/gtest.h"
+
+#include "lldb/Core/ConstString.h"
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace lldb_private;
+
+TEST(ConstStringTest, Uniquing)
+{
+    std::string str("ConstStringTest::Uniquing");
+    ConstString a(str.c_str());
+    ConstString b{llvm::StringRef(str)};
+    ConstString c(str.c_str(), 11);
+
+    EXPECT_EQ(a.GetCString(), b.GetCString());
+    EXPECT_NE(a.GetCString(), str.c_str());
+    EXPECT_EQ(str.size(), a.GetLength());
+    EXPECT_EQ(11u, c.GetLength());
+    EXPECT_STREQ("ConstString", c.GetCString());
+    EXPECT_EQ(0u, ConstString().GetLength());
+
+    // Strings with embedded NULs are distinct from their prefixes.
+    ConstString d(llvm::StringRef("abc\0def", 7));
+    ConstString e("abc");
+    EXPECT_NE(d.GetCString(), e.GetCString());
+    EXPECT_EQ(7u, d.GetLength());
+}
+
+TEST(ConstStringTest, MangledCounterpart)
+{
+    ConstString mangled("_ZN16ConstStringTest3fooEv");
+    ConstString demangled;
+    demangled.SetCStringWithMangledCounterpart("ConstStringTest::foo()", mangled);
+
+    ConstString counterpart;
+    EXPECT_TRUE(demangled.GetMangledCounterpart(counterpart));
+    EXPECT_EQ(mangled, counterpart);
+    EXPECT_TRUE(mangled.GetMangledCounterpart(counterpart));
+    EXPECT_EQ(demangled, counterpart);
+
+    EXPECT_FALSE(ConstString("ConstStringTest::bar()").GetMangledCounterpart(counterpart));
+}
+
+TEST(ConstStringTest, ConcurrentAccess)
+{
+    // Hammer the pool from several threads looking up and inserting an
+    // overlapping set of strings, enough of them to grow every shard a few
+    // times. Every thread must end up with the same uniqued pointers.
+    const size_t num_threads = std::max(4u, std::thread::hardware_concurrency());
+    const size_t num_strings = 49999; // Prime, so every stride below visits all the strings
+    const size_t num_rounds = 4;
+
+    std::vector<std::vector<const char *>> results(num_threads);
+    std::atomic<bool> mismatch(false);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back([t, num_strings, num_rounds, &results, &mismatch]() {
+            std::vector<const char *> &result = results[t];
+            result.resize(num_strings);
+            for (size_t round = 0; round < num_rounds; ++round)
+            {
+                // Each thread walks the strings in a different order.
+                for (size_t i = 0; i < num_strings; ++i)
+                {
+                    const size_t idx = (i * (2 * t + 1) + t * 7919) % num_strings;
+                    std::string str = "ConstStringTest::ConcurrentAccess::" + std::to_string(idx);
+                    ConstString cstr(str.c_str());
+                    if (round == 0)
+                        result[idx] = cstr.GetCString();
+                    if (result[idx] != cstr.GetCString() || cstr.GetLength() != str.size())
+                        mismatch = true;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    ASSERT_FALSE(mismatch);
+    for (size_t t = 0; t < num_threads; ++t)
+    {
+        for (size_t i = 0; i < num_strings; ++i)
+            ASSERT_EQ(results[0][i], results[t][i]);
+    }
+    for (size_t i = 0; i < num_strings; ++i)
+        ASSERT_EQ("ConstStringTest::ConcurrentAccess::" + std::to_string(i), results[0][i]);
+}
@@ -0,0 +1,129 @@
+//===-- FormatCacheTest.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#if defined(_MSC_VER) && (_HAS_EXCEPTIONS == 0)
+// Workaround for MSVC standard library bug, which fails to include <thread> when
+// exceptions are disabled.
+#include <eh.h>
+#endif
+
+#include "gtest/gtest.h"
+
+#include "lldb/Core/ConstString.h"
+#include "lldb/DataFormatters/FormatCache.h"
+#include "lldb/DataFormatters/TypeFormat.h"
+
+#include <string>
+#include <vector>
+
+using namespace lldb;
+using namespace lldb_private;
+
+TEST(FormatCacheTest, StaleRevision)
+{
+    FormatCache cache;
+    const ConstString type("int");
+    TypeFormatImplSP format_sp(new TypeFormatImpl_Format(eFormatHex));
+    cache.SetFormat(type, eNoDynamicValues, 1, format_sp);
+
+    TypeFormatImplSP found_sp;
+    EXPECT_TRUE(cache.GetFormat(type, eNoDynamicValues, 1, found_sp));
+    EXPECT_EQ(format_sp, found_sp);
+
+    // The formatters changed since the entry was stored.
+    EXPECT_FALSE(cache.GetFormat(type, eNoDynamicValues, 2, found_sp));
+    EXPECT_FALSE(found_sp);
+    EXPECT_EQ(1u, cache.GetCacheHits());
+    EXPECT_EQ(1u, cache.GetCacheMisses());
+
+    // Storing under the new revision replaces the stale entry, which then
+    // can't be found under the old one either.
+    TypeFormatImplSP new_format_sp(new TypeFormatImpl_Format(eFormatDecimal));
+    cache.SetFormat(type, eNoDynamicValues, 2, new_format_sp);
+    EXPECT_TRUE(cache.GetFormat(type, eNoDynamicValues, 2, found_sp));
+    EXPECT_EQ(new_format_sp, found_sp);
+    EXPECT_FALSE(cache.GetFormat(type, eNoDynamicValues, 1, found_sp));
+}
+
+TEST(FormatCacheTest, DynamicValueTypes)
+{
+    FormatCache cache;
+    const ConstString type("Base *");
+    TypeFormatImplSP static_format_sp(new TypeFormatImpl_Format(eFormatHex));
+    TypeFormatImplSP dynamic_format_sp(new TypeFormatImpl_Format(eFormatDecimal));
+    cache.SetFormat(type, eNoDynamicValues, 1, static_format_sp);
+
+    TypeFormatImplSP found_sp;
+    EXPECT_FALSE(cache.GetFormat(type, eDynamicCanRunTarget, 1, found_sp));
+    EXPECT_FALSE(cache.GetFormat(type, eDynamicDontRunTarget, 1, found_sp));
+
+    cache.SetFormat(type, eDynamicCanRunTarget, 1, dynamic_format_sp);
+    EXPECT_TRUE(cache.GetFormat(type, eNoDynamicValues, 1, found_sp));
+    EXPECT_EQ(static_format_sp, found_sp);
+    EXPECT_TRUE(cache.GetFormat(type, eDynamicCanRunTarget, 1, found_sp));
+    EXPECT_EQ(dynamic_format_sp, found_sp);
+    EXPECT_FALSE(cache.GetFormat(type, eDynamicDontRunTarget, 1, found_sp));
+}
+
+TEST(FormatCacheTest, NegativeHits)
+{
+    FormatCache cache;
+    const ConstString type("int");
+
+    // Nothing is known about the summary yet.
+    TypeSummaryImplSP summary_sp;
+    EXPECT_FALSE(cache.GetSummary(type, eNoDynamicValues, 1, summary_sp));
+    EXPECT_EQ(0u, cache.GetCacheHits());
+    EXPECT_EQ(0u, cache.GetCacheNegativeHits());
+    EXPECT_EQ(1u, cache.GetCacheMisses());
+
+    // The type has no summary.
+    TypeSummaryImplSP no_summary_sp;
+    cache.SetSummary(type, eNoDynamicValues, 1, no_summary_sp);
+    EXPECT_TRUE(cache.GetSummary(type, eNoDynamicValues, 1, summary_sp));
+    EXPECT_FALSE(summary_sp);
+    EXPECT_EQ(1u, cache.GetCacheHits());
+    EXPECT_EQ(1u, cache.GetCacheNegativeHits());
+    EXPECT_EQ(1u, cache.GetCacheMisses());
+
+    // The other kinds of formatter of the entry are still unknown.
+    SyntheticChildrenSP synthetic_sp;
+    EXPECT_FALSE(cache.GetSynthetic(type, eNoDynamicValues, 1, synthetic_sp));
+    EXPECT_EQ(2u, cache.GetCacheMisses());
+
+    // A hit that found a formatter isn't a negative hit.
+    TypeFormatImplSP format_sp(new TypeFormatImpl_Format(eFormatHex));
+    cache.SetFormat(type, eNoDynamicValues, 1, format_sp);
+    TypeFormatImplSP found_sp;
+    EXPECT_TRUE(cache.GetFormat(type, eNoDynamicValues, 1, found_sp));
+    EXPECT_EQ(2u, cache.GetCacheHits());
+    EXPECT_EQ(1u, cache.GetCacheNegativeHits());
+}
+
+TEST(FormatCacheTest, Clear)
+{
+    FormatCache cache;
+
+    // Enough types to end up in every stripe.
+    std::vector<ConstString> types;
+    for (int i = 0; i < 256; ++i)
+        types.push_back(ConstString(("type_" + std::to_string(i)).c_str()));
+
+    TypeFormatImplSP format_sp(new TypeFormatImpl_Format(eFormatHex));
+    for (const ConstString &type : types)
+        cache.SetFormat(type, eNoDynamicValues, 1, format_sp);
+
+    TypeFormatImplSP found_sp;
+    for (const ConstString &type : types)
+        EXPECT_TRUE(cache.GetFormat(type, eNoDynamicValues, 1, found_sp));
+
+    cache.Clear();
+    for (const ConstString &type : types)
+        EXPECT_FALSE(cache.GetFormat(type, eNoDynamicValues, 1, found_sp)) << type.GetCString();
+}
@@ -0,0 +1,95 @@
+//===-- RegexPrefixFilterTest.cpp -------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#if defined(_MSC_VER) && (_HAS_EXCEPTIONS == 0)
+// Workaround for MSVC standard library bug, which fails to include <thread> when
+// exceptions are disabled.
+#include <eh.h>
+#endif
+
+#include "gtest/gtest.h"
+
+#include "lldb/Core/RegularExpression.h"
+#include "lldb/DataFormatters/RegexPrefixFilter.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace lldb_private;
+
+TEST(RegexPrefixFilterTest, LiteralPrefix)
+{
+    EXPECT_EQ("std::__1::vector<", RegexPrefixFilter::GetLiteralPrefix("^std::__1::vector<.+>(( )?&)?$"));
+    EXPECT_EQ("std::", RegexPrefixFilter::GetLiteralPrefix("^std::(__cxx11::)?list<.+>(( )?&)?$"));
+    EXPECT_EQ("a.b", RegexPrefixFilter::GetLiteralPrefix("^a\\.b[x]"));
+    EXPECT_EQ("ab", RegexPrefixFilter::GetLiteralPrefix("^ab+c"));
+    EXPECT_EQ("a", RegexPrefixFilter::GetLiteralPrefix("^ab*c"));
+    EXPECT_EQ("a", RegexPrefixFilter::GetLiteralPrefix("^ab?c"));
+    EXPECT_EQ("a", RegexPrefixFilter::GetLiteralPrefix("^ab{2}c"));
+
+    // Unanchored patterns and top level alternations have no prefix.
+    EXPECT_EQ("", RegexPrefixFilter::GetLiteralPrefix("std::vector<.+>"));
+    EXPECT_EQ("", RegexPrefixFilter::GetLiteralPrefix("^a|b"));
+    EXPECT_EQ("", RegexPrefixFilter::GetLiteralPrefix("^(std::)?vector<.+>$"));
+    EXPECT_EQ("a", RegexPrefixFilter::GetLiteralPrefix("^a(b|c)"));
+    EXPECT_EQ("a", RegexPrefixFilter::GetLiteralPrefix("^a[|]"));
+    EXPECT_EQ("", RegexPrefixFilter::GetLiteralPrefix("^a[[:alpha:]]|b"));
+    EXPECT_EQ("", RegexPrefixFilter::GetLiteralPrefix("^\\d"));
+    EXPECT_EQ("", RegexPrefixFilter::GetLiteralPrefix(nullptr));
+}
+
+TEST(RegexPrefixFilterTest, Candidates)
+{
+    const char *patterns[] = {
+        "^std::__1::vector<.+>(( )?&)?$",
+        "^std::(__cxx11::)?list<.+>(( )?&)?$",
+        "^(std::)?vector<.+>$",
+        "^std::__1::map<.+> >(( )?&)?$",
+        "^std::__1::vector<bool,.+>$",
+        "Foo$",
+    };
+    const size_t num_patterns = sizeof(patterns) / sizeof(patterns[0]);
+
+    RegexPrefixFilter filter;
+    for (const char *pattern : patterns)
+        filter.Append(pattern);
+    EXPECT_EQ(num_patterns, filter.GetSize());
+
+    std::vector<uint32_t> candidates;
+    filter.GetCandidates("std::__1::vector<bool, std::__1::allocator<bool> >", candidates);
+    EXPECT_EQ((std::vector<uint32_t>{0, 1, 2, 4, 5}), candidates);
+
+    filter.GetCandidates("int", candidates);
+    EXPECT_EQ((std::vector<uint32_t>{2, 5}), candidates);
+
+    // Every pattern that matches a name must be a candidate for it.
+    const char *names[] = {
+        "std::__1::vector<int, std::__1::allocator<int> >",
+        "std::__1::vector<bool, std::__1::allocator<bool> > &",
+        "std::__cxx11::list<int, std::allocator<int> >",
+        "std::__1::map<int, int, std::__1::less<int>, std::__1::allocator<std::__1::pair<const int, int> > >",
+        "vector<int>",
+        "MyFoo",
+    };
+    for (const char *name : names)
+    {
+        filter.GetCandidates(name, candidates);
+        for (size_t i = 0; i < num_patterns; ++i)
+        {
+            RegularExpression regex(patterns[i]);
+            if (regex.Execute(name))
+                EXPECT_NE(candidates.end(), std::find(candidates.begin(), candidates.end(), i)) << name;
+        }
+    }
+
+    filter.Clear();
+    EXPECT_EQ(0u, filter.GetSize());
+    filter.GetCandidates("int", candidates);
+    EXPECT_TRUE(candidates.empty());
+}
@@ -0,0 +1,270 @@
+//===-- AgentExpressionCompilerTest.cpp -------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#if defined(_MSC_VER) && (_HAS_EXCEPTIONS == 0)
+// Workaround for MSVC standard library bug, which fails to include <thread> when
+// exceptions are disabled.
+#include <eh.h>
+#endif
+
+#include "gtest/gtest.h"
+
+#include "lldb/Core/Address.h"
+#include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/ConstString.h"
+#include "lldb/Core/Debugger.h"
+#include "lldb/Core/Error.h"
+#include "lldb/Host/HostInfo.h"
+#include "lldb/Target/Platform.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Target/TargetList.h"
+#include "Plugins/Platform/Linux/PlatformLinux.h"
+#include "Plugins/Process/Utility/DynamicRegisterInfo.h"
+#include "Plugins/Process/gdb-remote/AgentExpressionCompiler.h"
+
+#include <string.h>
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::process_gdb_remote;
+
+namespace
+{
+    // The registers of the stub, by "p" packet number.
+    enum
+    {
+        k_reg_r64,
+        k_reg_r32,
+        k_reg_v128
+    };
+
+    // Serves the register values of the test.
+    class TestContext : public AgentExpression::Context
+    {
+    public:
+        TestContext (uint64_t r64, uint64_t r32) :
+            m_r64 (r64),
+            m_r32 (r32)
+        {
+        }
+
+        bool
+        ReadRegister (uint32_t reg_num, uint64_t &value) override
+        {
+            if (reg_num == k_reg_r64)
+                value = m_r64;
+            else if (reg_num == k_reg_r32)
+                value = m_r32;
+            else
+                return false;
+            return true;
+        }
+
+        bool
+        ReadMemory (addr_t addr, void *buf, size_t size) override
+        {
+            return false;
+        }
+
+        ByteOrder
+        GetByteOrder () override
+        {
+            return eByteOrderLittle;
+        }
+
+    private:
+        uint64_t m_r64;
+        uint64_t m_r32;
+    };
+}
+
+class AgentExpressionCompilerTest : public testing::Test
+{
+public:
+    static void
+    SetUpTestCase ()
+    {
+        HostInfo::Initialize();
+        ArchSpec arch ("x86_64-pc-linux");
+        Platform::SetHostPlatform (platform_linux::PlatformLinux::CreateInstance (true, &arch));
+        Debugger::Initialize (nullptr);
+    }
+
+    static void
+    TearDownTestCase ()
+    {
+        Debugger::Terminate();
+        HostInfo::Terminate();
+    }
+
+    void
+    SetUp () override
+    {
+        m_debugger_sp = Debugger::CreateInstance();
+        ASSERT_TRUE (m_debugger_sp);
+
+        ArchSpec arch ("x86_64-pc-linux");
+        PlatformSP platform_sp;
+        m_debugger_sp->GetTargetList().CreateTarget (*m_debugger_sp, nullptr, arch, false, platform_sp, m_target_sp);
+        ASSERT_TRUE (m_target_sp);
+
+        AddRegister ("r64", 8, eEncodingUint, k_reg_r64);
+        AddRegister ("r32", 4, eEncodingUint, k_reg_r32);
+        AddRegister ("v128", 16, eEncodingVector, k_reg_v128);
+        m_register_info.Finalize (arch);
+    }
+
+    void
+    TearDown () override
+    {
+        m_target_sp.reset();
+        Debugger::Destroy (m_debugger_sp);
+    }
+
+protected:
+    void
+    AddRegister (const char *name, uint32_t byte_size, Encoding encoding, uint32_t reg_num)
+    {
+        RegisterInfo reg_info;
+        memset (&reg_info, 0, sizeof(reg_info));
+        reg_info.byte_size = byte_size;
+        reg_info.byte_offset = m_register_info.GetRegisterDataByteSize();
+        reg_info.encoding = encoding;
+        reg_info.format = eFormatHex;
+        for (uint32_t &kind : reg_info.kinds)
+            kind = LLDB_INVALID_REGNUM;
+        reg_info.kinds[eRegisterKindProcessPlugin] = reg_num;
+        reg_info.kinds[eRegisterKindLLDB] = reg_num;
+        ConstString reg_name (name);
+        ConstString reg_alt_name;
+        ConstString set_name ("General Purpose Registers");
+        m_register_info.AddRegister (reg_info, reg_name, reg_alt_name, set_name);
+    }
+
+    // Compile the condition and evaluate it against the register values.
+    bool
+    Evaluate (const char *condition, uint64_t r64, uint64_t r32, uint64_t &result)
+    {
+        AgentExpressionCompiler compiler (*m_target_sp, m_register_info);
+        AgentExpression expression;
+        Error error;
+        if (!compiler.Compile (condition, Address (), expression, error))
+        {
+            ADD_FAILURE() << "can't compile \"" << condition << "\": " << error.AsCString();
+            return false;
+        }
+        TestContext context (r64, r32);
+        return expression.Evaluate (context, result);
+    }
+
+    // The value of an expression on constants and the register values.
+    uint64_t
+    GetValue (const char *condition, uint64_t r64 = 0, uint64_t r32 = 0)
+    {
+        uint64_t result = 0;
+        EXPECT_TRUE (Evaluate (condition, r64, r32, result)) << condition;
+        return result;
+    }
+
+    bool
+    Compiles (const char *condition)
+    {
+        AgentExpressionCompiler compiler (*m_target_sp, m_register_info);
+        AgentExpression expression;
+        Error error;
+        const bool success = compiler.Compile (condition, Address (), expression, error);
+        EXPECT_EQ (success, error.Success()) << condition;
+        return success;
+    }
+
+    DebuggerSP m_debugger_sp;
+    TargetSP m_target_sp;
+    DynamicRegisterInfo m_register_info;
+};
+
+TEST_F (AgentExpressionCompilerTest, Comparisons)
+{
+    EXPECT_EQ (1u, GetValue ("1 < 2"));
+    EXPECT_EQ (0u, GetValue ("1 > 2"));
+    EXPECT_EQ (1u, GetValue ("2 >= 2"));
+    EXPECT_EQ (0u, GetValue ("3 <= 2"));
+    EXPECT_EQ (1u, GetValue ("2 != 3"));
+    EXPECT_EQ (1u, GetValue ("$r64 == 5", 5));
+    EXPECT_EQ (1u, GetValue ("$r32 == 1 || $r64 == 5", 5, 0));
+    EXPECT_EQ (0u, GetValue ("$r32 == 1 && $r64 == 5", 5, 0));
+    EXPECT_EQ (1u, GetValue ("!($r32 == 1) && ($r64 & 4)", 5, 0));
+}
+
+TEST_F (AgentExpressionCompilerTest, Signedness)
+{
+    // An int converted to unsigned int is taken modulo 2^32.
+    EXPECT_EQ (1u, GetValue ("$r32 == -1", 0, 0xffffffff));
+    EXPECT_EQ (1u, GetValue ("-1 == $r32", 0, 0xffffffff));
+    EXPECT_EQ (0u, GetValue ("$r32 > -1", 0, 0xffffffff));
+    EXPECT_EQ (1u, GetValue ("$r32 > 0", 0, 0xffffffff));
+    EXPECT_EQ (1u, GetValue ("-1 < 0"));
+    EXPECT_EQ (0u, GetValue ("-1 < 0u"));
+    EXPECT_EQ (1u, GetValue ("-1 == 4294967295u"));
+    EXPECT_EQ (1u, GetValue ("-2 > 1u"));
+
+    // Division and remainder follow the signedness of the common type,
+    // shifts the one of the left operand.
+    EXPECT_EQ (-4, (int64_t)GetValue ("-8 / 2"));
+    EXPECT_EQ (0x7ffffffcu, GetValue ("-8 / 2u"));
+    EXPECT_EQ (-1, (int64_t)GetValue ("-7 % 2"));
+    EXPECT_EQ (-4, (int64_t)GetValue ("-8 >> 1"));
+    EXPECT_EQ (0x7fffffffu, GetValue ("$r32 >> 1", 0, 0xffffffff));
+}
+
+TEST_F (AgentExpressionCompilerTest, Widths)
+{
+    // The int -1 converted to a 64 bit unsigned register is UINT64_MAX.
+    EXPECT_EQ (0u, GetValue ("$r64 == -1", 0xffffffff));
+    EXPECT_EQ (1u, GetValue ("$r64 == -1", UINT64_MAX));
+    EXPECT_EQ (1u, GetValue ("$r64 == 4294967295u", 0xffffffff));
+    EXPECT_EQ (0u, GetValue ("-1 == 4294967295"));
+
+    // 32 bit arithmetic wraps around, 64 bit arithmetic doesn't.
+    EXPECT_EQ (0u, GetValue ("$r32 + 1", 0, 0xffffffff));
+    EXPECT_EQ (0x100000000ull, GetValue ("$r64 + 1", 0xffffffff));
+    EXPECT_EQ (0u, GetValue ("$r32 + 1 == 4294967296", 0, 0xffffffff));
+    EXPECT_EQ (0xfffffffeu, GetValue ("~1u"));
+    EXPECT_EQ (-2, (int64_t)GetValue ("~1"));
+}
+
+TEST_F (AgentExpressionCompilerTest, DivisionByZero)
+{
+    // The condition compiles, its evaluation fails so the stub reports the
+    // breakpoint hit and lldb evaluates the condition.
+    uint64_t result = 0;
+    EXPECT_FALSE (Evaluate ("$r32 / 0 == 1", 0, 1, result));
+    EXPECT_FALSE (Evaluate ("$r64 % $r32", 5, 0, result));
+    EXPECT_TRUE (Evaluate ("$r64 % $r32", 5, 3, result));
+    EXPECT_EQ (2u, result);
+}
+
+TEST_F (AgentExpressionCompilerTest, UnsupportedConstructs)
+{
+    EXPECT_TRUE (Compiles ("$r64 == 1"));
+
+    EXPECT_FALSE (Compiles (""));
+    EXPECT_FALSE (Compiles ("1.5 > 1"));
+    EXPECT_FALSE (Compiles ("1e3 > 1"));
+    EXPECT_FALSE (Compiles ("\"abc\""));
+    EXPECT_FALSE (Compiles ("'a' == 97"));
+    EXPECT_FALSE (Compiles ("foo(1)"));
+    EXPECT_FALSE (Compiles ("unknown_variable == 1"));
+    EXPECT_FALSE (Compiles ("$unknown == 1"));
+    EXPECT_FALSE (Compiles ("$v128 == 1"));
+    EXPECT_FALSE (Compiles ("$r64 = 1"));
+    EXPECT_FALSE (Compiles ("$r64 == 1 ? 2 : 3"));
+    EXPECT_FALSE (Compiles ("*$r64 == 1"));
+    EXPECT_FALSE (Compiles ("(1 == 1"));
+    EXPECT_FALSE (Compiles ("nullptr + 1"));
+}
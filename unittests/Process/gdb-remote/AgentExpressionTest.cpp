@@ -0,0 +1,273 @@
+//===-- AgentExpressionTest.cpp ---------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#if defined(_MSC_VER) && (_HAS_EXCEPTIONS == 0)
+// Workaround for MSVC standard library bug, which fails to include <thread> when
+// exceptions are disabled.
+#include <eh.h>
+#endif
+
+#include "gtest/gtest.h"
+
+#include "Plugins/Process/gdb-remote/AgentExpression.h"
+
+#include <string.h>
+
+#include <map>
+#include <vector>
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::process_gdb_remote;
+
+namespace
+{
+    typedef AgentExpression E;
+
+    const addr_t k_memory_base = 0x1000;
+
+    // Registers numbered like the "p" packet and a few bytes of little
+    // endian memory at k_memory_base.
+    class TestContext : public AgentExpression::Context
+    {
+    public:
+        TestContext () :
+            m_registers (),
+            m_memory ()
+        {
+            m_registers[0] = 0x1122334455667788ull;
+            m_registers[1] = 0xfffffffeull;
+            const uint8_t memory[] = { 0xfe, 0xff, 0xff, 0xff, 0x01, 0x02, 0x03, 0x04 };
+            m_memory.assign (memory, memory + sizeof(memory));
+        }
+
+        bool
+        ReadRegister (uint32_t reg_num, uint64_t &value) override
+        {
+            auto pos = m_registers.find (reg_num);
+            if (pos == m_registers.end())
+                return false;
+            value = pos->second;
+            return true;
+        }
+
+        bool
+        ReadMemory (addr_t addr, void *buf, size_t size) override
+        {
+            if (addr < k_memory_base || addr + size > k_memory_base + m_memory.size())
+                return false;
+            memcpy (buf, &m_memory[addr - k_memory_base], size);
+            return true;
+        }
+
+        ByteOrder
+        GetByteOrder () override
+        {
+            return eByteOrderLittle;
+        }
+
+    private:
+        std::map<uint32_t, uint64_t> m_registers;
+        std::vector<uint8_t> m_memory;
+    };
+
+    bool
+    Evaluate (const AgentExpression &expression, uint64_t &result)
+    {
+        TestContext context;
+        return expression.Evaluate (context, result);
+    }
+
+    // Push a and b, then run the binary opcode.
+    bool
+    EvaluateBinary (uint64_t a, uint64_t b, E::Opcode opcode, uint64_t &result)
+    {
+        AgentExpression expression;
+        expression.AppendConstant (a);
+        expression.AppendConstant (b);
+        expression.AppendOpcode (opcode);
+        expression.AppendOpcode (E::eOpEnd);
+        return Evaluate (expression, result);
+    }
+}
+
+TEST(AgentExpressionTest, Constants)
+{
+    const uint64_t values[] = { 0, 0x7f, 0x1234, 0x12345678, 0x123456789abcdef0ull, UINT64_MAX };
+    for (uint64_t value : values)
+    {
+        AgentExpression expression;
+        expression.AppendConstant (value);
+        expression.AppendOpcode (E::eOpEnd);
+        uint64_t result = 0;
+        ASSERT_TRUE (Evaluate (expression, result));
+        EXPECT_EQ (value, result);
+    }
+
+    // The operands are big endian.
+    const uint8_t bytes[] = { E::eOpConst16, 0x12, 0x34, E::eOpEnd };
+    uint64_t result = 0;
+    ASSERT_TRUE (Evaluate (AgentExpression (bytes, sizeof(bytes)), result));
+    EXPECT_EQ (0x1234u, result);
+}
+
+TEST(AgentExpressionTest, Arithmetic)
+{
+    uint64_t result = 0;
+    ASSERT_TRUE (EvaluateBinary (5, 3, E::eOpSub, result));
+    EXPECT_EQ (2u, result);
+    ASSERT_TRUE (EvaluateBinary (3, 5, E::eOpSub, result));
+    EXPECT_EQ (-2, (int64_t)result);
+    ASSERT_TRUE (EvaluateBinary (6, 7, E::eOpMul, result));
+    EXPECT_EQ (42u, result);
+    ASSERT_TRUE (EvaluateBinary (1, 63, E::eOpLsh, result));
+    EXPECT_EQ (0x8000000000000000ull, result);
+    ASSERT_TRUE (EvaluateBinary (1, 64, E::eOpLsh, result));
+    EXPECT_EQ (0u, result);
+    ASSERT_TRUE (EvaluateBinary (0xf0, 0x3c, E::eOpBitXor, result));
+    EXPECT_EQ (0xccu, result);
+}
+
+TEST(AgentExpressionTest, Signedness)
+{
+    const uint64_t minus_one = UINT64_MAX;
+    const uint64_t minus_eight = -8ull;
+    uint64_t result = 0;
+
+    ASSERT_TRUE (EvaluateBinary (minus_one, 0, E::eOpLessSigned, result));
+    EXPECT_EQ (1u, result);
+    ASSERT_TRUE (EvaluateBinary (minus_one, 0, E::eOpLessUnsigned, result));
+    EXPECT_EQ (0u, result);
+
+    ASSERT_TRUE (EvaluateBinary (minus_eight, 2, E::eOpDivSigned, result));
+    EXPECT_EQ (-4, (int64_t)result);
+    ASSERT_TRUE (EvaluateBinary (minus_eight, 2, E::eOpDivUnsigned, result));
+    EXPECT_EQ (0x7ffffffffffffffcull, result);
+    ASSERT_TRUE (EvaluateBinary (-7ull, 2, E::eOpRemSigned, result));
+    EXPECT_EQ (-1, (int64_t)result);
+    ASSERT_TRUE (EvaluateBinary (minus_eight, 1, E::eOpRshSigned, result));
+    EXPECT_EQ (-4, (int64_t)result);
+    ASSERT_TRUE (EvaluateBinary (minus_eight, 1, E::eOpRshUnsigned, result));
+    EXPECT_EQ (0x7ffffffffffffffcull, result);
+
+    // INT64_MIN / -1 overflows, it must not trap.
+    ASSERT_TRUE (EvaluateBinary (0x8000000000000000ull, minus_one, E::eOpDivSigned, result));
+    EXPECT_EQ (0x8000000000000000ull, result);
+    ASSERT_TRUE (EvaluateBinary (0x8000000000000000ull, minus_one, E::eOpRemSigned, result));
+    EXPECT_EQ (0u, result);
+}
+
+TEST(AgentExpressionTest, Extend)
+{
+    AgentExpression expression;
+    expression.AppendConstant (0xffffff80);
+    expression.AppendOpcode (E::eOpExt, 8);
+    expression.AppendOpcode (E::eOpEnd);
+    uint64_t result = 0;
+    ASSERT_TRUE (Evaluate (expression, result));
+    EXPECT_EQ (-128, (int64_t)result);
+
+    expression = AgentExpression ();
+    expression.AppendConstant (UINT64_MAX);
+    expression.AppendOpcode (E::eOpZeroExt, 32);
+    expression.AppendOpcode (E::eOpEnd);
+    ASSERT_TRUE (Evaluate (expression, result));
+    EXPECT_EQ (0xffffffffu, result);
+}
+
+TEST(AgentExpressionTest, DivisionByZero)
+{
+    const E::Opcode opcodes[] = { E::eOpDivSigned, E::eOpDivUnsigned, E::eOpRemSigned, E::eOpRemUnsigned };
+    for (E::Opcode opcode : opcodes)
+    {
+        uint64_t result = 0;
+        EXPECT_FALSE (EvaluateBinary (1, 0, opcode, result)) << "opcode " << opcode;
+    }
+}
+
+TEST(AgentExpressionTest, RegistersAndMemory)
+{
+    AgentExpression expression;
+    expression.AppendRegister (1);
+    expression.AppendOpcode (E::eOpEnd);
+    uint64_t result = 0;
+    ASSERT_TRUE (Evaluate (expression, result));
+    EXPECT_EQ (0xfffffffeu, result);
+
+    expression = AgentExpression ();
+    expression.AppendRegister (2);
+    expression.AppendOpcode (E::eOpEnd);
+    EXPECT_FALSE (Evaluate (expression, result));
+
+    // ref32 reads in the byte order of the process and zero extends.
+    expression = AgentExpression ();
+    expression.AppendConstant (k_memory_base);
+    expression.AppendOpcode (E::eOpRef32);
+    expression.AppendOpcode (E::eOpEnd);
+    ASSERT_TRUE (Evaluate (expression, result));
+    EXPECT_EQ (0xfffffffeu, result);
+
+    expression = AgentExpression ();
+    expression.AppendConstant (k_memory_base);
+    expression.AppendOpcode (E::eOpRef64);
+    expression.AppendOpcode (E::eOpEnd);
+    ASSERT_TRUE (Evaluate (expression, result));
+    EXPECT_EQ (0x04030201fffffffeull, result);
+
+    expression = AgentExpression ();
+    expression.AppendConstant (k_memory_base + 4);
+    expression.AppendOpcode (E::eOpRef64);
+    expression.AppendOpcode (E::eOpEnd);
+    EXPECT_FALSE (Evaluate (expression, result));
+}
+
+TEST(AgentExpressionTest, Jumps)
+{
+    // if (reg1 != 0) result = 2; else result = 3;
+    AgentExpression expression;
+    expression.AppendRegister (1);
+    const size_t if_jump = expression.AppendJump (E::eOpIfGoto);
+    expression.AppendConstant (3);
+    const size_t end_jump = expression.AppendJump (E::eOpGoto);
+    expression.SetJumpTarget (if_jump, expression.GetSize());
+    expression.AppendConstant (2);
+    expression.SetJumpTarget (end_jump, expression.GetSize());
+    expression.AppendOpcode (E::eOpEnd);
+    uint64_t result = 0;
+    ASSERT_TRUE (Evaluate (expression, result));
+    EXPECT_EQ (2u, result);
+}
+
+TEST(AgentExpressionTest, InvalidExpressions)
+{
+    uint64_t result = 0;
+
+    // Empty, stack underflows and missing end.
+    EXPECT_FALSE (Evaluate (AgentExpression (), result));
+    const uint8_t underflow[] = { E::eOpConst8, 1, E::eOpAdd, E::eOpEnd };
+    EXPECT_FALSE (Evaluate (AgentExpression (underflow, sizeof(underflow)), result));
+    const uint8_t empty_end[] = { E::eOpEnd };
+    EXPECT_FALSE (Evaluate (AgentExpression (empty_end, sizeof(empty_end)), result));
+    const uint8_t no_end[] = { E::eOpConst8, 1 };
+    EXPECT_FALSE (Evaluate (AgentExpression (no_end, sizeof(no_end)), result));
+    const uint8_t truncated_operand[] = { E::eOpConst32, 1, 2 };
+    EXPECT_FALSE (Evaluate (AgentExpression (truncated_operand, sizeof(truncated_operand)), result));
+
+    // Floating point and tracing opcodes aren't supported.
+    const uint8_t float_opcode[] = { 0x01, E::eOpConst8, 1, E::eOpEnd };
+    EXPECT_FALSE (Evaluate (AgentExpression (float_opcode, sizeof(float_opcode)), result));
+    const uint8_t trace_opcode[] = { E::eOpConst8, 1, 0x0c, E::eOpEnd };
+    EXPECT_FALSE (Evaluate (AgentExpression (trace_opcode, sizeof(trace_opcode)), result));
+
+    // Infinite loops and unbounded stacks are stopped.
+    const uint8_t loop[] = { E::eOpGoto, 0, 0, E::eOpEnd };
+    EXPECT_FALSE (Evaluate (AgentExpression (loop, sizeof(loop)), result));
+    const uint8_t push_loop[] = { E::eOpConst8, 1, E::eOpGoto, 0, 0, E::eOpEnd };
+    EXPECT_FALSE (Evaluate (AgentExpression (push_loop, sizeof(push_loop)), result));
+}
@@ -0,0 +1,356 @@
+//===-- MemoryCacheTest.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#if defined(_MSC_VER) && (_HAS_EXCEPTIONS == 0)
+// Workaround for MSVC standard library bug, which fails to include <thread> when
+// exceptions are disabled.
+#include <eh.h>
+#endif
+
+#include "gtest/gtest.h"
+
+#include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/Debugger.h"
+#include "lldb/Core/Listener.h"
+#include "lldb/Host/HostInfo.h"
+#include "lldb/Target/Memory.h"
+#include "lldb/Target/Platform.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Target/TargetList.h"
+#include "Plugins/Platform/Linux/PlatformLinux.h"
+
+#include <vector>
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    const addr_t k_memory_base = 0x10000;
+    const size_t k_memory_size = 0x10000;
+
+    // A process whose only memory is k_memory_size bytes at k_memory_base.
+    // Like most stubs, it fails a read entirely if any part of it isn't
+    // readable.
+    class DummyProcess : public Process
+    {
+    public:
+        DummyProcess (TargetSP target_sp, ListenerSP listener_sp) :
+            Process (target_sp, listener_sp),
+            m_memory (k_memory_size),
+            m_num_reads (0),
+            m_range_reads ()
+        {
+            for (size_t i = 0; i < k_memory_size; ++i)
+                m_memory[i] = (uint8_t)(i * 7);
+        }
+
+        ~DummyProcess () override
+        {
+            Finalize();
+        }
+
+        bool
+        CanDebug (TargetSP target, bool plugin_specified_by_name) override
+        {
+            return true;
+        }
+
+        Error
+        DoDestroy () override
+        {
+            return Error();
+        }
+
+        void
+        RefreshStateAfterStop () override
+        {
+        }
+
+        size_t
+        DoReadMemory (addr_t vm_addr, void *buf, size_t size, Error &error) override
+        {
+            ++m_num_reads;
+            if (vm_addr < k_memory_base || vm_addr + size > k_memory_base + k_memory_size)
+            {
+                error.SetErrorString ("unreadable memory");
+                return 0;
+            }
+            memcpy (buf, &m_memory[vm_addr - k_memory_base], size);
+            return size;
+        }
+
+        // Reads every range it can, like a stub answering jMultiMemRead.
+        void
+        DoReadMemoryRanges (MemoryRangeReads &reads) override
+        {
+            m_range_reads.push_back (reads.size());
+            for (MemoryRangeRead &read : reads)
+            {
+                read.bytes_read = 0;
+                if (read.addr >= k_memory_base && read.addr + read.size <= k_memory_base + k_memory_size)
+                {
+                    memcpy (read.buf, &m_memory[read.addr - k_memory_base], read.size);
+                    read.bytes_read = read.size;
+                }
+            }
+        }
+
+        size_t
+        DoWriteMemory (addr_t vm_addr, const void *buf, size_t size, Error &error) override
+        {
+            if (vm_addr < k_memory_base || vm_addr + size > k_memory_base + k_memory_size)
+            {
+                error.SetErrorString ("unwritable memory");
+                return 0;
+            }
+            memcpy (&m_memory[vm_addr - k_memory_base], buf, size);
+            return size;
+        }
+
+        bool
+        UpdateThreadList (ThreadList &old_thread_list, ThreadList &new_thread_list) override
+        {
+            return false;
+        }
+
+        ConstString
+        GetPluginName () override
+        {
+            return ConstString ("dummy");
+        }
+
+        uint32_t
+        GetPluginVersion () override
+        {
+            return 1;
+        }
+
+        uint8_t
+        GetByte (addr_t addr) const
+        {
+            return m_memory[addr - k_memory_base];
+        }
+
+        uint32_t
+        GetNumReads () const
+        {
+            return m_num_reads;
+        }
+
+        // The number of ranges of each DoReadMemoryRanges() call
+        const std::vector<size_t> &
+        GetRangeReads () const
+        {
+            return m_range_reads;
+        }
+
+    private:
+        std::vector<uint8_t> m_memory;
+        uint32_t m_num_reads;
+        std::vector<size_t> m_range_reads;
+    };
+}
+
+class MemoryCacheTest : public testing::Test
+{
+public:
+    static void
+    SetUpTestCase ()
+    {
+        HostInfo::Initialize();
+        ArchSpec arch ("x86_64-pc-linux");
+        Platform::SetHostPlatform (platform_linux::PlatformLinux::CreateInstance (true, &arch));
+        Debugger::Initialize (nullptr);
+    }
+
+    static void
+    TearDownTestCase ()
+    {
+        Debugger::Terminate();
+        HostInfo::Terminate();
+    }
+
+    void
+    SetUp () override
+    {
+        m_debugger_sp = Debugger::CreateInstance();
+        ASSERT_TRUE (m_debugger_sp);
+
+        ArchSpec arch ("x86_64-pc-linux");
+        PlatformSP platform_sp;
+        TargetSP target_sp;
+        m_debugger_sp->GetTargetList().CreateTarget (*m_debugger_sp, nullptr, arch, false, platform_sp, target_sp);
+        ASSERT_TRUE (target_sp);
+
+        m_process_sp.reset (new DummyProcess (target_sp, Listener::MakeListener ("MemoryCacheTest")));
+        m_line_size = m_process_sp->GetMemoryCacheLineSize();
+        ASSERT_LT (16u * m_line_size, k_memory_size);
+    }
+
+    void
+    TearDown () override
+    {
+        m_process_sp.reset();
+        Debugger::Destroy (m_debugger_sp);
+    }
+
+protected:
+    // Read dst_len bytes through the memory cache and check they are the
+    // bytes of the process.
+    void
+    CheckRead (addr_t addr, size_t dst_len)
+    {
+        std::vector<uint8_t> dst (dst_len);
+        Error error;
+        ASSERT_EQ (dst_len, m_process_sp->ReadMemory (addr, dst.data(), dst_len, error)) << error.AsCString();
+        for (size_t i = 0; i < dst_len; ++i)
+            ASSERT_EQ (m_process_sp->GetByte (addr + i), dst[i]) << "at 0x" << std::hex << addr + i;
+    }
+
+    DebuggerSP m_debugger_sp;
+    std::shared_ptr<DummyProcess> m_process_sp;
+    uint64_t m_line_size;
+};
+
+TEST_F (MemoryCacheTest, PrefetchWindow)
+{
+    const addr_t base = k_memory_base;
+
+    // The first miss reads a single line.
+    CheckRead (base, 4);
+    MemoryCache::Statistics stats = m_process_sp->GetMemoryCacheStatistics();
+    EXPECT_EQ (1u, stats.misses);
+    EXPECT_EQ (1u, stats.process_reads);
+    EXPECT_EQ (m_line_size, stats.bytes_read);
+
+    // Misses that continue where the previous one stopped double the
+    // number of lines read, up to 16.
+    CheckRead (base + m_line_size, 4);
+    stats = m_process_sp->GetMemoryCacheStatistics();
+    EXPECT_EQ (2u, stats.process_reads);
+    EXPECT_EQ (3 * m_line_size, stats.bytes_read);
+
+    CheckRead (base + 3 * m_line_size, 4);
+    stats = m_process_sp->GetMemoryCacheStatistics();
+    EXPECT_EQ (3u, stats.process_reads);
+    EXPECT_EQ (7 * m_line_size, stats.bytes_read);
+
+    // The prefetched lines are hits, even for a read spanning two of them.
+    CheckRead (base + 5 * m_line_size - 2, 4);
+    stats = m_process_sp->GetMemoryCacheStatistics();
+    EXPECT_EQ (3u, stats.process_reads);
+    EXPECT_EQ (3u, stats.misses);
+    EXPECT_EQ (1u, stats.hits);
+
+    // A miss somewhere else starts over with a single line.
+    CheckRead (base + 12 * m_line_size, 4);
+    stats = m_process_sp->GetMemoryCacheStatistics();
+    EXPECT_EQ (4u, stats.process_reads);
+    EXPECT_EQ (8 * m_line_size, stats.bytes_read);
+    EXPECT_EQ (4u, m_process_sp->GetNumReads());
+}
+
+TEST_F (MemoryCacheTest, PrefetchStopsAtUnreadableMemory)
+{
+    const addr_t end = k_memory_base + k_memory_size;
+
+    // Read the last lines sequentially so the next miss wants 4 lines while
+    // only the last one is readable.
+    CheckRead (end - 4 * m_line_size, 4);
+    CheckRead (end - 3 * m_line_size, 4);
+    MemoryCache::Statistics stats = m_process_sp->GetMemoryCacheStatistics();
+    EXPECT_EQ (2u, stats.process_reads);
+
+    // The batched read fails and the first line is read again on its own.
+    CheckRead (end - m_line_size, 4);
+    stats = m_process_sp->GetMemoryCacheStatistics();
+    EXPECT_EQ (3u, stats.misses);
+    EXPECT_EQ (4u, stats.process_reads);
+
+    // Reading past the end still fails.
+    uint8_t byte;
+    Error error;
+    EXPECT_EQ (0u, m_process_sp->ReadMemory (end, &byte, 1, error));
+    EXPECT_TRUE (error.Fail());
+}
+
+TEST_F (MemoryCacheTest, WritesInvalidateCachedLines)
+{
+    const addr_t base = k_memory_base;
+
+    // A small read goes to the L2 cache, a read larger than a line goes to
+    // the L1 cache.
+    CheckRead (base + 16, 4);
+    CheckRead (base + 8 * m_line_size, 2 * m_line_size);
+    MemoryCache::Statistics stats = m_process_sp->GetMemoryCacheStatistics();
+    EXPECT_EQ (2u, stats.process_reads);
+
+    CheckRead (base + 16, 4);
+    CheckRead (base + 8 * m_line_size, 2 * m_line_size);
+    stats = m_process_sp->GetMemoryCacheStatistics();
+    EXPECT_EQ (2u, stats.process_reads);
+    EXPECT_EQ (2u, stats.hits);
+
+    const uint8_t new_bytes[] = { 0xaa, 0xbb };
+    Error error;
+    EXPECT_EQ (sizeof(new_bytes), m_process_sp->WriteMemory (base + 17, new_bytes, sizeof(new_bytes), error));
+    EXPECT_EQ (sizeof(new_bytes), m_process_sp->WriteMemory (base + 9 * m_line_size, new_bytes, sizeof(new_bytes), error));
+
+    // Both reads see the new bytes, read again from the process.
+    CheckRead (base + 16, 4);
+    EXPECT_EQ (0xaa, m_process_sp->GetByte (base + 17));
+    CheckRead (base + 8 * m_line_size, 2 * m_line_size);
+    stats = m_process_sp->GetMemoryCacheStatistics();
+    EXPECT_EQ (4u, stats.process_reads);
+    EXPECT_EQ (2u, stats.hits);
+}
+
+TEST_F (MemoryCacheTest, ReadMemoryRanges)
+{
+    const addr_t base = k_memory_base;
+    CheckRead (base, 4);
+    ASSERT_EQ (1u, m_process_sp->GetNumReads());
+
+    // The first range is cached, the next two are read with one bulk read
+    // and the unmapped one is retried on its own and fails.
+    uint8_t bufs[4][16];
+    Process::MemoryRangeReads reads;
+    const addr_t addrs[4] = { base + 8, base + 0x2000, base + 0x3000, 0x100 };
+    for (size_t i = 0; i < 4; ++i)
+    {
+        Process::MemoryRangeRead read = { addrs[i], bufs[i], sizeof(bufs[i]), 0 };
+        reads.push_back (read);
+    }
+    EXPECT_EQ (3u, m_process_sp->ReadMemoryRanges (reads));
+
+    ASSERT_EQ (1u, m_process_sp->GetRangeReads().size());
+    EXPECT_EQ (3u, m_process_sp->GetRangeReads()[0]);
+    for (size_t i = 0; i < 3; ++i)
+    {
+        ASSERT_EQ (sizeof(bufs[i]), reads[i].bytes_read);
+        for (size_t j = 0; j < sizeof(bufs[i]); ++j)
+            EXPECT_EQ (m_process_sp->GetByte (addrs[i] + j), bufs[i][j]);
+    }
+    EXPECT_EQ (0u, reads[3].bytes_read);
+    EXPECT_EQ (2u, m_process_sp->GetNumReads());
+
+    // The ranges read in bulk are in the cache now.
+    CheckRead (base + 0x2000, 16);
+    CheckRead (base + 0x3004, 8);
+    EXPECT_EQ (2u, m_process_sp->GetNumReads());
+
+    // A single range isn't worth a bulk read.
+    reads.resize (1);
+    reads[0].addr = base + 0x5000;
+    EXPECT_EQ (1u, m_process_sp->ReadMemoryRanges (reads));
+    EXPECT_EQ (1u, m_process_sp->GetRangeReads().size());
+    EXPECT_EQ (3u, m_process_sp->GetNumReads());
+}
@@ -2,6 +2,13 @@
 
 #include "lldb/Utility/TaskPool.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+
 TEST (TaskPoolTest, AddTask)
 {
     auto fn = [](int x) { return x * x + 1; };
@@ -60,3 +67,139 @@ TEST (TaskPoolTest, TaskRunner)
 
     ASSERT_EQ(4, count);
 }
+
+TEST (TaskPoolTest, ParallelFor)
+{
+    std::vector<std::atomic<int>> visits(1000);
+    for (auto& v : visits)
+        v = 0;
+
+    ASSERT_TRUE(TaskPool::ParallelFor(0, visits.size(), [&visits](size_t idx) { visits[idx]++; }));
+
+    for (auto& v : visits)
+        ASSERT_EQ(1, v);
+
+    // An empty range is a no-op
+    ASSERT_TRUE(TaskPool::ParallelFor(5, 5, [](size_t) { FAIL(); }));
+}
+
+TEST (TaskPoolTest, ParallelForUnevenLoad)
+{
+    // A few long items among many short ones: the short ones must not queue up behind the long
+    // ones on a single thread.
+    const uint32_t old_thread_count = TaskPool::GetThreadCount();
+    TaskPool::SetThreadCount(4);
+
+    const size_t num_items = 2000;
+    std::vector<std::atomic<int>> visits(num_items);
+    for (auto& v : visits)
+        v = 0;
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+
+    ASSERT_TRUE(TaskPool::ParallelFor(0, num_items, [&visits, &mutex, &threads](size_t idx) {
+        if (idx % 500 == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        visits[idx]++;
+        std::lock_guard<std::mutex> guard(mutex);
+        threads.insert(std::this_thread::get_id());
+    }));
+
+    for (size_t idx = 0; idx < num_items; ++idx)
+        ASSERT_EQ(1, visits[idx]) << "index " << idx;
+    ASSERT_GT(threads.size(), 1u);
+
+    TaskPool::SetThreadCount(old_thread_count);
+}
+
+TEST (TaskPoolTest, ParallelForNested)
+{
+    // Nested loops must not deadlock even when there is only a single worker thread.
+    const uint32_t old_thread_count = TaskPool::GetThreadCount();
+    for (uint32_t thread_count : {1u, 4u})
+    {
+        TaskPool::SetThreadCount(thread_count);
+
+        std::atomic<size_t> sum(0);
+        TaskPool::ParallelFor(0, 16, [&sum](size_t i) {
+            TaskPool::ParallelFor(0, 64, [&sum, i](size_t j) { sum += i * 64 + j; });
+        });
+        ASSERT_EQ(1023u * 1024u / 2u, sum);
+
+        auto f = TaskPool::AddTask([]() {
+            auto inner = TaskPool::AddTask([]() { return 42; });
+            TaskPool::Wait(inner);
+            return inner.get();
+        });
+        TaskPool::Wait(f);
+        ASSERT_EQ(42, f.get());
+    }
+    TaskPool::SetThreadCount(old_thread_count);
+}
+
+TEST (TaskPoolTest, ParallelForCancel)
+{
+    std::atomic<bool> cancel(false);
+    std::atomic<size_t> count(0);
+    const size_t num_items = 100000;
+
+    bool completed = TaskPool::ParallelFor(0, num_items, [&cancel, &count](size_t idx) {
+        if (++count == 10)
+            cancel = true;
+    }, &cancel);
+
+    ASSERT_FALSE(completed);
+    ASSERT_LT(count, num_items);
+}
+
+TEST (TaskPoolTest, ThreadCount)
+{
+    const uint32_t old_thread_count = TaskPool::GetThreadCount();
+
+    TaskPool::SetThreadCount(4);
+    ASSERT_EQ(4u, TaskPool::GetThreadCount());
+
+    // With 4 workers the iterations must be able to run concurrently: every iteration waits
+    // (with a generous timeout) until an other one is running at the same time.
+    std::atomic<uint32_t> running(0);
+    std::atomic<bool> overlapped(false);
+    TaskPool::ParallelFor(0, 4, [&running, &overlapped](size_t) {
+        ++running;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!overlapped && std::chrono::steady_clock::now() < deadline)
+        {
+            if (running >= 2)
+                overlapped = true;
+            std::this_thread::yield();
+        }
+        --running;
+    });
+    ASSERT_TRUE(overlapped);
+
+    TaskPool::SetThreadCount(1);
+    ASSERT_EQ(1u, TaskPool::GetThreadCount());
+    auto f = TaskPool::AddTask([](int x) { return x + 1; }, 1);
+    ASSERT_EQ(2, f.get());
+
+    TaskPool::SetThreadCount(old_thread_count);
+}
+
+TEST (TaskPoolTest, ConcurrentAddTask)
+{
+    // Many small independent tasks added from several threads at once, making sure the queues
+    // don't lose or duplicate work under contention.
+    const size_t num_producers = 8;
+    const size_t tasks_per_producer = 2000;
+    std::atomic<size_t> executed(0);
+
+    TaskPool::ParallelFor(0, num_producers, [&executed, tasks_per_producer](size_t) {
+        std::vector<std::future<void>> futures;
+        futures.reserve(tasks_per_producer);
+        for (size_t i = 0; i < tasks_per_producer; ++i)
+            futures.push_back(TaskPool::AddTask([&executed]() { executed++; }));
+        for (auto& f : futures)
+            TaskPool::Wait(f);
+    });
+
+    ASSERT_EQ(num_producers * tasks_per_producer, executed);
+}